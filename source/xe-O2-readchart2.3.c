@@ -40,6 +40,7 @@ long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long *xf_lineparse1(char *line,long *nwords);
 char *xf_strcat1(char *string1,char *string2,char *delimiter);
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 /* external functions end */
 
@@ -69,6 +69,7 @@ long xf_interp3_f(float *data, long ndata);
 long xf_outlier2_f(float *dat1, long ndat1, long *start, long nblocks, long blocklen, long zero, float thresh, double *result, char *message);
 int xf_compare1_d(const void *a, const void *b);
 int xf_percentile1_d(float *data, long nn, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 
 float *xf_readbin2_f(char *infile, off_t *parameters, char *message);
 int xf_filter_bworth1_f(float *X, off_t nn, float sample_freq, float setlow, float sethigh, float res, char *message);
@@ -20,6 +20,7 @@ long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 int xf_bin1b_d(double *data1, long *setn, long *setz, double setbinsize, char *message);
 long xf_binpeak1_d(double *data1,long n, double binsize, char *message);
 double xf_percentile2_d(double *data, long nn, double setper, char *message);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 /* external functions end */
 
@@ -27,6 +27,7 @@ double *xf_matrixtrans1_d(double *data1, long *width, long *height);
 long xf_norm3_d(double *data,long ndata,int normtype,long start,long stop,char *message);
 int xf_smoothgauss1_d(double *original, size_t arraysize,int smooth);
 long xf_bin3_d(double *data1, short *flag1, long n1, long zero, double setbinsize, char *message);
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
 /* external functions end */
 
 /* compare-function for qsort */
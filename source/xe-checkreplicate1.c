@@ -1,5 +1,5 @@
 #define thisprog "xe-checkreplicate1"
-#define TITLE_STRING thisprog" 22.March.2021 [JRH]"
+#define TITLE_STRING thisprog" 18.October.2026 [JRH]"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -7,6 +7,8 @@
 /*
 <TAGS> LDAS </TAGS>
 
+ 18.October.2026 [JRH]
+ 	- sort group-lists with xf_qsortindex1_d (radix sort) instead of qsort
  22.March.2021 [JRH]
  	- add checks for missing columns 
 v 1: DAY.MONTH.YEAR [JRH]
@@ -18,7 +20,7 @@ v 1: DAY.MONTH.YEAR [JRH]
 /* external functions start */
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
-int xf_compare1_d(const void *a, const void *b);
+void xf_qsortindex1_d(double *data, long *index,long nn);
 /* external functions end */
 
 
@@ -177,13 +179,13 @@ int main (int argc, char *argv[]) {
 	CREATE A SORTED LIST OF THE UNIQUE ELEMENTS IN EACH GROUPING VARIABLE
 	********************************************************************************/
 	for(ii=0;ii<nn;ii++) listgrp1[ii]= grp1[ii];
-	qsort(listgrp1,nn,sizeof(double),xf_compare1_d);
+	xf_qsortindex1_d(listgrp1,NULL,nn);
 	aa=listgrp1[0]; for(ii=nlistgrp1=1;ii<nn;ii++) {if(listgrp1[ii]!=aa) listgrp1[nlistgrp1++]= listgrp1[ii]; aa= listgrp1[ii]; }
 	for(ii=0;ii<nn;ii++) listgrp2[ii]=grp2[ii];
-	qsort(listgrp2,nn,sizeof(double),xf_compare1_d);
+	xf_qsortindex1_d(listgrp2,NULL,nn);
 	aa=listgrp2[0]; for(ii=nlistgrp2=1;ii<nn;ii++) {if(listgrp2[ii]!=aa) listgrp2[nlistgrp2++]= listgrp2[ii]; aa= listgrp2[ii]; }
 	for(ii=0;ii<nn;ii++) listgrp3[ii]=grp3[ii];
-	qsort(listgrp3,nn,sizeof(double),xf_compare1_d);
+	xf_qsortindex1_d(listgrp3,NULL,nn);
 	aa=listgrp3[0]; for(ii=nlistgrp3=1;ii<nn;ii++) {if(listgrp3[ii]!=aa) listgrp3[nlistgrp3++]= listgrp3[ii]; aa= listgrp3[ii]; }
 	//TEST:	for(ii=0;ii<nn;ii++) printf("%g\t%g\t%g\t\t%g\n",listgrp1[ii],listgrp2[ii],listgrp3[ii],data[ii]); exit(0);
 	//TEST: printf("1:%ld\n2:%ld\n3:%ld\n",nlistgrp1,nlistgrp2,nlistgrp3);exit(0);
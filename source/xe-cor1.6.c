@@ -1,5 +1,5 @@
 #define thisprog "xe-cor1"
-#define TITLE_STRING thisprog" v 6, 17.April.2016 [JRH]"
+#define TITLE_STRING thisprog" v 7, 18.October.2026 [JRH]"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,6 +11,8 @@
 <TAGS>stats</TAGS>
 
 CHANGES:
+v 7, 18.October.2026 [JRH]
+	- add matrix-mode (-mat) to correlate many columns with each other, using xf_correlatematrix1_d
 v 6, 17.April.2016 [JRH]
 	- add explicit fclose command at end of file read - somehow this had been omitted!
 	- add explicit exit at end
@@ -30,6 +32,9 @@ v 1.2 21.July.2011 [JRH]
 
 /* external functions start */
 double xf_correlate_simple_d(double *x, double *y, long n, double *result_d);
+char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
+int xf_correlatematrix1_d(double *data, long nn, long ncols, double setinv, double *result, char *message);
+float xf_prob_F(float F,int df1,int df2);
 /* external functions end */
 
 int main(int argc, char *argv[]) {
@@ -45,8 +50,12 @@ int main(int argc, char *argv[]) {
 	/* program-specific variables */
 	long nlines=0, nskipped=0;
 	double *xdat=NULL,*ydat=NULL,r=0.0;
+	char *mline=NULL,message[MAXLINELEN];
+	long maxlinelen=0,ncols=0,nrows=0,mm,*matcol=NULL;
+	double *matdata=NULL,*matres=NULL,*pres;
 	/* arguments */
-	int setcolx=1,setcoly=2,setverb=0;
+	char *setcols=NULL;
+	int setcolx=1,setcoly=2,setverb=0,setmat=0;
 	double setxmin=NAN,setxmax=NAN;
 
 	if(argc==1) {
@@ -69,6 +78,13 @@ int main(int argc, char *argv[]) {
 		fprintf(stderr,"	-xmin minimum value of independent value to include [%g]\n",setxmin);
 		fprintf(stderr,"	-xmax maximum value of independent value to include [%g]\n",setxmax);
 		fprintf(stderr,"	-v sets verbosity of output (0=single line, 1=full report) [%d]\n",setverb);
+		fprintf(stderr,"	-mat correlate many columns with each other (matrix-mode) [%d]\n",setmat);
+		fprintf(stderr,"		0= no: correlate -cx and -cy only\n");
+		fprintf(stderr,"		1= yes: output n, r, intercept and slope for every pair of columns\n");
+		fprintf(stderr,"		2= yes: output a square matrix of r-values\n");
+		fprintf(stderr,"		NOTE: -xmin, -xmax and -v do not apply\n");
+		fprintf(stderr,"		NOTE: pairs with n<4 give r= \"-\"\n");
+		fprintf(stderr,"	-cols (-mat 1-2) comma-separated columns to correlate [all]\n");
 		fprintf(stderr,"\n");
 		fprintf(stderr,"EXAMPLE:\n");
  		fprintf(stderr,"	%s temp.dat -cx 5 -cy 7\n",thisprog);
@@ -89,8 +105,12 @@ int main(int argc, char *argv[]) {
 			else if(strcmp(argv[i],"-xmin")==0) 	{ setxmin=atof(argv[i+1]); i++;}
 			else if(strcmp(argv[i],"-xmax")==0) 	{ setxmax=atof(argv[i+1]); i++;}
 			else if(strcmp(argv[i],"-v")==0) 	{ setverb=atoi(argv[i+1]); i++;}
+			else if(strcmp(argv[i],"-mat")==0) 	{ setmat=atoi(argv[i+1]); i++;}
+			else if(strcmp(argv[i],"-cols")==0) 	{ setcols=argv[i+1]; i++;}
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[i]); exit(1);}
 	}}
+	if(setmat<0||setmat>2) {fprintf(stderr,"\n--- Error[%s]: invalid -mat (%d) - must be 0-2\n\n",thisprog,setmat); exit(1);}
+	if(setmat>0) goto MATRIX;
 
 	/* READ THE DATA - SPECIFIC COLUMNS HOLD DATA  */
 	if(strcmp(infile,"stdin")==0) fpin=stdin;
@@ -132,4 +152,70 @@ int main(int argc, char *argv[]) {
 
 	exit(0);
 
+	/* MATRIX-MODE: STORE THE SELECTED COLUMNS, THEN CORRELATE ALL PAIRS */
+MATRIX:
+	/* build the list of columns - if none were specified, the columns on the first line are used */
+	if(setcols!=NULL && strcmp(setcols,"all")!=0) {
+		pline=setcols;
+		for(col=1;(pcol=strtok(pline,","))!=NULL;col++) {
+			pline=NULL;
+			if(sscanf(pcol,"%ld",&k)!=1 || k<1) {fprintf(stderr,"\n--- Error[%s]: invalid column \"%s\" in -cols\n\n",thisprog,pcol); exit(1);}
+			if((matcol=realloc(matcol,(ncols+1)*sizeof(*matcol)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			matcol[ncols++]= k;
+	}}
+	if(strcmp(infile,"stdin")==0) fpin=stdin;
+	else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
+	while((mline=xf_lineread1(mline,&maxlinelen,fpin))!=NULL) {
+		if(maxlinelen==-1) {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
+		if(mline[0]=='#') continue;
+		/* count the columns on the first line */
+		if(ncols==0) {
+			for(pline=mline,n=0;*pline!='\0';pline++) if(!strchr(" ,\t\n",*pline) && (pline==mline || strchr(" ,\t\n",*(pline-1)))) n++;
+			if(n<1) continue;
+			if((matcol=realloc(matcol,(n+1)*sizeof(*matcol)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			for(ncols=0;ncols<n;ncols++) matcol[ncols]= ncols+1;
+		}
+		if((nrows%1024)==0) {
+			if((matdata=realloc(matdata,((nrows+1024)*ncols)*sizeof(*matdata)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		}
+		/* missing or non-numeric values are stored as NAN */
+		for(j=0;j<ncols;j++) matdata[nrows*ncols+j]= NAN;
+		pline=mline;
+		for(col=1;(pcol=strtok(pline," ,\t\n"))!=NULL;col++) {
+			pline=NULL;
+			for(j=0;j<ncols;j++) if(matcol[j]==col && sscanf(pcol,"%lf",&aa)==1) matdata[nrows*ncols+j]= aa;
+		}
+		nrows++;
+	}
+	if(strcmp(infile,"stdin")!=0) fclose(fpin);
+	if(ncols<2) {fprintf(stderr,"\n--- Error[%s]: matrix-mode requires at least 2 columns\n\n",thisprog);exit(1);}
+
+	if((matres=malloc((6*ncols*ncols+1)*sizeof(*matres)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+	if(xf_correlatematrix1_d(matdata,nrows,ncols,NAN,matres,message)<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+
+	mm= ncols*ncols;
+	if(setmat==1) {
+		printf("col1\tcol2\tn\tr\tinter\tslope\n");
+		for(i=0;i<ncols;i++) for(j=i+1;j<ncols;j++) {
+			pres= matres+i*ncols+j;
+			if(pres[0]<4) { printf("%ld\t%ld\t%ld\t-\t-\t-\n",matcol[i],matcol[j],(long)pres[0]); continue; }
+			printf("%ld\t%ld\t%ld\t%.5f\t%.5f\t%.5f\n",matcol[i],matcol[j],(long)pres[0],pres[1*mm],pres[5*mm],pres[4*mm]);
+		}
+	}
+	else {
+		printf("col");
+		for(j=0;j<ncols;j++) printf("\t%ld",matcol[j]);
+		printf("\n");
+		for(i=0;i<ncols;i++) {
+			printf("%ld",matcol[i]);
+			for(j=0;j<ncols;j++) printf("\t%.5f",matres[1*mm+i*ncols+j]);
+			printf("\n");
+		}
+	}
+	free(mline);
+	free(matcol);
+	free(matdata);
+	free(matres);
+	exit(0);
+
 }
@@ -89,6 +89,7 @@ double *xf_filter_FIRcoef1(int NumTaps, int PassType, double OmegaC, double BW,
 int xf_filter_FIRapply2_f(float *input, float *output, long nn, double *coefs, int ncoefs, int shift, char *message);
 double xf_correlate_simple_f(float *x, float *y, long n, double *result_d);
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 /* external functions end */
 
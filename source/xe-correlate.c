@@ -4,7 +4,7 @@
 #include <math.h>
 
 #define thisprog "xe-correlate"
-#define TITLE_STRING thisprog" v 2: 18.April.2016 [JRH]"
+#define TITLE_STRING thisprog" v 3: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 
 /*
@@ -12,6 +12,11 @@
 
 CHANGES:
 
+v 3: 18.October.2026 [JRH]
+	- add matrix-mode (-mat) to correlate many columns with each other, using xf_correlatematrix1_d
+		- each pair of columns uses all lines where both are valid
+		- data for matrix-mode is stored in memory
+
 v 2: 17 April.2016 [JRH]
 	- major re-write to make this the standard low-memory correlation solution
 	- switch to modern error-handling & syntax
@@ -25,6 +30,8 @@ v 1.3: JRH, 26.September.2010
 
 /* external functions start */
 float xf_prob_F(float F,int df1,int df2);
+char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
+int xf_correlatematrix1_d(double *data, long nn, long ncols, double setinv, double *result, char *message);
 /* external functions end */
 
 
@@ -40,12 +47,16 @@ int main(int argc, char *argv[]) {
 
 	/* program-specific variables */
 	long linesread=0,dfa,dfb;
+	char *mline=NULL;
+	long ncols=0,nrows=0,*matcol=NULL;
+	double *matdata=NULL,*matres=NULL,*pres;
 	double xx,yy,b0,b1,SUMx,SUMy,SUMx2,SUMy2,SUMxy,MEANx,MEANy,SSx,SSy,SDx,SDy,SSreg,SSres,SPxy,SE,PIP,r,r2,r2adj,F,prob;
 
 
 	/* arguments */
 	char infile[256];
-	int setverb=0;
+	char *setcols=NULL;
+	int setverb=0,setmat=0;
 	long setcolx=1,setcoly=2;
 	double invalid=NAN,setxmin=NAN,setxmax=NAN;
 
@@ -73,12 +84,22 @@ int main(int argc, char *argv[]) {
 		fprintf(stderr,"	-xmax maximum value of independent value to include [%g]\n",setxmax);
 		fprintf(stderr,"	-invalid numerical data entries to omit [%g]\n",invalid);
 		fprintf(stderr,"	-verb sets verbosity (0=one-line, 1=headered, 2=full report[%d]\n",setverb);
+		fprintf(stderr,"	-mat correlate many columns with each other (matrix-mode) [%d]\n",setmat);
+		fprintf(stderr,"		0= no: correlate -cx and -cy only\n");
+		fprintf(stderr,"		1= yes: output a table of statistics for every pair of columns\n");
+		fprintf(stderr,"		2= yes: output a square matrix of r-values\n");
+		fprintf(stderr,"		NOTE: -xmin, -xmax and -verb do not apply\n");
+		fprintf(stderr,"	-cols (-mat 1-2) comma-separated columns to correlate [all]\n");
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s data.txt -cx 2 -cy 3 -invalid -1\n",thisprog);
 		fprintf(stderr,"	cut -f 2,3 temp.txt | %s stdin\n",thisprog);
+		fprintf(stderr,"	%s data.txt -mat 1 -cols 2,3,5,6\n",thisprog);
 		fprintf(stderr,"OUTPUT:\n");
 		fprintf(stderr,"	-verb 0-1: r,r2,dfa,dfb,F,prob,slope,intercept\n");
 		fprintf(stderr,"	-verb 2  : verbose summary\n");
+		fprintf(stderr,"	-mat 1   : col1,col2,n,r,r2,dfa,dfb,F,prob,slope,intercept\n");
+		fprintf(stderr,"		- col1 is x (independent) and col2 is y (dependent)\n");
+		fprintf(stderr,"	-mat 2   : matrix with a header-line and -column of column-numbers\n");
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"\n");
 		exit(0);
@@ -98,8 +119,12 @@ int main(int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-xmax")==0)     setxmax=atof(argv[++ii]);
 			else if(strcmp(argv[ii],"-invalid")==0) invalid=atof(argv[++ii]);
 			else if(strcmp(argv[ii],"-verb")==0)    setverb=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-mat")==0)     setmat=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-cols")==0)    setcols=argv[++ii];
 			else {fprintf(stderr,"\n*** %s [ERROR: invalid command line argument \"%s\"]\n\n",thisprog,argv[ii]); exit(1);}
 	}}
+	if(setmat<0||setmat>2) {fprintf(stderr,"\n*** %s [ERROR: invalid -mat (%d) - must be 0-2]\n\n",thisprog,setmat); exit(1);}
+	if(setmat>0) goto MATRIX;
 
 
 	/********************************************************************************/
@@ -245,8 +270,77 @@ int main(int argc, char *argv[]) {
 		printf("\n");
 	}
 
+	exit(0);
 
 
+	/********************************************************************************/
+	/* MATRIX-MODE: STORE THE SELECTED COLUMNS, THEN CORRELATE ALL PAIRS */
+	/********************************************************************************/
+MATRIX:
+	/* build the list of columns - if none were specified, the columns on the first line are used */
+	if(setcols!=NULL && strcmp(setcols,"all")!=0) {
+		pline=setcols;
+		for(col=1;(pcol=strtok(pline,","))!=NULL;col++) {
+			pline=NULL;
+			if(sscanf(pcol,"%ld",&kk)!=1 || kk<1) {fprintf(stderr,"\n*** %s [ERROR: invalid column \"%s\" in -cols]\n\n",thisprog,pcol); exit(1);}
+			if((matcol=realloc(matcol,(ncols+1)*sizeof(*matcol)))==NULL) {fprintf(stderr,"\n*** %s [ERROR: insufficient memory]\n\n",thisprog); exit(1);}
+			matcol[ncols++]= kk;
+	}}
+	if(strcmp(infile,"stdin")==0) fpin=stdin;
+	else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n*** %s [ERROR: file \"%s\" not found]\n\n",thisprog,infile); exit(1);}
+	while((mline=xf_lineread1(mline,&maxlinelen,fpin))!=NULL) {
+		if(maxlinelen==-1) {fprintf(stderr,"\n*** %s [ERROR: readline function encountered insufficient memory]\n\n",thisprog); exit(1);}
+		if(mline[0]=='#') continue;
+		/* count the columns on the first line */
+		if(ncols==0) {
+			for(pline=mline,nn=0;*pline!='\0';pline++) if(!strchr(" ,\t\n",*pline) && (pline==mline || strchr(" ,\t\n",*(pline-1)))) nn++;
+			if(nn<1) continue;
+			if((matcol=realloc(matcol,(nn+1)*sizeof(*matcol)))==NULL) {fprintf(stderr,"\n*** %s [ERROR: insufficient memory]\n\n",thisprog); exit(1);}
+			for(ncols=0;ncols<nn;ncols++) matcol[ncols]= ncols+1;
+		}
+		if((nrows%1024)==0) {
+			if((matdata=realloc(matdata,((nrows+1024)*ncols)*sizeof(*matdata)))==NULL) {fprintf(stderr,"\n*** %s [ERROR: insufficient memory]\n\n",thisprog); exit(1);}
+		}
+		/* missing or non-numeric values are stored as NAN */
+		for(jj=0;jj<ncols;jj++) matdata[nrows*ncols+jj]= NAN;
+		pline=mline;
+		for(col=1;(pcol=strtok(pline," ,\t\n"))!=NULL;col++) {
+			pline=NULL;
+			for(jj=0;jj<ncols;jj++) if(matcol[jj]==col && sscanf(pcol,"%lf",&aa)==1) matdata[nrows*ncols+jj]= aa;
+		}
+		nrows++;
+	}
+	if(strcmp(infile,"stdin")!=0) fclose(fpin);
+	if(ncols<2) {fprintf(stderr,"\n*** %s [ERROR: matrix-mode requires at least 2 columns]\n\n",thisprog); exit(1);}
+
+	if((matres=malloc((6*ncols*ncols+1)*sizeof(*matres)))==NULL) {fprintf(stderr,"\n*** %s [ERROR: insufficient memory]\n\n",thisprog); exit(1);}
+	if(xf_correlatematrix1_d(matdata,nrows,ncols,invalid,matres,message)<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+
+	mm= ncols*ncols;
+	if(setmat==1) {
+		printf("col1	col2	n	r	r2	dfa	dfb	F	prob	slope	inter\n");
+		for(ii=0;ii<ncols;ii++) for(jj=ii+1;jj<ncols;jj++) {
+			pres= matres+ii*ncols+jj;
+			nn= (long)pres[0];
+			if(nn<4) { printf("%ld	%ld	%ld	-	-	-	-	-	-	-	-\n",matcol[ii],matcol[jj],nn); continue; }
+			r= pres[1*mm];
+			printf("%ld	%ld	%ld	%.4f	%.4f	%d	%ld	%.4f	%.4f	%g	%g\n",matcol[ii],matcol[jj],nn,r,(r*r),1,(nn-2),pres[2*mm],pres[3*mm],pres[4*mm],pres[5*mm]);
+		}
+	}
+	else {
+		printf("col");
+		for(jj=0;jj<ncols;jj++) printf("\t%ld",matcol[jj]);
+		printf("\n");
+		for(ii=0;ii<ncols;ii++) {
+			printf("%ld",matcol[ii]);
+			for(jj=0;jj<ncols;jj++) printf("\t%.4f",matres[1*mm+ii*ncols+jj]);
+			printf("\n");
+		}
+	}
+	free(mline);
+	free(matcol);
+	free(matdata);
+	free(matres);
 	exit(0);
 
 }
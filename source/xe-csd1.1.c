@@ -15,6 +15,7 @@
 
 /* external functions start */
 double *xf_matrixread1_d(long *nmatrices, long *ncols, long *nrows, char *message, FILE *fpin);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -3,9 +3,13 @@
 #include <string.h>
 #include <math.h>
 #include <float.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #define thisprog "xe-densitymatrix1"
-#define TITLE_STRING thisprog" v 10: 23.October.2018 [JRH]"
+#define TITLE_STRING thisprog" v 11: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
+#define CHUNKLINES 4096
 
 /*
 <TAGS>signal_processing</TAGS>
@@ -15,6 +19,19 @@ TEST DATA GENERATION:
 	for i in $(seq 0 9) ; do { for j in $(seq 0 .5 2) ; do { x=$(echo $i $j | awk '{print $1+$2}') ; echo $i $j $x ; } done  ; } done > jj1
 	cat jj1 jj1 > jj2
 
+v 11: 18.October.2026 [JRH]
+	- new option -stream 1: bin points as they are read (xf_densitymatrix3_d), without storing them
+		- memory depends on the matrix size, not the number of input lines
+		- the matrix spans -xmin to -xmax and -ymin to -ymax (not the range of the data within those limits)
+			- NOTE: so if limits are set, the output differs from -stream 0, which spans the data within the limits
+		- unset limits are estimated from the first -sample points, and later points beyond them are ignored
+		- with OpenMP, chunks of lines are parsed in parallel and binned into per-thread matrices which are summed
+	- stored input (-stream 0) is allocated in blocks rather than per line
+	- bugfix: stored input - points at the maximum no longer fall outside the matrix through rounding
+
+v 10: 18.October.2026 [JRH]
+	- auto-scaling sorts the <x> and <y> lists with xf_qsortindex1_d (radix sort) instead of qsort
+
 v 10: 23.October.2018 [JRH]
 	- corrected uninitialized variables
 
@@ -53,23 +70,122 @@ v 1.5: 25.March.2012 [JRH]
 /* external functions start */
 void xf_norm1_d(double *data,long N,int normtype);
 int xf_smoothgauss2_d(double *data,int xbintot,int ybintot,int xsmooth,int ysmooth);
-int xf_compare1_d(const void *a, const void *b);
+void xf_qsortindex1_d(double *data, long *index,long nn);
+long xf_densitymatrix3_d(double *xdata, double *ydata, double *zdata, long nn, double *range, long xbintot, long ybintot, double *matrix, long *matrixcount);
 /* external functions end */
 
+/* streaming: read chunks of lines, parse them in parallel, and bin each thread's share into its own partial matrix
+- range holds xmin,xmax,ymin,ymax - limits not set (setrange[]=0) are estimated from the first setsample valid points
+- returns the number of points binned, or -1 on memory error - nvalid receives the number of valid points within the user limits */
+static long xe_densitymatrix1_stream(FILE *fpin, int setformat, double *range, int *setrange, long setsample, long xbintot, long ybintot, double *matrix, long *matrixcount, long *nvalid) {
+
+	char *lines=NULL;
+	int sampling,done=0,nthreads=1;
+	long ii,jj,nlines,nstored=0,nadded=0,bufsize,matrixsize=xbintot*ybintot;
+	long *partialcount=NULL;
+	double *xdata=NULL,*ydata=NULL,*zdata=NULL,*partial=NULL,limit[4];
+
+	for(ii=0;ii<4;ii++) limit[ii]= range[ii];
+	sampling= !(setrange[0] && setrange[1] && setrange[2] && setrange[3]);
+	bufsize= sampling ? (setsample+CHUNKLINES) : CHUNKLINES;
+	#ifdef _OPENMP
+	nthreads= omp_get_max_threads();
+	#endif
+	lines= malloc(CHUNKLINES*MAXLINELEN*sizeof(*lines));
+	xdata= malloc(bufsize*sizeof(*xdata));
+	ydata= malloc(bufsize*sizeof(*ydata));
+	if(setformat>1) zdata= malloc(bufsize*sizeof(*zdata));
+	partial= calloc(nthreads*matrixsize,sizeof(*partial));
+	partialcount= calloc(nthreads*matrixsize,sizeof(*partialcount));
+	if(lines==NULL||xdata==NULL||ydata==NULL||(setformat>1&&zdata==NULL)||partial==NULL||partialcount==NULL) return(-1);
+	*nvalid= 0;
+
+	while(!done) {
+		/* READ A CHUNK OF LINES */
+		for(nlines=0;nlines<CHUNKLINES;nlines++) if(fgets((lines+nlines*MAXLINELEN),MAXLINELEN,fpin)==NULL) { done=1; break; }
+
+		/* PARSE IN PARALLEL - UNUSABLE LINES OR POINTS OUTSIDE THE USER LIMITS ARE SET TO NAN */
+		#pragma omp parallel for schedule(static)
+		for(ii=0;ii<nlines;ii++) {
+			int ok;
+			double aa,bb,cc=1.0;
+			if(setformat==1) ok= (sscanf((lines+ii*MAXLINELEN),"%lf %lf",&aa,&bb)==2);
+			else ok= (sscanf((lines+ii*MAXLINELEN),"%lf %lf %lf",&aa,&bb,&cc)==3);
+			if(!ok || !isfinite(aa) || !isfinite(bb) || !isfinite(cc)) aa= NAN;
+			else if(aa<limit[0] || aa>limit[1] || bb<limit[2] || bb>limit[3]) aa= NAN;
+			xdata[nstored+ii]= aa;
+			ydata[nstored+ii]= bb;
+			if(zdata!=NULL) zdata[nstored+ii]= cc;
+		}
+		/* keep the valid points */
+		for(ii=jj=nstored;ii<(nstored+nlines);ii++) {
+			if(isnan(xdata[ii])) continue;
+			xdata[jj]= xdata[ii];
+			ydata[jj]= ydata[ii];
+			if(zdata!=NULL) zdata[jj]= zdata[ii];
+			jj++;
+		}
+		*nvalid+= (jj-nstored);
+		nstored= jj;
+
+		/* WHILE SAMPLING, STORE POINTS UNTIL THERE ARE ENOUGH TO ESTIMATE THE UNSET LIMITS */
+		if(sampling) {
+			if(nstored<setsample && !done) continue;
+			if(nstored<1) break;
+			if(!setrange[0]) { range[0]=xdata[0]; for(ii=0;ii<nstored;ii++) if(xdata[ii]<range[0]) range[0]=xdata[ii]; }
+			if(!setrange[1]) { range[1]=xdata[0]; for(ii=0;ii<nstored;ii++) if(xdata[ii]>range[1]) range[1]=xdata[ii]; }
+			if(!setrange[2]) { range[2]=ydata[0]; for(ii=0;ii<nstored;ii++) if(ydata[ii]<range[2]) range[2]=ydata[ii]; }
+			if(!setrange[3]) { range[3]=ydata[0]; for(ii=0;ii<nstored;ii++) if(ydata[ii]>range[3]) range[3]=ydata[ii]; }
+			sampling= 0;
+		}
+
+		/* BIN THE STORED POINTS - EACH THREAD TAKES A CONTIGUOUS SHARE AND ITS OWN PARTIAL MATRIX */
+		#pragma omp parallel reduction(+:nadded)
+		{
+			int tid=0,nth=1;
+			long start,stop;
+			#ifdef _OPENMP
+			tid= omp_get_thread_num();
+			nth= omp_get_num_threads();
+			#endif
+			start= nstored*tid/nth;
+			stop= nstored*(tid+1)/nth;
+			nadded+= xf_densitymatrix3_d((xdata+start),(ydata+start),(zdata==NULL?NULL:(zdata+start)),(stop-start),range,xbintot,ybintot,(partial+tid*matrixsize),(partialcount+tid*matrixsize));
+		}
+		nstored= 0;
+	}
+
+	/* SUM THE PARTIAL MATRICES */
+	for(jj=0;jj<nthreads;jj++) {
+		for(ii=0;ii<matrixsize;ii++) {
+			matrix[ii]+= partial[jj*matrixsize+ii];
+			matrixcount[ii]+= partialcount[jj*matrixsize+ii];
+	}}
+
+	free(lines);
+	if(xdata!=NULL) free(xdata);
+	if(ydata!=NULL) free(ydata);
+	if(zdata!=NULL) free(zdata);
+	free(partial);
+	free(partialcount);
+	return(nadded);
+}
+
 int main(int argc, char *argv[]) {
 
 	char infile[256],temp_str[MAXLINELEN],line[MAXLINELEN];
-	long i,j,k,n=0,*matrixcount=NULL;
+	long i,j,k,n=0,nvalid=0,*matrixcount=NULL;
 	int x,y,z,matrixsize,sizeofdouble=sizeof(double);
 	float a,b,c;
 	double aa,bb,cc,dd;
 	double *xdata=NULL,*ydata=NULL,*zdata=NULL,*matrix=NULL,*listx=NULL,*listy=NULL;
 	double xmin,xmin2,xmax,xmax2,xrange,ymin,ymin2,ymax,ymax2,yrange;
-	double xbinwidth,ybinwidth,xbinwidth_inv,ybinwidth_inv;
+	double xbinwidth,ybinwidth,xbinwidth_inv,ybinwidth_inv,range[4];
 	/* arguments */
 	int setnorm=-1,setyflip=0,setxsmooth=0,setysmooth=0;
 	int setxmin=0,setxmax=0,setymin=0,setymax=0,setformat=1;
-	long setxbintot=-1,setybintot=-1;
+	int setstream=0,setrange[4];
+	long setxbintot=-1,setybintot=-1,setsample=100000;
 	FILE *fpin;
 
 	xmin2= ymin2= -DBL_MAX;
@@ -103,6 +219,13 @@ int main(int argc, char *argv[]) {
 		fprintf(stderr,"	-xmax : force matrix to use this as the x-maximum [unset]\n");
 		fprintf(stderr,"	-ymax : force matrix to use this as the y-maximum [unset]\n");
 		fprintf(stderr,"	-yflip : flip matrix 0,0=top-left (0=NO, 1=YES) [%d]\n",setyflip);
+		fprintf(stderr,"	-stream : bin points as they are read, without storing them (0=NO, 1=YES) [%d]\n",setstream);
+		fprintf(stderr,"		- requires -x and -y to be >0\n");
+		fprintf(stderr,"		- the matrix spans -xmin to -xmax and -ymin to -ymax\n");
+		fprintf(stderr,"		  NOTE: -stream 0 spans only the data within these limits\n");
+		fprintf(stderr,"		- unset limits are estimated from the first -sample points,\n");
+		fprintf(stderr,"		  and later points beyond them are ignored (with a warning)\n");
+		fprintf(stderr,"	-sample : points used to estimate unset limits if -stream 1 [%ld]\n",setsample);
 		fprintf(stderr," - EXAMPLE: %s temp.txt -x 100 -y 25 -p 1 -s 0\n",thisprog);
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"\n");
@@ -125,6 +248,8 @@ int main(int argc, char *argv[]) {
 			else if(strcmp(argv[i],"-ymin")==0)  ymin2= atof(argv[++i]);
 			else if(strcmp(argv[i],"-ymax")==0)  ymax2= atof(argv[++i]);
 			else if(strcmp(argv[i],"-yflip")==0) setyflip= atoi(argv[++i]);
+			else if(strcmp(argv[i],"-stream")==0) setstream= atoi(argv[++i]);
+			else if(strcmp(argv[i],"-sample")==0) setsample= atol(argv[++i]);
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[i]); exit(1);}
 	}}
 
@@ -132,111 +257,139 @@ int main(int argc, char *argv[]) {
 	if(setformat<1||setformat>3) {fprintf(stderr,"\n--- Error[%s]: invalid -f (%d) - must be 1 2 or 3\n\n",thisprog,setformat);exit(1);}
 	if(xmin2>=xmax2) {fprintf(stderr,"\n--- Error[%s]: -xmin (%g) must be less than -xmax (%g)\n\n",thisprog,xmin2,xmax2);exit(1);}
 	if(ymin2>=ymax2) {fprintf(stderr,"\n--- Error[%s]: -ymin (%g) must be less than -ymax (%g)\n\n",thisprog,ymin2,ymax2);exit(1);}
-
-
-	/* STORE DATA */
-	if(strcmp(infile,"stdin")==0) fpin=stdin;
-	else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
-	if(setformat==1) {
-		while(fgets(line,MAXLINELEN,fpin)!=NULL) {
-			if(sscanf(line,"%lf %lf",&aa,&bb)!=2) continue;
-			if(isfinite(aa) && isfinite(bb)) {
-				if(aa<xmin2) continue;
-				if(aa>xmax2) continue;
-				if(bb<ymin2) continue;
-				if(bb>ymax2) continue;
-				xdata=(double *)realloc(xdata,(n+1)*sizeofdouble); if(xdata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-				ydata=(double *)realloc(ydata,(n+1)*sizeofdouble); if(ydata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-				xdata[n]=aa;
-				ydata[n]=bb;
-				n++;
-	}}}
-	if(setformat==2 || setformat==3) {
-		while(fgets(line,MAXLINELEN,fpin)!=NULL) {
-			if(sscanf(line,"%lf %lf %lf",&aa,&bb,&cc)!=3) continue;
-			if(isfinite(aa) && isfinite(bb) && isfinite(cc)) {
-				if(aa<xmin2) continue;
-				if(aa>xmax2) continue;
-				if(bb<ymin2) continue;
-				if(bb>ymax2) continue;
-				xdata=(double *)realloc(xdata,(n+1)*sizeofdouble); if(xdata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-				ydata=(double *)realloc(ydata,(n+1)*sizeofdouble); if(ydata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-				zdata=(double *)realloc(zdata,(n+1)*sizeofdouble); if(zdata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-				xdata[n]=aa;
-				ydata[n]=bb;
-				zdata[n]=cc;
-				n++;
-	}}}
-	if(strcmp(infile,"stdin")!=0) fclose(fpin);
-
-	if(n<1) {fprintf(stderr,"\n--- Error[%s]: input (%s) is empty, non-numeric, or fails to meet min/max criteria\n\n",thisprog,infile);exit(1);}
-
-	//for(i=0;i<n;i++) printf("%d	%g	%g\n",i,xdata[i],ydata[i]);
-	//for(i=0;i<n;i++) printf("%d	%g	%g	%g\n",i,xdata[i],ydata[i],zdata[i]);
-
-	/* AUTO-DETERMINE WIDTH AND HEIGHT OF MATRIX */
-	if(setxbintot<=0) {
-		if((listx=(double *)realloc(listx,n*sizeof(double)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
-		for(i=0;i<n;i++) listx[i]=xdata[i];
-		qsort(listx,n,sizeof(double),xf_compare1_d);
-		aa=listx[0]; for(i=j=1;i<n;i++) {if(listx[i]!=aa) listx[j++]=listx[i];aa=listx[i]; }
-		setxbintot=j;
-		xmin=listx[0];
-		xmax=listx[j-1];
-		free(listx);
-	}
-	else { xmin=xmax=xdata[0]; for(i=0;i<n;i++) {if(xdata[i]<xmin) xmin=xdata[i];if(xdata[i]>xmax) xmax=xdata[i];}}
-	if(setybintot<=0) {
-		if((listy=(double *)realloc(listy,n*sizeof(double)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
-		for(i=0;i<n;i++) listy[i]=ydata[i];
-		qsort(listy,n,sizeof(double),xf_compare1_d);
-		aa=listy[0]; for(i=j=1;i<n;i++) {if(listy[i]!=aa) listy[j++]=listy[i];aa=listy[i]; }
-		setybintot=j;
-		ymin=listy[0];
-		ymax=listy[j-1];
-		free(listy);
+	if(setstream!=0&&setstream!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -stream (%d) - must be 0 or 1\n\n",thisprog,setstream);exit(1);}
+	if(setstream==1 && (setxbintot<=0 || setybintot<=0)) {fprintf(stderr,"\n--- Error[%s]: -stream 1 requires -x and -y to be >0\n\n",thisprog);exit(1);}
+	if(setsample<1) {fprintf(stderr,"\n--- Error[%s]: invalid -sample (%ld) - must be >0\n\n",thisprog,setsample);exit(1);}
+
+
+	/* STREAM DATA: BIN POINTS AS THEY ARE READ */
+	if(setstream==1) {
+		range[0]=xmin2; range[1]=xmax2; range[2]=ymin2; range[3]=ymax2;
+		setrange[0]=(xmin2!=-DBL_MAX); setrange[1]=(xmax2!=DBL_MAX); setrange[2]=(ymin2!=-DBL_MAX); setrange[3]=(ymax2!=DBL_MAX);
+		matrixsize=setxbintot*setybintot;
+		matrix= calloc((matrixsize+1),sizeof(double)); if(matrix==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		matrixcount= calloc((matrixsize+1),sizeof(long)); if(matrixcount==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		if(strcmp(infile,"stdin")==0) fpin=stdin;
+		else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
+		n= xe_densitymatrix1_stream(fpin,setformat,range,setrange,setsample,setxbintot,setybintot,matrix,matrixcount,&nvalid);
+		if(strcmp(infile,"stdin")!=0) fclose(fpin);
+		if(n<0) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		if(n<1) {fprintf(stderr,"\n--- Error[%s]: input (%s) is empty, non-numeric, or fails to meet min/max criteria\n\n",thisprog,infile);exit(1);}
+		if(nvalid>n) fprintf(stderr,"--- Warning[%s]: %ld points fell outside the range estimated from the first %ld, and were ignored\n",thisprog,(nvalid-n),setsample);
+		/* for means-output, divide the sums by the bin-counts */
+		if(setformat==3) for(i=0;i<matrixsize;i++) { if(matrixcount[i]>0) matrix[i]/=matrixcount[i]; else matrix[i]=NAN; }
 	}
-	else { ymin=ymax=ydata[0]; for(i=0;i<n;i++) {if(ydata[i]<ymin) ymin=ydata[i];if(ydata[i]>ymax) ymax=ydata[i];}}
-
-	/* DETERMINE RANGE & BIN WIDTHS */
-	xrange=xmax-xmin;
-	yrange=ymax-ymin;
-	xbinwidth = xrange/(double)setxbintot;
-	ybinwidth = yrange/(double)setybintot;
-	xbinwidth_inv = 1.0/nextafter(xbinwidth,DBL_MAX);
-	ybinwidth_inv = 1.0/nextafter(ybinwidth,DBL_MAX);
-
-	/* INITIALISE MATRIX */
-	matrixsize=setxbintot*setybintot;
-	matrix = (double *) realloc(matrix,(matrixsize+1)*sizeof(double)); if(matrix==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-	matrixcount = (long *) realloc(matrixcount,(matrixsize+1)*sizeof(long)); if(matrixcount==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-	for(j=0;j<matrixsize;j++) { matrix[j]=0.0; matrixcount[j]=0; }
-
-	/* BUILD THE MATRIX */
-	if(setformat==1) {
-		for(i=0;i<n;i++) {
-			x=(int)((xdata[i]-xmin)*xbinwidth_inv);
-			y=(int)((ydata[i]-ymin)*ybinwidth_inv);
-			j=y*setxbintot+x;
-			matrix[j]++;
-	}}
-	if(setformat==2||setformat==3) {
-		for(i=0;i<n;i++) {
-			x=(int)((xdata[i]-xmin)*xbinwidth_inv);
-			y=(int)((ydata[i]-ymin)*ybinwidth_inv);
-			j=y*setxbintot+x;
-			matrixcount[j]++;
-			matrix[j]+=zdata[i];
-
-			/* printf("%d		%g	%d			%g	%g	%g\n",j,matrix[j],matrixcount[j],xdata[i],ydata[i],zdata[i]);  */
-	}}
-
-	/* FOR MEANS-OUTPUT, CORRECT MATRIC BY BIN-COUNT */
-	if(setformat==3) {
-		k=setybintot*setxbintot;
-		for(i=0;i<k;i++) {
-			if(matrixcount[i]>0) matrix[i]/=matrixcount[i];
-			else matrix[i]=NAN;
+	else {
+
+
+		/* STORE DATA */
+		if(strcmp(infile,"stdin")==0) fpin=stdin;
+		else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
+		if(setformat==1) {
+			while(fgets(line,MAXLINELEN,fpin)!=NULL) {
+				if(sscanf(line,"%lf %lf",&aa,&bb)!=2) continue;
+				if(isfinite(aa) && isfinite(bb)) {
+					if(aa<xmin2) continue;
+					if(aa>xmax2) continue;
+					if(bb<ymin2) continue;
+					if(bb>ymax2) continue;
+					if((n%CHUNKLINES)==0) {
+						xdata=(double *)realloc(xdata,(n+CHUNKLINES)*sizeofdouble); if(xdata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+						ydata=(double *)realloc(ydata,(n+CHUNKLINES)*sizeofdouble); if(ydata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+					}
+					xdata[n]=aa;
+					ydata[n]=bb;
+					n++;
+		}}}
+		if(setformat==2 || setformat==3) {
+			while(fgets(line,MAXLINELEN,fpin)!=NULL) {
+				if(sscanf(line,"%lf %lf %lf",&aa,&bb,&cc)!=3) continue;
+				if(isfinite(aa) && isfinite(bb) && isfinite(cc)) {
+					if(aa<xmin2) continue;
+					if(aa>xmax2) continue;
+					if(bb<ymin2) continue;
+					if(bb>ymax2) continue;
+					if((n%CHUNKLINES)==0) {
+						xdata=(double *)realloc(xdata,(n+CHUNKLINES)*sizeofdouble); if(xdata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+						ydata=(double *)realloc(ydata,(n+CHUNKLINES)*sizeofdouble); if(ydata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+						zdata=(double *)realloc(zdata,(n+CHUNKLINES)*sizeofdouble); if(zdata==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+					}
+					xdata[n]=aa;
+					ydata[n]=bb;
+					zdata[n]=cc;
+					n++;
+		}}}
+		if(strcmp(infile,"stdin")!=0) fclose(fpin);
+
+		if(n<1) {fprintf(stderr,"\n--- Error[%s]: input (%s) is empty, non-numeric, or fails to meet min/max criteria\n\n",thisprog,infile);exit(1);}
+
+		//for(i=0;i<n;i++) printf("%d	%g	%g\n",i,xdata[i],ydata[i]);
+		//for(i=0;i<n;i++) printf("%d	%g	%g	%g\n",i,xdata[i],ydata[i],zdata[i]);
+
+		/* AUTO-DETERMINE WIDTH AND HEIGHT OF MATRIX */
+		if(setxbintot<=0) {
+			if((listx=(double *)realloc(listx,n*sizeof(double)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			for(i=0;i<n;i++) listx[i]=xdata[i];
+			xf_qsortindex1_d(listx,NULL,n);
+			aa=listx[0]; for(i=j=1;i<n;i++) {if(listx[i]!=aa) listx[j++]=listx[i];aa=listx[i]; }
+			setxbintot=j;
+			xmin=listx[0];
+			xmax=listx[j-1];
+			free(listx);
+		}
+		else { xmin=xmax=xdata[0]; for(i=0;i<n;i++) {if(xdata[i]<xmin) xmin=xdata[i];if(xdata[i]>xmax) xmax=xdata[i];}}
+		if(setybintot<=0) {
+			if((listy=(double *)realloc(listy,n*sizeof(double)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			for(i=0;i<n;i++) listy[i]=ydata[i];
+			xf_qsortindex1_d(listy,NULL,n);
+			aa=listy[0]; for(i=j=1;i<n;i++) {if(listy[i]!=aa) listy[j++]=listy[i];aa=listy[i]; }
+			setybintot=j;
+			ymin=listy[0];
+			ymax=listy[j-1];
+			free(listy);
+		}
+		else { ymin=ymax=ydata[0]; for(i=0;i<n;i++) {if(ydata[i]<ymin) ymin=ydata[i];if(ydata[i]>ymax) ymax=ydata[i];}}
+
+		/* DETERMINE RANGE & BIN WIDTHS */
+		xrange=xmax-xmin;
+		yrange=ymax-ymin;
+		xbinwidth = xrange/(double)setxbintot;
+		ybinwidth = yrange/(double)setybintot;
+		xbinwidth_inv = 1.0/nextafter(xbinwidth,DBL_MAX);
+		ybinwidth_inv = 1.0/nextafter(ybinwidth,DBL_MAX);
+
+		/* INITIALISE MATRIX */
+		matrixsize=setxbintot*setybintot;
+		matrix = (double *) realloc(matrix,(matrixsize+1)*sizeof(double)); if(matrix==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		matrixcount = (long *) realloc(matrixcount,(matrixsize+1)*sizeof(long)); if(matrixcount==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		for(j=0;j<matrixsize;j++) { matrix[j]=0.0; matrixcount[j]=0; }
+
+		/* BUILD THE MATRIX */
+		if(setformat==1) {
+			for(i=0;i<n;i++) {
+				x=(int)((xdata[i]-xmin)*xbinwidth_inv); if(x>=setxbintot) x=setxbintot-1;
+				y=(int)((ydata[i]-ymin)*ybinwidth_inv); if(y>=setybintot) y=setybintot-1;
+				j=y*setxbintot+x;
+				matrix[j]++;
+		}}
+		if(setformat==2||setformat==3) {
+			for(i=0;i<n;i++) {
+				x=(int)((xdata[i]-xmin)*xbinwidth_inv); if(x>=setxbintot) x=setxbintot-1;
+				y=(int)((ydata[i]-ymin)*ybinwidth_inv); if(y>=setybintot) y=setybintot-1;
+				j=y*setxbintot+x;
+				matrixcount[j]++;
+				matrix[j]+=zdata[i];
+
+				/* printf("%d		%g	%d			%g	%g	%g\n",j,matrix[j],matrixcount[j],xdata[i],ydata[i],zdata[i]);  */
+		}}
+
+		/* FOR MEANS-OUTPUT, CORRECT MATRIC BY BIN-COUNT */
+		if(setformat==3) {
+			k=setybintot*setxbintot;
+			for(i=0;i<k;i++) {
+				if(matrixcount[i]>0) matrix[i]/=matrixcount[i];
+				else matrix[i]=NAN;
+			}
 		}
 	}
 
@@ -13,6 +13,7 @@
 
 /* external functions start */
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 /* external functions end */
 
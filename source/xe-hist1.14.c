@@ -1,10 +1,20 @@
 #define thisprog "xe-hist1"
-#define TITLE_STRING thisprog" v 14: 9.November.2018 [JRH]"
+#define TITLE_STRING thisprog" v 15: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
+#define FINEBINS 65536
+#define CHUNKSIZE 4096
 
 /*
 <TAGS>signal_processing stats</TAGS>
 
+v 15: 18.October.2026 [JRH]
+	- streaming histograms (xf_histinit1_d etc.): memory depends on the number of bins, not the number of values
+		- if -min and -max are both set, values are binned as they are read (results unchanged)
+		- new option -stream 1: if the range is not set, values are binned in 65536 fine bins which
+		  expand as required, rather than being stored (results are exact if there are <=65536 values)
+	- [input] can be a comma-separated list of files, read in parallel (with OpenMP) and merged
+	- bugfix: setting only -min or -max with no input data no longer crashes
+
 v 14: 9.November.2018 [JRH]
 	- update variable name conventions
 	- resolve some "uninitialized variable" warnings
@@ -55,12 +65,32 @@ v.1.5: bugfix: histograms now include values which match arguments "min" and "ma
 
 /* external functions start */
 long xf_hist1d(double *data, long n, double *histx, double *histy, int bintot, double min, double max, int format);
+double *xf_histinit1_d(double min, double max, long nbins, char *message);
+long xf_histadd1_d(double *hist, double *data, long nn);
+int xf_histmerge1_d(double *hist1, double *hist2, char *message);
+long xf_histresult1_d(double *hist, double *histx, double *histy, int bintot, double min, double max, int format);
 /* external functions end */
 
+/* calculate the total number of bins - a specific bin-width may adjust min and max */
+static int xe_hist1_bintot(double *min, double *max, int setbintot, double setbinwidth) {
+	int bintot=0;
+	double aa,bb,cc,range=*max-*min;
+	if(setbintot>0) bintot=setbintot;
+	else if(setbinwidth>0) { // if a specific binwidth is called for...
+		aa=range/setbinwidth; // calculate exact (possibly non-integer) number of bins
+		bb=aa-1.0*(int)(range/setbinwidth); // calculate remainder
+		bintot=(int)aa;	// first assume that aa was an integer (the modulus, bb, would be zero)
+		if(bb!=0) { // if not then get then add a bin and adjust the range accordingly
+			bintot++; cc=setbinwidth/2.0; *min-=cc; *max+=cc;
+		}
+	}
+	return(bintot);
+}
+
 int main (int argc, char *argv[]) {
 
 	/* general variables */
-	char *infile,line[MAXLINELEN];
+	char *infile,*pword,line[MAXLINELEN],message[MAXLINELEN];
 	int w,x,y,z;
 	long ii,jj,kk,nn;
 	int sizeofint=sizeof(int),sizeoffloat=sizeof(float),sizeofdouble=sizeof(double);
@@ -70,8 +100,11 @@ int main (int argc, char *argv[]) {
 	/* program-specific variables */
 	int *count,bin,bintot=0,setrange=0,outofrange=0;
 	double *raw=NULL,*histx=NULL,*histy=NULL,min=0.0,max=0.0,range,binwidth,plotedge,inv_binwidth;
+	char **filelist=NULL;
+	long nfiles=0;
+	double **hist=NULL,datamin=0.0,datamax=0.0,first=0.0;
 	/* arguments */
-	int settype=1,setbinlabel=2,setbintot=25;
+	int settype=1,setbinlabel=2,setbintot=25,setstream=0;
 	double setlow=0.0,sethigh=0.0,setbinwidth=0.0;
 
 	/* PRINT INSTRUCTIONS IF THERE IS NO FILENAME SPECIFIED */
@@ -84,7 +117,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"Input is a series of numbers - ideally one row or one column\n");
 		fprintf(stderr,"Non-numeric and non-normal values (Nan and Inf) will be ignored\n");
 		fprintf(stderr,"USAGE: %s [input] [options]\n",thisprog);
-		fprintf(stderr,"	[input]: file name or \"stdin\", reads all columns & rows\n");
+		fprintf(stderr,"	[input]: file name or \"stdin\", reads first number on each line\n");
+		fprintf(stderr,"		- or a comma-separated list of files, combined in one histogram\n");
 		fprintf(stderr,"VALID OPTIONS: defaults in []:\n");
 		fprintf(stderr,"	-t(ype): 1(counts) 2(range 0-1) or 3(probability) [%d]\n",settype);
 		fprintf(stderr,"	-b(ars) in histogram [%d]\n",setbintot);
@@ -92,6 +126,11 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	-min sets bottom end of histogram scale [unset]\n");
 		fprintf(stderr,"	-max sets upper end of histogram scale [unset]\n");
 		fprintf(stderr,"	-label: bin-labels identify start(1) middle(2) or end(3) [%d]\n",setbinlabel);
+		fprintf(stderr,"	-stream: if -min or -max are unset, bin values as they are read [%d]\n",setstream);
+		fprintf(stderr,"		0= no, store all values (exact)\n");
+		fprintf(stderr,"		1= yes, fixed memory (exact for up to 65536 values, otherwise\n");
+		fprintf(stderr,"		   bins are accurate to 1/32768 of the data range)\n");
+		fprintf(stderr,"		NOTE: if -min and -max are both set, values are always streamed\n");
 		fprintf(stderr,"NOTE:\n");
 		fprintf(stderr,"	- default outputs values for the middle of each bin\n");
 		fprintf(stderr,"	- for integers this may produce seemingly unusual results\n");
@@ -122,6 +161,7 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-t")==0)     settype= atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-b")==0)     setbintot= atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-label")==0) setbinlabel= atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-stream")==0) setstream= atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-w")==0)     setbinwidth= atof(argv[++ii]);
 			else if(strcmp(argv[ii],"-min")==0)   { setlow=1; min= atof(argv[++ii]); }
 			else if(strcmp(argv[ii],"-max")==0)   { sethigh=1; max= atof(argv[++ii]); }
@@ -130,65 +170,111 @@ int main (int argc, char *argv[]) {
 
 
 	if(settype<1||settype>3) {fprintf(stderr,"\a\n\t--- Error[%s]: invalid histogram type (-t %d) - must be 1,2 or 3\n\n",thisprog,settype);exit(1);}
-	if(setbintot<1) {fprintf(stderr,"\a\n\t--- Error[%s]: invalid bin-total (-b %ld) - must be >1\n\n",thisprog,setbintot);exit(1);}
+	if(setbintot<1) {fprintf(stderr,"\a\n\t--- Error[%s]: invalid bin-total (-b %d) - must be >1\n\n",thisprog,setbintot);exit(1);}
 	if(setlow!=0 && sethigh!=0 && min>=max) {fprintf(stderr,"\a\n\t--- Error[%s]: minimum (-min %g) is not less than maximum (-max %g)\n\n",thisprog,min,max);exit(1);}
 	if(setbinlabel<1||setbinlabel>3) {fprintf(stderr,"\a\n\t--- Error[%s]: -label (%d) invalid - must be 1,2 or 3\n\n",thisprog,setbinlabel);exit(1);}
+	if(setstream!=0&&setstream!=1) {fprintf(stderr,"\a\n\t--- Error[%s]: -stream (%d) invalid - must be 0 or 1\n\n",thisprog,setstream);exit(1);}
 	if(setbinwidth>0.0) setbintot=0;
 
-	/* STORE RAW DATA - FROM FILE OR STANDARD-INPUT IF FILENAME=STDIN */
-	if(strcmp(infile,"stdin")==0) fpin=stdin;
-	else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\a\n\t--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
-	nn=0;
-	while(fgets(line,MAXLINELEN,fpin)!=NULL) {
-		if(sscanf(line,"%lf",&aa)==1 && isfinite(aa)) {
-			raw= realloc(raw,(nn+1)*sizeofdouble);
-			if(raw==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
-			raw[nn++]= aa;
-	}}
-	if(strcmp(infile,"stdin")!=0) fclose(fpin);
+	/* BUILD THE LIST OF INPUT FILES */
+	for(pword=infile;(pword=strtok(pword,","))!=NULL;pword=NULL) {
+		if((filelist=realloc(filelist,(nfiles+1)*sizeof(*filelist)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		filelist[nfiles++]= pword;
+	}
+	if(nfiles<1) {fprintf(stderr,"\a\n\t--- Error[%s]: no input file specified\n\n",thisprog);exit(1);}
+	for(ii=0;ii<nfiles;ii++) if(strcmp(filelist[ii],"stdin")==0 && nfiles>1) {fprintf(stderr,"\a\n\t--- Error[%s]: \"stdin\" cannot be part of a list of files\n\n",thisprog);exit(1);}
+	/* streaming is required if the range is set */
+	if(setlow!=0 && sethigh!=0) setstream=2;
+
+	/* FIXED RANGE: THE BINS ARE KNOWN BEFORE THE DATA IS READ */
+	if(setstream==2) bintot= xe_hist1_bintot(&min,&max,setbintot,setbinwidth);
+
+	/* READ EACH FILE - STREAM THE VALUES INTO A PARTIAL HISTOGRAM, OR STORE THEM */
+	if(setstream>0) {
+		if((hist=calloc(nfiles,sizeof(*hist)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		for(ii=0;ii<nfiles;ii++) {
+			if(setstream==2) hist[ii]= xf_histinit1_d(min,max,bintot,message);
+			else hist[ii]= xf_histinit1_d(NAN,NAN,FINEBINS,message);
+			if(hist[ii]==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+		}
+		#pragma omp parallel for schedule(dynamic)
+		for(ii=0;ii<nfiles;ii++) {
+			char tline[MAXLINELEN];
+			long nchunk=0;
+			double chunk[CHUNKSIZE],tval;
+			FILE *tfpin;
+			if(strcmp(filelist[ii],"stdin")==0) tfpin=stdin;
+			else if((tfpin=fopen(filelist[ii],"r"))==0) {fprintf(stderr,"\a\n\t--- Error[%s]: file \"%s\" not found\n\n",thisprog,filelist[ii]);exit(1);}
+			while(fgets(tline,MAXLINELEN,tfpin)!=NULL) {
+				if(sscanf(tline,"%lf",&tval)==1 && isfinite(tval)) {
+					chunk[nchunk++]= tval;
+					if(nchunk==CHUNKSIZE) { xf_histadd1_d(hist[ii],chunk,nchunk); nchunk=0; }
+			}}
+			xf_histadd1_d(hist[ii],chunk,nchunk);
+			if(strcmp(filelist[ii],"stdin")!=0) fclose(tfpin);
+		}
+		/* merge the partial histograms */
+		for(ii=1;ii<nfiles;ii++) {
+			if(xf_histmerge1_d(hist[0],hist[ii],message)<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+			free(hist[ii]);
+		}
+		nn= (long)hist[0][4];
+	}
+	else {
+		nn=0;
+		for(jj=0;jj<nfiles;jj++) {
+			if(strcmp(filelist[jj],"stdin")==0) fpin=stdin;
+			else if((fpin=fopen(filelist[jj],"r"))==0) {fprintf(stderr,"\a\n\t--- Error[%s]: file \"%s\" not found\n\n",thisprog,filelist[jj]);exit(1);}
+			while(fgets(line,MAXLINELEN,fpin)!=NULL) {
+				if(sscanf(line,"%lf",&aa)==1 && isfinite(aa)) {
+					if((nn%CHUNKSIZE)==0) {
+						raw= realloc(raw,(nn+CHUNKSIZE)*sizeofdouble);
+						if(raw==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+					}
+					raw[nn++]= aa;
+			}}
+			if(strcmp(filelist[jj],"stdin")!=0) fclose(fpin);
+		}
+	}
 
 
 	/* DETERMINE MIN AND MAX VALUES IF SETLOW=0 or SETHIGH=0 - DEAL WITH DATA OUT OF RANGE ETC */
-	if(setlow==0 && sethigh==0) {
+	/* - datamin and datamax come from the stored values or the streaming histogram */
+	if(setstream!=2) {
 		if(nn<1) {fprintf(stderr,"\n--- Error[%s]: no input data - must manually set range if output is to be produced\n\n",thisprog);exit(1);};
-		min=max=raw[0]; for(ii=0;ii<nn;ii++) {if(raw[ii]<min) min=raw[ii]; if(raw[ii]>max) max=raw[ii];}
+		if(setstream==1) { datamin=hist[0][5]; datamax=hist[0][6]; }
+		else { datamin=datamax=raw[0]; for(ii=0;ii<nn;ii++) {if(raw[ii]<datamin) datamin=raw[ii]; if(raw[ii]>datamax) datamax=raw[ii];} }
+		first= (setstream==1) ? hist[0][8+FINEBINS] : raw[0];
+	}
+	if(setlow==0 && sethigh==0) {
+		min=datamin; max=datamax;
 		// deal with the possibility that all values are the same - create a fake range to fill
-		if(min==max) {aa=raw[0]; if(aa==0.0) {min=aa-1.0;max=aa+1.0;} else {min=0.5*aa;max=1.5*aa;}}
+		if(min==max) {aa=first; if(aa==0.0) {min=aa-1.0;max=aa+1.0;} else {min=0.5*aa;max=1.5*aa;}}
 	}
 	else if(setlow==0)  { // max is set - determine appropriate minimum
-		aa=raw[0];
-		min=aa; for(ii=0;ii<nn;ii++) {if(raw[ii]<min) min=raw[ii];}
+		aa=first;
+		min=datamin;
 		if(min==max) {if(aa==0.0) {min=aa-1.0;} else {min=0.5*aa;}}
 		if(min>max) {if(max==0.0) {min=max-1.0;} else {min=0.5*max;}}
 	}
 	else if(sethigh==0) { // min is set - determine approproate maximum
-		aa=raw[0];
-		max=aa; for(ii=0;ii<nn;ii++) {if(raw[ii]>max) max=raw[ii];}
+		aa=first;
+		max=datamax;
 		if(min==max) {if(aa==0.0) {max=aa+1.0;} else {max=1.5*aa;}}
 		if(min>max) {if(min==0.0) {max=min+1.0;} else {max=1.5*min;}}
 	}
 
-	// NOW SET RANGE - THIS COMES AFTER ALL DECISIONS ABOUT AUTO OR PRESET MIN AND MAX
+	/* CALCULATE TOTAL NUMBER OF BINS - THIS COMES AFTER ALL DECISIONS ABOUT AUTO OR PRESET MIN AND MAX */
+	if(setstream!=2) bintot= xe_hist1_bintot(&min,&max,setbintot,setbinwidth);
 	range=max-min;
 
-	/* CALCULATE TOTAL NUMBER OF BINS */
-	if(setbintot>0) bintot=setbintot;
-	else if(setbinwidth>0) { // if a specific binwidth is called for...
-		aa=range/setbinwidth; // calculate exact (possibly non-integer) number of bins
-		bb=aa-1.0*(int)(range/setbinwidth); // calculate remainder
-		bintot=(int)aa;	// first assume that aa was an integer (the modulus, bb, would be zero)
-		if(bb!=0) { // if not then get then add a bin and adjust the range accordingly
-			bintot++; cc=setbinwidth/2.0; min-=cc; max+=cc; range=max-min;
-		}
-	}
-
-
 	/* ASSIGN MEMORY FOR HISTOGRAM */
 	histx= calloc((bintot+1),sizeofdouble); if(histx==NULL) {fprintf(stderr,"\a\n\t--- Error[%s]: insufficient memory\n",thisprog);exit(1);}
 	histy= calloc((bintot+1),sizeofdouble); if(histy==NULL) {fprintf(stderr,"\a\n\t--- Error[%s]: insufficient memory\n",thisprog);exit(1);}
 
 	/* FILL THE HISTOGRAM */
-	kk = xf_hist1d(raw,nn,histx,histy,bintot,min,max,settype);
+	if(setstream>0) kk= xf_histresult1_d(hist[0],histx,histy,bintot,min,max,settype);
+	else kk= xf_hist1d(raw,nn,histx,histy,bintot,min,max,settype);
 
 	/* ALTER THE LABELS IF REQUIRED */
 	aa= range/(bintot*2); // determine the half-width of the bins
@@ -199,6 +285,8 @@ int main (int argc, char *argv[]) {
 	for(ii=0;ii<bintot;ii++) printf("%g	%g\n",histx[ii],histy[ii]);
 
 	if(raw!=NULL) free(raw);
+	if(hist!=NULL) { free(hist[0]); free(hist); }
+	if(filelist!=NULL) free(filelist);
 	if(histx!=NULL) free(histx);
 	if(histy!=NULL) free(histy);
 	exit(0);
@@ -83,6 +83,7 @@ v 1.2: JRH, 8.April.2011
 /* external functions start */
 char* xf_strsub1 (char *source, char *str1, char *str2);
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 /* external functions end */
 
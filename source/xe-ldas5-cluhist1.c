@@ -1,5 +1,5 @@
 #define thisprog "xe-ldas5-cluhist1"
-#define TITLE_STRING thisprog" v 1: 28.July.2017 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 
 #include <stdio.h>
@@ -10,6 +10,9 @@
 /*
 <TAGS>dt.spikes</TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- allow input from an indexed spike-store (.clux) - only clusters in -list are read
+
 v 1: 21.August.2018 [JRH]
 	- remove limit on maximum histogram size
 
@@ -50,6 +53,7 @@ v 1: 3.April.2010 [JRH] (based on xe-clustats1)
 /* external functions start */
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long xf_readclub1(char *infile1, char *infile2, long **clubt, short **club, char *message);
+long xf_readclux1(char *infile, char *list1, long tstart, long tstop, long **clubt, short **club, long *params, char *message);
 double *xf_wint1(double *time, int *group, long n, int g1, int g2, float winsize, long *result_l);
 long xf_hist1d(double *data,long n,double *x,double *y,int bintot,double min,double max,int format);
 long *xf_wint1_ls(long *time, short *group, long nn, short g1, short g2, long winsize, long *nintervals);
@@ -102,6 +106,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	%s [infile1] [infile2] [options]\n",thisprog);
 		fprintf(stderr,"	[infile1]: .clubt timestamp file\n");
 		fprintf(stderr,"	[infile2]: .club cluster-id file\n");
+		fprintf(stderr,"	NOTE: [infile1] can also be an indexed spike-store (.clux)\n");
+		fprintf(stderr,"		- [infile2] is then ignored, and only clusters in -list are read\n");
 		fprintf(stderr,"VALID OPTIONS (defaults in []:\n");
 		fprintf(stderr,"	-list: CSV list of clusters to analyze [all]\n");
 		fprintf(stderr,"	-cor: auto-(1) or cross-(2) corellogram? [%d]\n",setcor);
@@ -186,7 +192,11 @@ int main (int argc, char *argv[]) {
 	/************************************************************
 	READ THE CLUSTER TIMESTAMPS AND IDs
 	***********************************************************/
- 	spiketot= xf_readclub1(infile1,infile2,&clubt,&club,message);
+ 	if(strstr(infile1,".clux")!=NULL) {
+		if(setlist==NULL || strcmp(setlist,"all")==0) spiketot= xf_readclux1(infile1,NULL,0,0,&clubt,&club,NULL,message);
+		else spiketot= xf_readclux1(infile1,setlist,0,0,&clubt,&club,NULL,message);
+	}
+ 	else spiketot= xf_readclub1(infile1,infile2,&clubt,&club,message);
  	if(spiketot<0) {fprintf(stderr,"\n*** %s/%s\n\n",thisprog,message); exit(1);}
 	/* find highest cluster id */
 	clumax=-1; for(ii=0;ii<spiketot;ii++) if(club[ii]>clumax) clumax=club[ii]; clumax++;
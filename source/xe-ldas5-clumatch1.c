@@ -1,5 +1,5 @@
 #define thisprog "xe-ldas5-clumatch1"
-#define TITLE_STRING thisprog" v 1: 2.June.2017 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 #include <stdlib.h>
 #include <stdio.h>
@@ -11,6 +11,15 @@
 /* <TAGS>LDAS dt.spikes</TAGS> */
 
 /************************************************************************
+v 2: 18.October.2026 [JRH]
+	- matching is now a single merge-style pass over both (time-sorted) spike lists
+		- each reference spike is matched to only its nearest comparison spike within -diff
+		- proportions [p] can therefore no longer exceed 1
+	- cluster-pair counts are kept as a sparse list instead of a clumax1 x clumax2 matrix
+		- the list is built with counting passes over the cluster numbers (linear time, no comparison sort)
+	- add -out 2: sparse confusion-matrix output
+	- add -seg: split reference spikes into time-segments which can be matched in parallel (OpenMP)
+
 v 1: 1.June.2017 [JRH]
 	- new prog: match clusters from different clustering runs based on timestamps
 *************************************************************************/
@@ -36,16 +45,13 @@ int main (int argc, char *argv[]) {
 
 	/* program-specific variables */
 	short *club1=NULL,*club2=NULL;
-	long *clubt1=NULL,*clubt2=NULL,*clucount2=NULL,*clucount1=NULL,*clumatch=NULL;
-	long *sort1=NULL,*sort2=NULL;
-	long clumax1,clumax2,diff,start2,stop2,tref,index1,mindiff,mindiffindex;
-	off_t nlist,nclu;
+	long *clubt1=NULL,*clubt2=NULL,*clucount1=NULL,*clukey=NULL;
+	long *pairref=NULL,*paircomp=NULL,*paircount=NULL,*sort1=NULL,*sort2=NULL,*binstart=NULL,*tempkey=NULL;
+	long clumax1,clumax2,npairs,nmatch,segsize;
 
 	/* arguments */
-	char *setscreenfile=NULL,*setscreenlist=NULL,*setclulist=NULL;
-	int setout=-1,setverb=0;
-	long setmaxdiff=0;
-	nlist=0;
+	int setout=1,setverb=0;
+	long setmaxdiff=0,setseg=1;
 
 	/************************************************************
 	PRINT INSTRUCTIONS IF THERE IS NO FILENAME SPECIFIED
@@ -57,6 +63,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"Match clusters from different clustering runs based on timestamps\n");
 		fprintf(stderr,"- how are reference cluster spikes found in comparison clusters?\n");
+		fprintf(stderr,"- each reference spike is matched to the nearest comparison spike\n");
+		fprintf(stderr,"- both inputs must be sorted by time\n");
 		fprintf(stderr,"USAGE:\n");
 		fprintf(stderr,"	%s [clubt1] [club1] [clubt2] [club2] [options]\n",thisprog);
 		fprintf(stderr,"	[clubt1]: reference .clubt file\n");
@@ -65,17 +73,22 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	[club2]:  comparison .club file\n");
 		fprintf(stderr,"VALID OPTIONS:\n");
 		fprintf(stderr,"	-diff: max offset (samples) between matched timestamps [%ld]\n",setmaxdiff);
+		fprintf(stderr,"	-seg: number of time-segments to match in parallel [%ld]\n",setseg);
+		fprintf(stderr,"		NOTE: parallel only if compiled with OpenMP (-fopenmp)\n");
+		fprintf(stderr,"		NOTE: results are identical for any number of segments\n");
+		fprintf(stderr,"	-out: output format (see below) [%d]\n",setout);
 		fprintf(stderr,"	-verb: set verbocity of output (0=low, 1=high) [%d]\n",setverb);
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s A.clubt A.club B.clubt B.club -diff 5\n",thisprog);
-		fprintf(stderr,"OUTPUT:\n");
+		fprintf(stderr,"OUTPUT (-out 1): \n");
 		fprintf(stderr,"	[c0] [n] [p] [x1:m1] [x2:m2] [x3:m3] ... etc\n");
 		fprintf(stderr,"		[c0]: reference cluster ID\n");
 		fprintf(stderr,"		[n]: spike count for reference cluster\n");
 		fprintf(stderr,"		[p]: proportion of [n] found in comparison cluster\n");
-		fprintf(stderr,"			- NOTE: typically 0-1, but may be >1\n");
 		fprintf(stderr,"		x+: comparison cluster ID\n");
 		fprintf(stderr,"		m+: comparison cluster timestamps matching [c0]\n");
+		fprintf(stderr,"OUTPUT (-out 2): sparse confusion-matrix, non-zero pairs only\n");
+		fprintf(stderr,"	clu1	clu2	count\n");
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"\n");
 		exit(0);
@@ -93,9 +106,14 @@ int main (int argc, char *argv[]) {
 		if( *(argv[ii]+0) == '-') {
 			if((ii+1)>=argc) {fprintf(stderr,"\n--- Error[%s]: missing value for argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
 			else if(strcmp(argv[ii],"-diff")==0) setmaxdiff=atol(argv[++ii]);
+			else if(strcmp(argv[ii],"-seg")==0) setseg=atol(argv[++ii]);
+			else if(strcmp(argv[ii],"-out")==0) setout=atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-verb")==0) setverb=atoi(argv[++ii]);
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
 	}}
+	if(setmaxdiff<0) {fprintf(stderr,"\n--- Error[%s]: invalid -diff (%ld) : must be >=0\n\n",thisprog,setmaxdiff);exit(1);}
+	if(setseg<1) {fprintf(stderr,"\n--- Error[%s]: invalid -seg (%ld) : must be >0\n\n",thisprog,setseg);exit(1);}
+	if(setout<1 || setout>2) {fprintf(stderr,"\n--- Error[%s]: invalid -out (%d) : must be 1-2\n\n",thisprog,setout);exit(1);}
 	if(setverb<0 || setverb>1) {fprintf(stderr,"\n--- Error[%s]: invalid -verb (%d) : must be 0-1\n\n",thisprog,setverb);exit(1);}
 
 
@@ -104,9 +122,9 @@ int main (int argc, char *argv[]) {
 	if(setverb==1) {
 		fprintf(stderr,"reading input files...\n");
 		fprintf(stderr,"	reference clubt file: %s\n",infile1);
-		fprintf(stderr,"	reference lub  file: %s\n",infile2);
+		fprintf(stderr,"	reference club  file: %s\n",infile2);
 		fprintf(stderr,"	comparison clubt file: %s\n",infile3);
-		fprintf(stderr,"	ccomparison lub  file: %s\n",infile4);
+		fprintf(stderr,"	comparison club  file: %s\n",infile4);
 	}
 
 	/************************************************************
@@ -116,10 +134,16 @@ int main (int argc, char *argv[]) {
  	if(nn<0) {fprintf(stderr,"\n*** %s/%s\n\n",thisprog,message); exit(1);}
 
 	mm= xf_readclub1(infile3,infile4,&clubt2,&club2,message);
- 	if(nn<0) {fprintf(stderr,"\n*** %s/%s\n\n",thisprog,message); exit(1);}
+ 	if(mm<0) {fprintf(stderr,"\n*** %s/%s\n\n",thisprog,message); exit(1);}
 
 	/************************************************************
-	CALCULATE THE MAXIMUM CLUSTRE-ID IN THER REFERENCE AND COMPARISON DATA
+	MAKE SURE TIMESTAMPS ARE SORTED - REQUIRED FOR THE MERGE BELOW
+	***********************************************************/
+	for(ii=1;ii<nn;ii++) if(clubt1[ii]<clubt1[ii-1]) {fprintf(stderr,"\n--- Error[%s]: timestamps in %s are not sorted\n\n",thisprog,infile1);exit(1);}
+	for(ii=1;ii<mm;ii++) if(clubt2[ii]<clubt2[ii-1]) {fprintf(stderr,"\n--- Error[%s]: timestamps in %s are not sorted\n\n",thisprog,infile3);exit(1);}
+
+	/************************************************************
+	CALCULATE THE MAXIMUM CLUSTER-ID IN THE REFERENCE AND COMPARISON DATA
 	***********************************************************/
 	clumax1=-1; for(ii=0;ii<nn;ii++) if(club1[ii]>clumax1) clumax1=club1[ii];
 	clumax2=-1; for(ii=0;ii<mm;ii++) if(club2[ii]>clumax2) clumax2=club2[ii];
@@ -128,105 +152,142 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	clumax2= %ld\n",clumax2);
 	}
 
-	/************************************************************
-	ALLCOATE MEMORY FOR THE CLUMATCH RECORDS
-	- this is a matrix of size clumax1*clumax2
-	***********************************************************/
-	kk= (clumax1+1)*(clumax2+1);
-	if((clumatch=calloc(kk,sizeof *clumatch))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
-	if((sort1=calloc(clumax2+1,sizeof *sort1))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
-	if((sort2=calloc(clumax2+1,sizeof *sort2))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
-
 	/************************************************************
 	CLU-COUNTS FOR REFERENCE CLUSTERS
 	- allows empty clusters to be skipped
 	***********************************************************/
 	if(setverb==1) fprintf(stderr,"	allocating memory...\n");
 	if((clucount1=calloc(clumax1+1,sizeof *clucount1))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
-	if((clucount2=calloc(clumax2+1,sizeof *clucount2))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
+	if((clukey=calloc(nn+1,sizeof *clukey))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
 	for(ii=0;ii<nn;ii++) clucount1[club1[ii]]++;
-	for(ii=0;ii<mm;ii++) clucount2[club2[ii]]++;
 
 	/************************************************************
 	MATCH THE CLUSTERS
+	- for each reference spike, find the nearest comparison spike
+	- jj tracks the first comparison timestamp >= the reference timestamp
+		- this only ever moves forward, so the search is O(nn+mm)
+		- the nearest spike is therefore either jj or jj-1
+	- the reference spikes are split into setseg segments
+		- each segment finds its own starting jj by binary search
+		- every spike is matched independently, so results do not depend on setseg
+	- clukey stores the cluster-pair for each reference spike, or -1 if unmatched
 	***********************************************************/
 	if(setverb==1) fprintf(stderr,"	matching clusters...\n");
-	/* for every reference timestamp... */
-	start2=0;
-	for(ii=0;ii<nn;ii++) {
-		/* ...find matching comparison timestamps */
-		for(jj=start2;jj<mm;jj++) {
-			/* test timestamp difference - break if too far, reset start and continue if not far enough */
-			diff= clubt2[jj]-clubt1[ii];
-			if(diff>setmaxdiff) break;
-			if(diff<-setmaxdiff) { start2= jj+1; continue; } // current sample cannot be useful for any other reference events
-
-			/* otherwise, calculate the current time-difference */
-			mindiff= diff;
-			mindiffindex= jj;
-			/* scan forward to see if there are any closer timestamps */
+	if(setseg>nn) setseg= nn;
+	segsize= 1; if(setseg>0) segsize= (nn+setseg-1)/setseg;
+
+	#pragma omp parallel for schedule(static)
+	for(kk=0;kk<setseg;kk++) {
+		long i1,i2,j1,j2,ii,jj,tref,diff1,diff2,best;
+		/* define the range of reference spikes for this segment */
+		i1= kk*segsize;
+		i2= i1+segsize; if(i2>nn) i2= nn;
+		/* binary search: find the first comparison timestamp >= the first reference timestamp */
+		j1=0; j2=mm;
+		if(i1<i2) while(j1<j2) { jj= (j1+j2)/2; if(clubt2[jj]<clubt1[i1]) j1= jj+1; else j2= jj; }
+		jj= j1;
+		/* merge */
+		for(ii=i1;ii<i2;ii++) {
 			tref= clubt1[ii];
-			//start2= jj; // current sample MIGHT be useful for other referecnce events - maintain start-point
-			stop2= jj+(2.0*setmaxdiff);
-			if(stop2>mm) stop2= mm;
-			for(kk=start2;kk<stop2;kk++) {
-				diff= clubt2[jj]-tref;
-				if(diff<0) diff= 0-diff;
-				if(diff<mindiff) { mindiff=diff; mindiffindex=kk; }
-			}
-			/* calculate the index to the cluster pair */
-			index1= club1[ii]*clumax2 + club2[mindiffindex];
-			/* increment the match-count */
-			clumatch[index1]++;
-		} // end of loop - comparison timestamps
-	} // end of loop: reference timestamps
-
+			while(jj<mm && clubt2[jj]<tref) jj++;
+			best= -1;
+			diff1= diff2= setmaxdiff+1;
+			if(jj>0) diff1= tref-clubt2[jj-1];
+			if(jj<mm) diff2= clubt2[jj]-tref;
+			if(diff1<=diff2 && diff1<=setmaxdiff) best= jj-1;
+			else if(diff2<diff1 && diff2<=setmaxdiff) best= jj;
+			/* store the cluster-pair as a single key: sorting by key sorts by reference then comparison cluster */
+			if(best>=0) clukey[ii]= (long)club1[ii]*(clumax2+1) + (long)club2[best];
+			else clukey[ii]= -1;
+		}
+	}
 
+	/************************************************************
+	BUILD THE SPARSE CONFUSION MATRIX
+	- remove unmatched spikes, sort the keys, and count runs of identical keys
+	- keys are sorted by two stable counting passes over the cluster bins, first by comparison
+	  cluster and then by reference cluster, so the time is O(nmatch+clumax1+clumax2)
+	***********************************************************/
+	if(setverb==1) fprintf(stderr,"	building sparse confusion matrix...\n");
+	for(ii=nmatch=0;ii<nn;ii++) if(clukey[ii]>=0) clukey[nmatch++]= clukey[ii];
+	kk= ((clumax1>clumax2) ? clumax1 : clumax2)+2;
+	if((binstart=calloc(kk,sizeof *binstart))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
+	if((tempkey=calloc(nmatch+1,sizeof *tempkey))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
+	/* pass 1: comparison cluster (clukey to tempkey) */
+	for(ii=0;ii<nmatch;ii++) binstart[clukey[ii]%(clumax2+1)+1]++;
+	for(ii=1;ii<=(clumax2+1);ii++) binstart[ii]+= binstart[ii-1];
+	for(ii=0;ii<nmatch;ii++) tempkey[binstart[clukey[ii]%(clumax2+1)]++]= clukey[ii];
+	/* pass 2: reference cluster (tempkey back to clukey) */
+	for(ii=0;ii<kk;ii++) binstart[ii]= 0;
+	for(ii=0;ii<nmatch;ii++) binstart[tempkey[ii]/(clumax2+1)+1]++;
+	for(ii=1;ii<=(clumax1+1);ii++) binstart[ii]+= binstart[ii-1];
+	for(ii=0;ii<nmatch;ii++) clukey[binstart[tempkey[ii]/(clumax2+1)]++]= tempkey[ii];
+	free(binstart); binstart=NULL;
+	free(tempkey); tempkey=NULL;
+	for(ii=npairs=0;ii<nmatch;ii++) if(ii==0 || clukey[ii]!=clukey[ii-1]) npairs++;
+	if((pairref=calloc(npairs+1,sizeof *pairref))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
+	if((paircomp=calloc(npairs+1,sizeof *paircomp))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
+	if((paircount=calloc(npairs+1,sizeof *paircount))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
+	for(ii=0,jj=-1;ii<nmatch;ii++) {
+		if(ii==0 || clukey[ii]!=clukey[ii-1]) {
+			jj++;
+			pairref[jj]= clukey[ii]/(clumax2+1);
+			paircomp[jj]= clukey[ii]%(clumax2+1);
+		}
+		paircount[jj]++;
+	}
+	if(setverb==1) fprintf(stderr,"	%ld of %ld reference spikes matched, %ld cluster-pairs\n",nmatch,nn,npairs);
 
 	/************************************************************
 	REPORT RESULTS
-	- format: [refcluster] [count] [c1:n1] [c2:n2] [c3:n3] ... etc
-		- [c?:n?]:
-		 	c?= reference cluster ID
-			n?= no. timestamps matching [refcluster]
 	***********************************************************/
 	if(setverb==1) fprintf(stderr,"	reporting...\n");
-	for(ii=0;ii<=clumax1;ii++) {
-		if(clucount1[ii]<1) continue;
-
-		printf("%ld\t%ld",ii,clucount1[ii]);
-		kk=0; // reset the counter for the number of good cluster-2 matches
-		mm=0; // re-use clu2 counter to store the total matches
-		for(jj=0;jj<clumax2;jj++) {
-			index1= ii*clumax2 + jj;
-			if(clumatch[index1]<1) continue;
-			sort1[kk]= jj; // temporary array holding current cluster-2
-			sort2[kk]= clumatch[index1]; // temporary array holding match-count
-			mm+= clumatch[index1]; // talley total spike-matches
-			kk++;  // increment counter for good cluster-2 matches
+	/* sparse confusion matrix */
+	if(setout==2) {
+		printf("clu1\tclu2\tcount\n");
+		for(jj=0;jj<npairs;jj++) printf("%ld\t%ld\t%ld\n",pairref[jj],paircomp[jj],paircount[jj]);
+	}
+	/* format: [refcluster] [count] [prop] [c1:n1] [c2:n2] [c3:n3] ... etc
+		- [c?:n?]:
+		 	c?= comparison cluster ID
+			n?= no. timestamps matching [refcluster]
+		- pairs for each reference cluster are contiguous in the sparse matrix */
+	if(setout==1) {
+		if((sort1=calloc(clumax2+2,sizeof *sort1))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
+		if((sort2=calloc(clumax2+2,sizeof *sort2))==NULL) {fprintf(stderr,"\n--- Error [%s]: insufficient memory\n\n",thisprog); exit(1);};
+		jj=0; // index to the sparse matrix
+		for(ii=0;ii<=clumax1;ii++) {
+			if(clucount1[ii]<1) continue;
+			printf("%ld\t%ld",ii,clucount1[ii]);
+			kk=0; // reset the counter for the number of good cluster-2 matches
+			mm=0; // re-use clu2 counter to store the total matches
+			while(jj<npairs && pairref[jj]<ii) jj++;
+			for(jj=jj;jj<npairs && pairref[jj]==ii;jj++) {
+				sort1[kk]= paircomp[jj]; // temporary array holding current cluster-2
+				sort2[kk]= paircount[jj]; // temporary array holding match-count
+				mm+= paircount[jj]; // tally total spike-matches
+				kk++;  // increment counter for good cluster-2 matches
+			}
+			/* print the percentage matched */
+			printf("\t%.3f",(double)mm/(double)clucount1[ii]);
+			/* sort cluster-2 based on number of matches */
+			xf_qsortindex1_l(sort2,sort1,kk);
+			/* print the sorted matches in reverse order */
+			for(kk=(kk-1);kk>=0;kk--) printf("\t%ld:%ld",sort1[kk],sort2[kk]);
+			printf("\n");
 		}
-
-		/* print the percentage matched */
-		printf("\t%.3f",(double)mm/(double)clucount1[ii]);
-
-		/* sort cluster-2 based on number of matches */
-		xf_qsortindex1_l(sort2,sort1,kk);
-
-		/* print the sorted matches in reverse order */
-		for(jj=(kk-1);jj>=0;jj--) printf("\t%ld:%ld",sort1[jj],sort2[jj]);
-		printf("\n");
 	}
 
 
-
-
 	if(club1!=NULL) free(club1);
 	if(club2!=NULL) free(club2);
 	if(clubt1!=NULL) free(clubt1);
 	if(clubt2!=NULL) free(clubt2);
 	if(clucount1!=NULL) free(clucount1);
-	if(clucount2!=NULL) free(clucount2);
-	if(clumatch!=NULL) free(clumatch);
+	if(clukey!=NULL) free(clukey);
+	if(pairref!=NULL) free(pairref);
+	if(paircomp!=NULL) free(paircomp);
+	if(paircount!=NULL) free(paircount);
 	if(sort1!=NULL) free(sort1);
 	if(sort2!=NULL) free(sort2);
 
@@ -1,5 +1,5 @@
 #define thisprog "xe-ldas5-clurate1"
-#define TITLE_STRING thisprog" v 1: 24.November.2017 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -10,6 +10,9 @@
 /************************************************************************
 <TAGS>dt.spikes</TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- allow input from an indexed spike-store (.clux) - only clusters in -clu are read
+
 v 1: 24.November.2017 [JRH]
 	- bugfix: duration is now defined properly
 	- realign function updated to also adjust cluster-id's
@@ -20,6 +23,7 @@ v 1: 13.November.2017 [JRH]
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long xf_readssp1(char *infile, long **start, long **stop, char *message);
 long xf_readclub1(char *infile1, char *infile2, long **clubt, short **club, char *message);
+long xf_readclux1(char *infile, char *list1, long tstart, long tstop, long **clubt, short **club, long *params, char *message);
 long xf_matchclub1_ls(char *list1, long *clubt, short *club, long nn, char *message);
 long xf_blockrealign1_ls(long *samplenum, short *class, long nn, long *bstart, long *bstop, long nblocks, char *message);
 long *xf_density1_l(long *etime,long nn,long min,long max,double winsize,long *nwin,char *message);
@@ -37,9 +41,9 @@ int main (int argc, char *argv[]) {
 
 	/* program-specific variables */
 	short *club=NULL,*clukeep;
-	int setscreen=0;
+	int setscreen=0,setclux=0;
 	long *clubt=NULL,*start1=NULL,*stop1=NULL,*index1=NULL,*clucount=NULL;
-	long *density1=NULL,clumaxp1=-1,tmin,tmax,duration1,nwin;
+	long *density1=NULL,clumaxp1=-1,tmin,tmax,duration1,nwin,cluxparams[4];
 	off_t nstart,nclulist;
 	double duration2;
 
@@ -64,6 +68,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	%s [clubt] [club] [options]\n",thisprog);
 		fprintf(stderr,"	[clubt]: binary file containing cluster-times (long int)\n");
 		fprintf(stderr,"	[club]: binary file containing cluster-IDs (short int)\n");
+		fprintf(stderr,"	NOTE: [clubt] can also be an indexed spike-store (.clux)\n");
+		fprintf(stderr,"		- [club] is then ignored, and only clusters in -clu are read\n");
 		fprintf(stderr,"VALID OPTIONS:\n");
 		fprintf(stderr,"	-clu: screen using CSV list of cluster IDs [unset]\n",setclulist);
 		fprintf(stderr,"	-scrf: screen-file (binary ssp) defining bounds for infile1 [unset]\n");
@@ -88,7 +94,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile1);
 		exit(1);
 	}
-	if(strcmp(infile2,"stdin")!=0 && stat(infile2,&sts)==-1 && errno == ENOENT) {
+	if(strstr(infile1,".clux")!=NULL) setclux=1;
+	if(setclux==0 && strcmp(infile2,"stdin")!=0 && stat(infile2,&sts)==-1 && errno == ENOENT) {
 		fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile2);
 		exit(1);
 	}
@@ -115,7 +122,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	clubt file: %s\n",infile1);
 		fprintf(stderr,"	club  file: %s\n",infile2);
 	}
- 	nn= xf_readclub1(infile1,infile2,&clubt,&club,message);
+ 	if(setclux==1) nn= xf_readclux1(infile1,setclulist,0,0,&clubt,&club,cluxparams,message);
+ 	else nn= xf_readclub1(infile1,infile2,&clubt,&club,message);
  	if(nn<0) {fprintf(stderr,"\n*** %s/%s\n\n",thisprog,message); exit(1);}
 
 	/************************************************************
@@ -142,8 +150,8 @@ int main (int argc, char *argv[]) {
 	/************************************************************
 	INITIALIZE TRIAL-DURATION PARAMETERS USING ORIGINAL CLU RECORDS
 	***********************************************************/
-	tmin= clubt[0];
-	tmax= clubt[nn-1];
+	if(setclux==1) { tmin= cluxparams[2]; tmax= cluxparams[3]; }
+	else { tmin= clubt[0]; tmax= clubt[nn-1]; }
 	duration1= tmax-tmin;
 	duration2= (double)duration1/(double)setfreq;
 
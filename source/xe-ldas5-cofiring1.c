@@ -3,12 +3,15 @@
 #include <string.h>
 
 #define thisprog "xe-ldas5-cofiring1"
-#define TITLE_STRING thisprog" v 1: 27.November.2017 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 
 /*
 <TAGS>dt.spikes</TAGS>
 
+v 2: 18.October.2026 [JRH] :
+	- allow input from an indexed spike-store (.clux) - only clusters in -clu are read
+
 v 1: 27.November.2017 [JRH] :
 	- based on xe-cofiring1 & (now retired) xe-cofiring2
 */
@@ -17,6 +20,7 @@ v 1: 27.November.2017 [JRH] :
 
 /* external functions start */
 long xf_readclub1(char *fileclubt, char *fileclub, long **clubt, short **club, char *message);
+long xf_readclux1(char *infile, char *list1, long tstart, long tstop, long **clubt, short **club, long *params, char *message);
 long xf_matchclub1_ls(char *setclulist, long *clubt, short *club, long nclub, char *message);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long xf_readssp1(char *infile, long **start, long **stop, char *message);
@@ -58,6 +62,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	%s [clubt] [club] [ssp] [options]\n",thisprog);
 		fprintf(stderr,"	[clubt]: binary file containing cluster-times (long int)\n");
 		fprintf(stderr,"	[club]: binary file containing cluster-IDs (short int)\n");
+		fprintf(stderr,"	NOTE: [clubt] can also be an indexed spike-store (.clux)\n");
+		fprintf(stderr,"		- [club] is then ignored, and only clusters in -clu are read\n");
 		fprintf(stderr,"	[ssp]: binary start-stop-pair file defining time-windows\n");
 		fprintf(stderr,"VALID ARGUMENTS (defaults in []) ...\n");
 		fprintf(stderr,"	-clu: CSV list of clusters to use [unset]\n",setclulist);
@@ -102,7 +108,8 @@ int main (int argc, char *argv[]) {
 	STORE THE CLUSTER TIMESTAMPS AND IDs
 	***********************************************************/
 	if(setverb==1) fprintf(stderr,"Reading club(t) files...\n");
- 	nn= xf_readclub1(fileclubt,fileclub,&clubt,&club,message);
+ 	if(strstr(fileclubt,".clux")!=NULL) nn= xf_readclux1(fileclubt,setclulist,0,0,&clubt,&club,NULL,message);
+ 	else nn= xf_readclub1(fileclubt,fileclub,&clubt,&club,message);
  	if(nn<0) {fprintf(stderr,"\n*** %s/%s\n\n",thisprog,message); exit(1);}
 	/* keep only the clusters of interest */
 	if(setclulist!=NULL) {
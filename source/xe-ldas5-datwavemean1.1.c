@@ -1,16 +1,27 @@
 #define thisprog "xe-ldas5-datwavemean1"
-#define TITLE_STRING thisprog" v 2: 20.July.2017 [JRH]"
+#define TITLE_STRING thisprog" v 3: 18.October.2026 [JRH]"
 #include<stdlib.h>
 #include<stdio.h>
 #include<string.h>
 #include<math.h>
+#include<fcntl.h>
 
 #define MAX_LINELEN 1000
+#define BLOCKSAMPS 65536 // multi-channel samples read from the .dat file at a time
 
 /*
 <TAGS>LDAS dt.spikes math</TAGS>
 
 CHANGES THIS VERSION:
+v 3: 18.October.2026 [JRH]
+	- waveforms are now gathered in a single pass through the .dat file
+		- spikes are sorted by time and the .dat file is streamed in blocks, rather than read into memory
+		- sums and sums-of-squares are accumulated together, giving means and standard deviations in one pass
+		- accumulators are held in .dat (sample x channel) order so the inner loop is contiguous and vectorizes
+	- bugfix: mean no longer truncated by integer division before conversion to uV
+	- bugfix: standard deviation (-out 2) is now calculated correctly
+	- spikes whose waveform extends beyond the start or end of the .dat file are excluded (with a warning)
+	- channel-list values are checked against the number of channels
 v 2: 20.July.2017 [JRH]
 	- allow specification of a total number of channels
 v 2: 17.March.2017 [JRH]
@@ -45,7 +56,7 @@ v.1.4
 /* external functions start */
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long xf_readclub1(char *infile1, char *infile2, long **clubt, short **club, char *message);
-off_t xf_readbin2_v(FILE *fpin, void **data, off_t startbyte, off_t bytestoread, char *message);
+void xf_qsortindex1_l(long *data, long *index,long n);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -60,15 +71,15 @@ float a,b,c,d;
 double aa,bb,cc;
 FILE *fpin;
 // program specific variables
-void *pdat=NULL;
 short *dat=NULL,*club=NULL;
 long nprobes=1,nchanlist,*probechan=NULL,*goodchan=NULL;
 int setbits=12,datasize=2;
-long *sampindex=NULL;
 long probe,cluster,clumax=0;
-long *clubt=NULL,*spiketot=NULL,*index=NULL,*wave,datpos,wavelen,nclu,nres;
+long *clubt=NULL,*spiketot=NULL,*index=NULL,*spikeindex=NULL,datpos,wavelen,nclu,nres,nskip=0;
+long blockstart=0,blockn=0,blockmax;
 double uv_per_unit;
-double *sdev=NULL;
+double *wave=NULL,*sdev=NULL,*pwave,*psdev;
+short *prow,*pref;
 off_t ndat,readparam[16];
 // command-line variables
 char infile1[256],infile2[256],infile3[256],*setchanlist=NULL,*setgoodlist=NULL;
@@ -144,17 +155,18 @@ if(argc<4) {
 
 
 	/*********************************************************************************************************/
-	/* READ THE .DAT FILE
+	/* OPEN THE .DAT FILE - IT IS READ IN BLOCKS LATER, SO JUST CHECK THE SIZE
 	/*********************************************************************************************************/
-	fprintf(stderr,"\tReading %s\n",infile1);
+	fprintf(stderr,"\tOpening %s\n",infile1);
+	if(setnchan<1) {fprintf(stderr,"\n\t--- %s [ERROR]: invalid -nch (%ld) - must be >0\n\n",thisprog,setnchan);exit(1);}
+	if(spklen<1||spkpre<0) {fprintf(stderr,"\n\t--- %s [ERROR]: invalid -spklen (%ld) or -spkpre (%ld)\n\n",thisprog,spklen,spkpre);exit(1);}
 	if((fpin=fopen(infile1,"rb"))==0) {fprintf(stderr,"\n\t--- %s [ERROR]: could not open .dat file: %s\n\n",thisprog,infile1);exit(1);}
-	ndat = xf_readbin2_v(fpin,&pdat,0,0,message);
-	fclose(fpin);
-	if(ndat==0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	if(fseeko(fpin,0,SEEK_END)!=0 || (ndat=ftello(fpin))<0) {fprintf(stderr,"\n\t--- %s [ERROR]: could not determine size of .dat file: %s\n\n",thisprog,infile1);exit(1);}
+	if(ndat==0) { fprintf(stderr,"\n\t--- %s [ERROR]: .dat file %s is empty\n\n",thisprog,infile1); exit(1); }
 	if(ndat%(setnchan*datasize)!=0) { fprintf(stderr,"\n\t--- %s [ERROR]: corrupt .dat file %s, is not %d channels of short integers\n\n",thisprog,infile1,setnchan); exit(1); }
-	dat=(short *)pdat;
 	ndat/=(setnchan*datasize);
-	//jj=0; kk=16; for(ii=ndat-10;ii<ndat-20000;ii++) printf("%d\n",dat[ii*kk+jj]);
+	/* the file will be read front-to-back: let the kernel read ahead */
+	posix_fadvise(fileno(fpin),0,0,POSIX_FADV_SEQUENTIAL);
 
 
 
@@ -183,7 +195,10 @@ if(argc<4) {
 		if(index==NULL) {fprintf(stderr,"\n--- Error[%s]: xf_lineparse2 failed\n\n",thisprog);exit(1);}
 		if(nchanlist<1) {fprintf(stderr,"\n--- Error[%s]: channel list is empty\n\n",thisprog);exit(1);}
 		if(nchanlist!=setnchan) {fprintf(stderr,"\n--- Error[%s]: channel list [n=%ld] does not match channel total [n=%ld] \n\n",thisprog,nchanlist,setnchan);exit(1);}
-		for(ii=0;ii<setnchan;ii++) probechan[ii]=atol(setchanlist+index[ii]);
+		for(ii=0;ii<setnchan;ii++) {
+			probechan[ii]=atol(setchanlist+index[ii]);
+			if(probechan[ii]<0||probechan[ii]>=setnchan) {fprintf(stderr,"\n--- Error[%s]: channel list contains an invalid channel (%ld) for %ld channels\n\n",thisprog,probechan[ii],setnchan);exit(1);}
+		}
 	}
 	else {
 		for(ii=0;ii<setnchan;ii++) probechan[ii]=ii;
@@ -205,62 +220,85 @@ if(argc<4) {
 	}
 	for(ii=0;ii<(setnchan-1);ii++) fprintf(stderr,"%d,",goodchan[ii]);fprintf(stderr,"%d\n",goodchan[(setnchan-1)]);
 
- 	/* allocate memory for .dat buffer and multi-cluster waveform storage */
- 	wavelen = spklen*setnchan; // total length of compound waveform
- 	if( (wave=(long *)calloc((clumax+1)*wavelen,sizeoflong))==NULL ) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);};
+	/* allocate memory for .dat buffer and multi-cluster waveform storage */
+	/* wave and sdev hold the sums and sums-of-squares in .dat order: [cluster][sample][channel] */
+	wavelen = spklen*setnchan; // total length of compound waveform
+	blockmax = BLOCKSAMPS+spklen; // block size, allowing every waveform starting in a block to fit
+	if( (wave=(double *)calloc((clumax+1)*wavelen,sizeofdouble))==NULL ) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);};
 	if( (sdev=(double *)calloc((clumax+1)*wavelen,sizeofdouble))==NULL ) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);};
 	if( (spiketot=(long *)calloc((clumax+1),sizeof(long)))==NULL ) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);};
- 	if( (sampindex=(long*)malloc(wavelen*sizeof(long)))==NULL ) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);};
+	if( (dat=(short *)malloc(blockmax*setnchan*sizeof(short)))==NULL ) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);};
+	if( (spikeindex=(long *)malloc((nclu+1)*sizeof(long)))==NULL ) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);};
 
 	/************************************************************
- 	BUILD INDEX FOR TRANSPOSING .DAT RECORDS INTO wave[clu][wavelen]
-	- takes into acount defined channel-order
-	************************************************************/
-	for(ii=0;ii<setnchan;ii++) {
-		for(jj=0;jj<spklen;jj++) {
-			kk=ii*spklen+jj;
-			sampindex[kk] = jj*setnchan + probechan[ii];
-		}
-	}
- 	//TEST: for(ii=0;ii<wavelen;ii++) printf("%d %d\n",ii,sampindex[ii]); exit(0);
+	SORT THE SPIKES BY TIME, SO THE .DAT FILE IS READ ONCE, IN ORDER
+	- spikeindex maps each sorted timestamp back to its cluster-ID
+	***********************************************************/
+	for(ii=0;ii<nclu;ii++) spikeindex[ii]=ii;
+	for(ii=1;ii<nclu;ii++) if(clubt[ii]<clubt[ii-1]) break;
+	if(ii<nclu) xf_qsortindex1_l(clubt,spikeindex,nclu);
 
 	/************************************************************
-	STORE THE SUMMED WAVEFORMS
+	STORE THE SUMMED WAVEFORMS AND SUMS-OF-SQUARES
 	- values normalized to sample-zero on each channel
+	- the block currently in memory holds samples blockstart to blockstart+blockn-1
 	***********************************************************/
 	fprintf(stderr,"\tExtracting waveforms...\n");
 	for(ii=0;ii<nclu;ii++) {
-		cluster= club[ii];
+		datpos= clubt[ii]-spkpre; // first sample of the waveform
+		if(datpos<0 || (datpos+spklen)>ndat) { nskip++; continue; }
+		/* read a new block if this waveform is not entirely within the current one */
+		if((datpos+spklen)>(blockstart+blockn)) {
+			blockstart= datpos;
+			blockn= ndat-blockstart; if(blockn>blockmax) blockn=blockmax;
+			if(fseeko(fpin,(off_t)blockstart*setnchan*datasize,SEEK_SET)!=0 ||
+				fread(dat,(setnchan*datasize),blockn,fpin)!=(size_t)blockn)
+				{fprintf(stderr,"\n\t--- %s [ERROR]: problem reading .dat file %s\n\n",thisprog,infile1);exit(1);}
+		}
+		cluster= club[spikeindex[ii]];
 		spiketot[cluster]++; // count total spikes in each cluster
-		datpos= (clubt[ii]-spkpre)*setnchan; // start position of waveform
-		for(jj=0;jj<setnchan;jj++) {
-			if(goodchan[jj]==0) continue;
-			mm= jj*spklen;
-			for(kk=0;kk<spklen;kk++) {
-				nn= mm+kk;
-				// build waveform total, .dat voltage minus the voltage from sample-0 from each wire
-				wave[cluster*wavelen+nn] += ( dat[datpos+sampindex[nn]] - dat[datpos+sampindex[mm]] );
-	}}}
+		pref= dat+(datpos-blockstart)*setnchan; // sample-zero for each channel
+		pwave= wave+cluster*wavelen;
+		psdev= sdev+cluster*wavelen;
+		for(kk=0;kk<spklen;kk++) {
+			prow= pref+kk*setnchan;
+			// build waveform totals, .dat voltage minus the voltage from sample-0 on each wire
+			for(jj=0;jj<setnchan;jj++) {
+				aa= (double)(prow[jj]-pref[jj]);
+				pwave[jj]+= aa;
+				psdev[jj]+= aa*aa;
+			}
+			pwave+= setnchan;
+			psdev+= setnchan;
+	}}
+	fclose(fpin);
+	if(nskip>0) fprintf(stderr,"\t--- %s [WARNING]: %ld spikes omitted - waveforms extend beyond the .dat file\n",thisprog,nskip);
 
 	/************************************************************
-	CALCULATE STANDARD DEVIATION
+	CONVERT SUMS TO MEAN AND STANDARD DEVIATION (uV)
+	- results are stored in wave and sdev in output order: [cluster][channel][sample]
 	***********************************************************/
-	if(setout==2) {
-		fprintf(stderr,"\tCalculating standard deviations...\n");
-		for(ii=0;ii<nclu;ii++) {
-			cluster= club[ii];
-			aa= spiketot[cluster];
-			datpos= (clubt[ii]-spkpre)*setnchan; // start position of waveform
-			for(jj=0;jj<setnchan;jj++) {
-			if(goodchan[jj]==0) continue;
+	if((pwave=(double *)malloc(2*wavelen*sizeofdouble))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);};
+	psdev= pwave+wavelen;
+	for(cluster=0;cluster<=clumax;cluster++) {
+		aa= (double)spiketot[cluster];
+		if(aa<=0) continue;
+		for(jj=0;jj<setnchan;jj++) {
+			mm= jj*spklen;
 			for(kk=0;kk<spklen;kk++) {
-				mm= jj*spklen;
 				nn= mm+kk;
-				bb= (dat[datpos+sampindex[nn]] - dat[datpos+sampindex[mm]]) ; //corrected current datapoint
-				cc= (double)wave[cluster*wavelen+kk]/aa; // mean
-				sdev[cluster*wavelen+nn] += (bb-cc)*(bb-cc); // std.dev still needs to be square-rooted and divided by nspikes-1
-		}}}
+				pp= cluster*wavelen + kk*setnchan + probechan[jj]; // position in .dat-ordered sums
+				bb= wave[pp]/aa; // mean
+				if(aa>1) cc= (sdev[pp]-bb*wave[pp])/(aa-1.0); // variance
+				else cc= NAN;
+				if(cc<0) cc=0; // guard against rounding error
+				pwave[nn]= bb*uv_per_unit;
+				psdev[nn]= sqrt(cc)*uv_per_unit;
+		}}
+		memcpy(wave+cluster*wavelen,pwave,wavelen*sizeofdouble);
+		memcpy(sdev+cluster*wavelen,psdev,wavelen*sizeofdouble);
 	}
+	free(pwave);
 
 	/************************************************************
 	OUTPUT WFM FILE - ONE ROW PER CLUSTER
@@ -283,7 +321,7 @@ if(argc<4) {
 				for(kk=0;kk<spklen;kk++) {
 					nn= mm+kk;
 					if(goodchan[jj]==0) aa=NAN;
-					else aa= (wave[cluster*wavelen+nn]/spiketot[cluster]) * uv_per_unit;
+					else aa= wave[cluster*wavelen+nn];
 					printf("%.3lf ",aa);
 				}
 			}
@@ -304,8 +342,8 @@ if(argc<4) {
 					nn= mm+kk;
 					if(goodchan[jj]==0) aa=bb=NAN;
 					else {
-						aa= (wave[cluster*wavelen+nn]/spiketot[cluster]) * uv_per_unit; // mean
-						bb= (sqrt(sdev[cluster*wavelen+kk])/(nn-1)) * uv_per_unit; // standard deviation
+						aa= wave[cluster*wavelen+nn]; // mean
+						bb= sdev[cluster*wavelen+nn]; // standard deviation
 					}
 					printf("%ld\t%ld\t%.3lf\t%.3lf\n",cluster,nn,aa,bb);
 	}}}}
@@ -320,7 +358,7 @@ if(argc<4) {
 	if(goodchan!=NULL) free(goodchan);
 	if(spiketot!=NULL) free(spiketot);
 	if(index!=NULL) free(index);
-	if(sampindex!=NULL) free(sampindex);
+	if(spikeindex!=NULL) free(spikeindex);
 	if(wave!=NULL) free(wave);
 	if(sdev!=NULL) free(sdev);
 	exit(0);
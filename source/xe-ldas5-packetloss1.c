@@ -33,6 +33,7 @@ long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 int xf_bin1b_s(short *data, long *setn, long *setz, double setbinsize, char *message);
 int xf_stats2_d(double *data, long n, int varcalc, double *result_d);
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 /* external functions end */
 
@@ -21,6 +21,8 @@ long xf_screen_ssp1(long *start1, long *stop1, long nssp1, long *start2, long *s
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long *xf_density2_l(long *start1,long *stop1,long nn,long min,long max,double winsize,long *nwin,char *message);
 int xf_writebin1_v(FILE *fpout, void *data0, size_t nn, size_t datasize, char *message);
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 /* external functions end */
 
 
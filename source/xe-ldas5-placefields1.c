@@ -1,7 +1,6 @@
 #define thisprog "xe-ldas5-placefields1"
-#define TITLE_STRING thisprog" v 2: 16.March.2019 [JRH]"
+#define TITLE_STRING thisprog" v 3: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
-#define MAXCLUSTER 1000
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -14,6 +13,14 @@
 /************************************************************************
 <TAGS>dt.spikes</TAGS>
 
+v 3: 18.October.2026 [JRH]
+	- allow input from an indexed spike-store (.clux) - only clusters in -clu are read
+	- spikes are grouped by cluster in a single pass, instead of re-scanning all spikes for each cluster
+	- spike-maps, smoothing and rate-division for all clusters are built in parallel (if compiled with -fopenmp)
+		- maps are then output in cluster order, as before
+		- errors from any thread are recorded in a critical section, and smoothing failures are reported as such
+	- remove the 1000-cluster limit
+
 v 2: 16.March.2019 [JRH]
 	- update to use new function xf_screen_club - because the older xs-screen_ls should not update the timestamps
 
@@ -61,6 +68,7 @@ long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long xf_readssp1(char *infile, long **start, long **stop, char *message);
 long xf_readxydt(char *infile1, char *infile2, long **post, float **posx, float **posy, float **posd, char *message);
 long xf_readclub1(char *infile1, char *infile2, long **clubt, short **club, char *message);
+long xf_readclux1(char *infile, char *list1, long tstart, long tstop, long **clubt, short **club, long *params, char *message);
 long xf_matchclub1_ls(char *list1, long *clubt, short *club, long nn, char *message);
 long xf_screen_club(long *start, long *stop, long nssp, long *clubt, short *club, long nclub, char *message);
 long xf_screen_xydt(long *start, long *stop, long nssp, long *xydt, float *xydx, float *xydy, float *xydd, long ndata, char *message);
@@ -69,6 +77,8 @@ int xf_matrixcontig1_l(long *matrix1, long setxbintot, long setybintot, long set
 int xf_densitymatrix2_l(float *xdata, float *ydata, long nn, long *matrix, long setxbintot, long setybintot, float *ranges, char *message);
 int xf_smoothgauss2_d(double *data,int xbintot,int ybintot,int xsmooth,int ysmooth);
 int xf_matrixpeak1_d(double *data1,int *mask, long width, long height, float thresh, double *result);
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -96,9 +106,11 @@ int main (int argc, char *argv[]) {
 	double *matrix1=NULL,*matrix3=NULL,matrixmax,matrixpeak;
 	double binsize=-1;
 
-	int datasize,blocksread,setscreen=0;
+	int datasize,blocksread,setscreen=0,setclux=0;
 	long headerbytes=0,maxread,blocksize,matrixsize;
-	long cluster,clustern[MAXCLUSTER];
+	long cluster,cluindex,clumax,nclu,*clustern=NULL,*cluoffset=NULL,*clulist=NULL;
+	double *ratemaps=NULL;
+	int setfail=0;
 	off_t params[4]={0,0,0,0},block,nread,nreadtot,nout,nssp,nclulist;
 
 	/* arguments */
@@ -127,6 +139,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"  	%s [clubt] [club] [xyd] [xydt] [options]\n",thisprog);
 		fprintf(stderr,"	[clubt]: binary file containing cluster-times (long int)\n");
 		fprintf(stderr,"	[club]: binary file containing cluster-IDs (short int)\n");
+		fprintf(stderr,"	NOTE: [clubt] can also be an indexed spike-store (.clux)\n");
+		fprintf(stderr,"		- [club] is then ignored, and only clusters in -clu are read\n");
 		fprintf(stderr,"	[xydt]: binary file containing position-times (long int)\n");
 		fprintf(stderr,"	[xyd]: binary file containing position-values (3x float)\n");
 		fprintf(stderr,"VALID OPTIONS:\n");
@@ -151,6 +165,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"		2= path+spike x/y coordinates\n");
 		fprintf(stderr,"		3= spike-density matrix (counts)\n");
 		fprintf(stderr,"		4= spike-firing rate (Hz)\n");
+		fprintf(stderr,"		NOTE: for 3-4, one matrix per cluster, preceded by \"# [cluster] : [n] spikes\"\n");
+		fprintf(stderr,"		NOTE: clusters are mapped in parallel if compiled with OpenMP (-fopenmp)\n");
 		fprintf(stderr,"	-verb: set verbocity of output (0=low, 1=high) [%d]\n",setverb);
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s data.clubt data.club -scrl 100,200,1500,1600\n",thisprog);
@@ -171,7 +187,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile1);
 		exit(1);
 	}
-	if(strcmp(infile2,"stdin")!=0 && stat(infile2,&sts)==-1 && errno == ENOENT) {
+	if(strstr(infile1,".clux")!=NULL) setclux=1;
+	if(setclux==0 && strcmp(infile2,"stdin")!=0 && stat(infile2,&sts)==-1 && errno == ENOENT) {
 		fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile2);
 		exit(1);
 	}
@@ -256,7 +273,8 @@ int main (int argc, char *argv[]) {
 	/************************************************************
 	READ THE CLUSTER TIMESTAMPS AND IDs
 	***********************************************************/
- 	nn= xf_readclub1(infile1,infile2,&clubt,&club,message);
+ 	if(setclux==1) nn= xf_readclux1(infile1,setclulist,0,0,&clubt,&club,NULL,message);
+ 	else nn= xf_readclub1(infile1,infile2,&clubt,&club,message);
  	if(nn<0) {fprintf(stderr,"\n*** %s/%s\n\n",thisprog,message); exit(1);}
 
 	/************************************************************
@@ -322,7 +340,9 @@ int main (int argc, char *argv[]) {
 	***********************************************************/
 	if(setscreen==1) {
 		mm= xf_screen_xydt(start1,stop1,nssp,xydt,xydx,xydy,xydd,mm,message);
+		if(mm==-1) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
 		nn= xf_screen_club(start1,stop1,nssp,clubt,club,nn,message);
+		if(nn==-1) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
 	}
 
 	/************************************************************
@@ -339,12 +359,10 @@ int main (int argc, char *argv[]) {
 	clubx   = spike-x-coordinates
 	cluby   = spike-y-coordinates
 	clubd   = spike-direction
-	tempx   = temporary spike-x-coordinates array for a single cluster
-	tempy   = temporary spike-y-coordinates array for a single cluster
+	tempx   = spike-x-coordinates grouped by cluster
+	tempy   = spike-y-coordinates grouped by cluster
 	matrix0 = dwell-counts
 	matrix1 = dwell-time
-	matrix2 = spike-counts
-	matrix3 = spike-rate
 	***********************************************************/
 	if((clubx=realloc(clubx,nn*sizeof(*clubx)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
 	if((cluby=realloc(cluby,nn*sizeof(*cluby)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
@@ -353,8 +371,6 @@ int main (int argc, char *argv[]) {
 	if((tempy=realloc(tempy,nn*sizeof(*tempy)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
 	if((matrix0=realloc(matrix0,matrixsize*sizeof(*matrix0)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
 	if((matrix1=realloc(matrix1,matrixsize*sizeof(*matrix1)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
-	if((matrix2=realloc(matrix2,matrixsize*sizeof(*matrix2)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
-	if((matrix3=realloc(matrix3,matrixsize*sizeof(*matrix3)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
 	if((mask=realloc(mask,matrixsize*sizeof(*mask)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
 
 	/************************************************************
@@ -424,68 +440,115 @@ int main (int argc, char *argv[]) {
 	***********************************************************/
 	else if(setout>=2) {
 
-		/* initialize & get the spike counts in each cluster */
-		for(ii=0;ii<MAXCLUSTER;ii++) clustern[ii]=0;
+		/* get the spike counts in each cluster */
+		for(ii=clumax=0;ii<nn;ii++) {
+			if(club[ii]<0) {fprintf(stderr,"\n\t--- %s [ERROR]: invalid cluster-ID (%d)\n\n",thisprog,club[ii]);exit(1);}
+			if(club[ii]>clumax) clumax=club[ii];
+		}
+		if((clustern=calloc((clumax+1),sizeof(*clustern)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
+		if((cluoffset=calloc((clumax+2),sizeof(*cluoffset)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
+		if((clulist=calloc((clumax+1),sizeof(*clulist)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
 		for(ii=0;ii<nn;ii++) clustern[club[ii]]++;
 
- 		for(cluster=0;cluster<MAXCLUSTER;cluster++) {
+		/* group the spike positions by cluster (tempx,tempy) in a single pass - order within a cluster is preserved */
+		for(cluster=0;cluster<=clumax;cluster++) cluoffset[cluster+1]= cluoffset[cluster]+clustern[cluster];
+		for(ii=0;ii<nn;ii++) {
+			kk= cluoffset[club[ii]]++;
+			tempx[kk]=clubx[ii];
+			tempy[kk]=cluby[ii];
+		}
+		for(cluster=clumax;cluster>0;cluster--) cluoffset[cluster]= cluoffset[cluster-1];
+		cluoffset[0]=0;
 
-			if(clustern[cluster]==0) continue;
-			if(setverb==1) fprintf(stderr,"	 -building cluster %ld\n",cluster);
+		/* make a list of the clusters which have spikes */
+		for(cluster=nclu=0;cluster<=clumax;cluster++) if(clustern[cluster]>0) clulist[nclu++]=cluster;
 
-			/* generate tempx & tempy */
-			for(ii=jj=0;ii<nn;ii++) {
-				if(club[ii]==cluster) {
-					tempx[jj]=clubx[ii];
-					tempy[jj]=cluby[ii];
-					jj++;
-				}
-			}
-
-			/* if only outputting spike positions, this is as far as we need to go */
-			if(setout==2) {
+		/* if only outputting spike positions, this is as far as we need to go */
+		if(setout==2) {
+			for(cluindex=0;cluindex<nclu;cluindex++) {
+				cluster= clulist[cluindex];
 				for(ii=0;ii<mm;ii++) printf("0\t%g\t%g\n",xydx[ii],xydy[ii]);
-				for(ii=0;ii<clustern[cluster];ii++) printf("1\t%g\t%g\n",tempx[ii],tempy[ii]);
-				continue;
+				for(ii=cluoffset[cluster];ii<cluoffset[cluster+1];ii++) printf("1\t%g\t%g\n",tempx[ii],tempy[ii]);
 			}
+		}
+		else {
+			/* build the map for every cluster, in parallel - one matrix per cluster in ratemaps */
+			if((ratemaps=malloc(nclu*matrixsize*sizeof(*ratemaps)))==NULL) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
+			#pragma omp parallel for schedule(dynamic) private(ii,z,cluster,matrix2,matrix3)
+			for(cluindex=0;cluindex<nclu;cluindex++) {
+				char message2[256];
+				int fail;
+				/* setfail and message are only read or written inside a critical section */
+				#pragma omp critical
+				{ fail= setfail; }
+				if(fail!=0) continue;
+				cluster= clulist[cluindex];
+				matrix3= ratemaps+cluindex*matrixsize;
+				if(setverb==1) fprintf(stderr,"	 -building cluster %ld\n",cluster);
+				if((matrix2=malloc(matrixsize*sizeof(*matrix2)))==NULL) {
+					#pragma omp critical
+					{ if(setfail==0) setfail=1; }
+					continue;
+				}
 
-			/* calculate spike-count density matrix (matrix2) - use position ranges previously defined for dwell-map */
-			z= xf_densitymatrix2_l(tempx,tempy,clustern[cluster],matrix2,xbintot,ybintot,ranges,message);
-			if(z==-1) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
-
-			/* convert to to double (matrix3) */
-		 	for(ii=0;ii<matrixsize;ii++) matrix3[ii]= (double)matrix2[ii];
+				/* calculate spike-count density matrix (matrix2) - use position ranges previously defined for dwell-map */
+				z= xf_densitymatrix2_l(tempx+cluoffset[cluster],tempy+cluoffset[cluster],clustern[cluster],matrix2,xbintot,ybintot,ranges,message2);
+				if(z==-1) {
+					#pragma omp critical
+					{ if(setfail==0) { sprintf(message,"%s",message2); setfail=2; }}
+					free(matrix2);
+					continue;
+				}
 
-			/* apply smoothing to spike-counts  */
-			if(setsmoothtype==1) {
-				z= xf_smoothgauss2_d(matrix3,(int)xbintot,(int)ybintot,(int)setxsmooth,(int)setysmooth);
-				if(z!=0) {fprintf(stderr,"\n\t--- %s [ERROR]: smoothing function encountered insufficient memory\n\n",thisprog);exit(1);}
-			}
+				/* convert to to double (matrix3) */
+			 	for(ii=0;ii<matrixsize;ii++) matrix3[ii]= (double)matrix2[ii];
+				free(matrix2);
+
+				/* apply smoothing to spike-counts  */
+				if(setsmoothtype==1) {
+					z= xf_smoothgauss2_d(matrix3,(int)xbintot,(int)ybintot,(int)setxsmooth,(int)setysmooth);
+					if(z!=0) {
+						#pragma omp critical
+						{ if(setfail==0) setfail=3; }
+						continue;
+					}
+				}
 
-			/* convert spike counts to rates (modify matrix3) */
-		 	if(setout==4) for(ii=0;ii<matrixsize;ii++) { if(matrix0[ii]>0) matrix3[ii]/=matrix1[ii]; else matrix3[ii]=NAN; }
+				/* convert spike counts to rates (modify matrix3) */
+			 	if(setout==4) for(ii=0;ii<matrixsize;ii++) { if(matrix0[ii]>0) matrix3[ii]/=matrix1[ii]; else matrix3[ii]=NAN; }
+
+				/* apply smoothing to rate-map */
+				if(setsmoothtype==2) {
+					z= xf_smoothgauss2_d(matrix3,xbintot,ybintot,setxsmooth,setysmooth);
+					if(z!=0) {
+						#pragma omp critical
+						{ if(setfail==0) setfail=3; }
+						continue;
+					}
+				}
 
-			/* apply smoothing to rate-map */
-			if(setsmoothtype==2) {
-				z= xf_smoothgauss2_d(matrix3,xbintot,ybintot,setxsmooth,setysmooth);
-	  			if(z!=0) {fprintf(stderr,"\n\t--- %s [ERROR]: smoothing function encountered insufficient memory\n\n",thisprog);exit(1);}
+				/* restore NANs to bins that were unvisited */
+				for(ii=0;ii<matrixsize;ii++) if(matrix0[ii]==0) matrix3[ii]=NAN;
 			}
-
-			/* restore NANs to bins that were unvisited */
-			for(ii=0;ii<matrixsize;ii++) if(matrix0[ii]==0) matrix3[ii]=NAN;
-
-			/* print the matrix with row "0" last (i.e. low values of y at the botttom) */
-			printf("# %ld : %ld spikes\n",cluster,clustern[cluster]);
-			for(ii=ybintot-1;ii>=0;ii--) {
-				for(jj=0;jj<xbintot;jj++) {
-					kk= ii*xbintot + jj;
-					if(jj>0) printf("\t");
-					printf("%g",matrix3[kk]);
+			if(setfail==1) {fprintf(stderr,"\n\t--- %s [ERROR]: insufficient memory\n\n",thisprog);exit(1);}
+			if(setfail==2) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+			if(setfail==3) {fprintf(stderr,"\n\t--- %s [ERROR]: smoothing failed (xf_smoothgauss2_d)\n\n",thisprog);exit(1);}
+
+			/* print the matrices with row "0" last (i.e. low values of y at the botttom) */
+			for(cluindex=0;cluindex<nclu;cluindex++) {
+				cluster= clulist[cluindex];
+				matrix3= ratemaps+cluindex*matrixsize;
+				printf("# %ld : %ld spikes\n",cluster,clustern[cluster]);
+				for(ii=ybintot-1;ii>=0;ii--) {
+					for(jj=0;jj<xbintot;jj++) {
+						kk= ii*xbintot + jj;
+						if(jj>0) printf("\t");
+						printf("%g",matrix3[kk]);
+					}
+					printf("\n");
 				}
-				printf("\n");
 			}
-
- 		} // END OF LOOP: for cluster=0 to maxcluster
+		}
 	} // END OF LOOP: else if(setout==2)
 
 	//TEST: if(setout>=0) { or(ii=0;ii<nn;ii++) if(club[ii]==setout) fprintf(stderr,"%ld\t%f\t%f\n",clubt[ii],clubx[ii],cluby[ii]); }
@@ -511,8 +574,10 @@ int main (int argc, char *argv[]) {
  	if(stop1!=NULL) free(stop1);
  	if(matrix0!=NULL) free(matrix0);
  	if(matrix1!=NULL) free(matrix1);
- 	if(matrix2!=NULL) free(matrix2);
-	if(matrix3!=NULL) free(matrix3);
+ 	if(clustern!=NULL) free(clustern);
+ 	if(cluoffset!=NULL) free(cluoffset);
+ 	if(clulist!=NULL) free(clulist);
+ 	if(ratemaps!=NULL) free(ratemaps);
 	if(mask!=NULL) free(mask);
 	exit(0);
 
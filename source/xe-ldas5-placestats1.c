@@ -1,5 +1,5 @@
 #define thisprog "xe-ldas5-placestats1"
-#define TITLE_STRING thisprog" v 3: 21.October.2017 [JRH]"
+#define TITLE_STRING thisprog" v 4: 18.October.2026 [JRH]"
 
 #include <math.h>
 #include <stdio.h>
@@ -9,21 +9,27 @@
 /*
 <TAGS>dt.spikes</TAGS>
 
+v 4: 18.October.2026 [JRH]
+	- place fields are defined by connected-component labelling (xf_matrixlabel1_d) of all smoothed maps in one call
+		- the field is the contiguous region around the highest smoothed rate, including pixels only reachable by a winding path
+
 v 3: 21.October.2017 [JRH]
 */
 
 
 /* external functions start */
 long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1, long *ncols, long *nrows, char *message);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse1(char *line,long *nwords);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 int xf_smoothgauss2_d(double *data,int xbintot,int ybintot,int xsmooth,int ysmooth);
-int xf_matrixpeak1_d(double *data1,int *mask, size_t width, size_t height, double thresh, double *result);
+long xf_matrixlabel1_d(double *data, long nmatrices, long width, long height, double *thresh, long *label, long *ncomp, double **stats, char *message);
 int xf_placestats1_d(double *dwell,double *rate,long width,long height,double dwelltot,double *result, char *message);
 long xf_stats3_d(double *data, long n, int varcalc, double *result_in);
 double xf_correlate_simple_d(double *x, double *y, long nn, double *result_d);
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 /* external functions end */
 
@@ -34,14 +40,14 @@ int main (int argc, char *argv[]) {
 	int v,w,x,y,z,n=0,col,colmatch,result_i[32];
 	int sizeofint=sizeof(int),sizeoflong=sizeof(long),sizeofdouble=sizeof(double);
 	float a,b,c,d;
-	double aa,bb,cc,dd,result_d[8];
+	double aa,bb,cc,dd,result_d[32];
 	FILE *fpin,*fpout;
 	/* program-specific variables */
 	int *mask;
-	long nmatrices,width,height,count=0,peakfound;
+	long nmatrices,width,height,count=0,ntot,*label=NULL,*ncomp=NULL;
 	double xmin,xmax,ymin,ymax;
-	double *matrix0=NULL,*matrix1=NULL,*id0=NULL,*id1=NULL,*pmatrix1,binsize,dwelltot,fsize,fx,fy,fmax1,thresh;
-	double rate_mean,rate_base= result_d[2],rate_max,rate_median,rate_peak,space_info,space_spar,space_coh;
+	double *matrix0=NULL,*matrix1=NULL,*id0=NULL,*id1=NULL,*pmatrix1,binsize,dwelltot,fsize,fx,fy,fmax1;
+	double *thresh=NULL,*stats=NULL,*pstats,*ps,*rstats=NULL,*prstats;
 
 	/* arguments */
 	char *filedwell,*filerate,*setvrange=NULL;
@@ -57,7 +63,7 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"%s\n",TITLE_STRING);
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"Perform place-field analysis on a multi-matrix file\n");
-		fprintf(stderr," - this peak starts at the highest-value pixel and propogates outward\n");
+		fprintf(stderr," - the field is the contiguous region around the highest-value pixel\n");
 		fprintf(stderr," - diagonal propogation is not permitted\n");
 		fprintf(stderr," - if peak size is below a minimum, another attempt is made\n");
 		fprintf(stderr," - attempts are made until no peak is detected at all\n");
@@ -144,7 +150,12 @@ int main (int argc, char *argv[]) {
 	/* allocate memory for the mask */
 	nn= width*height;
 	mask= malloc(nn*sizeof(*mask));
-	if(mask==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+	/* allocate memory for the basic stats, thresholds and field labels for every matrix */
+	rstats= malloc(nmatrices*8*sizeof(*rstats));
+	thresh= malloc(nmatrices*sizeof(*thresh));
+	label= malloc(nmatrices*nn*sizeof(*label));
+	ncomp= malloc(nmatrices*sizeof(*ncomp));
+	if(mask==NULL||rstats==NULL||thresh==NULL||label==NULL||ncomp==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
 
 	/********************************************************************************/
 	/* DEFINE THE DATA-POSITION RANGES AUTOMATICALLY */
@@ -165,26 +176,26 @@ int main (int argc, char *argv[]) {
 	}
 
 	/********************************************************************************/
-	/* FOR EACH MATRIX */
+	/* FOR EACH MATRIX: BASIC STATS, THEN SMOOTH FOR FIELD DETECTION */
 	/********************************************************************************/
-	printf("cluster	rmax	rmean	rbase	rmed	rpeak	info	spar	coh	fmax	fsize	fx	fy\n");
 	for(kk=0;kk<nmatrices;kk++) {
 
-		/* set the matrix pointer */
+		/* set the matrix pointers */
 		pmatrix1= matrix1+(nn*kk);
+		prstats= rstats+(8*kk);
 
 		/* CALCULATE BASIC AND SPATIAL STATISTICS */
 		ii= xf_placestats1_d(matrix0,pmatrix1,width,height,dwelltot,result_d,message);
-		rate_max= result_d[0];
-		rate_mean= result_d[1];
-		rate_base= result_d[2];   // 10th percentile
-		rate_median= result_d[3]; // 50th percentile
-		rate_peak= result_d[4];   // 97.5th percentile = midpoint of 95th percentile
-		space_info= result_d[6];
-		space_spar= result_d[7];
-		space_coh= result_d[8];
-
-		/* DEFINE THE PLACE FIELD */
+		prstats[0]= result_d[0]; // max
+		prstats[1]= result_d[1]; // mean
+		prstats[2]= result_d[2]; // 10th percentile
+		prstats[3]= result_d[3]; // 50th percentile
+		prstats[4]= result_d[4]; // 97.5th percentile = midpoint of 95th percentile
+		prstats[5]= result_d[6]; // information content
+		prstats[6]= result_d[7]; // sparsity
+		prstats[7]= result_d[8]; // coherence
+
+		/* SMOOTH THE MATRIX */
 		/* use mask array to store NAN status */
 		for(ii=0;ii<nn;ii++) { if(isfinite(pmatrix1[ii])) mask[ii]=0; else mask[ii]=-1; }
 		/* apply 2d smoothing */
@@ -194,16 +205,36 @@ int main (int argc, char *argv[]) {
 		/* get the max value */
 		fmax1=0; for(ii=0;ii<nn;ii++) { aa= pmatrix1[ii]; if(isfinite(aa) && aa>fmax1) fmax1=aa; }
 		/* define the matrix-specific threshold */
-		thresh= fmax1*setthresh;
-		/* re-initialize the mask */
-		for(ii=0;ii<nn;ii++) mask[ii]=0;
-		/* detect the highest-rate peak firing zone */
-		peakfound= xf_matrixpeak1_d(pmatrix1,mask,width,height,thresh,result_d);
-		if(peakfound==1 && result_d[0]>setsize) {
-			fsize= result_d[0];   // number of pixels in the field
-			fx= result_d[3];      // x-centroid
-			fy= result_d[4];      // y-centroid
-			fmax1= result_d[6];  // highest-value peak in the field
+		thresh[kk]= fmax1*setthresh;
+	}
+
+	/********************************************************************************/
+	/* LABEL THE CONTIGUOUS SUPRA-THRESHOLD REGIONS IN ALL MATRICES */
+	/********************************************************************************/
+	ntot= xf_matrixlabel1_d(matrix1,nmatrices,width,height,thresh,label,ncomp,&stats,message);
+	if(ntot<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+
+	/********************************************************************************/
+	/* FOR EACH MATRIX: DEFINE THE PLACE FIELD AND OUTPUT */
+	/********************************************************************************/
+	printf("cluster	rmax	rmean	rbase	rmed	rpeak	info	spar	coh	fmax	fsize	fx	fy\n");
+	pstats= stats;
+	for(kk=0;kk<nmatrices;kk++) {
+
+		prstats= rstats+(8*kk);
+		if(kk>0) pstats+= ncomp[kk-1]*8;
+
+		/* the field is the component holding the highest-rate pixel, which must exceed the threshold */
+		ps= NULL;
+		for(jj=0;jj<ncomp[kk];jj++) {
+			if(pstats[jj*8+3]<=thresh[kk]) continue;
+			if(ps==NULL || pstats[jj*8+3]>ps[3] || (pstats[jj*8+3]==ps[3] && (pstats[jj*8+5]*width+pstats[jj*8+4]) < (ps[5]*width+ps[4]))) ps= pstats+jj*8;
+		}
+		if(ps!=NULL && ps[0]>setsize) {
+			fsize= ps[0];   // number of pixels in the field
+			fx= ps[6];      // x-centroid
+			fy= ps[7];      // y-centroid
+			fmax1= ps[3];   // highest-value peak in the field
 			/* convert pixels to cm */
 			fmax1*= binsize;
 			fsize*= binsize;
@@ -216,13 +247,11 @@ int main (int argc, char *argv[]) {
 		/* OUTPUT THE RESULTS */
 		printf("%g	%.3f	%.3f	%.3f	%.3f	%.3f	%.3f	%.3f	%.3f	%.3f	%.3f	%.3f	%.3f\n",
 			id1[kk],
-			rate_max,rate_mean,rate_base,rate_median,rate_peak,
-			space_info,space_spar,space_coh,
+			prstats[0],prstats[1],prstats[2],prstats[3],prstats[4],
+			prstats[5],prstats[6],prstats[7],
 			fmax1,fsize,fx,fy
 		);
 
-
-
 	} // END OF PER-MATRIX LOOP (KK)
 
 	/* FREE MEMORY AND EXIT */
@@ -231,6 +260,11 @@ int main (int argc, char *argv[]) {
 	if(id0!=NULL) free(id0);
 	if(id1!=NULL) free(id1);
 	if(mask!=NULL) free(mask);
+	if(rstats!=NULL) free(rstats);
+	if(thresh!=NULL) free(thresh);
+	if(label!=NULL) free(label);
+	if(ncomp!=NULL) free(ncomp);
+	if(stats!=NULL) free(stats);
 	exit(0);
 
 	}
@@ -1,5 +1,5 @@
 #define thisprog "xe-ldas5-readclub1"
-#define TITLE_STRING thisprog" v 6: 16.March.2019 [JRH]"
+#define TITLE_STRING thisprog" v 7: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 #include <stdlib.h>
 #include <stdio.h>
@@ -11,6 +11,10 @@
 /************************************************************************
 <TAGS>dt.spikes</TAGS>
 
+v 7: 18.October.2026 [JRH]
+	- allow input from an indexed spike-store (.clux) - only clusters in -clu are read
+	- add -out 1: write an indexed spike-store (.clux)
+
 v 6: 16.March.2019 [JRH]
 	- update to use new function xf_screen_club - because the older xs-screen_ls should not update the timestamps
 v 6: 5.November.2018 [JRH]
@@ -47,12 +51,17 @@ long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long xf_readssp1(char *infile, long **start, long **stop, char *message);
 long xf_screen_club(long *start, long *stop, long nssp, long *time, short *data, long ndata, char *message);
 void xf_qsortindex1_l(long *data, long *index,long nn);
+long xf_readclux1(char *infile, char *list1, long tstart, long tstop, long **clubt, short **club, long *params, char *message);
+long xf_writeclux1(char *outfile, long *clubt, short *club, long nn, char *message);
+int xf_compare1_l(const void *a, const void *b);
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
 
 	/* general variables */
-	char infile1[256],infile2[256],outfile1[256],outfile2[256],message[256];
+	char infile1[256],infile2[256],outfile1[256],outfile2[256],outfile3[256],message[256];
 	int v,w,x,y,z,sizeofshort=sizeof(short),sizeoflong=sizeof(long);
 	long int ii,jj,kk,mm,nn;
 	float a,b,c,d;
@@ -63,8 +72,8 @@ int main (int argc, char *argv[]) {
 	/* program-specific variables */
 	short *club=NULL,*tempclub=NULL;
 	long *clubt=NULL,*start1=NULL,*stop1=NULL,*index1=NULL,*index2=NULL,*clucount=NULL,*index3=NULL;
-	long clumaxp1=-1,duration1;
-	int setscreen=0;
+	long clumaxp1=-1,duration1,cluxparams[4];
+	int setscreen=0,setclux=0;
 	off_t nstart,nclulist;
 	double duration2;
 
@@ -75,6 +84,7 @@ int main (int argc, char *argv[]) {
 
 	sprintf(outfile1,"temp_%s.clubt",thisprog);
 	sprintf(outfile2,"temp_%s.club",thisprog);
+	sprintf(outfile3,"temp_%s.clux",thisprog);
 	nstart=nclulist=0;
 
 	/************************************************************
@@ -93,6 +103,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	%s [clubt] [club] [options]\n",thisprog);
 		fprintf(stderr,"	[clubt]: binary file containing cluster-times (long int)\n");
 		fprintf(stderr,"	[club]: binary file containing cluster-IDs (short int)\n");
+		fprintf(stderr,"	NOTE: [clubt] can also be an indexed spike-store (.clux)\n");
+		fprintf(stderr,"		- [club] is then ignored, and only clusters in -clu are read\n");
 		fprintf(stderr,"VALID OPTIONS:\n");
 		fprintf(stderr,"	-clu: screen using CSV list of cluster IDs [unset]\n");
 		fprintf(stderr,"	-scrf: screen-file (binary ssp) defining bounds for infile1 [unset]\n");
@@ -104,6 +116,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"		 0= binary files x2 (long,short)\n");
 		fprintf(stderr,"		 	%s\n",outfile1);
 		fprintf(stderr,"		 	%s\n",outfile2);
+		fprintf(stderr,"		 1= indexed spike-store (.clux)\n");
+		fprintf(stderr,"		 	%s\n",outfile3);
 		fprintf(stderr,"	-sf: sample freq to calculate firing rates [%.3f]\n",setfreq);
 		fprintf(stderr,"	-verb: set verbocity of output (0=low, 1=high) [%d]\n",setverb);
 		fprintf(stderr,"EXAMPLES:\n");
@@ -123,7 +137,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile1);
 		exit(1);
 	}
-	if(strcmp(infile2,"stdin")!=0 && stat(infile2,&sts)==-1 && errno == ENOENT) {
+	if(strstr(infile1,".clux")!=NULL) setclux=1;
+	if(setclux==0 && strcmp(infile2,"stdin")!=0 && stat(infile2,&sts)==-1 && errno == ENOENT) {
 		fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile2);
 		exit(1);
 	}
@@ -139,7 +154,7 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-verb")==0) setverb=atoi(argv[++ii]);
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
 	}}
-	if(setout!=-2&&setout!=-1&&setout!=0) {fprintf(stderr,"\n--- Error[%s]: invalid -out (%d) : must be -2 -1 or 0\n\n",thisprog,setout);exit(1);}
+	if(setout<-2 || setout>1) {fprintf(stderr,"\n--- Error[%s]: invalid -out (%d) : must be -2 -1 0 or 1\n\n",thisprog,setout);exit(1);}
 	if(setsort<0 || setsort>1) {fprintf(stderr,"\n--- Error[%s]: invalid -sort (%d) : must be 0-1\n\n",thisprog,setsort);exit(1);}
 	if(setverb<0 || setverb>1) {fprintf(stderr,"\n--- Error[%s]: invalid -verb (%d) : must be 0-1\n\n",thisprog,setverb);exit(1);}
 	if(setscreenfile!=NULL && setscreenlist!=NULL) {fprintf(stderr,"\n--- Error[%s]: cannot define both a screen-list and a screen-file\n\n",thisprog);exit(1);}
@@ -185,7 +200,8 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	clubt file: %s\n",infile1);
 		fprintf(stderr,"	club  file: %s\n",infile2);
 	}
- 	nn= xf_readclub1(infile1,infile2,&clubt,&club,message);
+ 	if(setclux==1) nn= xf_readclux1(infile1,setclulist,0,0,&clubt,&club,cluxparams,message);
+ 	else nn= xf_readclub1(infile1,infile2,&clubt,&club,message);
  	if(nn<0) {fprintf(stderr,"\n*** %s/%s\n\n",thisprog,message); exit(1);}
 
 	/************************************************************
@@ -194,8 +210,10 @@ int main (int argc, char *argv[]) {
 	***********************************************************/
 	if(setscreen==1) {
 		nn= xf_screen_club(start1,stop1,nstart,clubt,club,nn,message);
+		if(nn==-1) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
 		for(ii=duration1=0;ii<nstart;ii++) duration1+= (stop1[ii]-start1[ii]);
 	}
+	else if(setclux==1) { duration1= cluxparams[3]-cluxparams[2]; }
 	else { duration1= clubt[nn-1]-clubt[0]; }
 	duration2= (double)duration1/(double)setfreq;
 	if(setverb==1) fprintf(stderr,"- recording duration: %g seconds\n",duration2);
@@ -258,6 +276,11 @@ int main (int argc, char *argv[]) {
 		fclose(fpout1);
 		fclose(fpout2);
 	}
+	/* output indexed spike-store */
+	else if(setout==1) {
+		mm= xf_writeclux1(outfile3,clubt,club,nn,message);
+		if(mm<0) {fprintf(stderr,"\n*** %s/%s\n\n",thisprog,message); exit(1);}
+	}
 
  	/* SECOND REPORT - re-use clubt[] array for cluster-counts */
 	if(setverb==1) {
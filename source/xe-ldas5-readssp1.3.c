@@ -45,6 +45,8 @@ v 2: 1.September.2015 [JRH]
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long xf_readssp1(char *infile, long **start, long **stop, char *message);
 long xf_screen_ssp1(long *start1, long *stop1, long nssp1, long *start2, long *stop2, long nssp2, int mode, char *message);
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
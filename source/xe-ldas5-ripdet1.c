@@ -149,6 +149,8 @@ int xf_blockrealign2(long *samplenum, long nn, long *bstart, long *bstop, long n
 void kiss_fftr(kiss_fftr_cfg st,const kiss_fft_scalar *timedata,kiss_fft_cpx *freqdata);
 void kiss_fft(kiss_fft_cfg cfg,const kiss_fft_cpx *fin,kiss_fft_cpx *fout);
 */
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 /* external functions end */
 
 
@@ -1,5 +1,5 @@
 #define thisprog "xe-ldas5-screentxt1"
-#define TITLE_STRING thisprog" v 1: 29.July.2016 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 #define MAXLABELS 1000
 
@@ -13,6 +13,11 @@
 /*
 <TAGS> file screen time</TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- screening uses a sorted SSP-index (xf_sspindex1_l) instead of testing every SSP for every line
+		- speeds up screening with large numbers of SSPs, particularly for time-ordered input
+	- bugfix: memory for the screening list is now properly freed
+
 v 1: 29.July.2016 [JRH]
 	- original
 */
@@ -21,6 +26,8 @@ v 1: 29.July.2016 [JRH]
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long xf_readssp1(char *infile, long **start, long **stop, char *message);
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 /* external functions end */
 
 
@@ -40,7 +47,7 @@ int main (int argc, char *argv[]) {
 	int lenwords=0,*count,grp,bin,bintot,setrange=0,colx=1,coly=2;
 	long nwords=0,*iword=NULL,*start=NULL,*block=NULL,*blockn=NULL,*list=NULL;
 
-	long *index=NULL,*start1=NULL,*stop1=NULL,nlist;
+	long *index=NULL,*start1=NULL,*stop1=NULL,*sspindex=NULL,nlist,hint=0;
 
 	/* arguments */
 	char *setscreenfile=NULL,*setscreenlist=NULL;
@@ -115,6 +122,9 @@ int main (int argc, char *argv[]) {
 		if(nlist<1) {fprintf(stderr,"\n--- Error[%s]: screening file \"%s\" is empty\n\n",thisprog,setscreenfile);exit(1);}
 	}
 	//TEST: for(jj=0;jj<nlist;jj++) printf("%ld	%ld	%ld\n",jj,start1[jj],stop1[jj]);free(start1);free(stop1);exit(0);
+	/* build the index used to look up the SSPs */
+	sspindex= xf_sspindex1_l(start1,stop1,nlist,message);
+	if(sspindex==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
 
 
 	/************************************************************
@@ -132,10 +142,9 @@ int main (int argc, char *argv[]) {
 		iword= xf_lineparse2(line,"\t",&nwords);
 		/* generate the timestamp for the line based on the user-defined column containing the timestamps */
 		kk=atol(line+iword[setcoltime]);
-		/* see if that timestamp falls between any of the start-stop pairs in the screening list */
-		for(ii=0;ii<nlist;ii++) if(kk>=start1[ii]&&kk<stop1[ii]) break;
-		/* if so, the counter would not have reached nlist: print the copy of the line */
-		if(ii<nlist) printf("%s",templine);
+		/* see if that timestamp falls between any of the start-stop pairs in the screening list (start<=kk<stop) */
+		/* if so, print the copy of the line */
+		if(xf_sspfind1_l(sspindex,nlist,kk,&hint)>kk) printf("%s",templine);
 	}
 	if(strcmp(infile,"stdin")!=0) fclose(fpin);
 
@@ -143,8 +152,9 @@ int main (int argc, char *argv[]) {
 	if(line!=NULL) free(line);
 	if(templine!=NULL) free(templine);
 	if(iword!=NULL) free(iword);
-	if(index==NULL) free(index);
-	if(start1==NULL) free(start1);
-	if(stop1==NULL) free(stop1);
+	if(index!=NULL) free(index);
+	if(start1!=NULL) free(start1);
+	if(stop1!=NULL) free(stop1);
+	if(sspindex!=NULL) free(sspindex);
 	exit(0);
 }
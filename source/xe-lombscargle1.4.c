@@ -61,6 +61,7 @@ void xf_lombscargle(double* t, double* x, double* w, double* P, int Nt, int Nw);
 void xf_norm1_d(double *data,long N,int normtype);
 int xf_smoothgauss1_d(double *original, size_t arraysize,int smooth);
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 int xf_auc2_d(double *curvex, double *curvey, size_t nn, int ref, double *result ,char *message);
 int xf_norm2_d(double *data,long ndata,int normtype);
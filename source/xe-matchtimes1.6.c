@@ -1,5 +1,5 @@
 #define thisprog "xe-matchtimes1"
-#define TITLE_STRING thisprog" v 6: 11.February.2014 [JRH]"
+#define TITLE_STRING thisprog" v 7: 18.October.2026 [JRH]"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,6 +14,11 @@
 /*
 <TAGS>database screen</TAGS>
 
+v 7: 18.October.2026 [JRH]
+	- time-windows are now searched using a sorted index (xf_sspindex1_d) instead of testing every window for every line
+		- speeds up matching against large timefiles, particularly for time-ordered datafiles
+		- output is unchanged
+
 v 6: 11.February.2014 [JRH]
 	- simplified and thread-safe implimentation, using xf_lineparse1 to manage words
 	- add ability to do inverse-matching (omit data lines falling within time ranges time-file)
@@ -28,6 +33,8 @@ v 5: 3.Decmber.2012 [JRH]
 
 /* external functions start */
 long *xf_lineparse1(char *line,long *nwords);
+double *xf_sspindex1_d(double *start, double *stop, long nssp, char *message);
+double xf_sspfind1_d(double *index, long nssp, double tt, long *hint);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -41,9 +48,9 @@ int main (int argc, char *argv[]) {
 	double aa,bb,cc;
 	FILE *fpin,*fpout;
 	/* program-specific variables */
-	char infile[256],listfile[256],outfile[256]="stdout",outfile2[256],padstr[64];
-	long nwords=0,*start=NULL;
-	double *tstart=NULL,*tend=NULL;
+	char infile[256],listfile[256],outfile[256]="stdout",outfile2[256],padstr[64],message[MAXLINELEN];
+	long nwords=0,*start=NULL,nindex,hint=0;
+	double *tstart=NULL,*tend=NULL,*tindex=NULL;
 	/* command line variables */
 	int dcol1=1,dcol2=-1,tcol1=1,tcol2=2,setpause=0,setpad=0,setinv=-1;
 
@@ -125,6 +132,11 @@ int main (int argc, char *argv[]) {
 		if(setinv==-1) { fprintf(stderr,"\n--- Warning[%s]: no valid time-windows in list file %s\n\n",thisprog,listfile);free(tstart);free(tend);exit(0);}
 	}
 
+	/* BUILD THE TIME-WINDOW INDEX - windows with NAN boundaries can never match, so leave them out */
+	for(i=nindex=0;i<n;i++) if(!isnan(tstart[i]) && !isnan(tend[i])) { tstart[nindex]=tstart[i]; tend[nindex]=tend[i]; nindex++; }
+	tindex= xf_sspindex1_d(tstart,tend,nindex,message);
+	if(tindex==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+
 	/* DECREMENT DCOL1 AND DCOL2 BECAUSE COLUMN POINTERS FROM xf_lineparse1 WILL BE ZERO-OFFSET */
 	dcol1--;
 	dcol2--;
@@ -149,7 +161,8 @@ int main (int argc, char *argv[]) {
 			if(nwords>=dcol1) {
 				if(sscanf(line+start[dcol1],"%lf",&aa)==1) {
 					if(isfinite(aa)) {
-						for(i=0;i<n;i++) { if(aa>=tstart[i] && aa<=tend[i]) {z*=-1;break;} }
+						/* time must fall within any window: tstart<=aa<=tend */
+						if(xf_sspfind1_d(tindex,nindex,aa,&hint)>=aa) z*=-1;
 			}}}
 			// if time did not fall within any window range continue, or pad as necessary
 			if(z>0) { fprintf(fpout,"%s",line+start[0]); for(i=1;i<nwords;i++) fprintf(fpout,"\t%s",line+start[i]);	fprintf(fpout,"\n"); }
@@ -164,7 +177,9 @@ int main (int argc, char *argv[]) {
 			if(nwords>=dcol1 && nwords>=dcol2) {
 				if(sscanf(line+start[dcol1],"%lf",&aa)==1 && sscanf(line+start[dcol2],"%lf",&bb)==1) {
 					if(isfinite(aa) && isfinite(bb)) {
-						for(i=0;i<n;i++) { if(aa>=tstart[i] && bb>=tstart[i] && aa <=tend[i] && bb <=tend[i]) {z*=-1;break;} }
+						/* both times must fall within the same window: tstart<=min(aa,bb) and max(aa,bb)<=tend */
+						if(aa<=bb) { if(xf_sspfind1_d(tindex,nindex,aa,&hint)>=bb) z*=-1; }
+						else { if(xf_sspfind1_d(tindex,nindex,bb,&hint)>=aa) z*=-1; }
 			}}}
 			// if time did not fall within any window range continue, or pad as necessary
 			if(z>0) { fprintf(fpout,"%s",line+start[0]); for(i=1;i<nwords;i++) fprintf(fpout,"\t%s",line+start[i]);	fprintf(fpout,"\n"); }
@@ -178,6 +193,7 @@ int main (int argc, char *argv[]) {
 
 	free(tstart);
 	free(tend);
+	free(tindex);
 	free(start);
 	exit(0);
 
@@ -2,13 +2,36 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define thisprog "xe-matrixavg2"
-#define TITLE_STRING thisprog" v 1: 10.June.2021 [JRH]"
+#define TITLE_STRING thisprog" v 3: 18.October.2026 [JRH]"
+#define CHUNKSIZE 4096
 
 /*
 <TAGS>math dt.matrix noise</TAGS>
 
+v 3: 18.October.2026 [JRH]
+	- Gaussian smoothing uses direct (double-precision) convolution by default
+		- new option -smfft 1 to use the faster single-precision FFT convolution for large kernels
+		- previously FFT was used automatically for large kernels, which could give large errors near strong peaks
+
+v 2: 18.October.2026 [JRH]
+	- the average is built from running accumulators (xf_matrixaccum1_d) for count, sum and squared deviations
+	- new option -stream 1: read and process one matrix at a time, so memory does not depend on the number of matrices
+	- [infile] can be a comma-separated list of files, processed in parallel (with OpenMP) and merged
+	- new option -out: output the mean, standard deviation, standard error or count for each cell
+	- matrices are rotated back in one batch (xf_matrixorient2_d)
+
+v 1: 18.October.2026 [JRH]
+	- Gaussian smoothing is applied to all matrices at once (xf_smoothgauss3_d)
+		- separable, and uses FFT convolution for large kernels
+	- bugfix: -smy now sets vertical smoothing (previously it reset -smx)
+	- input may be a binary multi-matrix file (see xe-matrixbin1)
+	- add -bin option to output the average in binary (BINXMM) format
+
 v 1: 10.June.2021 [JRH]
 	- add Gaussian smoothing option
 
@@ -56,16 +79,101 @@ v 1: 13.November.2012 [JRH]
 
 /* external functions start */
 double *xf_matrixread1_d(long *nmatrices, long *ncols, long *nrows, char *message, FILE *fpin);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
+long xf_matrixwritebin1_d(FILE *fpout, double *matrix, long nmatrices, long ncols, long nrows, double *id, char *message);
 long xf_spectdenoise1_d(double *matrix1,long width,long height,double setclip,double setz,int setsign,double setper,int setrotate,char *message);
 int xf_matrixrotate2_d(double *data1, long *width, long *height, int r);
-double *xf_matrixavg1_d(double *multimatrix, long n_matrices, long bintot, char message[]);
+double *xf_matrixread3_d(FILE *fpin, long *ncols, long *nrows, char *header, char *message);
+double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message);
+char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
+long *xf_lineparse1(char *line,long *nwords);
+long xf_matrixaccum1_d(double *acc, double *matrix, long bintot);
+void xf_matrixaccmerge1_d(double *acc1, double *acc2, long bintot);
+long xf_matrixaccresult1_d(double *acc, long bintot, double *mean, double *sd, double *sem);
 double *xf_matrixrotate1_d(double *data1, long *width, long *height, int r);
 long xf_norm3_d(double *data,long ndata,int normtype,long start,long stop,char *message);
 long xf_interp3_d(double *data, long ndata);
 int xf_filter_bworth_matrix1_d(double *matrix1, size_t width, size_t height, float sample_freq, float low_freq, float high_freq, float res, char *message);
-int xf_smoothgauss2_d(double *data,int xbintot,int ybintot,int xsmooth,int ysmooth);
+int xf_smoothgauss3_d(double *data, long nmaps, long xbintot, long ybintot, long xsmooth, long ysmooth, int setfft, char *message);
+// NOTE: the following function declarations are commented out to avoid re-initialization in kiss headers,
+// They are included here only so xs-progcompile (which won't detect that they are commented out) will include them during compilation
+/*
+void kiss_fftr(kiss_fftr_cfg st,const kiss_fft_scalar *timedata,kiss_fft_cpx *freqdata);
+void kiss_fft(kiss_fft_cfg cfg,const kiss_fft_cpx *fin,kiss_fft_cpx *fout);
+*/
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
+int xf_matrixorient2_d(double *data, long nmatrices, long *width, long *height, int op);
 /* external functions end */
 
+/* processing options - file-scope so they are available to xe_matrixavg2_process */
+int setsign=0,setrotate=0,setnorm=-1,setsmx =0,setsmy=0,setsmfft=0;
+long setn1=-1,setn2=-1;
+float setflo=0.0,setfhi=0.0,setfsr=1.0;
+double setclip=-1.0,setz=NAN,setp=25.0;
+
+/* de-noise, normalise, filter and smooth a block of nmatrices matrices, in place */
+/* - firstmatrix is the number of the first matrix in the input, for reporting */
+static int xe_matrixavg2_process(double *data1, long nmatrices1, long ncols1, long nrows1, long firstmatrix, char *message) {
+
+	int z;
+	long ii,jj,kk,mm,nn,bintot1=ncols1*nrows1;
+	double bb,*pmatrix=NULL,*pmatrix2=NULL;
+
+	for(ii=0;ii<nmatrices1;ii++) {
+		pmatrix= data1+(ii*bintot1);
+
+		if(setrotate==1) {z= xf_matrixrotate2_d(pmatrix,&ncols1,&nrows1,-90); if(z<0) return(-1); }
+
+		/* APPLY DE-NOISING IF REQUIRED */
+		if(isfinite(setz)) {
+			mm= xf_spectdenoise1_d(pmatrix,ncols1,nrows1,setclip,setz,setsign,setp,0,message);
+			if(mm==-1) return(-1);
+			bb= 100.0*(double)mm/(double)ncols1;
+			fprintf(stderr,"matrix= %ld sd= %g per= %g abs= %d rotate= %d noise= %.2f %% count=%ld\n",(firstmatrix+ii+1),setz,setp,setsign,setrotate,bb,mm);
+		}
+
+		/* APPLY INTERPOLATION-IN-TIME AS REQUIRED FOR FILTERING OR NORMALIZATION */
+		if(setflo>0.0 || setfhi>0.0 || setnorm>=0) {
+			for(jj=0;jj<nrows1;jj++) kk= xf_interp3_d(pmatrix+(jj*ncols1),ncols1);
+		}
+
+		/* APPLY NORMALIZATION ON EACH ROW */
+		if(setnorm>=0) {
+			for(jj=0;jj<nrows1;jj++) {
+				pmatrix2=data1+(ii*bintot1+jj*ncols1);
+				kk= xf_norm3_d(pmatrix2,ncols1,setnorm,setn1,setn2,message);
+				if(kk==-2) return(-1);
+				if(ii==-1) {
+					fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message);
+					for(kk=0;kk<ncols1;kk++) pmatrix2[kk]= NAN;
+		}}}
+
+		/* APPLY FILTERING ON EACH ROW  */
+		if(setflo>0.0 || setfhi>0.0) {
+			z= xf_filter_bworth_matrix1_d(pmatrix,ncols1,nrows1,setfsr,setflo,setfhi,1.4142,message);
+			if(z!=0) return(-1);
+		}
+
+		/* restore the matrix dimensions for the next matrix - this matrix stays rotated until after smoothing */
+		if(setrotate==1) { kk=ncols1; ncols1=nrows1; nrows1=kk; }
+	}
+
+	/* APPLY GAUSSIAN SMOOTHING IN 2-DIMENSIONS - ALL MATRICES AT ONCE */
+	if(setsmx >0.0 || setsmy>0.0) {
+		if(setrotate==1) { mm=nrows1; nn=ncols1; } else { mm=ncols1; nn=nrows1; }
+		z= xf_smoothgauss3_d(data1,nmatrices1,mm,nn,setsmx,setsmy,setsmfft,message);
+		if(z!=0) return(-1);
+	}
+
+	/* ROTATE THE MATRICES BACK - ALL AT ONCE */
+	if(setrotate==1) {
+		mm=nrows1; nn=ncols1;
+		z= xf_matrixorient2_d(data1,nmatrices1,&mm,&nn,2); if(z<0) return(-1);
+	}
+
+	return(0);
+}
+
 int main (int argc, char *argv[]) {
 	/* general variables */
 	char *line=NULL,*templine=NULL,*pline,*pcol;
@@ -77,13 +185,13 @@ int main (int argc, char *argv[]) {
 	/* program-specific variables */
 	char message[256];
 	long n1,nrows1,ncols1,nmatrices1,bintot1;
-	double *data1=NULL,*pmatrix=NULL,*pmatrix2=NULL,*mean1=NULL;
+	double *pmatrix=NULL,*pmatrix2=NULL,*mean1=NULL;
+	char **filelist=NULL;
+	long nfiles=0,*filecols=NULL,*filerows=NULL,*filecount=NULL;
+	double **acc=NULL,*sd1=NULL,*sem1=NULL;
 	/* arguments */
 	char *infile1=NULL;
-	int setsign=0,setrotate=0,setnorm=-1,setsmx =0,setsmy=0;
-	long setn1=-1,setn2=-1;
-	float setflo=0.0,setfhi=0.0,setfsr=1.0;
-	double setclip=-1.0,setz=NAN,setp=25.0;
+	int setbin=0,setstream=0,setout=0;
 
 	/* PRINT INSTRUCTIONS IF THERE IS NO FILENAME SPECIFIED */
 	if(argc<2) {
@@ -100,9 +208,11 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"\n");
 		fprintf(stderr,"USAGE: %s [infile] [options]\n",thisprog);
 		fprintf(stderr,"	[infile]: file (or \"stdin\") containing data matrix/matrices\n");
+		fprintf(stderr,"		- or a comma-separated list of files, processed in parallel\n");
 		fprintf(stderr,"		- format: space-delimited numbers in columns and rows\n");
 		fprintf(stderr,"		- matrix separator= blank or lines beginning with \"#\"\n");
 		fprintf(stderr,"		- missing values require placeholders (NAN, \"-\", etc.)\n");
+		fprintf(stderr,"		- may also be a binary multi-matrix file (see xe-matrixbin1)\n");
 		fprintf(stderr,"\n");
 		fprintf(stderr,"DE-NOISING OPTIONS aplied to each matrix: defaults in []\n");
 		fprintf(stderr,"	-z: Z-score threshold for noise at each freq (NAN=skip) [%g]\n",setz);
@@ -134,10 +244,23 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"SMOOTHING OPTIONS (applied in 2D): \n");
 		fprintf(stderr,"	-smx: horizontal smoothing (samples) [%d]\n",setsmx );
 		fprintf(stderr,"	-smy: vertical smoothing (samples) [%d]\n",setsmy);
+		fprintf(stderr,"	-smfft: use FFT convolution for large kernels (0=NO 1=YES) [%d]\n",setsmfft);
+		fprintf(stderr,"		- faster, but single-precision: values near strong peaks may be inaccurate\n");
+		fprintf(stderr,"\n");
+		fprintf(stderr,"OUTPUT OPTIONS: \n");
+		fprintf(stderr,"	-stream: read one matrix at a time (0=NO 1=YES) [%d]\n",setstream);
+		fprintf(stderr,"		- memory use does not depend on the number of matrices\n");
+		fprintf(stderr,"	-out: statistic for each cell [%d]\n",setout);
+		fprintf(stderr,"		0= mean\n");
+		fprintf(stderr,"		1= standard deviation\n");
+		fprintf(stderr,"		2= standard error of the mean\n");
+		fprintf(stderr,"		3= count of valid values\n");
+		fprintf(stderr,"		4= mean, SD and SEM, as a multi-matrix (\"# mean\", etc)\n");
+		fprintf(stderr,"	-bin: output in binary multi-matrix format (0=NO 1=YES) [%d]\n",setbin);
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s matrix.txt\n",thisprog);
 		fprintf(stderr,"OUTPUT:\n");
-		fprintf(stderr,"	A single average of the individual matrices\n");
+		fprintf(stderr,"	A single average of the individual matrices (or see -out)\n");
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"\n");
 		exit(0);
@@ -160,10 +283,18 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-flo")==0)  setflo=atof(argv[++ii]);
 			else if(strcmp(argv[ii],"-fhi")==0)  setfhi=atof(argv[++ii]);
 			else if(strcmp(argv[ii],"-smx")==0)  setsmx=atoi(argv[++ii]);
-			else if(strcmp(argv[ii],"-smy")==0)  setsmx=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-smy")==0)  setsmy=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-smfft")==0) setsmfft=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-bin")==0)  setbin=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-stream")==0) setstream=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-out")==0)  setout=atoi(argv[++ii]);
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
 	}}
 	if(setsign<-1||setsign>1) {fprintf(stderr,"\n--- Error[%s]: invalid -s [%d] must be -1, 0 or 1\n\n",thisprog,setsign);exit(1);}
+	if(setstream!=0&&setstream!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -stream [%d] must be 0 or 1\n\n",thisprog,setstream);exit(1);}
+	if(setout<0||setout>4) {fprintf(stderr,"\n--- Error[%s]: invalid -out [%d] must be 0-4\n\n",thisprog,setout);exit(1);}
+	if(setbin!=0&&setbin!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -bin [%d] must be 0 or 1\n\n",thisprog,setbin);exit(1);}
+	if(setsmfft!=0&&setsmfft!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -smfft [%d] must be 0 or 1\n\n",thisprog,setsmfft);exit(1);}
 	if(setrotate!=0&&setrotate!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -r [%d] must be 0 or 1\n\n",thisprog,setrotate);exit(1);}
 	if(setz==0.0) {fprintf(stderr,"\n--- Error[%s]: invalid -z [%g], cannot be zero\n\n",thisprog,setz);exit(1);}
 	if(setp<=0.0) {fprintf(stderr,"\n--- Error[%s]: invalid -per [%g], must be >0\n\n",thisprog,setp);exit(1);}
@@ -172,77 +303,101 @@ int main (int argc, char *argv[]) {
 	if(setflo<0.0) {fprintf(stderr,"\n--- Error[%s]: invalid -flo [%g], must be >=0\n\n",thisprog,setflo);exit(1);}
 	if(setfhi<0.0) {fprintf(stderr,"\n--- Error[%s]: invalid -fhi [%g], must be >=0\n\n",thisprog,setfhi);exit(1);}
 
-	/* STORE MULTI-MATRIX DATA #1  */
-	n1=nrows1=ncols1=nmatrices1=0;
-	if(strcmp(infile1,"stdin")==0) fpin=stdin;
-	else if((fpin=fopen(infile1,"r"))==0) {fprintf(stderr,"\n\a--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile1);exit(1);}
-	data1= xf_matrixread1_d(&nmatrices1,&ncols1,&nrows1,message,fpin);
-	if(strcmp(infile1,"stdin")!=0) fclose(fpin);
-	if(data1==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
-
-	/* GET SOME PARAMETERS */
-	bintot1= nrows1*ncols1;
-	n1= bintot1*nmatrices1;
-	bb=0.00;
-	mm=0;
-
-	for(ii=0;ii<nmatrices1;ii++) {
-		pmatrix= data1+(ii*bintot1);
-
-		if(setrotate==1) {z= xf_matrixrotate2_d(pmatrix,&ncols1,&nrows1,-90); if(z<0){ fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }}
-
-		/* APPLY DE-NOISING IF REQUIRED */
-		if(isfinite(setz)) {
-			mm= xf_spectdenoise1_d(pmatrix,ncols1,nrows1,setclip,setz,setsign,setp,0,message);
-			if(mm==-1) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
-			bb= 100.0*(double)mm/(double)ncols1;
-			fprintf(stderr,"matrix= %ld sd= %g per= %g abs= %d rotate= %d noise= %.2f %% count=%ld\n",(ii+1),setz,setp,setsign,setrotate,bb,mm);
-		}
-
-		/* APPLY INTERPOLATION-IN-TIME AS REQUIRED FOR FILTERING OR NORMALIZATION */
-		if(setflo>0.0 || setfhi>0.0 || setnorm>=0) {
-			for(jj=0;jj<nrows1;jj++) kk= xf_interp3_d(pmatrix+(jj*ncols1),ncols1);
-		}
-
-		/* APPLY NORMALIZATION ON EACH ROW */
-		if(setnorm>=0) {
-			for(jj=0;jj<nrows1;jj++) {
-				pmatrix2=data1+(ii*bintot1+jj*ncols1);
-				kk= xf_norm3_d(pmatrix2,ncols1,setnorm,setn1,setn2,message);
-				if(kk==-2) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
-				if(ii==-1) {
-					fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message);
-					for(kk=0;kk<ncols1;kk++) pmatrix2[kk]= NAN;
-		}}}
-
-		/* APPLY FILTERING ON EACH ROW  */
-		if(setflo>0.0 || setfhi>0.0) {
-			z= xf_filter_bworth_matrix1_d(pmatrix,ncols1,nrows1,setfsr,setflo,setfhi,1.4142,message);
-			if(z!=0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
-		}
-
-		/* APPLY GAUSSIAN SMOOTHING IN 2-DIMENSIONS */
-		if(setsmx >0.0 || setsmy>0.0) {
-			z= xf_smoothgauss2_d(pmatrix,ncols1,nrows1,setsmx,setsmy);
-			if(z!=0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	/* BUILD THE LIST OF INPUT FILES */
+	for(pline=infile1;(pline=strtok(pline,","))!=NULL;pline=NULL) {
+		if((filelist=realloc(filelist,(nfiles+1)*sizeof(*filelist)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		filelist[nfiles++]= pline;
+	}
+	if(nfiles<1) {fprintf(stderr,"\n--- Error[%s]: no input file specified\n\n",thisprog);exit(1);}
+	for(ii=0;ii<nfiles;ii++) if(strcmp(filelist[ii],"stdin")==0 && nfiles>1) {fprintf(stderr,"\n--- Error[%s]: \"stdin\" cannot be part of a list of files\n\n",thisprog);exit(1);}
+	acc= calloc(nfiles,sizeof(*acc));
+	filecols= calloc(nfiles,sizeof(*filecols));
+	filerows= calloc(nfiles,sizeof(*filerows));
+	filecount= calloc(nfiles,sizeof(*filecount));
+	if(acc==NULL||filecols==NULL||filerows==NULL||filecount==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+
+	/* READ AND PROCESS EACH FILE, ADDING THE MATRICES TO A SET OF ACCUMULATORS FOR EACH FILE */
+	/* - the whole file is stored and processed at once, or (-stream 1) one matrix at a time */
+	#pragma omp parallel for schedule(dynamic)
+	for(ii=0;ii<nfiles;ii++) {
+		char tmessage[256],theader[256];
+		long tcols,trows,tnmatrices,tbintot,kk;
+		double *tdata=NULL;
+		FILE *tfpin;
+		if(strcmp(filelist[ii],"stdin")==0) tfpin=stdin;
+		else if((tfpin=fopen(filelist[ii],"r"))==0) {fprintf(stderr,"\n\a--- Error[%s]: file \"%s\" not found\n\n",thisprog,filelist[ii]);exit(1);}
+		theader[0]= tmessage[0]= '\n'; theader[1]= tmessage[1]= '\0';
+		while(1) {
+			tcols=trows=tnmatrices=0;
+			if(setstream==1) {
+				tdata= xf_matrixread3_d(tfpin,&tcols,&trows,theader,tmessage);
+				if(trows<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,tmessage); exit(1); }
+				if(tdata==NULL) break;
+				tnmatrices= 1;
+			}
+			else {
+				if(filecount[ii]>0) break;
+				tdata= xf_matrixread1_d(&tnmatrices,&tcols,&trows,tmessage,tfpin);
+				if(tdata==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,tmessage); exit(1); }
+			}
+			tbintot= tcols*trows;
+			/* the first matrix sets the dimensions, and the accumulators are allocated */
+			if(filecount[ii]==0) {
+				filecols[ii]= tcols; filerows[ii]= trows;
+				acc[ii]= calloc(3*tbintot,sizeof(*acc[ii]));
+				if(acc[ii]==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			}
+			else if(tcols!=filecols[ii] || trows!=filerows[ii]) {fprintf(stderr,"\n--- Error[%s]: matrix %ld in %s has %ld columns and %ld rows - the first matrix has %ld and %ld\n\n",thisprog,(filecount[ii]+1),filelist[ii],tcols,trows,filecols[ii],filerows[ii]);exit(1);}
+			if(xe_matrixavg2_process(tdata,tnmatrices,tcols,trows,filecount[ii],tmessage)!=0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,tmessage); exit(1); }
+			for(kk=0;kk<tnmatrices;kk++) xf_matrixaccum1_d(acc[ii],(tdata+kk*tbintot),tbintot);
+			filecount[ii]+= tnmatrices;
+			free(tdata);
 		}
-
-		if(setrotate==1) {z= xf_matrixrotate2_d(pmatrix,&ncols1,&nrows1,90); if(z<0){ fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }}
+		if(strcmp(filelist[ii],"stdin")!=0) fclose(tfpin);
 	}
 
-
+	/* MERGE THE ACCUMULATORS - ALL FILES MUST HOLD MATRICES OF THE SAME SIZE */
+	for(ii=0;ii<nfiles;ii++) if(filecount[ii]>0) break;
+	if(ii==nfiles) {fprintf(stderr,"\n--- Error[%s]: no matrices in input\n\n",thisprog);exit(1);}
+	kk= ii;
+	ncols1= filecols[kk];
+	nrows1= filerows[kk];
+	bintot1= nrows1*ncols1;
+	for(ii=kk+1;ii<nfiles;ii++) {
+		if(filecount[ii]==0) continue;
+		if(filecols[ii]!=ncols1 || filerows[ii]!=nrows1) {fprintf(stderr,"\n--- Error[%s]: matrices in %s (%ld x %ld) differ in size from those in %s (%ld x %ld)\n\n",thisprog,filelist[ii],filecols[ii],filerows[ii],filelist[kk],ncols1,nrows1);exit(1);}
+		xf_matrixaccmerge1_d(acc[kk],acc[ii],bintot1);
+	}
 
 	/* CALCULATE THE AVERAGE, EXCLUDING NANs */
-	mean1= xf_matrixavg1_d(data1,nmatrices1,bintot1,message);
-	if(mean1==NULL) { fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message); exit(1);}
-	n1=nrows1*ncols1;
-
-	/* OUTPUT THE RESULTING AVERAGE MATRIX */
-	for(ii=jj=0;ii<n1;ii++) { printf("%g",mean1[ii]); if(++jj<ncols1) printf(" "); else { jj=0;printf("\n"); } }
+	mean1= malloc(3*bintot1*sizeof(*mean1));
+	if(mean1==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+	sd1= mean1+bintot1;
+	sem1= mean1+2*bintot1;
+	xf_matrixaccresult1_d(acc[kk],bintot1,mean1,sd1,sem1);
+	if(setout==1) pmatrix= sd1;
+	else if(setout==2) pmatrix= sem1;
+	else if(setout==3) { pmatrix= acc[kk]; }
+	else pmatrix= mean1;
+	n1= (setout==4) ? 3 : 1;
+
+	/* OUTPUT THE RESULTING MATRIX (OR MATRICES) */
+	if(setbin==1) {
+		if(xf_matrixwritebin1_d(stdout,pmatrix,n1,ncols1,nrows1,NULL,message)<0) { fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message); exit(1);}
+	}
+	else for(kk=0;kk<n1;kk++) {
+		if(setout==4) printf("%s\n",(kk==0?"# mean":(kk==1?"# sd":"# sem")));
+		pmatrix2= pmatrix+kk*bintot1;
+		for(ii=jj=0;ii<bintot1;ii++) { printf("%g",pmatrix2[ii]); if(++jj<ncols1) printf(" "); else { jj=0;printf("\n"); } }
+	}
 
 	/* CLEANUP AND EXIT */
-	if(line!=NULL) free(line);
-	if(data1!=NULL) free(data1);
+	for(ii=0;ii<nfiles;ii++) if(acc[ii]!=NULL) free(acc[ii]);
+	free(acc);
+	free(filecols);
+	free(filerows);
+	free(filecount);
+	free(filelist);
 	if(mean1!=NULL) free(mean1);
 	exit(0);
 }
@@ -4,12 +4,21 @@
 #include <string.h>
 
 #define thisprog "xe-matrixbands1"
-#define TITLE_STRING thisprog" v 1: 3.February.2021 [JRH]"
+#define TITLE_STRING thisprog" v 3: 18.October.2026 [JRH]"
 #define MAXBANDS 16
 
 /*
 <TAGS>math dt.matrix noise</TAGS>
 
+v 3: 18.October.2026 [JRH]
+	- add -bin option to output the band AUCs for each matrix as a binary (BINXMM) record
+	- bugfix: bands are no longer taken as differences of a running sum over the row, which lost
+	  precision when the row held much larger values outside the band - output matches v 1 again
+
+v 2: 18.October.2026 [JRH]
+	- all bands for all rows are calculated by one function call (xf_matrixbands1_d)
+	- rows are processed in parallel blocks if compiled with OpenMP
+
 v 1: 3.February.2021 [JRH]
 */
 
@@ -20,11 +29,16 @@ long *xf_lineparse1(char *line,long *nwords);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long *xf_definebands1(char *setbands,float *bstart1,float *bstop1, long *btot, char *messsage);
 double *xf_matrixread3_d(FILE *fpin, long *ncols, long *nrows, char *header, char *message1);
+double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message);
+long xf_matrixwritebin2_d(FILE *fpout, double *matrix, long ncols, long nrows, double id, char *message);
 int xf_matrixrotate2_d(double *matrix1, long *width, long *height, int r);
 double *xf_matrixtrans1_d(double *data1, long *width, long *height);
 
-int xf_auc1_d(double *curvey, long nn, double interval, int ref, double *result ,char *message1);
+int xf_matrixbands1_d(double *matrix, long nrows, long ncols, long *bstart, long *bstop, long nbands, double interval, double *result, char *message);
+int xf_auc1_d(double *curvey, long nn, double interval, int ref, double *result ,char *message);
 
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
+int xf_matrixorient2_d(double *data, long nmatrices, long *width, long *height, int op);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -43,7 +57,7 @@ int main (int argc, char *argv[]) {
 	/* program-specific variables */
 	char header[256],message1[256],message2[256];
 	long *ids=NULL,nids=0,idmax=-1,n1,nrows1,ncols1,nmatrices,bintot1;
-	double *matrix1=NULL,*pmatrix=NULL;
+	double *matrix1=NULL,*bandauc=NULL,*pauc=NULL;
 
 	/* band definition */
 	char setbandsdefault[]= "delta,.5,4,theta,4,12,beta,12,30,gamma,30,100"; // delta= Buzsaki, theta= Whishaw, beta= Magill (20Hz mean), gamma= mixedreferences
@@ -53,7 +67,7 @@ int main (int argc, char *argv[]) {
 
 	/* arguments */
 	char *infile1=NULL,*setheadids=NULL,*setbands=NULL,setyunits[256]="time";
-	int setrotate=0,settrans=0;
+	int setrotate=0,settrans=0,setbin=0;
 	long setn1=-1,setn2=-1;
 	double setxmin=1,setxint=1,setymin=1.0,setyint=1.0;
 
@@ -97,6 +111,11 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"    -bands: CSV band-triplets: name,start,stop\n");
 		fprintf(stderr,"        - default: %s\n",setbandsdefault);
 		fprintf(stderr,"\n");
+		fprintf(stderr,"    -bin: output in binary multi-matrix format (0=NO 1=YES) [%d]\n",setbin);
+		fprintf(stderr,"        - one matrix per input matrix: columns= bands, rows= times\n");
+		fprintf(stderr,"        - a header-less record stream: convert with xe-matrixbin1 if an offset table is needed\n");
+		fprintf(stderr,"        - the ID stored for each matrix is the numeric value of the first -ids field (NAN if unset)\n");
+		fprintf(stderr,"\n");
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"    %s in.txt -xmin 0.5 -xint 0.5 -ids 2,4,6\n",thisprog);
 		fprintf(stderr,"    %s in.txt -bands delta,.5,.4,theta,4,12\n",thisprog);
@@ -122,10 +141,12 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-ids")==0) setheadids= argv[++ii];
 			else if(strcmp(argv[ii],"-rot")==0)  setrotate= atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-trans")==0)  settrans= atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-bin")==0)  setbin= atoi(argv[++ii]);
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
 	}}
 	if(settrans!=0 && settrans!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -trans [%d]: must be 0 or 1\n\n",thisprog,settrans);exit(1);}
 	if(setrotate!=0 && setrotate!=-90 && setrotate!=90 && setrotate!=180) {fprintf(stderr,"\n--- Error[%s]: invalid -rot [%d]: must be 0,-90, 90, or 180\n\n",thisprog,setrotate);exit(1);}
+	if(setbin!=0 && setbin!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -bin [%d]: must be 0 or 1\n\n",thisprog,setbin);exit(1);}
 
 
 	/********************************************************************************
@@ -175,10 +196,12 @@ int main (int argc, char *argv[]) {
 	// TEST:for(ii=0;ii<btot;ii++) printf("band:%ld \tA1:%g \tZ1:%g \tA2:%ld \tZ2:%ld\n",ii,bstart1[ii],bstop1[ii],bstart2[ii],bstop2[ii]);
 
 	/* PRINT HEADER */
-	for(ii=0;ii<nids;ii++) printf("id%ld\t",ids[ii]);
-	printf("%s",setyunits);
-	for(ii=0;ii<btot;ii++) printf("\tband%ld",ii);
-	printf("\n");
+	if(setbin==0) {
+		for(ii=0;ii<nids;ii++) printf("id%ld\t",ids[ii]);
+		printf("%s",setyunits);
+		for(ii=0;ii<btot;ii++) printf("\tband%ld",ii);
+		printf("\n");
+	}
 
 	/* INITIALISE HEADER & MESSAGES ARRAYS - THIS IS REQUIRED FOR THE MATRIX READ FUNCTION */
 	header[0]='\n'  ; header[1]='\0';
@@ -220,6 +243,21 @@ int main (int argc, char *argv[]) {
 		}
 
 
+		/* CALCULATE AUC-VALUES FOR ALL BANDS IN ALL ROWS */
+		bandauc= realloc(bandauc,(nrows1*btot+1)*sizeof(*bandauc));
+		if(bandauc==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		z= xf_matrixbands1_d(matrix1,nrows1,ncols1,bstart2,bstop2,btot,setxint,bandauc,message1);
+		if(z!=0) { fprintf(stderr,"\b\n\t--- %s/%s\n\n",thisprog,message1); exit(1); }
+
+		/* BINARY OUTPUT: WRITE THE AUC-VALUES AS A RECORD */
+		if(setbin==1) {
+			if(nids<1 || sscanf((message2+iword[(ids[0]-1)]),"%lf",&aa)!=1) aa= NAN;
+			if(xf_matrixwritebin2_d(stdout,bandauc,btot,nrows1,aa,message1)<0) { fprintf(stderr,"\b\n\t--- %s/%s\n\n",thisprog,message1); exit(1); }
+			free(matrix1);
+			matrix1= NULL;
+			continue;
+		}
+
 		/* FOR EACH ROW (TIME), PRINT ID'S, TIME, AND AUC-VALUES FOR EACH BAND */
 		printf("\n");
 		for(row=0;row<nrows1;row++) {
@@ -227,20 +265,16 @@ int main (int argc, char *argv[]) {
 			for(ii=0;ii<nids;ii++) printf("%s\t",message2+iword[(ids[ii]-1)]);
 			/* print the y-value */
 			printf("%g",(setymin+ setyint*row));
-			/* calculate and print AUC for each band */
+			/* print AUC for each band */
+			pauc= bandauc+row*btot;
 			for(band=0;band<btot;band++) {
-				mm= bstop2[band] - bstart2[band];
-				pmatrix= matrix1+(row*ncols1)+bstart2[band];
-				for(kk=0;kk<mm;kk++) if(!isfinite(pmatrix[kk])) break;
-				if(kk==mm) {
-					x= xf_auc1_d(pmatrix,mm,setxint,0,result_d,message2);
-					if(x!=0) { fprintf(stderr,"\b\n\t--- %s/%s\n\n",thisprog,message2); exit(1); }
-					printf("\t%g",result_d[0]);
-				}
+				if(isfinite(pauc[band])) printf("\t%g",pauc[band]);
 				else printf("\tNaN");
 			}
 			printf("\n");
 		}
+		free(matrix1);
+		matrix1= NULL;
 	}
 
 
@@ -252,6 +286,7 @@ END:
 
 	if(ibands!=NULL) free(ibands);
 	if(matrix1!=NULL) free(matrix1);
+	if(bandauc!=NULL) free(bandauc);
 
 	exit(0);
 }
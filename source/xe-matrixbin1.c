@@ -0,0 +1,167 @@
+#define thisprog "xe-matrixbin1"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+<TAGS>dt.matrix file</TAGS>
+
+v 2: 18.October.2026 [JRH]
+	- binary input with ASCII or summary output (all matrices) is read one matrix at a time
+		- allows conversion of header-less record streams whose matrices differ in size (e.g. from xe-matrixsplit1)
+
+v 1: 18.October.2026 [JRH]
+	- first version: convert multi-matrix files between ASCII and binary (BINXMM) formats
+	- binary input allows direct access to a single matrix (-k) without reading the others
+*/
+
+
+/* external functions start */
+long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1, long *ncols, long *nrows, char *message);
+char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
+long *xf_lineparse1(char *line,long *nwords);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
+double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message);
+long xf_matrixwritebin1_d(FILE *fpout, double *matrix, long nmatrices, long ncols, long nrows, double *id, char *message);
+/* external functions end */
+
+/* print matrix kk in ASCII - the header line holds the id if there is one, otherwise matrices are separated by a blank line */
+void matrixbin1_printascii(double *matrix, long width, long height, double id, long kk) {
+	long ii,count,nn=width*height;
+	if(isfinite(id)) {
+		if(id==(long)id) printf("# %ld\n",(long)id);
+		else printf("# %.16f\n",id);
+	}
+	else if(kk>0) printf("\n");
+	for(ii=count=0;ii<nn;ii++) {
+		if(++count>=width) { printf("%g\n",matrix[ii]); count=0; }
+		else printf("%g\t",matrix[ii]);
+	}
+}
+
+int main (int argc, char *argv[]) {
+
+	/* general variables */
+	char message[256];
+	long ii,jj,kk,nn;
+	FILE *fpin;
+	/* program-specific variables */
+	int firstbyte;
+	int sizevaries=0;
+	long nmatrices,nmatout,width,height,width0=0,height0=0;
+	double aa,*matrix1=NULL,*id1=NULL,*pmatrix1;
+	/* arguments */
+	char *infile;
+	int setout=1;
+	long setidcol=1,setk=-1;
+
+	/********************************************************************************/
+	/* PRINT INSTRUCTIONS IF THERE IS NO FILENAME SPECIFIED */
+	/********************************************************************************/
+	if(argc<2) {
+		fprintf(stderr,"\n");
+		fprintf(stderr,"----------------------------------------------------------------------\n");
+		fprintf(stderr,"%s\n",TITLE_STRING);
+		fprintf(stderr,"----------------------------------------------------------------------\n");
+		fprintf(stderr,"Convert a multi-matrix file between ASCII and binary (BINXMM) formats\n");
+		fprintf(stderr,"- ASCII: matrices separated by blank lines or \"# <id-number>\" lines\n");
+		fprintf(stderr,"- binary: header, offset table, and one record per matrix\n");
+		fprintf(stderr,"	- the xe-matrix* programs detect binary input automatically\n");
+		fprintf(stderr,"	- no parsing is required, and any matrix can be read directly\n");
+		fprintf(stderr,"USAGE: %s [matrix] [options]\n",thisprog);
+		fprintf(stderr,"	[matrix]: file or \"stdin\" in (multi)matrix format, ASCII or binary\n");
+		fprintf(stderr,"VALID OPTIONS (defaults in []):\n");
+		fprintf(stderr,"	-idcol: (ASCII input) column on comment-lines holding the ID [%ld]\n",setidcol);
+		fprintf(stderr,"	-k: zero-offset number of the matrix to output (-1= all) [%ld]\n",setk);
+		fprintf(stderr,"	-out: output format [%d]\n",setout);
+		fprintf(stderr,"		0= ASCII\n");
+		fprintf(stderr,"		1= binary\n");
+		fprintf(stderr,"		2= summary (matrices, columns, rows)\n");
+		fprintf(stderr,"		   - columns and rows are \"-\" if the matrices differ in size\n");
+		fprintf(stderr,"	NOTE: matrices of different sizes (a binary record stream from xe-matrixsplit1)\n");
+		fprintf(stderr,"		can be converted to ASCII or summarised, or extracted with -k\n");
+		fprintf(stderr,"EXAMPLES:\n");
+		fprintf(stderr,"	%s matrix.txt -out 1 > matrix.bin\n",thisprog);
+		fprintf(stderr,"	%s matrix.bin -out 0 -k 5\n",thisprog);
+		fprintf(stderr,"	xe-matrixavg2 matrix.bin\n");
+		fprintf(stderr,"----------------------------------------------------------------------\n");
+		fprintf(stderr,"\n");
+		exit(0);
+	}
+
+
+	/* READ THE FILENAME AND OPTIONAL ARGUMENTS */
+	infile= argv[1];
+	for(ii=2;ii<argc;ii++) {
+		if( *(argv[ii]+0) == '-') {
+			if((ii+1)>=argc) {fprintf(stderr,"\n--- Error[%s]: missing value for argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
+			else if(strcmp(argv[ii],"-idcol")==0) setidcol= atol(argv[++ii]);
+			else if(strcmp(argv[ii],"-k")==0) setk= atol(argv[++ii]);
+			else if(strcmp(argv[ii],"-out")==0) setout= atoi(argv[++ii]);
+			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
+	}}
+	if(setout<0 || setout>2) { fprintf(stderr,"\n--- Error [%s]: invalid -out [%d] must be 0,1 or 2\n\n",thisprog,setout);exit(1);}
+	if(setk<-1) { fprintf(stderr,"\n--- Error [%s]: invalid -k [%ld] must be -1 or a matrix number\n\n",thisprog,setk);exit(1);}
+
+	/* STORE THE MULTI-MATRIX - FOR BINARY INPUT AND A SINGLE MATRIX, READ ONLY THAT MATRIX */
+	if(strcmp(infile,"stdin")==0) fpin=stdin;
+	else if((fpin=fopen(infile,"rb"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
+	firstbyte= fgetc(fpin);
+	if(firstbyte!=EOF) ungetc(firstbyte,fpin);
+	/* binary input, all matrices, ASCII or summary output: read one matrix at a time, so matrices may differ in size */
+	if(firstbyte==0x89 && setk<0 && setout!=1) {
+		nmatrices= 0;
+		while((matrix1=xf_matrixreadbin2_d(fpin,&width,&height,&aa,message))!=NULL) {
+			if(nmatrices==0) { width0= width; height0= height; }
+			else if(width!=width0 || height!=height0) sizevaries= 1;
+			if(setout==0) matrixbin1_printascii(matrix1,width,height,aa,nmatrices);
+			free(matrix1);
+			nmatrices++;
+		}
+		if(height<0) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
+		if(strcmp(infile,"stdin")!=0) fclose(fpin);
+		if(setout==2) {
+			printf("matrices\tcolumns\trows\n");
+			if(sizevaries) printf("%ld\t-\t-\n",nmatrices);
+			else printf("%ld\t%ld\t%ld\n",nmatrices,width0,height0);
+		}
+		exit(0);
+	}
+	else if(firstbyte==0x89) {
+		matrix1= xf_matrixreadbin1_d(fpin,setk,&nmatrices,&width,&height,&id1,message);
+		if(matrix1==NULL) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
+		if(strcmp(infile,"stdin")!=0) fclose(fpin);
+		nmatout= (setk<0) ? nmatrices : 1;
+		pmatrix1= matrix1;
+	}
+	else {
+		if(strcmp(infile,"stdin")!=0) fclose(fpin);
+		nmatrices= xf_matrixread2_d(infile,setidcol,&matrix1,&id1,&width,&height,message);
+		if(nmatrices==-1) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
+		if(setk>=nmatrices) {fprintf(stderr,"\n--- Error[%s]: -k (%ld) requested but input contains %ld matrices\n\n",thisprog,setk,nmatrices);exit(1);}
+		nmatout= (setk<0) ? nmatrices : 1;
+		pmatrix1= (setk<0) ? matrix1 : matrix1+(setk*width*height);
+		if(setk>=0) id1[0]= id1[setk];
+	}
+	nn= width*height;
+
+	/* OUTPUT */
+	if(setout==2) {
+		printf("matrices\tcolumns\trows\n");
+		printf("%ld\t%ld\t%ld\n",nmatrices,width,height);
+	}
+	else if(setout==1) {
+		if(xf_matrixwritebin1_d(stdout,pmatrix1,nmatout,width,height,id1,message)<0) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
+	}
+	else {
+		for(kk=0;kk<nmatout;kk++) matrixbin1_printascii((pmatrix1+kk*nn),width,height,id1[kk],kk);
+	}
+
+	/* FREE MEMORY AND EXIT */
+	if(matrix1!=NULL) free(matrix1);
+	if(id1!=NULL) free(id1);
+	exit(0);
+}
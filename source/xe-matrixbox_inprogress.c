@@ -18,6 +18,7 @@
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse1(char *line,long *nwords);
 double *xf_matrixread3_d(FILE *fpin, long *ncols, long *nrows, char *header, char *message);
+double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message);
 long xf_getindex1_d(double min, double max, long n, double value, char *message);
 double xf_matrixbox1_d(double *matrix1, long nx, long ny, double *range, double *box, int mode, char *message);
 /* external functions end */
@@ -1,5 +1,5 @@
 #define thisprog "xe-matrixcut1"
-#define TITLE_STRING thisprog" v 1: 2.March.2018 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 
 #include <math.h>
 #include <stdio.h>
@@ -9,6 +9,9 @@
 /*
 <TAGS>dt.matrix</TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- add -bin option to output the matching matrices in binary (BINXMM) format, with their IDs
+
 v 1: 2.March.2018 [JRH]
 	- user can now define whether a header-comment is included in output
 
@@ -22,6 +25,8 @@ v 1: 22.October.2017 [JRH]
 
 /* external functions start */
 long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1, long *ncols, long *nrows, char *message);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
+long xf_matrixwritebin1_d(FILE *fpout, double *matrix, long nmatrices, long ncols, long nrows, double *id, char *message);
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse1(char *line,long *nwords);
 /* external functions end */
@@ -37,7 +42,7 @@ int main (int argc, char *argv[]) {
 	double *matrix1=NULL,*id1=NULL,*pmatrix1;
 	/* arguments */
 	char *filematrix;
-	int sethead=1;
+	int sethead=1,setbin=0;
 	long setidcol=1;
 	double setid=1.0;
 
@@ -57,7 +62,9 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"VALID OPTIONS (defaults in []):\n");
 		fprintf(stderr,"	-idcol: zero-offset column on comment-lines holding the ID [%ld]\n",setidcol);
 		fprintf(stderr,"	-id:  numeric ID to match [%g]\n",setid);
-		fprintf(stderr,"	-head:  output header line (0=NO 1=YES) [%g]\n",sethead);
+		fprintf(stderr,"	-head:  output header line (0=NO 1=YES) [%d]\n",sethead);
+		fprintf(stderr,"	-bin: output in binary multi-matrix format (0=NO 1=YES) [%d]\n",setbin);
+		fprintf(stderr,"		NOTE: -head is ignored - IDs are stored in the binary file\n");
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s matrix.txt -id 001\n",thisprog);
 		fprintf(stderr,"----------------------------------------------------------------------\n");
@@ -74,15 +81,29 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-idcol")==0) setidcol= atol(argv[++ii]);
 			else if(strcmp(argv[ii],"-id")==0) setid= atof(argv[++ii]);
 			else if(strcmp(argv[ii],"-head")==0) sethead= atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-bin")==0) setbin= atoi(argv[++ii]);
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
 	}}
 	if(sethead!=0 && sethead!=1) { fprintf(stderr,"\n--- Error [%s]: invalid -head [%d] must be 0 or 1\n\n",thisprog,sethead);exit(1);}
+	if(setbin!=0&&setbin!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -bin [%d] must be 0 or 1\n\n",thisprog,setbin);exit(1);}
 
 	/* STORE THE MULTI-MATRIX */
 	nmatrices= xf_matrixread2_d(filematrix,setidcol,&matrix1,&id1,&width,&height,message);
 	if(nmatrices==-1) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
 	nn= width*height;
 
+	/* BINARY OUTPUT: MOVE THE MATCHING MATRICES AND IDS TO THE START OF THE ARRAYS AND WRITE THEM IN ONE CALL */
+	if(setbin==1) {
+		for(kk=count=0;kk<nmatrices;kk++) {
+			if(id1[kk]!=setid) continue;
+			if(count<kk) { for(ii=0;ii<nn;ii++) matrix1[count*nn+ii]= matrix1[kk*nn+ii]; id1[count]= id1[kk]; }
+			count++;
+		}
+		if(count==0) {fprintf(stderr,"\n--- Error[%s]: no matrices match -id %g\n\n",thisprog,setid);exit(1);}
+		if(xf_matrixwritebin1_d(stdout,matrix1,count,width,height,id1,message)<0) { fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message); exit(1);}
+		nmatrices= 0;
+	}
+
 	/* OUTPUT EACH MATRIX MATCHING THE ID  */
 	for(kk=0;kk<nmatrices;kk++) {
 		if(id1[kk]==setid) {
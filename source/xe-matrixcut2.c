@@ -1,5 +1,5 @@
 #define thisprog "xe-matrixcut2"
-#define TITLE_STRING thisprog" 7.February.2021 [JRH]"
+#define TITLE_STRING thisprog" 18.October.2026 [JRH]"
 
 #include <math.h>
 #include <stdio.h>
@@ -9,6 +9,9 @@
 /*
 <TAGS>dt.matrix</TAGS>
 
+18.October.2026 [JRH]
+	- add -bin option to output the matching matrices in binary (BINXMM) format, one record at a time
+
 7.February.2021 [JRH]
 	- allow setting of decimal precision for output
 
@@ -20,6 +23,8 @@
 
 /* external functions start */
 double *xf_matrixread3_d(FILE *fpin, long *ncols, long *nrows, char *header, char *message);
+double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message);
+long xf_matrixwritebin2_d(FILE *fpout, double *matrix, long ncols, long nrows, double id, char *message);
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse1(char *line,long *nwords);
 /* external functions end */
@@ -37,7 +42,7 @@ int main (int argc, char *argv[]) {
 	double *matrix1=NULL,iddouble=0.0;
 	/* arguments */
 	char *infile,*setid=NULL;
-	int sethead=1,setmatch=2,setp=-1;
+	int sethead=1,setmatch=2,setp=-1,setbin=0;
 	long setcol=1;
 
 	/********************************************************************************/
@@ -63,6 +68,10 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"        -2 : %%f \n");
 		fprintf(stderr,"	-1 : %%g (minimum required decimals, may truncate to 4 places)\n");
 		fprintf(stderr,"      >= 0 : value represents decimal precision\n");
+		fprintf(stderr,"    -bin   : output in binary multi-matrix format (0=NO 1=YES) [%d]\n",setbin);
+		fprintf(stderr,"        - a header-less record stream: convert with xe-matrixbin1 if an offset table is needed\n");
+		fprintf(stderr,"        - the ID stored for each matrix is the numeric value of the -col word (NAN if none)\n");
+		fprintf(stderr,"        - -head and -p are ignored\n");
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s matrix.txt -col 4 -id dose3 -match 2\n",thisprog);
 		fprintf(stderr,"	%s matrix.txt -col 7 -id 0.50 -match 4\n",thisprog);
@@ -81,10 +90,12 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-match")==0) setmatch=atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-head")==0)  sethead= atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-p")==0)     setp=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-bin")==0)   setbin=atoi(argv[++ii]);
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
 	}}
 	if(setmatch<1 || setmatch>4) { fprintf(stderr,"\n--- Error [%s]: invalid -match [%d] must be 1-4\n\n",thisprog,setmatch);exit(1);}
 	if(sethead!=0 && sethead!=1) { fprintf(stderr,"\n--- Error [%s]: invalid -head [%d] must be 0 or 1\n\n",thisprog,sethead);exit(1);}
+	if(setbin!=0&&setbin!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -bin [%d] must be 0 or 1\n\n",thisprog,setbin);exit(1);}
 	if(setcol<=0) { fprintf(stderr,"\n--- Error [%s]: invalid -col [%d] must be >0\n\n",thisprog,sethead);exit(1);}
 
 	/* adjust setcol to reflect the zero-offset word-pointers returned from xf_lineparse1 */
@@ -121,7 +132,13 @@ int main (int argc, char *argv[]) {
 			/* reject if the id-column isnt a numerical match (long) */
 			if(setmatch==4 && atof(pcol)!=iddouble) continue;
 		}
-		/* otherwise, output the current header and matrix */
+		/* otherwise, output the current matrix as a binary record... */
+		if(setbin==1) {
+			if(nwords<=setcol || sscanf((tempheader+start[setcol]),"%lf",&aa)!=1) aa= NAN;
+			if(xf_matrixwritebin2_d(stdout,matrix1,width,height,aa,message)<0) {fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message);exit(1);}
+			continue;
+		}
+		/* ...or output the current header and matrix */
 		if(sethead==1) printf("%s",header);
 		for(ii=0;ii<height;ii++) {
 			kk= ii*width;
@@ -17,6 +17,7 @@
 
 /* external functions start */
 double *xf_matrixread3_d(FILE *fpin, long *ncols, long *nrows, char *header, char *message);
+double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message);
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse1(char *line,long *nwords);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
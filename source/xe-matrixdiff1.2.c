@@ -4,13 +4,23 @@
 #include <string.h>
 
 #define thisprog "xe-matrixdiff1"
-#define TITLE_STRING thisprog" v 2: 13.April.2013 [JRH]"
+#define TITLE_STRING thisprog" v 4: 18.October.2026 [JRH]"
 #define MAXLINELEN 10000
 #define MAXLABELS 1000
 
 /*
 <TAGS>math dt.matrix</TAGS>
 
+v 4: 18.October.2026 [JRH]
+	- add -bin option to output the result in binary (BINXMM) format
+
+v 3: 18.October.2026 [JRH]
+	- read input using xf_matrixread2_d, so binary (BINXMM) multi-matrix files and "stdin" are accepted
+	- transpose each multi-matrix once, so the values for each bin are contiguous
+		- previously the values were gathered from every matrix for every bin
+	- bins are tested in parallel if compiled with OpenMP, and the results printed afterwards
+	- paired tests now require the same number of matrices in each input
+
 v 2: 13.April.2013 [JRH]
 	- add t-test as a way of determining sifgnificant differences - independent or paired
 
@@ -18,7 +28,12 @@ v 2: 13.April.2013 [JRH]
 
 
 /* external functions start */
-double *xf_matrixread1_d(long *nmatrices, long *ncols, long *nrows, char *message, FILE *fpin);
+long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1, long *ncols, long *nrows, char *message);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
+long xf_matrixwritebin1_d(FILE *fpout, double *matrix, long nmatrices, long ncols, long nrows, double *id, char *message);
+char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
+long *xf_lineparse1(char *line,long *nwords);
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
 long xf_stats3_d(double *data, long n, int varcalc, double *result_d);
 int xf_ttest2_d(double *data1, double *data2, long n1, long n2, int varcalc, double *result_d);
 int xf_ttest3_d(double *data1, double *data2, long n, int varcalc, double *result_d);
@@ -39,11 +54,11 @@ int main (int argc, char *argv[]) {
 	long *tot1=NULL,*tot2=NULL;
 	double *data1=NULL,*mean1=NULL,*sd1=NULL,*sem1=NULL;
 	double *data2=NULL,*mean2=NULL,*sd2=NULL,*sem2=NULL;
-	double *tempdata1=NULL,*tempdata2=NULL;
-	double diff,tstat,tcrit;
+	double *tempdata1=NULL,*tempdata2=NULL,*id1=NULL,*id2=NULL,*result=NULL;
 	/* arguments */
 	int setpaired=0;
 	int settype=1;
+	int setbin=0;
 	float setalpha=0.05;
 
 	/* PRINT INSTRUCTIONS IF THERE IS NO FILENAME SPECIFIED */
@@ -66,11 +81,12 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"USAGE:\n");
 		fprintf(stderr,"	%s [infile1] [infile2]\n",thisprog);
 		fprintf(stderr,"\n");
-		fprintf(stderr,"	[infile1]: file containing reference data matrix/matrices\n");
+		fprintf(stderr,"	[infile1]: file containing reference data matrix/matrices, or \"stdin\"\n");
 		fprintf(stderr,"		- format: space-delimited numbers in columns and rows\n");
 		fprintf(stderr,"		- multiple matrices must be separated by a blank line\n");
 		fprintf(stderr,"		- lines beginning with \"#\" may also separate matrices\n");
 		fprintf(stderr,"		- missing values require placeholders (NAN, \"-\", etc.)\n");
+		fprintf(stderr,"		- binary multi-matrix files (e.g. from xe-matrixsplit1) are detected automatically\n");
 		fprintf(stderr,"	[infile2]: the reference matrix is subtracted from this\n");
 		fprintf(stderr,"\n");
 		fprintf(stderr,"VALID OPTIONS:\n");
@@ -81,6 +97,7 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"			1= difference (mean2-mean1)\n");
 		fprintf(stderr,"			2= ratio (mean2/mean1)\n");
 		fprintf(stderr,"			3= t-statistic on the differences\n");
+		fprintf(stderr,"		-bin: output in binary multi-matrix format (0=NO 1=YES) [%d]\n",setbin);
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s matrix1.txt matrix2.txt -p 1 -a 0.01\n",thisprog);
 		fprintf(stderr,"OUTPUT:\n");
@@ -100,56 +117,59 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[i],"-p")==0) 	{ setpaired=atoi(argv[i+1]); i++;}
 			else if(strcmp(argv[i],"-a")==0) 	{ setalpha=atof(argv[i+1]); i++;}
 			else if(strcmp(argv[i],"-t")==0) 	{ settype=atoi(argv[i+1]); i++;}
+			else if(strcmp(argv[i],"-bin")==0) 	{ setbin=atoi(argv[i+1]); i++;}
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[i]); exit(1);}
 	}}
 
 	if(settype<1||settype>3) {fprintf(stderr,"\n\a--- Error[%s]: invalid -t (%d) - must be 1,2 or 3\n\n",thisprog,settype);exit(1);}
 	if(setpaired!=0&&setpaired!=1) {fprintf(stderr,"\n\a--- Error[%s]: invalid -p (%d) - must be 0 or 1\n\n",thisprog,setpaired);exit(1);}
+	if(setbin!=0&&setbin!=1) {fprintf(stderr,"\n\a--- Error[%s]: invalid -bin (%d) - must be 0 or 1\n\n",thisprog,setbin);exit(1);}
 	if(setalpha!=1.0F && setalpha!=0.05F && setalpha!=0.02F && setalpha!=0.01F && setalpha!=0.002F && setalpha!=0.001F) {fprintf(stderr,"\n\a--- Error[%s]: invalid -a (%g) - must be .05 .02 .01 .002 or .001\n\n",thisprog,setalpha);exit(1);}
 
 
 	/* STORE MULTI-MATRIX DATA #1  */
-	n1=ntot1=nrows1=ncols1=nmatrices1=0;
-	if((fpin=fopen(infile1,"r"))==0) {fprintf(stderr,"\n\a--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile1);exit(1);}
-	data1= xf_matrixread1_d(&nmatrices1,&ncols1,&nrows1,message,fpin);
-	fclose(fpin);
-	if(data1==NULL) {fprintf(stderr,"\n\a--- Error[%s]: file %s: %s\n\n",thisprog,infile1,message);exit(1);}
+	nmatrices1= xf_matrixread2_d(infile1,1,&data1,&id1,&ncols1,&nrows1,message);
+	if(nmatrices1<0) {fprintf(stderr,"\n\a--- Error[%s]: file %s: %s\n\n",thisprog,infile1,message);exit(1);}
+	if(nmatrices1==0) {fprintf(stderr,"\n\a--- Error[%s]: file %s: no matrices found\n\n",thisprog,infile1);exit(1);}
 	bintot1= nrows1*ncols1;
-	ntot1= n1*nmatrices1;
 
 	/* STORE MULTI-MATRIX DATA #2  */
-	n2=ntot2=nrows2=ncols2=nmatrices2=0;
-	if((fpin=fopen(infile2,"r"))==0) {fprintf(stderr,"\n\a--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile2);exit(1);}
-	data2= xf_matrixread1_d(&nmatrices2,&ncols2,&nrows2,message,fpin);
-	fclose(fpin);
-	if(data2==NULL) {fprintf(stderr,"\n\a--- Error[%s]: file %s: %s\n\n",thisprog,infile2,message);exit(1);}
+	nmatrices2= xf_matrixread2_d(infile2,1,&data2,&id2,&ncols2,&nrows2,message);
+	if(nmatrices2<0) {fprintf(stderr,"\n\a--- Error[%s]: file %s: %s\n\n",thisprog,infile2,message);exit(1);}
+	if(nmatrices2==0) {fprintf(stderr,"\n\a--- Error[%s]: file %s: no matrices found\n\n",thisprog,infile2);exit(1);}
 	bintot2= nrows2*ncols2;
-	ntot2= n2*nmatrices2;
 
 	/* MAKE SURE THE TEMPLATE MATRICES FROM EACH FILE HAVE THE SAME DIMENSIONS */
 	if(nrows2!=nrows1) {fprintf(stderr,"\n\a--- Error[%s]: number of matrix-rows differs between \"%s\" and \"%s\"\n\n",thisprog,infile1,infile2);exit(1);}
 	if(ncols2!=ncols1) {fprintf(stderr,"\n\a--- Error[%s]: number of matrix-columns differs between \"%s\" and \"%s\"\n\n",thisprog,infile1,infile2);exit(1);}
+	if(setpaired==1 && nmatrices2!=nmatrices1) {fprintf(stderr,"\n\a--- Error[%s]: paired test requires the same number of matrices in \"%s\" (%ld) and \"%s\" (%ld)\n\n",thisprog,infile1,nmatrices1,infile2,nmatrices2);exit(1);}
 
-	/* RESERVE MEMORY FOR RESULTS MATRICES */
-	if((tempdata1=(double *)realloc(tempdata1,nmatrices1*sizeof(double)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
-	if((tempdata2=(double *)realloc(tempdata2,nmatrices2*sizeof(double)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
-
+	/* TRANSPOSE EACH MULTI-MATRIX (ONE ROW PER MATRIX) SO THAT EACH ROW HOLDS THE VALUES FOR ONE BIN */
+	if((tempdata1=(double *)malloc(nmatrices1*bintot1*sizeof(double)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+	if((tempdata2=(double *)malloc(nmatrices2*bintot2*sizeof(double)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+	xf_matrixorient1_d(data1,tempdata1,bintot1,nmatrices1,1);
+	xf_matrixorient1_d(data2,tempdata2,bintot2,nmatrices2,1);
+	free(data1); data1= tempdata1; tempdata1= NULL;
+	free(data2); data2= tempdata2; tempdata2= NULL;
 
-	/* CALCULATE THE DIFFERENCE FOR EACH BIN - INDEPENDENT SAMPLES */
-	if(setpaired==0) for(i=col=0;i<bintot1;i++) {
+	/* RESERVE MEMORY FOR THE RESULT */
+	if((result=(double *)malloc(bintot1*sizeof(double)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
 
-		/* collect the data from the current bin for each matrix */
-		for(j=0;j<nmatrices1;j++) tempdata1[j]=data1[j*bintot1+i];
-		for(j=0;j<nmatrices2;j++) tempdata2[j]=data2[j*bintot1+i];
+	/* CALCULATE THE DIFFERENCE FOR EACH BIN - INDEPENDENT OR PAIRED SAMPLES */
+	#pragma omp parallel for schedule(dynamic,64)
+	for(i=0;i<bintot1;i++) {
+		long df;
+		double aa,bb,cc,diff,tstat,tcrit,result_d[64];
 
-		/* get the stats */
-		z= xf_ttest2_d(tempdata1,tempdata2,nmatrices1,nmatrices2,1,result_d);
+		/* the values for the current bin from each matrix are contiguous */
+		if(setpaired==0) xf_ttest2_d((data1+i*nmatrices1),(data2+i*nmatrices2),nmatrices1,nmatrices2,1,result_d);
+		else xf_ttest3_d((data1+i*nmatrices1),(data2+i*nmatrices2),nmatrices1,1,result_d);
 
 		tstat= result_d[0];
 		df= (long)result_d[1];
 		aa= result_d[4]; // mean, group1
 		bb= result_d[5]; // mean, group2
-		diff= result_d[6]; // difference
+		diff= result_d[6]; // difference (valid pairs only, if paired)
 
 		if(setalpha!=1.0F) tcrit= xf_crit_T1(df,setalpha,2);
 		else tcrit=0.0;
@@ -157,52 +177,20 @@ int main (int argc, char *argv[]) {
 		if(fabs(tstat)<tcrit) cc= NAN;
 		else if(settype==1) cc= diff;
 		else if(settype==2) cc= bb/aa;
-		else if(settype==3) cc= tstat;
-
-// if(i==0) {
-// 	for(j=0;j<nmatrices1;j++) fprintf(stderr,"%d	%g\n",j,tempdata1[j]);
-// 	fprintf(stderr,"mean1:%g\n\n",aa);
-// 	for(j=0;j<nmatrices2;j++) fprintf(stderr,"%d	%g\n",j,tempdata2[j]);
-// 	fprintf(stderr,"mean2:%g\n\n",bb);
-//
-// 	fprintf(stderr,"diff:%g\n\n",diff);
-// 	fprintf(stderr,"cc:%g\n\n",cc);
-// }
-
-		printf("%g",cc);
-		if(++col<ncols1) printf(" ");
-		else { col=0;printf("\n"); }
-
+		else cc= tstat;
+		result[i]= cc;
 	}
 
-	/* CALCULATE THE DIFFERENCE FOR EACH BIN - PAIRED SAMPLES */
-	if(setpaired==1) for(i=col=0;i<bintot1;i++) {
-
-		/* collect the data from the current bin for each matrix */
-		for(j=0;j<nmatrices1;j++) tempdata1[j]=data1[j*bintot1+i];
-		for(j=0;j<nmatrices2;j++) tempdata2[j]=data2[j*bintot1+i];
-
-		/* get the stats */
-		z= xf_ttest3_d(tempdata1,tempdata2,nmatrices1,1,result_d);
-
-		tstat= result_d[0];
-		df= (long)result_d[1];
-		aa= result_d[4]; // mean, group1
-		bb= result_d[5]; // mean, group2
-		diff= result_d[6]; // difference, valid pairs only
-
-		if(setalpha!=1.0F) tcrit= xf_crit_T1(df,setalpha,2);
-		else tcrit=0.0;
-
-		if(fabs(tstat)<tcrit) cc= NAN;
-		else if(settype==1) cc= diff;
-		else if(settype==2) cc= bb/aa;
-		else if(settype==3) cc= tstat;
-
-		printf("%g",cc);
-		if(++col<ncols1) printf(" ");
-		else { col=0;printf("\n"); }
-
+	/* OUTPUT THE RESULT */
+	if(setbin==1) {
+		if(xf_matrixwritebin1_d(stdout,result,1,ncols1,nrows1,NULL,message)<0) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
+	}
+	else {
+		for(i=col=0;i<bintot1;i++) {
+			printf("%g",result[i]);
+			if(++col<ncols1) printf(" ");
+			else { col=0;printf("\n"); }
+		}
 	}
 
 FINISH:
@@ -211,6 +199,9 @@ FINISH:
  	if(data2!=NULL) free(data2);
  	if(tempdata1!=NULL) free(tempdata1);
  	if(tempdata2!=NULL) free(tempdata2);
+ 	if(id1!=NULL) free(id1);
+ 	if(id2!=NULL) free(id2);
+ 	if(result!=NULL) free(result);
 
 	exit(0);
 	}
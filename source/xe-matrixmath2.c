@@ -1,6 +1,7 @@
-#define thisprog "xe-matrixsub1"
-#define TITLE_STRING thisprog" 2.February.2021 [JRH]"
+#define thisprog "xe-matrixmath2"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
+#define MAXOPS 64
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -10,51 +11,81 @@
 /*
 <TAGS>math dt.matrix math </TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- now a small expression engine: any number of operations are applied left to right in one call
+		- operands may be matrices (files) or constants
+		- new operations: log, zscore
+		- each output matrix has all operations applied before moving to the next, while it is in the cache
+		- the arithmetic is done by xf_matrixmath1_d, whose loops can be vectorised by the compiler
+	- multi-matrix input: every matrix is processed (previously only the first)
+		- an operand with one matrix is applied to every matrix of the input (broadcast), and vice versa
+	- binary (BINXMM) input is detected automatically, and -bin 1 gives binary output
+	- -nan option: non-finite values may be ignored (as before) or propagated
+	- if compiled with OpenMP, matrices are processed in parallel
+
 2.February.2021 [JRH]"
 	- new program to adjust matrix1 based on contents of matrix2
 */
 
 
 /* external functions start */
-double *xf_matrixread1_d(long *nmatrices, long *ncols, long *nrows, char *message, FILE *fpin);
+long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1, long *ncols, long *nrows, char *message);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
+char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
+long *xf_lineparse1(char *line,long *nwords);
+long xf_matrixwritebin1_d(FILE *fpout, double *matrix, long nmatrices, long ncols, long nrows, double *id, char *message);
+int xf_matrixmath1_d(double *data1, double *data2, double constant, long bintot, int op, int nanrule, char *message);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
 	/* general variables */
-	char outfile[256],*line=NULL,message[MAXLINELEN];
-	long ii,jj,kk,mm,nn,maxlinelen=0;
+	char *line=NULL,message[MAXLINELEN],*pchar;
+	long ii,jj,kk,mm,nn;
 	int v,w,x,y,z;
-	float a,b,c,d;
-	double aa,bb,cc,dd, result_d[64];
-	FILE *fpin1,*fpin2,*fpout;
+	double aa,bb,cc,dd;
+	FILE *fpin;
 	/* program-specific variables */
-	int mode;
-	long width1,height1,width2,height2,nmatrices,n1,n2;
-	double *dat1=NULL,*dat2=NULL;
+	char *opname[]= {"","add","sub","mul","div","log","zscore"};
+	int opcode[MAXOPS],error=0;
+	long width1,height1,width2,height2,nmatrices1,nmatrices2,nout,bintot,nops=0,opn[MAXOPS];
+	double *dat1=NULL,*id1=NULL,*dat2=NULL,*id2=NULL,*result=NULL,*idout=NULL,*opdata[MAXOPS],*opid[MAXOPS],opconst[MAXOPS];
 	/* arguments */
-	char *infile1=NULL,*infile2=NULL,*setmode=NULL;
+	char *infile1=NULL,*operand[MAXOPS];
+	int setnan=0,setbin=0;
 
 	/* PRINT INSTRUCTIONS IF THERE IS NO FILENAME SPECIFIED */
-	if(argc<4) {
+	if(argc<3) {
 		fprintf(stderr,"\n");
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"%s\n",TITLE_STRING);
 		fprintf(stderr,"----------------------------------------------------------------------\n");
-		fprintf(stderr,"- Adjust matrix-1 using the corresponding cell in matrix-2\n");
-		fprintf(stderr,"- Both matrices must have identical dimensions\n");
-		fprintf(stderr,"- Both should contain only numerical values - no headers or labels\n");
-		fprintf(stderr,"- Non-numbers in matrix-2 won't affect the corresponding martix-1 cell\n");
+		fprintf(stderr,"- Apply a sequence of operations to matrix-1, cell by cell\n");
+		fprintf(stderr,"- Operations are applied left to right, in a single pass through the data\n");
+		fprintf(stderr,"- Operands are matrices (files) or numbers (constants)\n");
+		fprintf(stderr,"    - matrices must have the same number of rows and columns\n");
+		fprintf(stderr,"    - multi-matrix files must have the same number of matrices, or one\n");
+		fprintf(stderr,"      (a single matrix is applied to every matrix in the other file)\n");
+		fprintf(stderr,"- Input should contain only numerical values - no headers or labels\n");
+		fprintf(stderr,"    - multiple matrices are separated by blank or \"# <id>\" lines\n");
+		fprintf(stderr,"    - binary (BINXMM) input is detected automatically\n");
 		fprintf(stderr,"- NOTE: consecutive delimiters (tabs or spaces) are treated as one\n");
-		fprintf(stderr,"USAGE: %s [matrix-1] [mode] [matrix-2]  [options]\n",thisprog);
-		fprintf(stderr,"    [matrix1] : original matrix filename or \"stdin\"\n");
-		fprintf(stderr,"    [mode]: add,sub,mul,div\n");
-		fprintf(stderr,"    [matrix2] : matrix of modifiers - filename\n");
+		fprintf(stderr,"USAGE: %s [matrix-1] [op] [operand] [op] [operand]... [options]\n",thisprog);
+		fprintf(stderr,"    [matrix-1] : original matrix filename or \"stdin\"\n");
+		fprintf(stderr,"    [op]: operation - followed by an operand for add,sub,mul,div\n");
+		fprintf(stderr,"        add, sub, mul, div: combine with operand (matrix or number)\n");
+		fprintf(stderr,"        log: natural logarithm\n");
+		fprintf(stderr,"        zscore: convert each matrix to z-scores (mean=0, sd=1)\n");
+		fprintf(stderr,"    [operand] : matrix filename (not \"stdin\"), or a number\n");
 		fprintf(stderr,"VALID OPTIONS:\n");
-		fprintf(stderr,"    - none\n");
+		fprintf(stderr,"    -nan: treatment of non-numbers (NaN, inf) [%d]\n",setnan);
+		fprintf(stderr,"        0= ignore: a non-number in either input leaves the cell unchanged\n");
+		fprintf(stderr,"        1= propagate: a non-number in either input yields NaN\n");
+		fprintf(stderr,"    -bin: output in binary multi-matrix format (0=NO 1=YES) [%d]\n",setbin);
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"    %s matrix1.txt sub matrix2.txt > newmatrix.txt\n",thisprog);
+		fprintf(stderr,"    %s power.bin div baseline.txt log mul 10 -nan 1\n",thisprog);
 		fprintf(stderr,"OUTPUT:\n");
-		fprintf(stderr,"    A modified matrix, sent to standard output\n");
+		fprintf(stderr,"    The modified matrix (or matrices), sent to standard output\n");
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"\n");
 		exit(0);
@@ -62,77 +93,129 @@ int main (int argc, char *argv[]) {
 
 
 	/********************************************************************************
-	READ THE FILENAME AND OPTIONAL ARGUMENTS
+	READ THE FILENAME, THE OPERATIONS AND OPTIONAL ARGUMENTS
 	********************************************************************************/
 	infile1= argv[1];
-	setmode= argv[2];
-	infile2= argv[3];
-	for(ii=4;ii<argc;ii++) {
-		if( *(argv[ii]+0) == '-') {
+	for(ii=2;ii<argc;ii++) {
+		for(x=1;x<=6;x++) if(strcmp(argv[ii],opname[x])==0) break;
+		if(x<=6) {
+			if(nops>=MAXOPS) {fprintf(stderr,"\n--- Error[%s]: too many operations (max %d)\n\n",thisprog,MAXOPS);exit(1);}
+			opcode[nops]= x;
+			operand[nops]= NULL;
+			if(x<=4) {
+				if((ii+1)>=argc) {fprintf(stderr,"\n--- Error[%s]: missing operand for \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
+				operand[nops]= argv[++ii];
+			}
+			nops++;
+		}
+		else if( *(argv[ii]+0) == '-') {
 			if((ii+1)>=argc) {fprintf(stderr,"\n--- Error[%s]: missing value for argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
+			else if(strcmp(argv[ii],"-nan")==0) setnan= atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-bin")==0) setbin= atoi(argv[++ii]);
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
-	}}
-
-	if(strcmp(infile2,"stdin")==0) {fprintf(stderr,"\n--- Error[%s]: matrix-2 cannot be \"stdin\"\n\n",thisprog);exit(1);}
-
-	if(
-		strcmp(setmode,"add")!=0 &&
-		strcmp(setmode,"sub")!=0 &&
-		strcmp(setmode,"mul")!=0 &&
-		strcmp(setmode,"div")!=0
-	) {fprintf(stderr,"\n--- Error[%s]: invalid mode (%s)\n\n",thisprog,setmode);exit(1);}
+		}
+		else {fprintf(stderr,"\n--- Error[%s]: invalid mode (%s)\n\n",thisprog,argv[ii]);exit(1);}
+	}
+	if(nops==0) {fprintf(stderr,"\n--- Error[%s]: no operations specified\n\n",thisprog);exit(1);}
+	if(setnan!=0&&setnan!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -nan [%d] must be 0 or 1\n\n",thisprog,setnan);exit(1);}
+	if(setbin!=0&&setbin!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -bin [%d] must be 0 or 1\n\n",thisprog,setbin);exit(1);}
 
 
 	/********************************************************************************
-	STORE DATA FOR MATRIX-1 : NEWLINE DELIMITED INPUT
+	STORE DATA FOR MATRIX-1
 	********************************************************************************/
-	if(strcmp(infile1,"stdin")==0) fpin1=stdin;
-	else if((fpin1=fopen(infile1,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile1);exit(1);}
-	dat1= xf_matrixread1_d(&nmatrices,&width1,&height1,message,fpin1);
-	if(strcmp(infile1,"stdin")!=0) fclose(fpin1);
-	if(dat1==NULL) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
-	n1= width1*height1;
-	//TEST:for(ii=0;ii<n1;ii++) printf("%g ",dat1[ii]); exit(0);
+	nmatrices1= xf_matrixread2_d(infile1,1,&dat1,&id1,&width1,&height1,message);
+	if(nmatrices1==-1) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
+	if(nmatrices1==0) {fprintf(stderr,"\n--- Error[%s]: file %s contains no matrices\n\n",thisprog,infile1);exit(1);}
+	bintot= width1*height1;
+	nout= nmatrices1;
 
 	/********************************************************************************
-	STORE DATA FOR MATRIX-2 : NEWLINE DELIMITED INPUT
+	STORE THE OPERANDS - CONSTANTS, OR MATRICES WHICH MUST MATCH MATRIX-1
 	********************************************************************************/
-	if((fpin2=fopen(infile2,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile2);exit(1);}
-	dat2= xf_matrixread1_d(&nmatrices,&width2,&height2,message,fpin2);
-	fclose(fpin2);
-	if(dat2==NULL) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
-	n2= width2*height2;
-	//TEST:	for(ii=0;ii<n2;ii++) printf("%g ",dat2[ii]); exit(0);
+	for(kk=0;kk<nops;kk++) {
+		opdata[kk]= opid[kk]= NULL;
+		opconst[kk]= NAN;
+		opn[kk]= 1;
+		if(operand[kk]==NULL) continue;
+		/* a number is a constant (unless it is also the name of a file) */
+		aa= strtod(operand[kk],&pchar);
+		if(pchar!=operand[kk] && *pchar=='\0') {
+			if((fpin=fopen(operand[kk],"r"))==NULL) { opconst[kk]= aa; continue; }
+			fclose(fpin);
+		}
+		if(strcmp(operand[kk],"stdin")==0) {fprintf(stderr,"\n--- Error[%s]: matrix-2 cannot be \"stdin\"\n\n",thisprog);exit(1);}
+		nmatrices2= xf_matrixread2_d(operand[kk],1,&dat2,&id2,&width2,&height2,message);
+		if(nmatrices2==-1) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
+		if(nmatrices2==0) {fprintf(stderr,"\n--- Error[%s]: file %s contains no matrices\n\n",thisprog,operand[kk]);exit(1);}
+		if(height1!=height2) {fprintf(stderr,"\n--- Error[%s]: total lines in %s (%ld) don't match %s (%ld)\n\n",thisprog,infile1,height1,operand[kk],height2);exit(1);}
+		if(width1!=width2)   {fprintf(stderr,"\n--- Error[%s]: total columns in %s (%ld) don't match %s (%ld)\n\n",thisprog,infile1,width1,operand[kk],width2);exit(1);}
+		if(nmatrices2!=1 && nout!=1 && nmatrices2!=nout) {fprintf(stderr,"\n--- Error[%s]: %s contains %ld matrices - must be 1 or %ld\n\n",thisprog,operand[kk],nmatrices2,nout);exit(1);}
+		if(nmatrices2>nout) nout= nmatrices2;
+		opdata[kk]= dat2;
+		opid[kk]= id2;
+		opn[kk]= nmatrices2;
+		dat2= id2= NULL;
+	}
 
 	/********************************************************************************
-	MAKE SURE MATRICES HAVE SAME NUMBER OF ROWS AND COLUMNS
+	ALLOCATE THE OUTPUT - MATRIX-1 IS MODIFIED IN PLACE UNLESS IT MUST BE BROADCAST
 	********************************************************************************/
-	if(height1!=height2) {fprintf(stderr,"\n--- Error[%s]: total lines in %s (%ld) don't match %s (%ld)\n\n",thisprog,infile1,height1,infile2,height2);exit(1);}
-	if(width1!=width2)   {fprintf(stderr,"\n--- Error[%s]: total columns in %s (%ld) don't match %s (%ld)\n\n",thisprog,infile1,width1,infile2,width2);exit(1);}
+	if(nmatrices1==nout) { result= dat1; idout= id1; }
+	else {
+		result= malloc(nout*bintot*sizeof(*result));
+		if(result==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		for(kk=0;kk<nops;kk++) if(opn[kk]==nout) { idout= opid[kk]; break; }
+	}
 
 	/********************************************************************************
-	ADJUST MATRIX-1 BY MATRIX-2
+	APPLY ALL OPERATIONS TO EACH OUTPUT MATRIX IN TURN
 	********************************************************************************/
-	if(strcmp(setmode,"add")==0) for(ii=0;ii<n1;ii++)      { aa=dat1[ii];bb=dat2[ii]; if(isfinite(aa)&&isfinite(bb)) dat1[ii]= aa+bb; }
-	else if(strcmp(setmode,"sub")==0) for(ii=0;ii<n1;ii++) { aa=dat1[ii];bb=dat2[ii]; if(isfinite(aa)&&isfinite(bb)) dat1[ii]= aa-bb; }
-	else if(strcmp(setmode,"mul")==0) for(ii=0;ii<n1;ii++) { aa=dat1[ii];bb=dat2[ii]; if(isfinite(aa)&&isfinite(bb)) dat1[ii]= aa*bb; }
-	else if(strcmp(setmode,"div")==0) for(ii=0;ii<n1;ii++) { aa=dat1[ii];bb=dat2[ii]; if(isfinite(aa)&&isfinite(bb)) dat1[ii]= aa/bb; }
-	else {fprintf(stderr,"\n--- Error[%s]: invalid mode (%s)\n\n",thisprog,setmode);exit(1);}
+	#pragma omp parallel for schedule(dynamic) reduction(|:error)
+	for(mm=0;mm<nout;mm++) {
+		long op;
+		double *pres= result+mm*bintot,*pop;
+		char message2[MAXLINELEN];
+		if(result!=dat1) memcpy(pres,dat1,bintot*sizeof(*pres));
+		for(op=0;op<nops;op++) {
+			if(opdata[op]==NULL) pop= NULL;
+			else pop= opdata[op]+((opn[op]==1)?0:mm)*bintot;
+			if(xf_matrixmath1_d(pres,pop,opconst[op],bintot,opcode[op],setnan,message2)!=0) error=1;
+		}
+	}
+	if(error) {fprintf(stderr,"\n--- Error[%s]: problem applying operations\n\n",thisprog);exit(1);}
 
 	/********************************************************************************
 	OUTPUT
 	********************************************************************************/
-	for(ii=jj=0;ii<n1;ii++) {
-		printf("%g",dat1[ii]);
-		if(++jj<width1) printf("\t");
-		else { printf("\n"); jj=0;}
+	if(setbin==1) {
+		if(xf_matrixwritebin1_d(stdout,result,nout,width1,height1,idout,message)<0) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
+	}
+	else for(kk=0;kk<nout;kk++) {
+		/* for multiple matrices, a header line holds the id if there is one - otherwise matrices are separated by a blank line */
+		if(nout>1) {
+			if(idout!=NULL && isfinite(idout[kk])) {
+				if(idout[kk]==(long)idout[kk]) printf("# %ld\n",(long)idout[kk]);
+				else printf("# %.16f\n",idout[kk]);
+			}
+			else if(kk>0) printf("\n");
+		}
+		for(ii=jj=0,nn=kk*bintot;ii<bintot;ii++,nn++) {
+			printf("%g",result[nn]);
+			if(++jj<width1) printf("\t");
+			else { printf("\n"); jj=0;}
+		}
 	}
 
 	/********************************************************************************/
 	/* CLEANUP AND EXIT */
 	/********************************************************************************/
-END:
+	if(result!=NULL && result!=dat1) free(result);
 	if(dat1!=NULL) free(dat1);
-	if(dat2!=NULL) free(dat2);
+	if(id1!=NULL) free(id1);
+	for(kk=0;kk<nops;kk++) {
+		if(opdata[kk]!=NULL) free(opdata[kk]);
+		if(opid[kk]!=NULL) free(opid[kk]);
+	}
 	exit(0);
 }
@@ -1,5 +1,5 @@
 #define thisprog "xe-matrixmod1"
-#define TITLE_STRING thisprog" v 21.October.2017 [JRH]"
+#define TITLE_STRING thisprog" v 21: 18.October.2026 [JRH]"
 
 #include <math.h>
 #include <stdio.h>
@@ -9,6 +9,13 @@
 /*
 <TAGS>signal_processing dt.matrix transform </TAGS>
 
+v 21: 18.October.2026 [JRH]
+	- add -bin option to output the modified matrix in binary (BINXMM) format
+
+v 20: 18.October.2026 [JRH]
+	- resampling uses the separable engine xf_matrixresample2_d (one pass per dimension, precomputed weights)
+	- new option -rs to choose the resampling method: box (default, results unchanged), linear or Lanczos
+
 v 21.October.2017 [JRH]
 	- update variable naming conventions for ii,jj,kk
 
@@ -85,15 +92,17 @@ v 3: 19.November.2012 [JRH]
 
 /* external functions start */
 double *xf_matrixread1_d(long *nmatrices, long *ncols, long *nrows, char *message, FILE *fpin);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
+long xf_matrixwritebin1_d(FILE *fpout, double *matrix, long nmatrices, long ncols, long nrows, double *id, char *message);
 void xf_norm2_d(double *data,long N,int normtype);
 int xf_smoothgauss2_d(double *data,int xbintot,int ybintot,int xsmooth,int ysmooth);
 double *xf_matrixrotate1_d(double *data1, long *nx1, long *ny1, int r);
-int xf_matrixbin1_d(double *matrix1, long nx1, long ny1, long nx2, long ny2, char *message);
-double *xf_matrixexpand1_d(double *matrix1, long nx1, long ny1, long nx2, long ny2, char *nessage);
+int xf_matrixresample2_d(double *matrix1, long nmatrices, long nx1, long ny1, double *matrix2, long nx2, long ny2, int method, char *message);
 void xf_fishertransform2_d(double *data, long n, int type);
 double *xf_matrixtrans1_d(double *data1, long *width, long *height);
 double *xf_matrixflipy_d(double *data1, long nx, long ny);
 double *xf_matrixflipx_d(double *data1, long nx, long ny);
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -111,7 +120,7 @@ int main (int argc, char *argv[]) {
 	long width1,width2,height1,height2;
 	double *matrix1=NULL,*matrix2=NULL;
 	/* arguments */
-	int setnorm=0,setfishers=0,setxsmooth=0,setysmooth=0,setkeepnans=0,setrotate=0,settrans=0,setflip=0;
+	int setnorm=0,setfishers=0,setxsmooth=0,setysmooth=0,setkeepnans=0,setrotate=0,settrans=0,setflip=0,setresample=0,setbin=0;
 	long setwidth=0,setheight=0;
 
 	/* PRINT INSTRUCTIONS IF THERE IS NO FILENAME SPECIFIED */
@@ -129,10 +138,13 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	-flip : flip matrix (0=NO, 1= x-flip, 2= y-flip) [%d]\n",setflip);
 		fprintf(stderr,"	-t : transpose (0=NO, 1=YES - cannot be combined with rotation) [%d]\n",settrans);
 		fprintf(stderr,"	-r : rotation, in degrees (choose 0,+-90,+-180,+-270) [%d]\n",setrotate);
-		fprintf(stderr,"	-w : width, set (resample) number of columns [%d]\n",setwidth);
-		fprintf(stderr,"	-h : height, set (resample) number of rows [%d]\n",setheight);
-		fprintf(stderr,"		NOTE: expands or averages data in each row/column as needed\n");
+		fprintf(stderr,"	-w : width, set (resample) number of columns [%ld]\n",setwidth);
+		fprintf(stderr,"	-h : height, set (resample) number of rows [%ld]\n",setheight);
 		fprintf(stderr,"		NOTE: set to zero to leave as-is\n");
+	fprintf(stderr,"	-rs : resampling method for -w and -h [%d]\n",setresample);
+		fprintf(stderr,"		0= box: average (downsample) or repeat (upsample) values\n");
+		fprintf(stderr,"		1= linear: triangle filter / linear interpolation\n");
+		fprintf(stderr,"		2= Lanczos: windowed-sinc, sharper but may overshoot at edges\n");
 		fprintf(stderr,"	-sx : 2D gaussian smoothing factor to apply to matrix [%d]\n",setxsmooth);
 		fprintf(stderr,"	-sy : 2D gaussian smoothing factor to apply to matrix [%d]\n",setysmooth);
 		fprintf(stderr,"	-pn : preserve NANs when smoothing (0=NO 1=YES) [%d]\n",setkeepnans);
@@ -141,6 +153,7 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"			transform for r-values\n");
 		fprintf(stderr,"			set to 1 of numbers range from -1 to 1\n");
 		fprintf(stderr,"			set to 2 of numbers range from  0 to 1\n");
+		fprintf(stderr,"	-bin: output in binary multi-matrix format (0=NO 1=YES) [%d]\n",setbin);
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s matrix.txt -n 0 -sx 1 -sy 2 \n",thisprog);
 		fprintf(stderr,"OUTPUT:\n");
@@ -162,9 +175,11 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-f")==0)    setfishers=atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-w")==0)    setwidth=atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-h")==0)    setheight=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-rs")==0)   setresample=atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-sx")==0)   setxsmooth=atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-sy")==0)   setysmooth=atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-pn")==0)   setkeepnans=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-bin")==0)  setbin=atoi(argv[++ii]);
 			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
 	}}
 
@@ -175,7 +190,9 @@ int main (int argc, char *argv[]) {
 	if(settrans!=0&&settrans!=1) {fprintf(stderr,"\n--- Error[%s]: invalid transpose setting (-t %d) \n\n",thisprog,settrans);exit(1);}
 	if(setkeepnans!=0&&setkeepnans!=1) {fprintf(stderr,"\n--- Error[%s]: invalid setting (-pn %d) \n\n",thisprog,setkeepnans);exit(1);}
 	if(settrans==1 && x>0) {fprintf(stderr,"\n--- Error[%s]: cannot both rotate and transpose the input\n\n",thisprog);exit(1);}
+	if(setresample<0 || setresample>2) {fprintf(stderr,"\n--- Error[%s]: invalid -rs (%d) must be 0-2\n\n",thisprog,setresample);exit(1);}
 	if(setflip<0 || setflip>2) {fprintf(stderr,"\n--- Error[%s]: invalid -flip (%d) must be 0-2\n\n",thisprog,setflip);exit(1);}
+	if(setbin!=0&&setbin!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -bin [%d] must be 0 or 1\n\n",thisprog,setbin);exit(1);}
 
 
 	/* STORE THE MATRIX -  THIS METHOD IS ROBUST AGAINST LINES OF UNKNOWN LENGTH */
@@ -202,35 +219,21 @@ int main (int argc, char *argv[]) {
 	if(matrix1==NULL) {fprintf(stderr,"\n--- Error[%s]: rotation function encountered insufficient memory\n\n",thisprog);exit(1);}
 
 
-	/*
-	RESAMPLE THE MATRIX
-	- note that the bin and expand functions will complain if passed arguments indicating the wrong type of modification
-	- hence we call the bin function first, and separately for width and height
-	- then, the expansion function only sees the matrix which has already been binned in one dimension, if required
-	*/
+	/* RESAMPLE THE MATRIX - BOTH DIMENSIONS IN ONE CALL */
 	if(setwidth>0 || setheight>0) {
 		/* for auto settings, assign existing matrix size to setwidth and/or setheight */
 		if(setwidth<=0) setwidth=width1;
 		if(setheight<=0) setheight=height1;
-		/* if matrix is to be downsampled (binned)... */
-		if(setwidth<width1) {
-			z= xf_matrixbin1_d(matrix1,width1,height1,setwidth,height1,message);
-			if(z!=0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
-			width1=setwidth;
-			matrix1=(double *)realloc(matrix1,((width1*height1)*sizeof(double)));
-		}
-		if(setheight<height1) {
-			z= xf_matrixbin1_d(matrix1,width1,height1,width1,setheight,message);
+		if(setwidth!=width1 || setheight!=height1) {
+			matrix2= malloc(setwidth*setheight*sizeof(*matrix2));
+			if(matrix2==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+			z= xf_matrixresample2_d(matrix1,1,width1,height1,matrix2,setwidth,setheight,setresample,message);
 			if(z!=0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
-			height1=setheight;
-			matrix1=(double *)realloc(matrix1,((width1*height1)*sizeof(double)));
-		}
-		/* if matrix is to be expanded... */
-		if(setwidth>width1 || setheight>height1) {
-			matrix1= xf_matrixexpand1_d(matrix1,width1,height1,setwidth,setheight,message);
-			if(matrix1==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
-			if(setwidth>width1) width1=setwidth;
-			if(setheight>height1) height1=setheight;
+			free(matrix1);
+			matrix1= matrix2;
+			matrix2= NULL;
+			width1= setwidth;
+			height1= setheight;
 		}
 		//else {fprintf(stderr,"\n--- Error[%s]: a single call to this program cannot mix matrix downsampling in one dimension with expansion in another: call this program twice instead\n\n",thisprog);exit(1);}
 		N1=width1*height1;
@@ -263,12 +266,17 @@ int main (int argc, char *argv[]) {
 		xf_norm2_d(matrix1,N1,(setnorm-1));
 
  	/* OUTPUT THE MATRIX */
-	for(ii=0;ii<height1;ii++) {
-		jj=ii*width1;
-		kk=jj+width1;
-		printf("%g",matrix1[jj++]);
-		for(jj=jj;jj<kk;jj++) printf(" %g",matrix1[jj]); // only print a tab separator for columns after the first column
-		printf("\n");
+	if(setbin==1) {
+		if(xf_matrixwritebin1_d(stdout,matrix1,1,width1,height1,NULL,message)<0) { fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message); exit(1);}
+	}
+	else {
+		for(ii=0;ii<height1;ii++) {
+			jj=ii*width1;
+			kk=jj+width1;
+			printf("%g",matrix1[jj++]);
+			for(jj=jj;jj<kk;jj++) printf(" %g",matrix1[jj]); // only print a tab separator for columns after the first column
+			printf("\n");
+		}
 	}
 
 	/* FREE MEMORY */
@@ -22,6 +22,8 @@ long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 int xf_matrixflip2_l(long *data1, long *width, long *height, int setflip);
 int xf_matrixrotate2_l(long *data1, long *width, long *height, int r);
 int xf_matrixtrans2_l(long *data1, long *width, long *height);
+int xf_matrixorient1_l(long *data1, long *data2, long nx, long ny, int op);
+int xf_matrixorient2_l(long *data, long nmatrices, long *width, long *height, int op);
 /* external functions end */
 
 
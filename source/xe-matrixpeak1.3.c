@@ -1,5 +1,5 @@
 #define thisprog "xe-matrixpeak1"
-#define TITLE_STRING thisprog" v 3: 15.February.2019 [JRH]"
+#define TITLE_STRING thisprog" v 4: 18.October.2026 [JRH]"
 
 #include <math.h>
 #include <stdio.h>
@@ -9,6 +9,11 @@
 /*
 <TAGS>dt.matrix</TAGS>
 
+v 4: 18.October.2026 [JRH]
+	- peaks are now defined by connected-component labelling (xf_matrixlabel1_d) of all matrices in one call
+		- each matrix is scanned once, rather than once per peak
+		- peaks now include every contiguous pixel above threshold, including those only reachable by a winding path
+
 v 3: 15.February.2019 [JRH]
 	- update variable usage, assign input filename directly from argv[1]
 
@@ -25,7 +30,8 @@ v 2: 20.February.2014 [JRH]
 
 /* external functions start */
 long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1, long *ncols, long *nrows, char *message);
-int xf_matrixpeak1_d(double *data1,int *mask, size_t width, size_t height, double thresh, double *result);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
+long xf_matrixlabel1_d(double *data, long nmatrices, long width, long height, double *thresh, long *label, long *ncomp, double **stats, char *message);
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse1(char *line,long *nwords);
 /* external functions end */
@@ -40,9 +46,9 @@ int main (int argc, char *argv[]) {
 	double aa,bb,cc,dd,result_d[8];
 	FILE *fpin,*fpout;
 	/* program-specific variables */
-	int *mask;
-	long nmatrices,width,height,count=0,peakfound,npeaks;
-	double *matrix1=NULL,*id1=NULL,*pmatrix,max=0,thresh;
+	long nmatrices,width,height,count=0,npeaks,norder,ntot,maxcomp,*label=NULL,*plabel,*ncomp=NULL,*order=NULL;
+	int *done=NULL;
+	double *matrix1=NULL,*id1=NULL,*pmatrix,*thresh=NULL,*stats=NULL,*pstats,*ps,max=0;
 	/* arguments */
 	char *infile;
 	int setfirst=1,setout=1;
@@ -57,10 +63,10 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"%s\n",TITLE_STRING);
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"Detect contiguous pixels exceeding a threshold in individual matrices \n");
-		fprintf(stderr," - this peak starts at the highest-value pixel and propogates outward\n");
-		fprintf(stderr," - diagonal propogation is not permitted\n");
-		fprintf(stderr," - if peak size is below a minimum, another attempt is made\n");
-		fprintf(stderr," - attempts are made until no peak is detected at all\n");
+		fprintf(stderr," - a peak is a contiguous region of pixels exceeding the threshold\n");
+		fprintf(stderr," - diagonal contiguity is not permitted\n");
+		fprintf(stderr," - peaks are reported in order of their highest-value pixel\n");
+		fprintf(stderr," - peaks below a minimum size are skipped\n");
 		fprintf(stderr,"USAGE: %s [matrix] [options]\n",thisprog);
 		fprintf(stderr,"	[matrix]: file or \"stdin\" in (multi)matrix format\n");
 		fprintf(stderr,"		- matrices separated by \"# <id-number>\" lines\n");
@@ -104,10 +110,12 @@ int main (int argc, char *argv[]) {
 	if(nmatrices==-1) {fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
 	if(nmatrices==0)  {fprintf(stderr,"\n--- Error[%s]: file %s contains no matrices\n\n",thisprog,infile);exit(1);}
 
-	/* allocate memory for the mask */
+	/* allocate memory for the labels, thresholds and component-counts */
 	nn= width*height;
-	mask= malloc(nn*sizeof(*mask));
-	if(mask==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+	label= malloc(nmatrices*nn*sizeof(*label));
+	thresh= malloc(nmatrices*sizeof(*thresh));
+	ncomp= malloc(nmatrices*sizeof(*ncomp));
+	if(label==NULL||thresh==NULL||ncomp==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
 
 	/* output the basic stats */
 	if(setout==1 || setout==3) {
@@ -117,36 +125,65 @@ int main (int argc, char *argv[]) {
 	}
 
 	/********************************************************************************/
-	/* FOR EACH MATRIX */
+	/* LABEL THE CONTIGUOUS REGIONS IN ALL MATRICES */
 	/********************************************************************************/
+	/* get the max value for each matrix and set the threshold */
 	for(kk=0;kk<nmatrices;kk++) {
-		/* set the matrix pointer */
 		pmatrix= matrix1+(nn*kk);
-		/* get the max value and update setthresh */
 		max=0; for(ii=0;ii<nn;ii++) { aa= pmatrix[ii]; if(isfinite(aa) && aa>max) max=aa; }
-		thresh= max*setthresh;
-		/* initialize the mask */
-		for(ii=0;ii<nn;ii++) mask[ii]=0;
+		thresh[kk]= max*setthresh;
+	}
+	ntot= xf_matrixlabel1_d(matrix1,nmatrices,width,height,thresh,label,ncomp,&stats,message);
+	if(ntot<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	/* allocate memory for the peak-order and already-reported flags */
+	maxcomp=0; for(kk=0;kk<nmatrices;kk++) if(ncomp[kk]>maxcomp) maxcomp=ncomp[kk];
+	order= malloc((maxcomp+1)*sizeof(*order));
+	done= malloc((maxcomp+1)*sizeof(*done));
+	if(order==NULL||done==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+
+	/********************************************************************************/
+	/* FOR EACH MATRIX */
+	/********************************************************************************/
+	pstats= stats;
+	for(kk=0;kk<nmatrices;kk++) {
+		/* set the matrix, label and statistics pointers */
+		pmatrix= matrix1+(nn*kk);
+		plabel= label+(nn*kk);
+		if(kk>0) pstats+= ncomp[kk-1]*8;
 		/* output the basic stats */
 		if(setout==1 || setout==3) {
+			max=0; for(ii=0;ii<nn;ii++) { aa= pmatrix[ii]; if(isfinite(aa) && aa>max) max=aa; }
 			fprintf(stderr,"--------------------------------------------------------------------------------\n");
 			fprintf(stderr,"matrixid= %g\n",id1[kk]);
 			fprintf(stderr,"max= %g\n",max);
-			fprintf(stderr,"peakthresh= %.3f\n",thresh);
+			fprintf(stderr,"peakthresh= %.3f\n",thresh[kk]);
 		}
 
+		/********************************************************************************/
+		/* ORDER THE COMPONENTS BY PEAK VALUE - A PEAK MUST EXCEED THE THRESHOLD */
+		/********************************************************************************/
+		for(ii=norder=0;ii<ncomp[kk];ii++) {
+			done[ii+1]= 0;
+			ps= pstats+ii*8;
+			if(ps[3]<=thresh[kk]) continue;
+			/* insertion sort: highest peak first, ties in order of position */
+			for(jj=norder;jj>0;jj--) {
+				aa= pstats[order[jj-1]*8+3];
+				if(aa>ps[3] || (aa==ps[3] && (pstats[order[jj-1]*8+5]*width+pstats[order[jj-1]*8+4]) < (ps[5]*width+ps[4]))) break;
+				order[jj]= order[jj-1];
+			}
+			order[jj]= ii;
+			norder++;
+		}
 
 		/********************************************************************************/
-		/* NOW DETECT THE PEAKS USING THE FIXED THRESHOLD */
+		/* NOW REPORT THE PEAKS */
 		/********************************************************************************/
-		npeaks=peakfound=0;
-		while(1) {
-			/* CALL THE PEAK DETECTION FUNCTION */
-			peakfound= xf_matrixpeak1_d(pmatrix,mask,width,height,thresh,result_d);
-			/* if no peak was detected, stop here */
-			if(peakfound==0) break;
-			/* if peak found was below size threshold, mask it and try again */
-			else if(peakfound>=0 && result_d[0]<setsize) { for(ii=0;ii<nn;ii++) if(mask[ii]>0) mask[ii]=-1;	continue; }
+		npeaks=0;
+		for(jj=0;jj<norder;jj++) {
+			ps= pstats+order[jj]*8;
+			/* if peak is below size threshold, mask it and try the next */
+			if(ps[0]<setsize) { done[order[jj]+1]=1; continue; }
 			/* so this is a good peak - increment the counter & carry on... */
 			npeaks++;
 
@@ -154,44 +191,47 @@ int main (int argc, char *argv[]) {
 			if(setout==1 || setout==3) {
 				fprintf(stderr,"\n");
 				fprintf(stderr,"peaknumber %ld\n",npeaks);
-				fprintf(stderr,"pixels %g\n",result_d[0]);
-				fprintf(stderr,"peak_x %g\n",result_d[1]);
-				fprintf(stderr,"peak_y %g\n",result_d[2]);
-				fprintf(stderr,"centroid_x %g\n",result_d[3]);
-				fprintf(stderr,"centroid_y %g\n",result_d[4]);
-				fprintf(stderr,"mean %g\n",result_d[5]);
-				fprintf(stderr,"max %g\n",result_d[6]);
+				fprintf(stderr,"pixels %g\n",ps[0]);
+				fprintf(stderr,"peak_x %g\n",ps[4]);
+				fprintf(stderr,"peak_y %g\n",ps[5]);
+				fprintf(stderr,"centroid_x %g\n",ps[6]);
+				fprintf(stderr,"centroid_y %g\n",ps[7]);
+				fprintf(stderr,"mean %g\n",ps[2]);
+				fprintf(stderr,"max %g\n",ps[3]);
 			}
 
-			/* OUTPUT THE MASK INDICATING THE PEAK - CHANGE -1 TO NAN */
+			/* OUTPUT THE MASK INDICATING THE PEAK - INVALID AND PREVIOUSLY-MASKED PIXELS ARE NAN */
 			if(setout==2 || setout==3) {
 		 		count=0;
 				printf("# %g	%ld\n",id1[kk],npeaks);
 				for(ii=0;ii<nn;ii++) {
-					/* if pixel was detected as part of peak, output and set mask to exclude re-detection */
-					if(mask[ii]>=0) printf("%d\t",mask[ii]);
-					/* otherwise output nan - this ixel may be detected in subsequent calls to xf_matrixpeak */
-					else printf("nan ");
+					if(!isfinite(pmatrix[ii]) || (plabel[ii]>0 && done[plabel[ii]]==1)) printf("nan ");
+					else printf("%d\t",(plabel[ii]==(order[jj]+1)));
 					/* counter - to tell when a newline should be printed */
 					if(++count>=width) {count=0; printf("\n");}
 				}
 			}
 
-			/* IF ANOTHER ITERATION IS REQUIRED, REMOVE CURRENT FIELD FROM THE MASK */
-			if(setfirst==0) {for(ii=0;ii<nn;ii++) { if(mask[ii]>0) mask[ii]=-1; }}
+			/* IF ANOTHER ITERATION IS REQUIRED, REMOVE CURRENT PEAK FROM THE MASK */
+			if(setfirst==0) done[order[jj]+1]=1;
 			else break;
 
-		} // END OF PER-PEAK WHILE CONDITION
+		} // END OF PER-PEAK LOOP
 
 		/* REPORT THE TOTAL PEAKS DETECTED */
-		if(setout==1 || setout==3) fprintf(stderr,"\nnpeaks %d\n",npeaks);
+		if(setout==1 || setout==3) fprintf(stderr,"\nnpeaks %ld\n",npeaks);
 
-	} // END OF PER-MATRICX LOOP
+	} // END OF PER-MATRIX LOOP
 
 	/* FREE MEMORY AND EXIT */
 	if(matrix1!=NULL) free(matrix1);
 	if(id1!=NULL) free(id1);
-	if(mask!=NULL) free(mask);
+	if(label!=NULL) free(label);
+	if(thresh!=NULL) free(thresh);
+	if(ncomp!=NULL) free(ncomp);
+	if(stats!=NULL) free(stats);
+	if(order!=NULL) free(order);
+	if(done!=NULL) free(done);
 	exit(0);
 
 	}
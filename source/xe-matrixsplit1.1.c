@@ -6,21 +6,29 @@
 #include <time.h>
 
 #define thisprog "xe-matrixsplit1"
-#define TITLE_STRING thisprog" v 1: 13.October.2014 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 #define MAXLABELS 1000
+#define CHUNKSIZE 4194304
+#define BINXMM_HEADERSIZE 500
+#define BINXMM_RECORDSIZE 32
 
 /*
 <TAGS>signal_processing dt.matrix</TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- ASCII input is read in large chunks and each block is written as it is found
+		- lines are located but not copied or parsed, and runs of lines in a block are written together
+	- BINXMM input (see xf_matrixwritebin1_d) is detected automatically
+		- rows before each block are skipped by seeking (or reading, if input is a pipe)
+		- the rows in each block are copied unchanged, in large chunks
+		- output is a BINXMM multi-matrix stream, one matrix per block
+		- the file header and offset table are only written if all blocks are the same size
+
 TO DO:
 
 - add checks to windows
 
-- add binary read option
-	- must know "width" of matrix, and read width-sized chunks of data
-	- thereafter, processing is identical to the ASCII version
-
 */
 
 /* external functions start */
@@ -42,10 +50,12 @@ int main (int argc, char *argv[]) {
 	size_t ii,jj,kk,nn,mm;
 
 	/* program-specific variables */
-	int output=0;
+	int output=0,linestart=1,binary=0,sameheight;
+	char *buffer=NULL,*pbuf,*pend,*prun,*pnewline,binheader[BINXMM_HEADERSIZE];
 	float *data1=NULL;
-	off_t datasize,startbyte,ntoread,nread,bytestoread,parameters[8];
-	size_t block,nblocks,*bstart=NULL,*bstop=NULL;
+	off_t datasize,startbyte,ntoread,nread,bytestoread,parameters[8],position,rowbytes;
+	size_t block,nblocks,nalloc=0,*bstart=NULL,*bstop=NULL,binparams[6];
+	long dims[2];
 
 	/* arguments */
 	char blkfile[256];
@@ -74,6 +84,12 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"		-1  = ASCII\n");
 		fprintf(stderr,"		0 to 9 = uchar,char,ushort,short,uint,int,ulong,long,float,double\n");
 		fprintf(stderr,"		NOTE: if data is not ASCII, matrix width (-w) must be defined\n");
+		fprintf(stderr,"		NOTE: BINXMM binary matrices are detected automatically\n");
+		fprintf(stderr,"		      - output is then a BINXMM stream, one matrix per block\n");
+		fprintf(stderr,"		      - if blocks differ in size, there is no file header, and programs\n");
+		fprintf(stderr,"		        which need equal-sized matrices (e.g. xe-matrixavg2) will reject it\n");
+		fprintf(stderr,"		      - such output can be converted to ASCII by xe-matrixbin1, or read\n");
+		fprintf(stderr,"		        one matrix at a time (xf_matrixread3_d, e.g. xe-matrixbands1)\n");
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"OUTPUT:\n");
 		fprintf(stderr,"----------------------------------------------------------------------\n");
@@ -93,7 +109,7 @@ int main (int argc, char *argv[]) {
 	}}
 
 	if(setdatatype<-1||setdatatype>9) {fprintf(stderr,"\n--- Error[%s]: data type (-dt %d) must be -1 or 0-9\n\n",thisprog,setdatatype);exit(1);};
-	if(setsampfreq<=0) {fprintf(stderr,"\n--- Error[%s]: -sf (%ld) must be >0\n\n",thisprog,setsampfreq);exit(1);};
+	if(setsampfreq<=0) {fprintf(stderr,"\n--- Error[%s]: -sf (%g) must be >0\n\n",thisprog,setsampfreq);exit(1);};
 
 
 	/******************************************************************************/
@@ -111,9 +127,13 @@ int main (int argc, char *argv[]) {
 		if(i>=j) {fprintf(stderr,"\n--- Error[%s]: block file %s contains a start-sample (%ld) which is >= the corresponding stop-sample (%ld)\n\n",thisprog,blkfile,i,j);exit(1);}
 		if(i<k) {fprintf(stderr,"\n--- Error[%s]: block file %s contains a start-sample (%ld) which is < the preceeding stop-sample (%ld)\n\n",thisprog,blkfile,i,k);exit(1);}
 
-		if((bstart=(size_t *)realloc(bstart,(nblocks+1)*kk))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		/* grow the block arrays by doubling */
+		if(nblocks>=nalloc) {
+			nalloc= (nalloc>0) ? nalloc*2 : 1024;
+			if((bstart=(size_t *)realloc(bstart,nalloc*kk))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+			if((bstop=(size_t *)realloc(bstop,nalloc*kk))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		}
 		bstart[nblocks]=(size_t)i;
-		if((bstop=(size_t *)realloc(bstop,(nblocks+1)*kk))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
 		bstop[nblocks]=(size_t)j;
 
 		k=j; // next start-sample must be at least the size of the current stop-sample
@@ -129,28 +149,109 @@ int main (int argc, char *argv[]) {
 	/* READ THE DATA  */
 	/******************************************************************************/
 	fprintf(stderr,"Reading the matrix...\n");
-
-	/* ASCII READ */
 	if(strcmp(infile,"stdin")==0) fpin=stdin;
 	else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
-	while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
-		if(maxlinelen==-1)  {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
-		/* firt check if this line marks the end of the current block - it may also mark the beginning of the next block*/
-		if(nn>=bstop[block]) { if(++block>=nblocks) break; output=0;}
-		/*now check if a new block has begun */
-		if(nn==bstart[block]) { printf("# BLOCK %ld\n",block); output=1;}
-		/* if we are in a block, output the line*/
-		if(output==1) {	printf("%s",line); }
-		nn++;
+	if((buffer=(char *)malloc(CHUNKSIZE))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+	setvbuf(stdout,NULL,_IOFBF,CHUNKSIZE);
+	/* the first byte of a BINXMM file (0x89) cannot start an ASCII file */
+	x= getc(fpin);
+	if(x==0x89) binary=1;
+	if(x!=EOF) ungetc(x,fpin);
+
+	/* ASCII READ: SCAN CHUNKS FOR LINE-ENDS, WRITING RUNS OF LINES FROM INSIDE BLOCKS STRAIGHT FROM THE BUFFER */
+	if(binary==0) {
+		while((nread=fread(buffer,1,CHUNKSIZE,fpin))>0) {
+			pbuf= prun= buffer;
+			pend= buffer+nread;
+			while(pbuf<pend) {
+				if(linestart==1) {
+					/* first check if this line marks the end of the current block - it may also mark the beginning of the next block */
+					if(nn>=bstop[block]) {
+						if(output==1) fwrite(prun,1,(pbuf-prun),stdout);
+						if(++block>=nblocks) goto ENDREAD;
+						output=0;
+					}
+					/* now check if a new block has begun */
+					if(nn==bstart[block]) { printf("# BLOCK %ld\n",block); output=1; prun= pbuf; }
+					linestart=0;
+				}
+				/* find the end of the line */
+				pnewline= memchr(pbuf,'\n',(pend-pbuf));
+				if(pnewline==NULL) pbuf= pend;
+				else { pbuf= pnewline+1; nn++; linestart=1; }
+			}
+			/* if we are in a block, output the rest of the chunk */
+			if(output==1) fwrite(prun,1,(pend-prun),stdout);
+		}
+		ENDREAD:
+		if(ferror(fpin)) {fprintf(stderr,"\n--- Error[%s]: problem reading file \"%s\"\n\n",thisprog,infile);exit(1);}
 	}
-	if(strcmp(infile,"stdin")!=0) fclose(fpin);
 
-	/* BINARY READ */
-	//??? to do
+	/* BINARY READ: COPY THE ROWS FOR EACH BLOCK WITHOUT PARSING */
+	else {
+		/* read the file header and skip the offset table and record header - see xf_matrixwritebin1_d */
+		if(fread(binheader,1,BINXMM_HEADERSIZE,fpin)!=BINXMM_HEADERSIZE || memcmp(binheader,"\x89" "BINXMM1",8)!=0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" is not a valid BINXMM file\n\n",thisprog,infile);exit(1);}
+		memcpy(binparams,(binheader+32),6*sizeof(size_t));
+		if(binparams[0]!=BINXMM_HEADERSIZE || binparams[1]!=sizeof(double) || binparams[2]!=9) {fprintf(stderr,"\n--- Error[%s]: unsupported BINXMM header parameters in \"%s\"\n\n",thisprog,infile);exit(1);}
+		if(binparams[5]!=1) {fprintf(stderr,"\n--- Error[%s]: \"%s\" contains %ld matrices - splitting requires a single matrix\n\n",thisprog,infile,(long)binparams[5]);exit(1);}
+		if(fread(buffer,1,(sizeof(long)+sizeof(double)+BINXMM_RECORDSIZE),fpin)!=(sizeof(long)+sizeof(double)+BINXMM_RECORDSIZE) || memcmp((buffer+sizeof(long)+sizeof(double)),"\x89" "MATRIX1",8)!=0) {
+			fprintf(stderr,"\n--- Error[%s]: invalid matrix record in \"%s\"\n\n",thisprog,infile);exit(1);}
+		position= BINXMM_HEADERSIZE+sizeof(long)+sizeof(double)+BINXMM_RECORDSIZE;
+		rowbytes= (off_t)binparams[3]*sizeof(double);
+		dims[0]= binparams[3];
+
+		/* blocks starting beyond the last row are dropped, and a block running past it is truncated */
+		for(ii=0;ii<nblocks;ii++) {
+			if(bstart[ii]>=binparams[4]) break;
+			if(bstop[ii]>binparams[4]) bstop[ii]= binparams[4];
+		}
+		nblocks= ii;
+		if(nblocks==0) {fprintf(stderr,"--- Warning[%s]: no blocks start within the %ld rows of the matrix\n",thisprog,(long)binparams[4]);exit(0);}
+
+		/* if all blocks are the same size, write a full BINXMM header and offset table, otherwise just the records */
+		for(ii=1,sameheight=1;ii<nblocks;ii++) if((bstop[ii]-bstart[ii])!=(bstop[0]-bstart[0])) sameheight=0;
+		if(sameheight==1) {
+			binparams[4]= bstop[0]-bstart[0];
+			binparams[5]= nblocks;
+			memcpy((binheader+32),binparams,6*sizeof(size_t));
+			fwrite(binheader,1,BINXMM_HEADERSIZE,stdout);
+			for(ii=0;ii<nblocks;ii++) {
+				i= BINXMM_HEADERSIZE + nblocks*(sizeof(long)+sizeof(double)) + ii*(BINXMM_RECORDSIZE+binparams[4]*rowbytes);
+				aa= (double)ii;
+				fwrite(&i,sizeof(long),1,stdout);
+				fwrite(&aa,sizeof(double),1,stdout);
+		}}
+
+		for(block=0;block<nblocks;block++) {
+			/* go to the first row of the block - seek if possible, otherwise read and discard */
+			startbyte= BINXMM_HEADERSIZE+sizeof(long)+sizeof(double)+BINXMM_RECORDSIZE+bstart[block]*rowbytes;
+			if(startbyte>position && fseeko(fpin,(startbyte-position),SEEK_CUR)!=0) {
+				for(;position<startbyte;position+=nread) {
+					ntoread= startbyte-position; if(ntoread>CHUNKSIZE) ntoread= CHUNKSIZE;
+					if((nread=fread(buffer,1,ntoread,fpin))!=ntoread) {fprintf(stderr,"\n--- Error[%s]: unexpected end of file \"%s\"\n\n",thisprog,infile);exit(1);}
+			}}
+			position= startbyte;
+			/* write the record header: tag, id, ncols, nrows */
+			aa= (double)block;
+			dims[1]= bstop[block]-bstart[block];
+			fwrite("\x89" "MATRIX1",1,8,stdout);
+			fwrite(&aa,sizeof(double),1,stdout);
+			fwrite(dims,sizeof(long),2,stdout);
+			/* copy the rows */
+			for(bytestoread=dims[1]*rowbytes;bytestoread>0;bytestoread-=nread) {
+				ntoread= bytestoread; if(ntoread>CHUNKSIZE) ntoread= CHUNKSIZE;
+				if((nread=fread(buffer,1,ntoread,fpin))!=ntoread) {fprintf(stderr,"\n--- Error[%s]: unexpected end of file \"%s\"\n\n",thisprog,infile);exit(1);}
+				if(fwrite(buffer,1,nread,stdout)!=nread) {fprintf(stderr,"\n--- Error[%s]: problem writing output\n\n",thisprog);exit(1);}
+				position+= nread;
+			}
+		}
+	}
+	if(strcmp(infile,"stdin")!=0) fclose(fpin);
 
 	/* FREE MEMORY */
-	if(bstart==NULL) free(bstart);
-	if(bstop==NULL) free(bstop);
+	if(bstart!=NULL) free(bstart);
+	if(bstop!=NULL) free(bstop);
+	if(buffer!=NULL) free(buffer);
 	if(line!=NULL) free(line);
 	if(data1!=NULL) free(data1);
 
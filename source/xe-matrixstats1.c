@@ -1,5 +1,5 @@
 #define thisprog "xe-matrixstats1"
-#define TITLE_STRING thisprog" v 1: 19.March.2018 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 
 #include <math.h>
 #include <stdio.h>
@@ -9,17 +9,23 @@
 /*
 <TAGS>dt.matrix</TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- accepts binary multi-matrix (BINXMM) input
+	- bugfix: spatial coherence no longer reads neighbours beyond the edges of the matrix
+		- previously edge bins used values wrapped from adjacent rows, or beyond the last matrix
 v 3: 21.October.2017 [JRH]
 */
 
 
 /* external functions start */
 long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1, long *ncols, long *nrows, char *message);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse1(char *line,long *nwords);
 int xf_smoothgauss2_d(double *data,int xbintot,int ybintot,int xsmooth,int ysmooth);
 double xf_correlate_simple_d(double *x, double *y, long nn, double *result_d);
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 double xf_matrixcoh1_d(double *rate,long width,long height,char *message);
 
@@ -1,5 +1,5 @@
 #define thisprog "xe-mxcor2"
-#define TITLE_STRING thisprog" v 2.1: 7.February.2019 [JRH]"
+#define TITLE_STRING thisprog" v 2.2: 18.October.2026 [JRH]"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,6 +11,16 @@
 <TAGS>signal_processing dt.matrix</TAGS>
 
 Versions History:
+v 2.2: 18.October.2026 [JRH]
+	- add -all option: correlate every map with every other map in one pass
+		- maps are packed into a single map x pixel array with a validity mask (invalid= -1)
+		- correlation sums for all pairs are calculated in parallel (if compiled with -fopenmp)
+		- output is either the pair-table (as for -cf) or a map-by-map matrix of r-values
+	- non-finite pixels (NAN, INF) are treated as unvisited (-1) - previously they were included in -c1/-c2/-cf correlations
+	- cell lookup uses a table instead of scanning the list of cells for each pair
+	- bugfix: per-cell pixel counts are now initialized
+	- bugfix: unreadable lines in the pair-file no longer cause an endless loop at end-of-file
+
 v 2.1: 7.February.2019 [JRH]
 	- bugfix: output was referring to an unused results variable
 
@@ -41,11 +51,12 @@ int main (int argc, char *argv[]) {
 	/* special variable for this program */
 	int cell,celltot=0,npairs=0,mwidth=-1,mcell[MAXCELLS],celln[MAXCELLS],mcelltot=0,badcount=0;
 	int *pair1=NULL,*pair2=NULL;
-	long N;
+	long N,ii,jj,kk,nmaps;
 	float *data=NULL,*tempfa1,*tempfa2;
+	double *mapval=NULL,*mapvalid=NULL,*allres=NULL,*pres;
 	/* command line arguments */
 	char matrixfile[256],cellfile[256];
-	int setcellfile=0,setcell1=1,setcell2=1;
+	int setcellfile=0,setcell1=1,setcell2=1,setall=0;
 
 	/* PRINT INSTRUCTIONS IF ONLY ONE ARGUMENT */
 	if(argc<2) {
@@ -55,15 +66,22 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"Reads one CRUNCH matrix output file containing multiple matrices\n");
 		fprintf(stderr,"Requires either cell-ids for a pair to analyze, or a pair-list file\n");
 		fprintf(stderr,"Outputs the spatial correlation for every cell pair specified\n");
+		fprintf(stderr,"Unvisited pixels (-1) and non-finite pixels (NAN, INF) are excluded\n");
 		fprintf(stderr,"USAGE: %s [matrixfile] [arguments]\n",thisprog);
 		fprintf(stderr,"- valid arguments: \n");
 		fprintf(stderr,"	-c1: cell 1 of a pair [%d]\n",setcell1);
 		fprintf(stderr,"	-c2: cell 2 of a pair [%d]\n",setcell2);
 		fprintf(stderr,"	-cf: file listing cell pairs\n");
 		fprintf(stderr,"		NOTE: this overrides -c1 and -c2\n");
+		fprintf(stderr,"	-all: correlate all maps with each other [%d]\n",setall);
+		fprintf(stderr,"		0: no - use -c1/-c2 or -cf\n");
+		fprintf(stderr,"		1: output every pair (c1<c2) in the same format as -cf\n");
+		fprintf(stderr,"		2: output a matrix of r-values, rows and columns in cell order\n");
+		fprintf(stderr,"		NOTE: pairs are processed in parallel if compiled with OpenMP (-fopenmp)\n");
 		fprintf(stderr,"Examples:\n");
 		fprintf(stderr,"	%s crunch_matrix.txt -c1 12 -c2 13\n",thisprog);
 		fprintf(stderr,"	%s crunch_matrix.txt -cf cellpairs.txt\n",thisprog);
+		fprintf(stderr,"	%s crunch_matrix.txt -all 2\n",thisprog);
 		fprintf(stderr,"\n");
 		exit(0);
 	}
@@ -76,8 +94,11 @@ int main (int argc, char *argv[]) {
 				else if(strcmp(argv[i],"-c1")==0) 	{ setcell1=atoi(argv[i+1]); i++; }
 				else if(strcmp(argv[i],"-c2")==0) 	{ setcell2=atoi(argv[i+1]); i++; }
 				else if(strcmp(argv[i],"-cf")==0) 	{ setcellfile=1; sprintf(cellfile,"%s\0",argv[i+1]); i++;}
+				else if(strcmp(argv[i],"-all")==0) 	{ setall=atoi(argv[i+1]); i++; }
 				else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[i]); exit(1);}
 	}}
+	if(setall<0||setall>2) {fprintf(stderr,"\n--- Error[%s]: invalid -all (%d) - must be 0-2\n\n",thisprog,setall); exit(1);}
+	for(i=0;i<MAXCELLS;i++) celln[i]=0;
 
 	/* READ THE MATRIX FILE TO GET WIDTH */
 	mwidth=-1;
@@ -95,25 +116,102 @@ int main (int argc, char *argv[]) {
 		// finding a line with the word "Cell" triggers data-read
 		if(xf_strkey1(line, " Cell ", 1, temp_str)>0) {
 			cell=atoi(temp_str);
-			if(cell>=MAXCELLS) {fprintf(stderr,"--- Error[%s]: cells defined exceeds max (%d)\n",thisprog,MAXCELLS);exit(1);}
+			if(cell<0||cell>=MAXCELLS) {fprintf(stderr,"--- Error[%s]: cells defined exceeds max (%d)\n",thisprog,MAXCELLS);exit(1);}
 			else mcell[mcelltot]=cell;
 			// read the cell rate-matrix
 			for(i=0;i<N;i++) {
 				if(fscanf(fpin,"%f",&data[cell*N+i])!=1) {
 					fprintf(stderr,"--- Error [%s]: bad or missing data in file %s cell %d\n",thisprog,matrixfile,cell);exit(1);}
-				else celln[cell]++;
+				/* non-finite pixels are treated as unvisited (-1), for -cf and -all alike */
+				if(!isfinite(data[cell*N+i])) data[cell*N+i]= -1.0;
+				celln[cell]++;
 			}
 			mcelltot++;
 	}}
 	fclose(fpin);
 
+	/* CORRELATE ALL MAPS WITH EACH OTHER */
+	if(setall>0) {
+		/* pack the maps (in cell order) into a map x pixel array, with invalid pixels set to zero in mapval and mapvalid */
+		for(cell=nmaps=0;cell<MAXCELLS;cell++) if(celln[cell]>0) mcell[nmaps++]=cell;
+		mapval= (double *) malloc((nmaps*N+1)*sizeof(double));
+		mapvalid= (double *) malloc((nmaps*N+1)*sizeof(double));
+		allres= (double *) malloc((nmaps*nmaps*4+1)*sizeof(double));
+		if(mapval==NULL||mapvalid==NULL||allres==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		for(ii=0;ii<nmaps;ii++) {
+			tempfa1= data+mcell[ii]*N;
+			for(kk=0;kk<N;kk++) {
+				aa= (double)tempfa1[kk];
+				if(aa!=-1.0) { mapval[ii*N+kk]=aa; mapvalid[ii*N+kk]=1.0; }
+				else { mapval[ii*N+kk]=0.0; mapvalid[ii*N+kk]=0.0; }
+		}}
+		/* for each pair, sums are taken over pixels valid in both maps - results: n,r,F,p */
+		#pragma omp parallel for schedule(dynamic) private(jj,kk,aa,bb,cc,pres)
+		for(ii=0;ii<nmaps;ii++) {
+			double *x1=mapval+ii*N,*m1=mapvalid+ii*N,*x2,*m2;
+			double nv,sx,sy,sxx,syy,sxy,ssx,ssy,spxy,r,F;
+			for(jj=ii+1;jj<nmaps;jj++) {
+				x2=mapval+jj*N; m2=mapvalid+jj*N;
+				nv=sx=sy=sxx=syy=sxy=0.0;
+				for(kk=0;kk<N;kk++) {
+					nv+= m1[kk]*m2[kk];
+					sx+= x1[kk]*m2[kk];
+					sy+= x2[kk]*m1[kk];
+					sxx+= x1[kk]*x1[kk]*m2[kk];
+					syy+= x2[kk]*x2[kk]*m1[kk];
+					sxy+= x1[kk]*x2[kk];
+				}
+				pres= allres+(ii*nmaps+jj)*4;
+				/* as for xf_correlate_f: fewer than 4 valid pixels gives zero results */
+				if(nv<4) { pres[0]=pres[1]=pres[2]=pres[3]=0.0; continue; }
+				ssx= sxx-((sx*sx)/nv);
+				ssy= syy-((sy*sy)/nv);
+				spxy= sxy-((sx*sy)/nv);
+				if(ssy==0.0||ssx==0.0) r=0.0;
+				else r= spxy/(sqrt(ssx)*sqrt(ssy));
+				F= (r*r*(nv-2))/(1-r*r);
+				pres[0]= nv;
+				pres[1]= r;
+				if(r>=.999999||r<=-.999999) { pres[2]=999999.0; pres[3]=0.0; }
+				else if(F>0 && nv>2 && ssx!=0.0) { pres[2]=F; pres[3]=xf_prob_F(F,1,(int)(nv-2)); }
+				else { pres[2]=F; pres[3]=NAN; }
+			}
+		}
+		/* output */
+		if(setall==1) {
+			printf("c1	c2	n	r	F	p\n");
+			for(ii=0;ii<nmaps;ii++) for(jj=ii+1;jj<nmaps;jj++) {
+				pres= allres+(ii*nmaps+jj)*4;
+				if(celln[mcell[ii]]<3||celln[mcell[jj]]<3) {printf("%d	%d	-	-	-	-\n",mcell[ii],mcell[jj]);continue;}
+				printf("%d	%d	%d	%.3f	%.3f	%f\n",mcell[ii],mcell[jj],(int)pres[0],pres[1],pres[2],pres[3]);
+			}
+		}
+		else {
+			printf("cell");
+			for(jj=0;jj<nmaps;jj++) printf("\t%d",mcell[jj]);
+			printf("\n");
+			for(ii=0;ii<nmaps;ii++) {
+				printf("%d",mcell[ii]);
+				for(jj=0;jj<nmaps;jj++) {
+					if(ii==jj) aa=1.0;
+					else if(ii<jj) pres= allres+(ii*nmaps+jj)*4;
+					else pres= allres+(jj*nmaps+ii)*4;
+					if(ii!=jj) { if(pres[0]<4) aa=NAN; else aa=pres[1]; }
+					printf("\t%.3f",aa);
+				}
+				printf("\n");
+			}
+		}
+		free(mapval); free(mapvalid); free(allres); free(data);
+		exit(0);
+	}
 
 	/* STORE CELL-PAIR LIST - WHICH PAIRS TO ANALYZE */
 	if(setcellfile==1) {
 		if((fpin=fopen(cellfile,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,cellfile);exit(1);}
 		npairs=0;
 		while(!feof(fpin)) {
-			if(fscanf(fpin,"%d %d",&x,&y)!=2) {fscanf(fpin,"%s",&line); continue;}
+			if(fscanf(fpin,"%d %d",&x,&y)!=2) { if(fscanf(fpin,"%s",line)!=1) break; continue; }
 			pair1= (int *) realloc(pair1,(npairs+1)*sizeofint);
 			pair2= (int *) realloc(pair2,(npairs+1)*sizeofint);
 			if(pair1==NULL || pair2==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
@@ -135,8 +233,8 @@ int main (int argc, char *argv[]) {
 	for(i=0;i<npairs;i++) {
 			x=pair1[i]; y=pair2[i]; z=0;
 			// make sure each cell in the list is present in the matrix file
-			for(j=0;j<mcelltot;j++) if(x==mcell[j]) {z++; break;}
-			for(j=0;j<mcelltot;j++) if(y==mcell[j]) {z++; break;}
+			if(x>=0 && x<MAXCELLS && celln[x]>0) z++;
+			if(y>=0 && y<MAXCELLS && celln[y]>0) z++;
 			if(z<2) {
 				printf("%d	%d	-	-	-	-\n",x,y); continue;
 			}
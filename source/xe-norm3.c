@@ -1,5 +1,6 @@
 #define thisprog "xe-norm3"
-#define TITLE_STRING thisprog" v 1: 19.April.2019 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
+#define BLOCKSIZE 4096
 #define MAXLINELEN 1000
 
 #include <math.h>
@@ -10,6 +11,12 @@
 /*
 <TAGS> stats transform </TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- rows are grouped by id1 and id2 with a single sort (xf_groupsort1_d), so input need not be sorted by id1 and id2
+		- rows within each group keep their input order, and output is in input order
+	- storage is allocated in blocks rather than per line
+	- bugfix: a block with no repeated-measure >= -n2 (other than the first block) caused an error
+
 v 1: 5.February.2021 [JRH]
 	- make id1 and id2 double-precision float, for more flexibility in naming of "groups"
 
@@ -21,6 +28,9 @@ v 1: 19.April.2019 [JRH]
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 long xf_norm3_d(double *data,long ndata,int normtype,long start,long stop,char *message);
+long xf_groupsort1_d(double **key, long nkeys, long nn, long *index, long *group, char *message);
+void xf_qsortindex1_d(double *data, long *index,long nn);
+void xf_qsortindex1_l(long *data, long *index,long nn);
 /* external functions end */
 
 void internal_print4(char *line,long *iword,long setid1,long setid2,long setrep,long setval) {
@@ -42,7 +52,8 @@ int main (int argc, char *argv[]) {
 	int sizeofid1,sizeofid2,sizeofrep,sizeofval,startfound,stopfound;
 	long *iword=NULL,nwords;
 	long nlines,start,stop,indexa,indexb;
-	double *datid1=NULL,*datid2=NULL,*datrep=NULL,*datval=NULL,previd1,previd2;
+	long *index=NULL,*group=NULL,ngroups;
+	double *datid1=NULL,*datid2=NULL,*datrep=NULL,*datval=NULL,*temprep=NULL,*tempval=NULL,*key[2];
 
 	/* arguments */
 	char *infile=NULL;
@@ -66,7 +77,7 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"- 	id2: identifier (float, typically group)\n");
 		fprintf(stderr,"- 	rep: repeated-measure (float, typically time)\n");
 		fprintf(stderr,"- 	val: value to be normalized (float)\n");
-		fprintf(stderr,"NOTE! assumes data are sorted by id1,id2 and rep (see below)\n");
+		fprintf(stderr,"NOTE! assumes data are sorted by rep within each id1/id2 combination\n");
 		fprintf(stderr,"USAGE: %s [in] [options]\n",thisprog);
 		fprintf(stderr,"	[in]: input file name or \"stdin\"\n");
 		fprintf(stderr,"VALID OPTIONS: defaults in []\n");
@@ -151,11 +162,13 @@ int main (int argc, char *argv[]) {
 		if(sscanf(line+iword[setrep],"%lf",&cc)!=1 || !isfinite(cc)) cc= NAN;
 		if(sscanf(line+iword[setval],"%lf",&dd)!=1 || !isfinite(dd)) dd= NAN;
 		/* dynamically allocate memory */
-		datid1= realloc(datid1,(nn+1)*sizeofid1);
-		datid2= realloc(datid2,(nn+1)*sizeofid2);
-		datrep= realloc(datrep,(nn+1)*sizeofrep);
-		datval= realloc(datval,(nn+1)*sizeofval);
-		if(datid1==NULL || datid2==NULL || datrep==NULL || datval==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		if((nn%BLOCKSIZE)==0) {
+			datid1= realloc(datid1,(nn+BLOCKSIZE)*sizeofid1);
+			datid2= realloc(datid2,(nn+BLOCKSIZE)*sizeofid2);
+			datrep= realloc(datrep,(nn+BLOCKSIZE)*sizeofrep);
+			datval= realloc(datval,(nn+BLOCKSIZE)*sizeofval);
+			if(datid1==NULL || datid2==NULL || datrep==NULL || datval==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		}
 		/* store values */
 		datid1[nn]= aa;
 		datid2[nn]= bb;
@@ -173,60 +186,51 @@ int main (int argc, char *argv[]) {
 	/********************************************************************************
 	NORMALIZE
 	********************************************************************************/
-	/* initializa the block-start & stop */
-	previd1= datid1[0];
-	previd2= datid2[0];
-	start=-1;
-	stop=-1;
-	indexa= 0;
-	indexb= nn;
-
-	for(ii=0;ii<=nn;ii++) { // we need this loop to go to nn
-
-		/* PROCESS THE DATA WHENEVER SUBJECT OR GROUP CHANGE, OR IF THIS IS THE END OF THE INPUT */
-		if(datid1[ii]!=previd1 || datid2[ii]!=previd2 || ii==nn) {
-
-			indexb= ii;    /* set the hard-stop for this block of data */
-			mm= 0;         /* initialize the within-block counter */
-			start= -1;     /* start by default is invalid */
-			stop=  -1;     /* stop by default is invalid */
-			//TEST:for(jj=indexa;jj<indexb;jj++) printf("%ld\t%ld\t%.3f\t%.3f\n",datid1[jj],datid2[jj],datrep[jj],datval[jj]); printf("\n");
-
-			/* SCROLL THOUGH THE BLOCK TO FIND START & STOP INDICES FOR THE NORMALIZATION FUNCTION */
-			for(jj=indexa;jj<indexb;jj++) { /* indexa is inherited from the previous iterration, or from initialization */
-				aa= datrep[jj];
-				/* find the index to the repeated-measures value first corresponding with setn1 */
-				if(aa>=setn1 && aa<setn2 && start<0) start= mm;
-				/* find the index to the repeated-measures value first corresponding with setn2 */
-				if(aa>=setn2 && stop<0) stop= mm;
-				/* increment the within-block counter - this will serve as the block-size on completion of the loop */
-				mm++;
-				//TEST:	printf("rep=%g\tstart=%ld\tstop=%ld\n",datrep[jj],start,stop);
-			}
-
-			/* CHECK THAT NORMALIZATION START AND STOP WERE DEFINED - USE FAKE START UNDER CERTAIN CONDITIONS */
-			if(start<0 && setnorm==0) start= 0; /* allow for no valid start if normalization= 0-1 range */
-			if(stop==-1) stop= indexb;
-			/* NOW NORMALIZE THE VALUES INSIDE THIS BLOCK */
-			if(start>=0) {
-				kk= xf_norm3_d((datval+indexa),(indexb-indexa),setnorm,start,stop,message);
-				if(kk==-2) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
-				if(kk==-1 && setverb>0) fprintf(stderr,"\t*** %s/%s\n",thisprog,message);
-			}
-			else { for(jj=indexa;jj<indexb;jj++) datval[jj]= NAN; }
-
-			/* BREAK IF WE HAVE GONE PAST THE LAST SAMPLE */
-			if(ii==nn) break;
-
-			/* RESET VARIABLES */
-			indexa= indexb;
-			previd1= datid1[ii];
-			previd2= datid2[ii];
-
-			/* ROLL BACK ii SO THE CURRENT ROW GET'S RE-TESTED FOR BEGINNING A NEW BLOCK */
-			ii--;
+	/* group the rows by id1 and id2 - rows in each group keep their original order */
+	index= malloc(nn*sizeof(*index));
+	group= malloc(nn*sizeof(*group));
+	temprep= malloc(nn*sizeof(*temprep));
+	tempval= malloc(nn*sizeof(*tempval));
+	if(index==NULL || group==NULL || temprep==NULL || tempval==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+	key[0]= datid1;
+	key[1]= datid2;
+	ngroups= xf_groupsort1_d(key,2,nn,index,group,message);
+	if(ngroups<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	/* copy the repeated-measure and values into group order */
+	for(ii=0;ii<nn;ii++) { temprep[ii]= datrep[index[ii]]; tempval[ii]= datval[index[ii]]; }
+
+	for(indexa=0;indexa<nn;indexa=indexb) {
+
+		/* FIND THE END OF THE BLOCK FOR THIS GROUP */
+		for(indexb=indexa;indexb<nn && group[index[indexb]]==group[index[indexa]];indexb++);
+		mm= 0;         /* initialize the within-block counter */
+		start= -1;     /* start by default is invalid */
+		stop=  -1;     /* stop by default is invalid */
+
+		/* SCROLL THOUGH THE BLOCK TO FIND START & STOP INDICES FOR THE NORMALIZATION FUNCTION */
+		for(jj=indexa;jj<indexb;jj++) {
+			aa= temprep[jj];
+			/* find the index to the repeated-measures value first corresponding with setn1 */
+			if(aa>=setn1 && aa<setn2 && start<0) start= mm;
+			/* find the index to the repeated-measures value first corresponding with setn2 */
+			if(aa>=setn2 && stop<0) stop= mm;
+			/* increment the within-block counter - this will serve as the block-size on completion of the loop */
+			mm++;
+		}
+
+		/* CHECK THAT NORMALIZATION START AND STOP WERE DEFINED - USE FAKE START UNDER CERTAIN CONDITIONS */
+		if(start<0 && setnorm==0) start= 0; /* allow for no valid start if normalization= 0-1 range */
+		if(stop==-1) stop= mm;
+		/* NOW NORMALIZE THE VALUES INSIDE THIS BLOCK */
+		if(start>=0) {
+			kk= xf_norm3_d((tempval+indexa),(indexb-indexa),setnorm,start,stop,message);
+			if(kk==-2) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+			if(kk==-1 && setverb>0) fprintf(stderr,"\t*** %s/%s\n",thisprog,message);
 		}
+		else { for(jj=indexa;jj<indexb;jj++) tempval[jj]= NAN; }
 	}
+	/* return the normalized values to their original rows */
+	for(ii=0;ii<nn;ii++) datval[index[ii]]= tempval[ii];
 
 	/********************************************************************************
 	OUTPUT:
@@ -246,5 +250,9 @@ END:
 	if(datid2!=NULL) free(datid2);
 	if(datrep!=NULL) free(datrep);
 	if(datval!=NULL) free(datval);
+	if(temprep!=NULL) free(temprep);
+	if(tempval!=NULL) free(tempval);
+	if(index!=NULL) free(index);
+	if(group!=NULL) free(group);
 	exit(0);
 }
@@ -0,0 +1,250 @@
+#define thisprog "xe-permboot1"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
+#define MAXLINELEN 1000
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+<TAGS>stats</TAGS>
+
+v 2: 18.October.2026 [JRH]
+	- add -test 4: permutation test (F-ratio) for any number of groups, using xf_permanova1_d
+
+v 1: 18.October.2026 [JRH]
+	- permutation and bootstrap tests using xf_permboot1_d
+	- replaces calls to R for non-parametric group-comparisons and correlations
+	- the same -seed gives the same result, regardless of the number of threads
+*/
+
+/* external functions start */
+char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
+long *xf_lineparse2(char *line,char *delimiters, long *nwords);
+int xf_permboot1_d(double *data1, double *data2, long n1, long n2, int test, long nperm, long nboot, double setci, unsigned long seed, double *result_d, char *message);
+int xf_permanova1_d(double *data, long *group, long nn, long ngrps, long nperm, unsigned long seed, double *result_d, char *message);
+double xf_rand2_d(unsigned long seed, unsigned long stream, unsigned long counter);
+void xf_qsortindex1_d(double *data, long *index,long nn);
+/* external functions end */
+
+
+int main (int argc, char *argv[]) {
+
+	/* general variables */
+	char *line=NULL,message[MAXLINELEN];
+	long ii,maxlinelen=0;
+	double aa,bb,result_d[64];
+	FILE *fpin;
+
+	/* program-specific variables */
+	int autogrp;
+	long nwords=0,*iword=NULL,n1=0,n2=0,colmax,ngrps=0,*group=NULL;
+	double *data1=NULL,*data2=NULL,*grpval=NULL;
+
+	/* arguments */
+	char *infile=NULL;
+	int settest=1,setverb=1;
+	long setcol1=1,setcol2=2,setperm=10000,setboot=10000;
+	unsigned long setseed=0;
+	double setg1=NAN,setg2=NAN,setci=95.0;
+
+
+	/********************************************************************************
+	PRINT INSTRUCTIONS IF THERE IS NO FILENAME SPECIFIED
+	********************************************************************************/
+	if(argc<2) {
+		fprintf(stderr,"\n");
+		fprintf(stderr,"----------------------------------------------------------------------\n");
+		fprintf(stderr,"%s\n",TITLE_STRING);
+		fprintf(stderr,"----------------------------------------------------------------------\n");
+		fprintf(stderr,"Non-parametric permutation and bootstrap tests\n");
+		fprintf(stderr,"- permutation p-value for the t-statistic, Pearson's r, or the F-ratio\n");
+		fprintf(stderr,"- bootstrap confidence interval for the mean difference or r\n");
+		fprintf(stderr,"- multi-threaded if compiled with OpenMP\n");
+		fprintf(stderr,"- non-numeric values ignored\n");
+		fprintf(stderr,"USAGE:\n");
+		fprintf(stderr,"	%s [input] [options]\n",thisprog);
+		fprintf(stderr,"	[input]: file name or \"stdin\" with tab-delimited columns\n");
+		fprintf(stderr,"VALID OPTIONS: defaults in []\n");
+		fprintf(stderr,"	-test: the type of test [%d]\n",settest);
+		fprintf(stderr,"		1= independent groups: -c1 holds the group, -c2 holds the data\n");
+		fprintf(stderr,"		2= paired samples: -c1 and -c2 hold the data for each pair\n");
+		fprintf(stderr,"		3= correlation: -c1 holds x, -c2 holds y\n");
+		fprintf(stderr,"		4= any number of groups: -c1 holds the group, -c2 holds the data\n");
+		fprintf(stderr,"		   - permutation only (-boot, -g1 and -g2 are ignored)\n");
+		fprintf(stderr,"	-c1: first column (first col = 1) [%ld]\n",setcol1);
+		fprintf(stderr,"	-c2: second column [%ld]\n",setcol2);
+		fprintf(stderr,"	-g1: (-test 1) value in -c1 identifying group 1 [%g]\n",setg1);
+		fprintf(stderr,"	-g2: (-test 1) value in -c1 identifying group 2 [%g]\n",setg2);
+		fprintf(stderr,"		NOTE: if unset, -c1 must hold exactly two groups\n");
+		fprintf(stderr,"	-perm: number of permutations (0 to skip) [%ld]\n",setperm);
+		fprintf(stderr,"	-boot: number of bootstrap resamples (0 to skip) [%ld]\n",setboot);
+		fprintf(stderr,"	-ci: bootstrap confidence interval (percent) [%g]\n",setci);
+		fprintf(stderr,"	-seed: random seed, 0= use time and process-ID [%lu]\n",setseed);
+		fprintf(stderr,"	-verb: verbose output (0=NO 1=YES) [%d]\n",setverb);
+		fprintf(stderr,"EXAMPLES:\n");
+		fprintf(stderr,"	%s data.txt -test 1 -c1 2 -c2 5 -g1 0 -g2 1\n",thisprog);
+		fprintf(stderr,"	cut -f 3,4 temp.txt | %s stdin -test 3 -seed 1\n",thisprog);
+		fprintf(stderr,"OUTPUT:\n");
+		fprintf(stderr,"	stat= [t-statistic for -test 1-2, r for -test 3]\n");
+		fprintf(stderr,"	effect= [mean difference (group2-group1 or c2-c1), or r]\n");
+		fprintf(stderr,"	n1= [valid values in group 1, or valid pairs]\n");
+		fprintf(stderr,"	n2= [valid values in group 2, or valid pairs]\n");
+		fprintf(stderr,"	pperm= [permutation p-value]\n");
+		fprintf(stderr,"	cilow= [lower limit of the confidence interval for the effect]\n");
+		fprintf(stderr,"	cihigh= [upper limit of the confidence interval for the effect]\n");
+		fprintf(stderr,"	se= [bootstrap standard error of the effect]\n");
+		fprintf(stderr,"	-test 4:\n");
+		fprintf(stderr,"		groups= [the group-values, in order of appearance]\n");
+		fprintf(stderr,"		stat= [F-ratio]\n");
+		fprintf(stderr,"		effect= [eta-squared]\n");
+		fprintf(stderr,"		n= [valid values]  ngroups= [groups with valid values]\n");
+		fprintf(stderr,"		pperm= [permutation p-value]\n");
+		fprintf(stderr,"		df1= [between-groups]  df2= [within-groups]  ssb= [between-groups sum-of-squares]\n");
+		fprintf(stderr,"	-verb 0: the same values on a single line\n");
+		fprintf(stderr,"----------------------------------------------------------------------\n");
+		fprintf(stderr,"\n");
+		exit(0);
+	}
+
+
+	/********************************************************************************
+	READ THE FILENAME AND OPTIONAL ARGUMENTS
+	********************************************************************************/
+	infile= argv[1];
+	for(ii=2;ii<argc;ii++) {
+		if( *(argv[ii]+0) == '-') {
+			if((ii+1)>=argc) {fprintf(stderr,"\n--- Error[%s]: missing value for argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
+			else if(strcmp(argv[ii],"-test")==0) settest=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-c1")==0)   setcol1=atol(argv[++ii]);
+			else if(strcmp(argv[ii],"-c2")==0)   setcol2=atol(argv[++ii]);
+			else if(strcmp(argv[ii],"-g1")==0)   setg1=atof(argv[++ii]);
+			else if(strcmp(argv[ii],"-g2")==0)   setg2=atof(argv[++ii]);
+			else if(strcmp(argv[ii],"-perm")==0) setperm=atol(argv[++ii]);
+			else if(strcmp(argv[ii],"-boot")==0) setboot=atol(argv[++ii]);
+			else if(strcmp(argv[ii],"-ci")==0)   setci=atof(argv[++ii]);
+			else if(strcmp(argv[ii],"-seed")==0) setseed=strtoul(argv[++ii],NULL,10);
+			else if(strcmp(argv[ii],"-verb")==0) setverb=atoi(argv[++ii]);
+			else {fprintf(stderr,"\n--- Error[%s]: invalid command line argument \"%s\"\n\n",thisprog,argv[ii]); exit(1);}
+	}}
+	if(settest<1||settest>4) {fprintf(stderr,"\n--- Error[%s]: invalid -test (%d) - must be 1-4\n\n",thisprog,settest); exit(1);}
+	if(setcol1<1||setcol2<1) {fprintf(stderr,"\n--- Error[%s]: invalid column (-c1 %ld -c2 %ld) - must be >0\n\n",thisprog,setcol1,setcol2); exit(1);}
+	if(setperm<0) {fprintf(stderr,"\n--- Error[%s]: invalid -perm (%ld) - must be >=0\n\n",thisprog,setperm); exit(1);}
+	if(setboot<0) {fprintf(stderr,"\n--- Error[%s]: invalid -boot (%ld) - must be >=0\n\n",thisprog,setboot); exit(1);}
+	if(setci<=0.0||setci>=100.0) {fprintf(stderr,"\n--- Error[%s]: invalid -ci (%g) - must be >0 and <100\n\n",thisprog,setci); exit(1);}
+	if(setverb!=0 && setverb!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -verb (%d) - must be 0 or 1\n\n",thisprog,setverb); exit(1);}
+	if(settest==1 && (isfinite(setg1)!=isfinite(setg2))) {fprintf(stderr,"\n--- Error[%s]: -g1 and -g2 must be set together\n\n",thisprog); exit(1);}
+	if(settest==1 && isfinite(setg1) && setg1==setg2) {fprintf(stderr,"\n--- Error[%s]: -g1 and -g2 must be different\n\n",thisprog); exit(1);}
+	if(setseed==0) setseed= (unsigned long)(time(NULL)+getpid());
+	setcol1--;
+	setcol2--;
+	colmax= (setcol1>setcol2) ? setcol1 : setcol2;
+	autogrp= !isfinite(setg1);
+
+
+	/********************************************************************************
+	STORE DATA - for independent groups, data1 and data2 are the two groups
+	********************************************************************************/
+	if(strcmp(infile,"stdin")==0) fpin=stdin;
+	else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
+	while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
+		if(maxlinelen==-1)  {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
+		if(iword!=NULL) free(iword);
+		iword= xf_lineparse2(line,"\t",&nwords);
+		if(nwords<0) {fprintf(stderr,"\n--- Error[%s]: lineparse function encountered insufficient memory\n\n",thisprog);exit(1);};
+		if(nwords<=colmax) continue;
+		if(sscanf(line+iword[setcol1],"%lf",&aa)!=1 || !isfinite(aa)) continue;
+		if(sscanf(line+iword[setcol2],"%lf",&bb)!=1 || !isfinite(bb)) continue;
+		if(settest==4) {
+			/* each new group-value defines a new group */
+			for(ii=0;ii<ngrps;ii++) if(grpval[ii]==aa) break;
+			if(ii==ngrps) {
+				if((grpval=realloc(grpval,(ngrps+1)*sizeof(*grpval)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+				grpval[ngrps++]= aa;
+			}
+			if((data1=realloc(data1,(n1+1)*sizeof(*data1)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			if((group=realloc(group,(n1+1)*sizeof(*group)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			data1[n1]= bb;
+			group[n1]= ii;
+			n2= ++n1;
+		}
+		else if(settest==1) {
+			/* if groups are not specified, the first two group-values found define the groups */
+			if(!isfinite(setg1)) setg1= aa;
+			else if(!isfinite(setg2) && aa!=setg1) setg2= aa;
+			if(aa==setg1) {
+				if((data1=realloc(data1,(n1+1)*sizeof(*data1)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+				data1[n1++]= bb;
+			}
+			else if(aa==setg2) {
+				if((data2=realloc(data2,(n2+1)*sizeof(*data2)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+				data2[n2++]= bb;
+			}
+			/* a third group is only an error if groups were not specified */
+			else if(autogrp==1) {fprintf(stderr,"\n--- Error[%s]: more than two groups in column %ld - use -g1 and -g2\n\n",thisprog,(setcol1+1));exit(1);}
+		}
+		else {
+			if((data1=realloc(data1,(n1+1)*sizeof(*data1)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			if((data2=realloc(data2,(n1+1)*sizeof(*data2)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			data1[n1]= aa;
+			data2[n1]= bb;
+			n2= ++n1;
+		}
+	}
+	if(strcmp(infile,"stdin")!=0) fclose(fpin);
+	if(n1==0||n2==0) {fprintf(stderr,"\n--- Error[%s]: no valid data for one or both %s\n\n",thisprog,(settest==1?"groups":"columns"));exit(1);}
+
+
+	/********************************************************************************
+	RUN THE TESTS
+	********************************************************************************/
+	if(settest==4) {
+		if(xf_permanova1_d(data1,group,n1,ngrps,setperm,setseed,result_d,message)<0) {
+			fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1);
+		}
+	}
+	else if(xf_permboot1_d(data1,data2,n1,n2,settest,setperm,setboot,setci,setseed,result_d,message)<0) {
+		fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1);
+	}
+
+	if(setverb==0) {
+		printf("%g",result_d[0]);
+		for(ii=1;ii<8;ii++) printf("\t%g",result_d[ii]);
+		printf("\n");
+	}
+	else if(settest==4) {
+		printf("groups=");
+		for(ii=0;ii<ngrps;ii++) printf(" %g",grpval[ii]);
+		printf("\n");
+		printf("stat= %g\n",result_d[0]);
+		printf("effect= %g\n",result_d[1]);
+		printf("n= %ld\n",(long)result_d[2]);
+		printf("ngroups= %ld\n",(long)result_d[3]);
+		printf("pperm= %g\n",result_d[4]);
+		printf("df1= %g\n",result_d[5]);
+		printf("df2= %g\n",result_d[6]);
+		printf("ssb= %g\n",result_d[7]);
+	}
+	else {
+		if(settest==1) printf("groups= %g %g\n",setg1,setg2);
+		printf("stat= %g\n",result_d[0]);
+		printf("effect= %g\n",result_d[1]);
+		printf("n1= %ld\n",(long)result_d[2]);
+		printf("n2= %ld\n",(long)result_d[3]);
+		printf("pperm= %g\n",result_d[4]);
+		printf("cilow= %g\n",result_d[5]);
+		printf("cihigh= %g\n",result_d[6]);
+		printf("se= %g\n",result_d[7]);
+	}
+
+	if(data1!=NULL) free(data1);
+	if(data2!=NULL) free(data2);
+	if(group!=NULL) free(group);
+	if(grpval!=NULL) free(grpval);
+	if(iword!=NULL) free(iword);
+	if(line!=NULL) free(line);
+	exit(0);
+}
@@ -1,5 +1,5 @@
 #define thisprog "xe-plotmatrix1"
-#define TITLE_STRING thisprog" 2.February.2021 [JRH]"
+#define TITLE_STRING thisprog" 18.October.2026 [JRH]"
 #define MAXWORDLEN 1000
 
 #include <stdio.h>
@@ -15,6 +15,9 @@ TO DO:
 	???: incorporate simplified xtlaff/ytaloff definition and axis-functions-definitions as per xe-plottable1 (1.January.2019)
 	???: incoporate updated min/max/range calculation as per xe-plottable1 (24.November.2018, 30.September.2018)
 
+v 23: 18.October.2026 [JRH]
+	- binary multi-matrix input (BINXMM, see xe-matrixbin1) is detected automatically - the first matrix is plotted
+
 v 23: 15.September.2020 [JRH]
 	- add option to reverse the order of the colour-palette
 v 23: 2.April.2020 [JRH]
@@ -64,7 +67,9 @@ int xf_compare1_d(const void *a, const void *b);
 int xf_precision_d(double number, int max);
 long xf_interp3_f(float *data, long ndata);
 double xf_percentile2_d(double *data, long nn, double setper, char *message);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_palette7(float *red, float *green, float *blue, long nn, char *palette, int rev);
+double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -79,7 +84,7 @@ int main (int argc, char *argv[]) {
 
 	/* PROGRAM-SPECIFIC VARIABLES */
 	char *xlabel=NULL,*ylabel=NULL,*plottitle=NULL,*bigtic=NULL;
-	int xticprecision,yticprecision,sizeofx,sizeofy,sizeofz,sizeofncols,zminper=0,zmaxper=0;
+	int xticprecision,yticprecision,sizeofx,sizeofy,sizeofz,sizeofncols,zminper=0,zmaxper=0,firstbyte;
 	long *index1=NULL,*index2=NULL,*ncols=NULL,nrows=0,colmax=0,maxlinelen=0,nhlines=0,nvlines=0;
 	float xlimit=500.0,ylimit=500.0; // this is the postscript plotting space, in pixels
 	float yticmaxchar;
@@ -274,7 +279,21 @@ int main (int argc, char *argv[]) {
 	sizeofncols= sizeof(*ncols);
 	if(strcmp(infile,"stdin")==0) fpin=stdin;
 	else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n\a--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
-	while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
+	/* binary multi-matrix input: use the first matrix */
+	firstbyte= fgetc(fpin);
+	if(firstbyte!=EOF) ungetc(firstbyte,fpin);
+	if(firstbyte==0x89) {
+		zdata= xf_matrixreadbin2_d(fpin,&colmax,&nrows,&aa,message);
+		if(zdata==NULL) {fprintf(stderr,"\n\a--- Error[%s]: %s\n\n",thisprog,message);exit(1);}
+		nn= colmax*nrows;
+		xdata= malloc(nn*sizeofx);
+		ydata= malloc(nn*sizeofy);
+		ncols= malloc(nrows*sizeofncols);
+		if(xdata==NULL||ydata==NULL||ncols==NULL) {fprintf(stderr,"\n\a--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		for(ii=0;ii<nn;ii++) { xdata[ii]= (double)(ii%colmax); ydata[ii]= (double)(ii/colmax); }
+		for(ii=0;ii<nrows;ii++) ncols[ii]= colmax;
+	}
+	else while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
 		if(maxlinelen==-1)  {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
 		if(line[0]=='#') continue;
 		pline=line;
@@ -68,6 +68,8 @@ long xf_stats3_f(float *data, long n1, int varcalc, double *result_d);
 int xf_percentile1_f(float *data, long nn, double *result);
 int xf_compare1_d(const void *a, const void *b);
 int xf_filter_bworth1_f(float *X, size_t nn, float sample_freq, float low_freq, float high_freq, float res, char *message);
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -1,24 +1,39 @@
 #define thisprog "xe-repeated1"
-#define TITLE_STRING thisprog" v 5.May.2019 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
+#define BLOCKSIZE 4096
 
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /*
 <TAGS>file screen</TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- the table is read once and blocks are defined by grouping the key-columns with a single sort (xf_groupsort1_d)
+		- rows with the same keys form one block even if they are not contiguous in the input
+		- blocks are output in order of first appearance, so output for contiguous blocks is unchanged
+		- there is no longer a limit on the size of a block (-max is ignored)
+		- with OpenMP, blocks are processed in parallel
+	- bugfix: normalization zone is reset for each block (previously inherited from the previous block)
+	- lines with too few columns, and comment lines, are skipped
+
 v 5.May.2019 [JRH]
 */
 
 /* external functions start */
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
-void xf_linereadblock1(long *params,double *keycurr,double *keyprev,long *keycol,double *rep1,double *dat1,FILE *fpin,char *message);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
 int xf_stats2_d(double *data, long n, int varcalc, double *result_d);
 int xf_compare1_d(const void *a, const void *b);
+long xf_groupsort1_d(double **key, long nkeys, long nn, long *index, long *group, char *message);
+void xf_qsortindex1_d(double *data, long *index,long nn);
+void xf_qsortindex1_l(long *data, long *index,long nn);
 double xf_samplefreq1_d(double *time1, long n1, char *message);
 long xf_interp3_d(double *data, long ndata);
 int xf_filter_bworth1_d(double *X, size_t nn, float sample_freq, float low_freq, float high_freq, float res, char *message);
@@ -38,9 +53,9 @@ int main (int argc, char *argv[]) {
 	FILE *fpin,*fpout;
 	/* program-specific variables */
 	char *words=NULL,**keyword=NULL;
-	long nwords=0,*iword=NULL,*keycol=NULL,params[8],repcol=-1,datcol=-1,nkeys=0,ndata=0,status=0;
-	long nstart=-1,nstop=-1;
-	double *keycurr=NULL,*keyprev=NULL,*rep1=NULL,*dat1=NULL;
+	long nwords=0,*iword=NULL,*keycol=NULL,repcol=-1,datcol=-1,nkeys=0,maxcol,ngroups;
+	long *index=NULL,*group=NULL,*blockstart=NULL,*blockn=NULL,*firstrow=NULL,*order=NULL;
+	double **key=NULL,*rep=NULL,*dat=NULL,*rep1=NULL,*dat1=NULL;
 	/* arguments */
 	char *infile=NULL,*setrep=NULL,*setdat=NULL,*setkeys=NULL;
 	int setinterp=0,setnorm=-1,setverb=0;
@@ -67,13 +82,13 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"USAGE: %s [in] [keys] [rep] [dat]   [options]\n",thisprog);
 		fprintf(stderr,"	[in]: file name or \"stdin\"\n");
 		fprintf(stderr,"	[keys]: CSV list of column-names for static keys\n");
-		fprintf(stderr,"		- equivalence from line-to-line defines the data block\n");
+		fprintf(stderr,"		- lines with the same key-values form a block\n");
 		fprintf(stderr,"	[rep]: column-name for repeated-measure variable\n");
 		fprintf(stderr,"	[dat]: column-name for data\n");
 		fprintf(stderr,"\n");
 		fprintf(stderr,"OPTIONS (defaults in []):\n");
 		fprintf(stderr,"	-interp: interpolate invalid values (0=NO 1=YES) [%d]\n",setinterp);
-		fprintf(stderr,"	-max: max number of replicates in a block [%ld]\n",setmax);
+		fprintf(stderr,"	-max: (ignored - retained for compatibility) [%ld]\n",setmax);
 		fprintf(stderr,"	-verb: verbose output (0=NO 1=YES 999=DEBUG) [%d]\n",setverb);
 		fprintf(stderr,"butterworth filter options:\n");
 		fprintf(stderr,"	-low: low frequency limit, 0=SKIP [%g]\n",setlow);
@@ -133,12 +148,9 @@ int main (int argc, char *argv[]) {
 	if((keycol=(long *)realloc(keycol,(nkeys)*sizeof(long)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
 	for(ii=0;ii<nkeys;ii++) keycol[ii]=-1;
 
-	/* ALLOCATE MEMORY FOR OTTHER VARIABLES */
-	keycurr= malloc(nkeys*sizeof(*keyprev));
-	keyprev= malloc(nkeys*sizeof(*keyprev));
-	rep1= malloc(setmax*sizeof(*rep1));
-	dat1= malloc(setmax*sizeof(*dat1));
-	if(keycurr==NULL||keyprev==NULL||rep1==NULL||dat1==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+	/* ALLOCATE MEMORY FOR POINTERS TO THE KEY-COLUMNS */
+	key= calloc(nkeys,sizeof(*key));
+	if(key==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
 
 
 	/********************************************************************************
@@ -151,6 +163,7 @@ int main (int argc, char *argv[]) {
 		if(maxlinelen==-1)  {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
 		if(line[0]=='#' || strlen(line)<2) continue; /* skip blank or commented lines */
 		if(nn++==0) {
+			if(iword!=NULL) free(iword);
 			iword= xf_lineparse2(line,"\t",&nwords);
 			for(ii=0;ii<nwords;ii++) {
 				pword= line+iword[ii];
@@ -178,59 +191,109 @@ int main (int argc, char *argv[]) {
 	printf("%s\t%s\n",setrep,setdat);
 
 	/********************************************************************************
-	PROCESS THE DATA
+	STORE THE DATA
 	********************************************************************************/
-	/* initialize the parameters for the read function */
-	params[0]= -9;
-	params[1]= 0;
-	params[2]= nkeys;
-	params[3]= repcol;
-	params[4]= datcol;
-	params[5]= setmax;
+	maxcol= repcol; if(datcol>maxcol) maxcol= datcol;
+	for(jj=0;jj<nkeys;jj++) if(keycol[jj]>maxcol) maxcol= keycol[jj];
 	nn= 0;
-	while(++nn) {
-		/* READ A BLOCK  */
-		xf_linereadblock1(params,keycurr,keyprev,keycol,rep1,dat1,fpin,message);
-		status= params[0];
-		ndata= params[1];
-		if(status<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
+		if(maxlinelen==-1)  {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
+		if(line[0]=='#') continue;
+		/* xf_lineparse2 allocates a new index-array every time, so free the previous one */
+		if(iword!=NULL) free(iword);
+		iword= xf_lineparse2(line,"\t",&nwords);
+		if(nwords<0) {fprintf(stderr,"\n--- Error[%s]: lineparse function encountered insufficient memory\n\n",thisprog);exit(1);};
+		if(nwords<=maxcol) continue; /* skip blank lines or lines with missing columns */
+		if((nn%BLOCKSIZE)==0) {
+			for(jj=0;jj<nkeys;jj++) if((key[jj]=realloc(key[jj],(nn+BLOCKSIZE)*sizeof(**key)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+			rep= realloc(rep,(nn+BLOCKSIZE)*sizeof(*rep));
+			dat= realloc(dat,(nn+BLOCKSIZE)*sizeof(*dat));
+			if(rep==NULL||dat==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+		}
+		for(jj=0;jj<nkeys;jj++) {
+			if(sscanf((line+iword[keycol[jj]]),"%lf",&aa)!=1 || !isfinite(aa)) aa= NAN;
+			key[jj][nn]= aa;
+		}
+		rep[nn]= atof(line+iword[repcol]);
+		dat[nn]= atof(line+iword[datcol]);
+		nn++;
+	}
+	if(strcmp(infile,"stdin")!=0) fclose(fpin);
+
+	/********************************************************************************
+	GROUP THE ROWS INTO BLOCKS WITH THE SAME KEYS
+	********************************************************************************/
+	index= malloc((nn+1)*sizeof(*index));
+	group= malloc((nn+1)*sizeof(*group));
+	rep1= malloc((nn+1)*sizeof(*rep1));
+	dat1= malloc((nn+1)*sizeof(*dat1));
+	if(index==NULL||group==NULL||rep1==NULL||dat1==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+	ngroups= xf_groupsort1_d(key,nkeys,nn,index,group,message);
+	if(ngroups<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	blockstart= malloc((ngroups+1)*sizeof(*blockstart));
+	blockn= malloc((ngroups+1)*sizeof(*blockn));
+	firstrow= malloc((ngroups+1)*sizeof(*firstrow));
+	order= malloc((ngroups+1)*sizeof(*order));
+	if(blockstart==NULL||blockn==NULL||firstrow==NULL||order==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+	/* copy the repeated-measure and data into block order, and find the start of each block */
+	for(ii=jj=0;ii<nn;ii++) {
+		rep1[ii]= rep[index[ii]];
+		dat1[ii]= dat[index[ii]];
+		if(ii==0 || group[index[ii]]!=group[index[ii-1]]) blockstart[jj++]= ii;
+	}
+	blockstart[ngroups]= nn;
+	/* blocks are output in order of their first appearance in the input */
+	for(ii=0;ii<ngroups;ii++) { firstrow[ii]= index[blockstart[ii]]; order[ii]= ii; }
+	xf_qsortindex1_l(firstrow,order,ngroups);
+
+	/********************************************************************************
+	PROCESS THE DATA - EACH BLOCK IS INDEPENDENT
+	********************************************************************************/
+	#pragma omp parallel for schedule(dynamic) private(ii,jj)
+	for(kk=0;kk<ngroups;kk++) {
+		char tmessage[MAXLINELEN];
+		long ndata,nstart=-1,nstop=-1;
+		double sampfreq,*prep=rep1+blockstart[kk],*pdat=dat1+blockstart[kk];
+
+		ndata= blockstart[kk+1]-blockstart[kk];
 
 		/* INTERPOLATE INVALID DATA */
-		if(setinterp==1) ii= xf_interp3_d(dat1,ndata);
+		if(setinterp==1) ii= xf_interp3_d(pdat,ndata);
 
 		/* FILTER */
 		if(setlow>0||sethigh>0) {
 			/* get the sample-frequency, assuming repeated-measure is seconds */
-			setsampfreq= xf_samplefreq1_d(rep1,ndata,message);
-			if(setsampfreq==0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+			sampfreq= xf_samplefreq1_d(prep,ndata,tmessage);
+			if(sampfreq==0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,tmessage); exit(1); }
 			/* apply the filter  */
-			z= xf_filter_bworth1_d(dat1,ndata,setsampfreq,setlow,sethigh,setresonance,message);
-			if(z<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+			jj= xf_filter_bworth1_d(pdat,ndata,sampfreq,setlow,sethigh,setresonance,tmessage);
+			if(jj<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,tmessage); exit(1); }
 		}
 
 		/* BIN THE DATA */
-		if(setbin>0) ndata= xf_bin2_d(rep1,dat1,ndata,setbin,2);
+		if(setbin>0) ndata= xf_bin2_d(prep,pdat,ndata,setbin,2);
 
 		/* NORMALISE THE BLOCK OF DATA */
 		if(setnorm>=0) {
-			for(ii=0;ii<ndata;ii++) {if(rep1[ii]<=setn1) nstart=ii; if(rep1[ii]> setn2) {nstop=ii;break;}}
-			// TEST: fprintf(stderr,"nstart:%ld\tnstop:%ld\n\n",nstart,nstop);
-			jj= xf_norm3_d(dat1,ndata,setnorm,nstart,nstop,message);
-			if(jj==-2) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1);}
+			for(ii=0;ii<ndata;ii++) {if(prep[ii]<=setn1) nstart=ii; if(prep[ii]> setn2) {nstop=ii;break;}}
+			jj= xf_norm3_d(pdat,ndata,setnorm,nstart,nstop,tmessage);
+			if(jj==-2) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,tmessage); exit(1);}
 		}
+		blockn[kk]= ndata;
+	}
 
-		/* OUTPUT THE BLOCK */
-		for(ii=0;ii<ndata;ii++) {
-			for(jj=0;jj<nkeys;jj++) printf("%g\t",keyprev[jj]);
+	/********************************************************************************
+	OUTPUT THE BLOCKS
+	********************************************************************************/
+	for(jj=0;jj<ngroups;jj++) {
+		kk= order[jj];
+		mm= index[blockstart[kk]]; /* first row of the block, for the key-values */
+		for(ii=blockstart[kk];ii<(blockstart[kk]+blockn[kk]);ii++) {
+			for(ll=0;ll<nkeys;ll++) printf("%g\t",key[ll][mm]);
 			printf("%f\t%f\n",rep1[ii],dat1[ii]);
 		}
 		printf("\n");
-
-		if(status==0) break; // end of file
-		if(status==1) for(ii=0;ii<nkeys;ii++) keyprev[ii]= keycurr[ii];
 	}
-	if(strcmp(infile,"stdin")!=0) fclose(fpin);
-	//TEST for(ii=0;ii<nn;ii++) printf("%g\t%g\n",xdatf[ii],ydatf[ii]);
 
 goto END;
 
@@ -242,5 +305,14 @@ END:
 	if(iword!=NULL) free(iword);
 	if(rep1!=NULL) free(rep1);
 	if(dat1!=NULL) free(dat1);
+	if(rep!=NULL) free(rep);
+	if(dat!=NULL) free(dat);
+	if(key!=NULL) { for(jj=0;jj<nkeys;jj++) free(key[jj]); free(key); }
+	if(index!=NULL) free(index);
+	if(group!=NULL) free(group);
+	if(blockstart!=NULL) free(blockstart);
+	if(blockn!=NULL) free(blockn);
+	if(firstrow!=NULL) free(firstrow);
+	if(order!=NULL) free(order);
 	exit(0);
 }
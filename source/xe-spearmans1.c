@@ -1,5 +1,5 @@
 #define thisprog "xe-spearmans1"
-#define TITLE_STRING thisprog" v 1: 17.July.2018 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 #define MAXLABELS 1000
 
@@ -7,10 +7,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 /*
 <TAGS>stats</TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- add matrix-mode (-mat) for correlating many columns with each other, using xf_spearmans2_d
+		- each column is ranked once, with ties given the average rank
+		- Pearson's r is also reported
+		- optional permutation p-values (-perm), re-using the ranks
+	- bugfix: -mat 0 also gives ties the average rank (previously ranked by sort order), so rho matches -mat 1
 v 1: 10.August.2018 [JRH]
 	- bugfix - corrected assignment of ranks to values
 v 1: 14.August.2012 [JRH]
@@ -24,6 +32,9 @@ double xf_spearmans1_f(float *data1, float *data2, long ndata, char *message);
 double xf_prob_T1(double t, long df, int tails);
 float xf_prob_F(float F,int df1,int df2);
 void xf_qsortindex1_f(float *data, long *index,long nn);
+long xf_spearmans2_d(double *data, long nrows, long ncols, double *rho, double *rpear, long nperm, unsigned long seed, double *pperm, char *message);
+long xf_rank1_d(double *data, double *rank, long nn, char *message);
+void xf_qsortindex1_d(double *data, long *index,long nn);
 /* external functions end */
 
 
@@ -43,10 +54,14 @@ int main (int argc, char *argv[]) {
 	long nwords=0,*iword=NULL;
 	float *xdatf=NULL,*ydatf=NULL,prob;
 	double rho=NAN,fstat,tstat;
+	long ncols=0,nrows=0,*matcol=NULL;
+	double *matdata=NULL,*matrho=NULL,*matr=NULL,*matp=NULL;
 
 	/* arguments */
-	int setverb=1;
-	long setcolx=1,setcoly=2;
+	char *setcols=NULL;
+	int setverb=1,setmat=0;
+	long setcolx=1,setcoly=2,setperm=0;
+	unsigned long setseed=0;
 
 	if((line=(char *)realloc(line,6))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
 	sizeofx= sizeof(*xdatf);
@@ -74,14 +89,26 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	-cx: column holding x-value (first col = 1) [%ld]\n",setcolx);
 		fprintf(stderr,"	-cy: column holding y-value (first col = 1) [%ld]\n",setcoly);
 		fprintf(stderr,"	-verb: verbose output (0=NO 1=YES, 999=DEBUG) [%d]\n",setverb);
+		fprintf(stderr,"	-mat: correlate many columns with each other (matrix-mode) [%d]\n",setmat);
+		fprintf(stderr,"		0= no: correlate -cx and -cy only\n");
+		fprintf(stderr,"		1= yes: output a table of statistics for every pair of columns\n");
+		fprintf(stderr,"		2= yes: output a square matrix of rho-values\n");
+		fprintf(stderr,"		NOTE: ties are given the average rank\n");
+		fprintf(stderr,"		NOTE: lines with non-numeric values in any column are ignored\n");
+		fprintf(stderr,"	-cols: (-mat 1-2) comma-separated columns to correlate [all]\n");
+		fprintf(stderr,"	-perm: (-mat 1) permutations for a non-parametric p-value [%ld]\n",setperm);
+		fprintf(stderr,"	-seed: (-perm) random seed, 0= use time and process-ID [%lu]\n",setseed);
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s data.txt -cx 2 -cy 3\n",thisprog);
 		fprintf(stderr,"	cat temp.txt | %s stdin\n",thisprog);
+		fprintf(stderr,"	%s data.txt -mat 1 -cols 2,3,5,6 -perm 1000\n",thisprog);
 		fprintf(stderr,"OUTPUT:\n");
 		fprintf(stderr,"	rho= [Spearmans rank coefficient]\n");
 		fprintf(stderr,"	n= [number of valid data-pairs]]\n");
 		fprintf(stderr,"	F= [F-statistic] \n");
 		fprintf(stderr,"	prob= [probability]\n");
+		fprintf(stderr,"	-mat 1: table with a header: col1 col2 n rho F prob r [pperm]\n");
+		fprintf(stderr,"	-mat 2: matrix with a header-line and -column of column-numbers\n");
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"\n");
 		exit(0);
@@ -99,18 +126,39 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-cx")==0)   setcolx=atol(argv[++ii]);
 			else if(strcmp(argv[ii],"-cy")==0)   setcoly=atol(argv[++ii]);
 			else if(strcmp(argv[ii],"-verb")==0) setverb=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-mat")==0)  setmat=atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-cols")==0) setcols=argv[++ii];
+			else if(strcmp(argv[ii],"-perm")==0) setperm=atol(argv[++ii]);
+			else if(strcmp(argv[ii],"-seed")==0) setseed=strtoul(argv[++ii],NULL,10);
 			else {fprintf(stderr,"\n*** %s [ERROR: invalid command line argument \"%s\"]\n\n",thisprog,argv[ii]); exit(1);}
 	}}
 	if(setverb!=0 && setverb!=1 && setverb!=999) { fprintf(stderr,"\n--- Error [%s]: invalid -verb [%d] must be 0,1 or 999\n\n",thisprog,setverb);exit(1);}
+	if(setmat<0||setmat>2) { fprintf(stderr,"\n--- Error [%s]: invalid -mat [%d] must be 0-2\n\n",thisprog,setmat);exit(1);}
+	if(setperm<0) { fprintf(stderr,"\n--- Error [%s]: invalid -perm [%ld] must be >=0\n\n",thisprog,setperm);exit(1);}
+	if(setseed==0) setseed= (unsigned long)(time(NULL)+getpid());
 
 	setcolx--;
 	setcoly--;
 
+	/* build the list of columns for matrix-mode - NULL for "all" means the columns on the first line are used */
+	if(setmat>0 && setcols!=NULL && strcmp(setcols,"all")!=0) {
+		iword= xf_lineparse2(setcols,",",&nwords);
+		if(nwords<0) {fprintf(stderr,"\n--- Error[%s]: lineparse function encountered insufficient memory\n\n",thisprog);exit(1);};
+		if((matcol= realloc(matcol,(nwords+1)*sizeof(*matcol)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		for(ii=0;ii<nwords;ii++) {
+			if(sscanf(setcols+iword[ii],"%ld",&kk)!=1 || kk<1) {fprintf(stderr,"\n--- Error[%s]: invalid column \"%s\" in -cols\n\n",thisprog,setcols+iword[ii]);exit(1);};
+			matcol[ii]= kk-1;
+		}
+		ncols= nwords;
+		free(iword); iword=NULL;
+	}
+
 	/********************************************************************************
 	STORE DATA - ASSUME WE DON'T KNOW THE LENGTH OF EACH INPUT LINE
 	********************************************************************************/
 	if(strcmp(infile,"stdin")==0) fpin=stdin;
 	else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
+	if(setmat>0) goto MATRIX;
 	nn=0;
 	while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
 		if(maxlinelen==-1)  {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
@@ -160,7 +208,84 @@ int main (int argc, char *argv[]) {
 		printf("prob= %.6f\n",prob);
 	}
 
+	goto END;
+
+
+	/********************************************************************************
+	MATRIX-MODE: STORE THE SELECTED COLUMNS, THEN CORRELATE ALL PAIRS
+	********************************************************************************/
+MATRIX:
+	nrows=0;
+	while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
+		if(maxlinelen==-1)  {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
+		if(iword!=NULL) free(iword);
+		iword= xf_lineparse2(line,"\t",&nwords);
+		if(nwords<0) {fprintf(stderr,"\n--- Error[%s]: lineparse function encountered insufficient memory\n\n",thisprog);exit(1);};
+		if(nwords<1) continue;
+		/* if no columns were specified, use all the columns on the first line */
+		if(ncols==0) {
+			if((matcol= realloc(matcol,(nwords+1)*sizeof(*matcol)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+			for(ii=0;ii<nwords;ii++) matcol[ii]=ii;
+			ncols= nwords;
+		}
+		/* store the row only if every column is present and numeric */
+		for(jj=0;jj<ncols;jj++) {
+			if(matcol[jj]>=nwords) break;
+			if(sscanf(line+iword[matcol[jj]],"%lf",&aa)!=1 || !isfinite(aa)) break;
+		}
+		if(jj<ncols) continue;
+		if((nrows%1024)==0) {
+			if((matdata= realloc(matdata,((nrows+1024)*ncols)*sizeof(*matdata)))==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		}
+		for(jj=0;jj<ncols;jj++) sscanf(line+iword[matcol[jj]],"%lf",(matdata+nrows*ncols+jj));
+		nrows++;
+	}
+	if(strcmp(infile,"stdin")!=0) fclose(fpin);
+	if(ncols<2) {fprintf(stderr,"\n--- Error[%s]: matrix-mode requires at least 2 columns\n\n",thisprog);exit(1);};
+
+	matrho= malloc((ncols*ncols+1)*sizeof(*matrho));
+	matr= malloc((ncols*ncols+1)*sizeof(*matr));
+	matp= malloc((ncols*ncols+1)*sizeof(*matp));
+	if(matrho==NULL||matr==NULL||matp==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+	if(setmat==2) setperm=0;
+	nn= xf_spearmans2_d(matdata,nrows,ncols,matrho,matr,setperm,setseed,matp,message);
+	if(nn<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	if(nn<3) { fprintf(stderr,"\n--- Error[%s]: fewer than 3 lines with valid data in all columns\n\n",thisprog); exit(1); }
+
+	if(setmat==1) {
+		printf("col1\tcol2\tn\trho\tF\tprob\tr");
+		if(setperm>0) printf("\tpperm");
+		printf("\n");
+		for(ii=0;ii<ncols;ii++) for(jj=ii+1;jj<ncols;jj++) {
+			rho= matrho[ii*ncols+jj];
+			if(rho>=.999999||rho<=-.999999) { fstat=999999.0; prob=0.0; }
+			else {
+				tstat= rho * sqrt((nn-2)/(1-rho*rho));
+				fstat= tstat*tstat;
+				prob= xf_prob_F((float)fstat,1,(nn-2));
+			}
+			printf("%ld\t%ld\t%ld\t%.5f\t%.5f\t%.5f\t%.5f",(matcol[ii]+1),(matcol[jj]+1),nn,rho,fstat,prob,matr[ii*ncols+jj]);
+			if(setperm>0) printf("\t%.5f",matp[ii*ncols+jj]);
+			printf("\n");
+		}
+	}
+	else {
+		printf("col");
+		for(jj=0;jj<ncols;jj++) printf("\t%ld",(matcol[jj]+1));
+		printf("\n");
+		for(ii=0;ii<ncols;ii++) {
+			printf("%ld",(matcol[ii]+1));
+			for(jj=0;jj<ncols;jj++) printf("\t%.5f",matrho[ii*ncols+jj]);
+			printf("\n");
+		}
+	}
+
 END:
+	if(matcol!=NULL) free(matcol);
+	if(matdata!=NULL) free(matdata);
+	if(matrho!=NULL) free(matrho);
+	if(matr!=NULL) free(matr);
+	if(matp!=NULL) free(matp);
 	if(xdatf!=NULL) free(xdatf);
 	if(ydatf!=NULL) free(ydatf);
 	if(words!=NULL) free(words);
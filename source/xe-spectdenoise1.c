@@ -1,5 +1,5 @@
 #define thisprog "xe-spectdenoise1"
-#define TITLE_STRING thisprog" v 1: 22.January.2019 [JRH]"
+#define TITLE_STRING thisprog" v 2: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 
 #include <math.h>
@@ -10,6 +10,9 @@
 /*
 <TAGS>dt.matrix signal_processing spectra noise</TAGS>
 
+v 2: 18.October.2026 [JRH]
+	- add -bin option to output the matrix in binary (BINXMM) format
+
 v 1: 22.January.2019 [JRH]
 	- add clipping capabilities
 
@@ -18,8 +21,12 @@ v 1: 2.January.2019 [JRH]
 
 /* external functions start */
 double *xf_matrixread1_d(long *nmatrices, long *ncols, long *nrows, char *message, FILE *fpin);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
+long xf_matrixwritebin1_d(FILE *fpout, double *matrix, long nmatrices, long ncols, long nrows, double *id, char *message);
 long xf_spectdenoise1_d(double *matrix1,long width,long height,double setclip,double setz,int setsign,double setper,int setrotate,char *message);
 int xf_matrixrotate2_d(double *data1, long *width, long *height, int r);
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
+int xf_matrixorient2_d(double *data, long nmatrices, long *width, long *height, int op);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -36,7 +43,7 @@ int main (int argc, char *argv[]) {
 	double *matrix=NULL,*temprow=NULL;
 	/* arguments */
 	char *infile=NULL;
-	int setsign=0,setrotate=0,setverb=0;
+	int setsign=0,setrotate=0,setverb=0,setbin=0;
 	double setclip=-1.0,setz=1.0,setp=25.0;
 
 
@@ -66,6 +73,7 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"	-r: 90-deg rotate for analysis (0=NO 1=YES) [%d]\n",setrotate);
 		fprintf(stderr,"		- use for if input column=freq and row=time\n");
 		fprintf(stderr,"		- matrix will be rotated back for output\n");
+		fprintf(stderr,"	-bin: output in binary multi-matrix format (0=NO 1=YES) [%d]\n",setbin);
 		//fprintf(stderr,"	-verb: verbose output (0=NO 1=YES 999=DEBUG) [%d]\n",setverb);
 		fprintf(stderr,"OUTPUT:\n");
 		fprintf(stderr,"	stdout: matrix with noise timepoints invalidated (NAN)\n");
@@ -90,14 +98,16 @@ int main (int argc, char *argv[]) {
 			else if(strcmp(argv[ii],"-z")==0)    setz= atof(argv[++ii]);
 			else if(strcmp(argv[ii],"-p")==0)    setp= atof(argv[++ii]);
 			else if(strcmp(argv[ii],"-r")==0)    setrotate= atoi(argv[++ii]);
+			else if(strcmp(argv[ii],"-bin")==0)  setbin= atoi(argv[++ii]);
 			else if(strcmp(argv[ii],"-verb")==0) setverb= atoi(argv[++ii]);
 			else {fprintf(stderr,"\n--- Error [%s]: invalid command line argument [%s]\n\n",thisprog,argv[ii]); exit(1);}
 	}}
 	if(setverb!=0 && setverb!=1 && setverb != 999) { fprintf(stderr,"\n--- Error [%s]: invalid -verb [%d] must be 0,1, or 999\n\n",thisprog,setverb);exit(1);}
 	if(setsign<-1||setsign>1) {fprintf(stderr,"\n--- Error[%s]: invalid -s [%d] must be -1, 0 or 1\n\n",thisprog,setsign);exit(1);}
 	if(setrotate!=0&&setrotate!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -r [%d] must be 0 or 1\n\n",thisprog,setrotate);exit(1);}
-	if(setz==0.0) {fprintf(stderr,"\n--- Error[%s]: invalid -z [%d], cannot be zero\n\n",thisprog,setz);exit(1);}
-	if(setp<=0.0) {fprintf(stderr,"\n--- Error[%s]: invalid -per [%d], must be >0\n\n",thisprog,setp);exit(1);}
+	if(setbin!=0&&setbin!=1) {fprintf(stderr,"\n--- Error[%s]: invalid -bin [%d] must be 0 or 1\n\n",thisprog,setbin);exit(1);}
+	if(setz==0.0) {fprintf(stderr,"\n--- Error[%s]: invalid -z [%g], cannot be zero\n\n",thisprog,setz);exit(1);}
+	if(setp<=0.0) {fprintf(stderr,"\n--- Error[%s]: invalid -p [%g], must be >0\n\n",thisprog,setp);exit(1);}
 	//TEST printf("setz=%g\n",setz); goto END;
 
 	/********************************************************************************
@@ -124,12 +134,17 @@ int main (int argc, char *argv[]) {
 	/********************************************************************************
 	OUTPUT THE MATRIX
 	********************************************************************************/
-	for(ii=0;ii<height;ii++) {
-		jj= ii*width;
-		kk= jj+width;
-		printf("%g",matrix[jj++]);
-		for(jj=jj;jj<kk;jj++) printf(" %g",matrix[jj]); // only print a tab separator for columns after the first column
-		printf("\n");
+	if(setbin==1) {
+		if(xf_matrixwritebin1_d(stdout,matrix,1,width,height,NULL,message)<0) { fprintf(stderr,"\n--- Error[%s]: %s\n\n",thisprog,message); exit(1);}
+	}
+	else {
+		for(ii=0;ii<height;ii++) {
+			jj= ii*width;
+			kk= jj+width;
+			printf("%g",matrix[jj++]);
+			for(jj=jj;jj<kk;jj++) printf(" %g",matrix[jj]); // only print a tab separator for columns after the first column
+			printf("\n");
+		}
 	}
 
 	/********************************************************************************
@@ -4,11 +4,26 @@
 #include <string.h>
 
 #define thisprog "xe-statscol1"
-#define TITLE_STRING thisprog" v 3: 1.April.2014 [JRH]"
+#define TITLE_STRING thisprog" v 9: 18.October.2026 [JRH]"
+#define CHUNKVALUES 1048576
+#define CHUNKPARTS 8
 
 /*
 <TAGS>math stats</TAGS>
 
+v 9: 18.October.2026 [JRH]
+	- chunked, parallel reduction
+		- values are buffered in chunks of up to CHUNKVALUES values (whole lines), stored by column
+		- each chunk is split into CHUNKPARTS parts per column, summarised in parallel (OpenMP)
+		- the partial accumulators are merged (xf_accmerge1_d) in a fixed order, so the result
+		  does not depend on the number of threads
+		- memory use depends only on the number of columns and CHUNKVALUES
+
+v 8: 18.October.2026 [JRH]
+	- use streaming accumulators (xf_accinit1_d, xf_accadd1_d, xf_accresult1_d), one per column
+		- data is no longer stored, so memory use depends only on the number of columns
+		- mean and variance use Welford's method, which is more stable than the computational formula
+
 v 7: 16.February.2016 [JRH]
 	- avoid in-loop realloc for some variables to improve performance
 	- bugfix: column stats now do actually ignore NANs and INFs as suggested by the instructions!
@@ -24,10 +39,25 @@ v 2: 5.May.2013 [JRH]
 
 /* external functions start */
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
-int xf_stats2_d(double *data, long n, int varcalc, double *result_d);
-int xf_compare1_l(const void *a, const void *b);
+void xf_accinit1_d(double *acc);
+long xf_accadd1_d(double *acc, double *data, long nn);
+long xf_accresult1_d(double *acc, double *result_d);
+void xf_accmerge1_d(double *acc1, double *acc2);
 /* external functions end */
 
+/* summarise a chunk of nrows values per column (chunk[col*chunkrows+row]) and merge into acc - part must hold ncols*CHUNKPARTS*8 values */
+void statscol1_chunk(double *chunk, long chunkrows, long nrows, long ncols, double *acc, double *part) {
+	long ii,nparts=ncols*CHUNKPARTS,partrows=(nrows+CHUNKPARTS-1)/CHUNKPARTS;
+	#pragma omp parallel for schedule(dynamic) if(nrows*ncols>=4096)
+	for(ii=0;ii<nparts;ii++) {
+		long col=ii/CHUNKPARTS,row1=(ii%CHUNKPARTS)*partrows,nn=nrows-row1;
+		if(nn>partrows) nn=partrows;
+		xf_accinit1_d(part+ii*8);
+		if(nn>0) xf_accadd1_d((part+ii*8),(chunk+col*chunkrows+row1),nn);
+	}
+	for(ii=0;ii<nparts;ii++) xf_accmerge1_d((acc+(ii/CHUNKPARTS)*8),(part+ii*8));
+}
+
 
 int main (int argc, char *argv[]) {
 	/* general variables */
@@ -39,8 +69,8 @@ int main (int argc, char *argv[]) {
 	double aa,bb,cc,dd, result_d[64];
 	FILE *fpin,*fpout;
 	/* program-specific variables */
-	long *column=NULL,*collist=NULL,ncollist=0,n2;
-	double *data=NULL,*tempdata=NULL;
+	long ncols=0,nwords,n2,nrows=0,chunkrows=0,maxwords=0;
+	double *acc=NULL,*chunk=NULL,*part=NULL,*rowbuf=NULL;
 	/* arguments */
 	int setformat=1,setbintot=25,coldata=1,setnbuff;
 	float setlow=0.0,sethigh=0.0,setbinwidth=0.0;
@@ -77,45 +107,52 @@ int main (int argc, char *argv[]) {
 	}}
 
 
-	/* STORE DATA METHOD 4 - if uncertain about total line length (eg reading large matrices) */
+	/* READ THE DATA INTO CHUNKS, ADDING EACH CHUNK TO THE ACCUMULATOR FOR EACH COLUMN */
 	if(strcmp(infile,"stdin")==0) fpin=stdin;
 	else if((fpin=fopen(infile,"r"))==0) {fprintf(stderr,"\n--- Error[%s]: file \"%s\" not found\n\n",thisprog,infile);exit(1);}
-	n=0;
-
 	while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
 		if(maxlinelen==-1)  {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
+		/* parse the line - non-numeric values are stored as NAN (ignored) */
  		pline=line;
- 		for(col=0;(pcol=strtok(pline," ,\t\n"))!=NULL;col++)	{
+ 		for(nwords=0;(pcol=strtok(pline," ,\t\n"))!=NULL;nwords++)	{
 			pline=NULL;
-			if((data=(double *)realloc(data,(n+1)*sizeofdouble))==NULL) {fprintf(stderr,"\n\a--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-			if((column=(long *)realloc(column,(n+1)*sizeoflong))==NULL) {fprintf(stderr,"\n\a--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-			if(sscanf(pcol,"%lf",&data[n])!=1 || !isfinite(data[n]) ) data[n]=NAN;
-			column[n]=col;
-			n++;
-	}}
+			if(nwords>=maxwords) {
+				maxwords= 2*nwords+16;
+				if((rowbuf=(double *)realloc(rowbuf,maxwords*sizeofdouble))==NULL) {fprintf(stderr,"\n\a--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+			}
+			if(sscanf(pcol,"%lf",&aa)!=1) aa= NAN;
+			rowbuf[nwords]= aa;
+		}
+		/* if this is the widest line so far, summarise the chunk so far and resize it for the new number of columns */
+		if(nwords>ncols) {
+			if(nrows>0) statscol1_chunk(chunk,chunkrows,nrows,ncols,acc,part);
+			nrows= 0;
+			chunkrows= CHUNKVALUES/nwords; if(chunkrows<1) chunkrows= 1;
+			if((acc=(double *)realloc(acc,nwords*8*sizeofdouble))==NULL) {fprintf(stderr,"\n\a--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+			if((chunk=(double *)realloc(chunk,nwords*chunkrows*sizeofdouble))==NULL) {fprintf(stderr,"\n\a--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+			if((part=(double *)realloc(part,nwords*CHUNKPARTS*8*sizeofdouble))==NULL) {fprintf(stderr,"\n\a--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
+			for(i=ncols;i<nwords;i++) xf_accinit1_d(acc+i*8);
+			ncols= nwords;
+		}
+		/* add the line to the chunk - columns missing from this line are NAN */
+		for(i=0;i<nwords;i++) chunk[i*chunkrows+nrows]= rowbuf[i];
+		for(i=nwords;i<ncols;i++) chunk[i*chunkrows+nrows]= NAN;
+		if(++nrows==chunkrows) { statscol1_chunk(chunk,chunkrows,nrows,ncols,acc,part); nrows=0; }
+	}
+	if(nrows>0) statscol1_chunk(chunk,chunkrows,nrows,ncols,acc,part);
 	if(strcmp(infile,"stdin")!=0) fclose(fpin);
-	if((tempdata=(double *)realloc(tempdata,n*sizeofdouble))==NULL) {fprintf(stderr,"\n\a--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-	if((collist=(long *)realloc(collist,n*sizeoflong))==NULL) {fprintf(stderr,"\n\a--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);}
-
-	/* make a list of the unique elements in "column" */
-	for(i=0;i<n;i++) collist[i]=column[i];
-	qsort(collist,n,sizeof(long),xf_compare1_l);
-	k=collist[0]; for(i=ncollist=1;i<n;i++) {if(collist[i]!=k) collist[ncollist++]=collist[i];k=collist[i]; }
 
 	printf("col	n	mean	stdev	sem\n");
-	for(i=0;i<ncollist;i++) {
-		n2=0;
-		for(j=0;j<n;j++) {
-			if(column[j]==i && isfinite(data[j])) tempdata[n2++]=data[j];
-		}
-		xf_stats2_d(tempdata,n2,1,result_d);
-		printf("%d	%d	%g	%g	%g\n",i,n2,result_d[0],result_d[2],result_d[3]);
+	for(i=0;i<ncols;i++) {
+		n2= xf_accresult1_d((acc+i*8),result_d);
+		if(n2<1) result_d[0]=result_d[2]=result_d[3]=0.0;
+		printf("%ld	%ld	%g	%g	%g\n",i,n2,result_d[0],result_d[2],result_d[3]);
 	}
 
 	if(line!=NULL) free(line);
-	free(data);
-	free(tempdata);
-	free(column);
-	free(collist);
+	if(acc!=NULL) free(acc);
+	if(chunk!=NULL) free(chunk);
+	if(part!=NULL) free(part);
+	if(rowbuf!=NULL) free(rowbuf);
 	exit(0);
 	}
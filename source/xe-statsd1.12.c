@@ -1,5 +1,5 @@
 #define thisprog "xe-statsd1"
-#define TITLE_STRING thisprog"v 12  14.September.2016 [JRH]"
+#define TITLE_STRING thisprog" v 13: 18.October.2026 [JRH]"
 #define MAXLINELEN 10000
 #define MAXGROUP 8000
 
@@ -12,6 +12,13 @@
 /*
 <TAGS>math stats</TAGS>
 
+v 13: 18.October.2026 [JRH]
+	- percentiles (-per 1) use selection instead of a full sort (see xf_percentile1_d)
+	- add -per 2: approximate percentiles in bounded memory
+		- data is not stored: stats use a streaming accumulator (xf_accadd1_d) and percentiles use a quantile-sketch (xf_qsketchadd1_d)
+		- percentile rank-error is typically <0.05% - identical to -per 1 if there are fewer than 4096 values
+		- NOTE: in this mode skew is reported even if negative (xf_stats2_d reports negative skew as zero)
+
 v 12  28.September.2018 [JRH]
 	- fix variable names and change "varcalc" to "setlarge" in function
 	- for large datasets (setlarge2), the stats function also uses a mean based on the mean-noirmalizad data
@@ -60,13 +67,21 @@ v.1.4
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 int xf_stats2_d(double *data, long n, int varcalc, double *result_d);
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 double xf_stats1_d(double *data1, long nn, int digits);
+void xf_accinit1_d(double *acc);
+long xf_accadd1_d(double *acc, double *data, long nn);
+long xf_accresult1_d(double *acc, double *result_d);
+double *xf_qsketchinit1_d(long kk, char *message);
+long xf_qsketchadd1_d(double *sketch, double *data, long nn);
+double xf_qsketchget1_d(double *sketch, double setper, char *message);
+void xf_qsortindex1_d(double *data, long *index,long nn);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
 	/* general variables */
-	char infile[256],outfile[256],*line=NULL,*pline,*pcol,*perror;
+	char infile[256],outfile[256],*line=NULL,*pline,*pcol,*perror,message[256];
 	long int i,j,k,n;
 	int w,x,y,z,col;
 	int sizeofint=sizeof(int),sizeoffloat=sizeof(float),sizeofdouble=sizeof(double);
@@ -75,7 +90,8 @@ int main (int argc, char *argv[]) {
 	double aa,bb,cc,result_d[64];
 	FILE *fpin,*fpout;
 	/* program-specific variables */
-	double *data=NULL,binsize=1.0,sumtot=0.0;
+	double *data=NULL,binsize=1.0,sumtot=0.0,acc[8],*sketch=NULL;
+	double perclist[11]={1,2.5,5,10,25,50,75,90,95,97.5,99};
 	double min,max,mean,sum,sumsquares,variance,stddev,sem,ci,skew;
 	/* arguments */
 	int groupcol=-1,varcalc=2,percalc=0,alphapercent=5,setformat=1;
@@ -104,6 +120,7 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"		1=computational, 2=per-sample with correction\n");
 		fprintf(stderr,"	-per percentile calculation[%d]\n",percalc);
 		fprintf(stderr,"		0=skip, 1=calculate mdeian and other percentiles\n");
+		fprintf(stderr,"		2=approximate percentiles without storing the data (for very large inputs)\n");
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s data.txt -var 1\n",thisprog);
 		fprintf(stderr,"	cat temp.txt | %s stdin \n",thisprog);
@@ -127,6 +144,12 @@ int main (int argc, char *argv[]) {
 			else {fprintf(stderr,"\t\aError[%s]: invalid command line argument \"%s\"\n",thisprog,argv[i]); exit(1);}
 	}}
 	if(varcalc!=1 && varcalc!=2) { fprintf(stderr,"\n--- Error [%s]: invalid -var [%d] must be 1 or 2\n\n",thisprog,varcalc);exit(1);}
+	if(percalc<0 || percalc>2) { fprintf(stderr,"\n--- Error [%s]: invalid -per [%d] must be 0-2\n\n",thisprog,percalc);exit(1);}
+	if(percalc==2) {
+		xf_accinit1_d(acc);
+		sketch= xf_qsketchinit1_d(4096,message);
+		if(sketch==NULL) { fprintf(stderr,"\n--- Error[%s/%s]\n\n",thisprog,message); exit(1); }
+	}
 
 
 	if(strcmp(outfile,"stdout")==0) fpout=stdout;
@@ -146,6 +169,8 @@ int main (int argc, char *argv[]) {
 			if(pcol[0]=='#') break;
 			pline=NULL;
 			if(sscanf(pcol,"%lf  ",&aa)==1) {
+				/* streaming mode - update the accumulator and sketch instead of storing the data */
+				if(percalc==2) { xf_accadd1_d(acc,&aa,1); xf_qsketchadd1_d(sketch,&aa,1); continue; }
 				data=(double *)realloc(data,(n+1)*sizeofdouble);
 				if(data==NULL) {fprintf(stderr,"\t\aError[%s]: insufficient memory\n",thisprog);exit(1);}
 				if(isfinite(aa)) data[n++]=aa; // only add to memory if the number is normal (not imaginary, not NaN or Inf)
@@ -155,7 +180,8 @@ int main (int argc, char *argv[]) {
 	/**********************************************************************************/
 	/* CALL BASIC STATS FUNCTION TO CALCULATE VALUES */
 	/**********************************************************************************/
-	xf_stats2_d(data,n,varcalc,result_d);int xf_percentile1_d(double *data, long n, double *result);
+	if(percalc==2) n= xf_accresult1_d(acc,result_d);
+	else xf_stats2_d(data,n,varcalc,result_d);
 	mean=result_d[0];
 	variance=result_d[1];
 	stddev=result_d[2];
@@ -169,25 +195,33 @@ int main (int argc, char *argv[]) {
 	if(n<1) {
 		if(setformat==0) {
 			printf("0	-	-	-	-	-	-	-	-	-");
-			if(percalc==1) for(i=0;i<11;i++) fprintf(fpout,"\t-");
+			if(percalc>0) for(i=0;i<11;i++) fprintf(fpout,"\t-");
 			fprintf(fpout,"\n"); free(data); exit(0);
 		}
 		if(setformat==1) {
 			fprintf(fpout,"\nN 0\nSUM -\nMEAN -\nMIN -\nMAX -\nRANGE -\nVARIANCE -\nSTDDEV -\nSEM -\nSKEW -\n");
-			if(percalc==1) fprintf(fpout,"\nPERCENTILE_1 -\nPERCENTILE_2.5 -\nPERCENTILE_5 -\nPERCENTILE_10 -\nPERCENTILE_25 -\nPERCENTILE_50 -\nPERCENTILE_75 -\nPERCENTILE_90 -\nPERCENTILE_95 -\nPERCENTILE_97.5 -\nPERCENTILE_99 -\n");
+			if(percalc>0) fprintf(fpout,"\nPERCENTILE_1 -\nPERCENTILE_2.5 -\nPERCENTILE_5 -\nPERCENTILE_10 -\nPERCENTILE_25 -\nPERCENTILE_50 -\nPERCENTILE_75 -\nPERCENTILE_90 -\nPERCENTILE_95 -\nPERCENTILE_97.5 -\nPERCENTILE_99 -\n");
 			fprintf(fpout,"\n"); free(data); exit(0);
 		}
 	}
 
+	/* CALCULATE PERCENTILES */
+	if(percalc==1) {
+		z=xf_percentile1_d(data,n,result_d);
+		if(z!=0) {fprintf(stderr,"\t\aError[%s]: insufficient memory for calculation of percentiles\n",thisprog);exit(1);}
+	}
+	else if(percalc==2) {
+		for(i=0;i<11;i++) {
+			result_d[i]= xf_qsketchget1_d(sketch,perclist[i],message);
+			if(!isfinite(result_d[i])) { fprintf(stderr,"\n--- Error[%s/%s]\n\n",thisprog,message); exit(1); }
+	}}
+
 	/* PRINT OUTPUT IN SINGLE-LINE MODE */
 	if(setformat==0) {
 		fprintf(fpout,"%ld\t%lg\t%lg\t%lg\t%lg\t%lg\t%lg\t%lg\t%lg\t%lg",
 			n,sum,mean,min,max,(max-min),variance,stddev,sem,skew);
-		if(percalc==1) { // IF PERCENTILES ARE REQUIRED
-
-			z=xf_percentile1_d(data,n,result_d);
-			if(z!=0) {fprintf(stderr,"\t\aError[%s]: insufficient memory for calculation of percentiles\n",thisprog);exit(1);}
-			else for(i=0;i<11;i++) fprintf(fpout,"\t%lg",result_d[i]);
+		if(percalc>0) { // IF PERCENTILES ARE REQUIRED
+			for(i=0;i<11;i++) fprintf(fpout,"\t%lg",result_d[i]);
 		}
 		fprintf(fpout,"\n");
 	}
@@ -204,11 +238,7 @@ int main (int argc, char *argv[]) {
 		fprintf(fpout,"STDDEV %lf\n",stddev);
 		fprintf(fpout,"SEM %lf\n",sem);
 		fprintf(fpout,"SKEW %lf\n",skew);
-		if(percalc==1) { // IF PERCENTILES ARE REQUIRED
-
-			z=xf_percentile1_d(data,n,result_d);
-			if(z!=0) {fprintf(stderr,"\t\aError[%s]: insufficient memory for calculation of percentiles\n",thisprog);exit(1);}
-
+		if(percalc>0) { // IF PERCENTILES ARE REQUIRED
 			fprintf(fpout,"\n");
 			fprintf(fpout,"PERCENTILE_1	%lg\n",result_d[0]);
 			fprintf(fpout,"PERCENTILE_2.5	%lg\n",result_d[1]);
@@ -229,5 +259,6 @@ int main (int argc, char *argv[]) {
 	if(strcmp(outfile,"stdout")!=0) fclose(fpout);
 	free(line);
 	free(data);
+	if(sketch!=NULL) free(sketch);
 	exit(0);
 }
@@ -68,6 +68,7 @@ v 2.1: 14 August 2011 [JRH]
 /* external functions start */
 int xf_precision_d(double number,int max);
 int xf_percentile1_d(double *data, long n, double *result);
+double xf_select1_d(double *data, long nn, long kk);
 int xf_compare1_d(const void *a, const void *b);
 /* external functions end */
 
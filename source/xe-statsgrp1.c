@@ -4,11 +4,16 @@
 #include <string.h>
 
 #define thisprog "xe-statsgrp1"
-#define TITLE_STRING thisprog" v 9: 29.April.2019 [JRH]"
+#define TITLE_STRING thisprog" v 10: 18.October.2026 [JRH]"
 
 /*
 <TAGS>math stats</TAGS>
 
+v 10: 18.October.2026 [JRH]
+	- use new group-by function xf_groupstats1_d
+		- rows are sorted once by the combined group-key, and stats for each group are calculated in a single pass
+		- previously all rows were re-scanned for every possible combination of group-values
+
 v 9: 29.April.2019 [JRH]
 	- rework so "grep -vE" can be used to generate code for xe-statsgroup2 and xe-statsgroup1 from xe-statsgroup3
 
@@ -64,21 +69,23 @@ v 1: 9.September.2012 [JRH]
 /* external functions start */
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
-void xf_stats2_d(double *data, long n, int varcalc, double *result_d);
-int xf_compare1_d(const void *a, const void *b);
+long xf_groupstats1_d(double **group, long ngrp, double *data, long nn, long **grpindex, double **grpstats, char *message);
+void xf_accinit1_d(double *acc);
+long xf_accadd1_d(double *acc, double *data, long nn);
+long xf_accresult1_d(double *acc, double *result_d);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
 	/* general variables */
-	char *line=NULL;
+	char *line=NULL,message[256];
 	long int ii,jj,kk,mm,nn,maxlinelen=0;
-	double aa,bb,cc,dd,result_d[64];
+	double aa,bb,cc,dd,*result_d=NULL;
 	FILE *fpin;
 	/* program-specific variables */
-	double *grp1=NULL,*listgrp1=NULL; long nlistgrp1=0; int sizeofgrp1=sizeof(*grp1); double tempgrp1;
+	double *grp1=NULL; int sizeofgrp1=sizeof(*grp1); double tempgrp1;
 	long nwords=0,*iword=NULL,colmatch;
-	long ntempdata=0,ngrptot=0;
-	double *data=NULL,*tempdata=NULL;
+	long ngrp=0,ngroups=0,*grpindex=NULL;
+	double *data=NULL,*group[3];
 	int sizeofdata=sizeof(*data);
 	/* arguments */
 	char *infile=NULL;
@@ -174,64 +181,29 @@ int main (int argc, char *argv[]) {
 	if(strcmp(infile,"stdin")!=0) fclose(fpin);
 
 
-	/* ALLOCATE MEMORY FOR LISTS AND TEMPDATA */
-	listgrp1= realloc(listgrp1,(nn+1)*sizeofgrp1);
-	tempdata= realloc(tempdata,(nn+1)*sizeofdata);
-	if(
-		listgrp1==NULL
-	) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
-
-
-	/* CREATE A SORTED LIST OF THE ELEMENTS IN grp1 */
-	for(ii=0;ii<nn;ii++) listgrp1[ii]= grp1[ii];
-	qsort(listgrp1,nn,sizeof(double),xf_compare1_d);
-	/* copy only unique items to new version of listgrp1 */
-	aa=listgrp1[0]; for(ii=nlistgrp1=1;ii<nn;ii++) {if(listgrp1[ii]!=aa) listgrp1[nlistgrp1++]=listgrp1[ii];aa=listgrp1[ii]; }
-
+	/* SORT THE ROWS BY GROUP AND CALCULATE STATS ON DATA IN EACH COMBINATION OF GROUP-CATEGORIES */
+	group[ngrp++]= grp1;
+	ngroups= xf_groupstats1_d(group,ngrp,data,nn,&grpindex,&result_d,message);
+	if(ngroups<0) { fprintf(stderr,"\n--- Error[%s/%s]\n\n",thisprog,message); exit(1); }
 
-
-
-
-	/* CALCULATE STATS ON DATA IN EACH COMBINATION OF GROUP-CATEGORIES */
 	printf("grp1\t");
 	printf("n\tmean\tsd\tsem\tntot\n");
-	for(ii=0;ii<nlistgrp1;ii++)
-	{
-		//printf("%g\n",listgrp1[ii]);
-		{
-			{
-				ngrptot= 0;
-				result_d[0]=result_d[2]=result_d[3]= NAN;
-				/* copy the good data for this category to a temp array */
-				ntempdata=0;
-				for(mm=0;mm<nn;mm++) {
-					if(
-						grp1[mm]==listgrp1[ii]
-					) {
-						ngrptot++;
-						if(isfinite(data[mm])) tempdata[ntempdata++]= data[mm];
-				}}
-				if(ngrptot<=0) continue;
-				/* get stats on the temp array */
-				if(ntempdata>0) xf_stats2_d(tempdata,ntempdata,2,result_d);
-				/* output the results */
-				if(setgint==0) {
-					printf("%g\t",listgrp1[ii]);
-					printf("%ld\t%g\t%g\t%g\t%ld\n",ntempdata,result_d[0],result_d[2],result_d[3],ngrptot);
-				}
-				else {
-					printf("%ld\t",(long)listgrp1[ii]);
-					printf("%ld\t%g\t%g\t%g\t%ld\n",ntempdata,result_d[0],result_d[2],result_d[3],ngrptot);
-				}
-			}
+	for(ii=0;ii<ngroups;ii++) {
+		jj= grpindex[ii];
+		if(setgint==0) {
+			printf("%g\t",grp1[jj]);
+		}
+		else {
+			printf("%ld\t",(long)grp1[jj]);
 		}
+		printf("%ld\t%g\t%g\t%g\t%ld\n",(long)result_d[ii*5+1],result_d[ii*5+2],result_d[ii*5+3],result_d[ii*5+4],(long)result_d[ii*5+0]);
 	}
 
 	if(line!=NULL) free(line);
 	if(iword!=NULL) free(iword);
 	if(grp1!=NULL) free(grp1);
-	if(listgrp1!=NULL) free(listgrp1);
 	if(data!=NULL) free(data);
-	if(tempdata!=NULL) free(tempdata);
+	if(grpindex!=NULL) free(grpindex);
+	if(result_d!=NULL) free(result_d);
 	exit(0);
 }
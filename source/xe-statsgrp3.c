@@ -6,11 +6,17 @@
 #define thisprog "xe-statsgrp1"
 #define thisprog "xe-statsgrp2"
 #define thisprog "xe-statsgrp3"
-#define TITLE_STRING thisprog" v 9: 29.April.2019 [JRH]"
+#define TITLE_STRING thisprog" v 10: 18.October.2026 [JRH]"
 
 /*
 <TAGS>math stats</TAGS>
 
+v 10: 18.October.2026 [JRH]
+	- use new group-by function xf_groupstats1_d
+		- rows are sorted once by the combined group-key, and stats for each group are calculated in a single pass
+		- previously all rows were re-scanned for every possible combination of group-values
+	- xe-statsgrp2 and xe-statsgrp1 can still be generated from this code using "grep -vE" (see v 9)
+
 v 9: 29.April.2019 [JRH]
 	- rework so "grep -vE" can be used to generate code for xe-statsgroup2 and xe-statsgroup1 from xe-statsgroup3
 		grep -vE 'grp3|cg3' xe-statsgrp3.c > xe-statsgrp2.c
@@ -70,23 +76,25 @@ v 1: 9.September.2012 [JRH]
 /* external functions start */
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse2(char *line,char *delimiters, long *nwords);
-void xf_stats2_d(double *data, long n, int varcalc, double *result_d);
-int xf_compare1_d(const void *a, const void *b);
+long xf_groupstats1_d(double **group, long ngrp, double *data, long nn, long **grpindex, double **grpstats, char *message);
+void xf_accinit1_d(double *acc);
+long xf_accadd1_d(double *acc, double *data, long nn);
+long xf_accresult1_d(double *acc, double *result_d);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
 	/* general variables */
-	char *line=NULL;
+	char *line=NULL,message[256];
 	long int ii,jj,kk,mm,nn,maxlinelen=0;
-	double aa,bb,cc,dd,result_d[64];
+	double aa,bb,cc,dd,*result_d=NULL;
 	FILE *fpin;
 	/* program-specific variables */
-	double *grp1=NULL,*listgrp1=NULL; long nlistgrp1=0; int sizeofgrp1=sizeof(*grp1); double tempgrp1;
-	double *grp2=NULL,*listgrp2=NULL; long nlistgrp2=0; int sizeofgrp2=sizeof(*grp2); double tempgrp2;
-	double *grp3=NULL,*listgrp3=NULL; long nlistgrp3=0; int sizeofgrp3=sizeof(*grp3); double tempgrp3;
+	double *grp1=NULL; int sizeofgrp1=sizeof(*grp1); double tempgrp1;
+	double *grp2=NULL; int sizeofgrp2=sizeof(*grp2); double tempgrp2;
+	double *grp3=NULL; int sizeofgrp3=sizeof(*grp3); double tempgrp3;
 	long nwords=0,*iword=NULL,colmatch;
-	long ntempdata=0,ngrptot=0;
-	double *data=NULL,*tempdata=NULL;
+	long ngrp=0,ngroups=0,*grpindex=NULL;
+	double *data=NULL,*group[3];
 	int sizeofdata=sizeof(*data);
 	/* arguments */
 	char *infile=NULL;
@@ -211,85 +219,31 @@ int main (int argc, char *argv[]) {
 	//TEST:	for(ii=0;ii<nn;ii++) printf("%g\t%g\t%g\t%g\n",grp1[ii],grp2[ii],grp3[ii],data[ii]); exit(0);
 
 
-	/* ALLOCATE MEMORY FOR LISTS AND TEMPDATA */
-	listgrp1= realloc(listgrp1,(nn+1)*sizeofgrp1);
-	listgrp2= realloc(listgrp2,(nn+1)*sizeofgrp2);
-	listgrp3= realloc(listgrp3,(nn+1)*sizeofgrp3);
-	tempdata= realloc(tempdata,(nn+1)*sizeofdata);
-	if(
-		listgrp1==NULL
-		|| listgrp2==NULL
-		|| listgrp3==NULL
-	) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
-
-
-	/* CREATE A SORTED LIST OF THE ELEMENTS IN grp1 */
-	for(ii=0;ii<nn;ii++) listgrp1[ii]= grp1[ii];
-	qsort(listgrp1,nn,sizeof(double),xf_compare1_d);
-	/* copy only unique items to new version of listgrp1 */
-	aa=listgrp1[0]; for(ii=nlistgrp1=1;ii<nn;ii++) {if(listgrp1[ii]!=aa) listgrp1[nlistgrp1++]=listgrp1[ii];aa=listgrp1[ii]; }
-
-	/* CREATE A SORTED LIST OF THE ELEMENTS IN grp2 */
-	for(ii=0;ii<nn;ii++) listgrp2[ii]=grp2[ii];
-	qsort(listgrp2,nn,sizeof(double),xf_compare1_d);
-	/* copy only unique items to new version of listgrp2 */
-	aa=listgrp2[0]; for(ii=nlistgrp2=1;ii<nn;ii++) {if(listgrp2[ii]!=aa) listgrp2[nlistgrp2++]=listgrp2[ii];aa=listgrp2[ii]; }
+	/* SORT THE ROWS BY GROUP AND CALCULATE STATS ON DATA IN EACH COMBINATION OF GROUP-CATEGORIES */
+	group[ngrp++]= grp1;
+	group[ngrp++]= grp2;
+	group[ngrp++]= grp3;
+	ngroups= xf_groupstats1_d(group,ngrp,data,nn,&grpindex,&result_d,message);
+	if(ngroups<0) { fprintf(stderr,"\n--- Error[%s/%s]\n\n",thisprog,message); exit(1); }
 
-	/* CREATE A SORTED LIST OF THE ELEMENTS IN grp3 */
-	for(ii=0;ii<nn;ii++) listgrp3[ii]=grp3[ii];
-	qsort(listgrp3,nn,sizeof(double),xf_compare1_d);
-	/* copy only unique items to new version of listgrp3 */
-	aa=listgrp3[0]; for(ii=nlistgrp3=1;ii<nn;ii++) {if(listgrp3[ii]!=aa) listgrp3[nlistgrp3++]=listgrp3[ii];aa=listgrp3[ii]; }
-
-	//TEST:	for(ii=0;ii<nn;ii++) printf("%g\t%g\t%g\t%g\n",listgrp1[ii],listgrp2[ii],listgrp3[ii],data[ii]); exit(0);
-	//TEST:	printf("1:%ld\n2:%ld\n3:%ld\n",nlistgrp1,nlistgrp2,nlistgrp3);exit(0);
-
-
-	/* CALCULATE STATS ON DATA IN EACH COMBINATION OF GROUP-CATEGORIES */
+	/* OUTPUT THE RESULTS - groups are in ascending order of grp1, then grp2, etc. */
 	printf("grp1\t");
 	printf("grp2\t");
 	printf("grp3\t");
 	printf("n\tmean\tsd\tsem\tntot\n");
-	for(ii=0;ii<nlistgrp1;ii++)
-	{
-		//printf("%g\n",listgrp1[ii]);
-		for(jj=0;jj<nlistgrp2;jj++)
-		{
-			//printf("\t%g\n",listgrp2[jj]);
-			for(kk=0;kk<nlistgrp3;kk++)
-			{
-				//printf("\t\t%g\n",listgrp3[kk]); continue;
-				ngrptot= 0;
-				result_d[0]=result_d[2]=result_d[3]= NAN;
-				/* copy the good data for this category to a temp array */
-				ntempdata=0;
-				for(mm=0;mm<nn;mm++) {
-					if(
-						grp1[mm]==listgrp1[ii]
-						&& grp2[mm]==listgrp2[jj]
-						&& grp3[mm]==listgrp3[kk]
-					) {
-						ngrptot++;
-						if(isfinite(data[mm])) tempdata[ntempdata++]= data[mm];
-				}}
-				if(ngrptot<=0) continue;
-				/* get stats on the temp array */
-				if(ntempdata>0) xf_stats2_d(tempdata,ntempdata,2,result_d);
-				/* output the results */
-				if(setgint==0) {
-					printf("%g\t",listgrp1[ii]);
-					printf("%g\t",listgrp2[jj]);
-					printf("%g\t",listgrp3[kk]);
-					printf("%ld\t%g\t%g\t%g\t%ld\n",ntempdata,result_d[0],result_d[2],result_d[3],ngrptot);
-				}
-				else {
-					printf("%ld\t",(long)listgrp1[ii]);
-					printf("%ld\t",(long)listgrp2[jj]);
-					printf("%ld\t",(long)listgrp3[kk]);
-					printf("%ld\t%g\t%g\t%g\t%ld\n",ntempdata,result_d[0],result_d[2],result_d[3],ngrptot);
-				}
-			}
+	for(ii=0;ii<ngroups;ii++) {
+		jj= grpindex[ii];
+		if(setgint==0) {
+			printf("%g\t",grp1[jj]);
+			printf("%g\t",grp2[jj]);
+			printf("%g\t",grp3[jj]);
+		}
+		else {
+			printf("%ld\t",(long)grp1[jj]);
+			printf("%ld\t",(long)grp2[jj]);
+			printf("%ld\t",(long)grp3[jj]);
 		}
+		printf("%ld\t%g\t%g\t%g\t%ld\n",(long)result_d[ii*5+1],result_d[ii*5+2],result_d[ii*5+3],result_d[ii*5+4],(long)result_d[ii*5+0]);
 	}
 
 	if(line!=NULL) free(line);
@@ -297,10 +251,8 @@ int main (int argc, char *argv[]) {
 	if(grp1!=NULL) free(grp1);
 	if(grp2!=NULL) free(grp2);
 	if(grp3!=NULL) free(grp3);
-	if(listgrp1!=NULL) free(listgrp1);
-	if(listgrp2!=NULL) free(listgrp2);
-	if(listgrp3!=NULL) free(listgrp3);
 	if(data!=NULL) free(data);
-	if(tempdata!=NULL) free(tempdata);
+	if(grpindex!=NULL) free(grpindex);
+	if(result_d!=NULL) free(result_d);
 	exit(0);
 }
@@ -5,11 +5,15 @@
 #include <float.h>
 
 #define thisprog "xe-statsrow1"
-#define TITLE_STRING thisprog" v 3: 24.November.2018 [JRH]"
+#define TITLE_STRING thisprog" v 4: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 
 /*
 <TAGS>math stats</TAGS>
+v 4: 18.October.2026 [JRH]
+	- standard deviation (-t 4) uses a streaming accumulator (xf_accadd1_d) instead of sums of squares
+		- avoids loss of precision for rows with a large mean relative to the variance
+
 v 3: 24.November.2018 [JRH]
 	- fix uninitialized value for nn in some conditions
 	- update variable namig and infile definition
@@ -27,6 +31,9 @@ v 2: 24 October.2014 [JRH]
 
 /* external functions start */
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
+void xf_accinit1_d(double *acc);
+long xf_accadd1_d(double *acc, double *data, long nn);
+long xf_accresult1_d(double *acc, double *result_d);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -38,7 +45,7 @@ int main (int argc, char *argv[]) {
 	double aa,bb;
 	FILE *fpin,*fpout;
 	/* program-specific variables */
-	double sum,sumsquares;
+	double sum,sumsquares,acc[8],result_d[8];
 	/* arguments */
 	char *infile=NULL;
 	int setstat=3;
@@ -140,21 +147,15 @@ int main (int argc, char *argv[]) {
 		while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
 			if(maxlinelen==-1)  {fprintf(stderr,"\n--- Error[%s]: readline function encountered insufficient memory\n\n",thisprog);exit(1);}
 			pline=line;
-			sum=sumsquares=0.0; nn=0;
+			xf_accinit1_d(acc);
 			for(col=1;(pcol=strtok(pline," ,\t\n\r"))!=NULL;col++) {
 				pline=NULL;
-				if(sscanf(pcol,"%lf",&aa)==1) {
-					if(isfinite(aa)) {
-					sum+=aa;
-					sumsquares+=aa*aa;
-					nn++;
-			}}}
+				if(sscanf(pcol,"%lf",&aa)==1) xf_accadd1_d(acc,&aa,1);
+			}
+			nn= xf_accresult1_d(acc,result_d);
 			if(nn==0) printf("NAN\n");
-			else {
-				if(nn>1)	bb= ( sumsquares - ( (sum*sum)/(double)nn )) / ((double)nn-1.0) ;
-				else bb=0.0;
-				printf("%lf\n",(sqrt(bb)));
-		}}
+			else printf("%lf\n",result_d[2]);
+		}
 	}
 	/* output the sample-number corresponding to the peak for each line (requires finite values) */
 	if(setstat==5||setstat==6) {
@@ -4,13 +4,20 @@
 #include <string.h>
 
 #define thisprog "xe-transpose4"
-#define TITLE_STRING thisprog" v 8: 4.April.2018 [JRH]"
+#define TITLE_STRING thisprog" v 8: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
+#define BLOCKSIZE 4096
 #define MAXLABELS 1000
 
 /*
 <TAGS>math stats</TAGS>
 
+v 8: 18.October.2026 [JRH]
+	- reshape using a single sort of integer-coded groups (xf_groupsort1_d) instead of rescanning the data for every cell
+		- time is now proportional to N log N rather than subjects x groups x levels x N
+	- storage is allocated in blocks rather than per line
+	- bugfix: setting -cg2 to 0 previously rejected every line - now all subjects are placed in group "1" as documented
+
 v 7: 26.January.2021 [JRH]
 	- add control of decimal precision (-p) for repeated measure (g3)
 
@@ -51,21 +58,22 @@ v 1: 9.September.2012 [JRH]
 
 
 /* external functions start */
-void xf_stats2_d(double *data, long n, int varcalc, double *result_d);
-int xf_compare1_d(const void *a, const void *b);
+long xf_groupsort1_d(double **key, long nkeys, long nn, long *index, long *group, char *message);
+void xf_qsortindex1_d(double *data, long *index,long nn);
+void xf_qsortindex1_l(long *data, long *index,long nn);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
 	/* general variables */
-	char line[MAXLINELEN],templine[MAXLINELEN],*pline,*pcol;
+	char line[MAXLINELEN],templine[MAXLINELEN],*pline,*pcol,message[MAXLINELEN];
 	long int ii,jj,kk,ll,mm,nn,col,colmatch;
 	double aa,bb,cc,dd,result_d[64];
 	FILE *fpin,*fpout;
 	/* program-specific variables */
 	int sizeofgrp1,sizeofgrp2,sizeofgrp3,sizeofdata;
-	long nlistgrp1=0,nlistgrp2=0,nlistgrp3=0,ntempdata=0,count;
-	double *grp1=NULL,*grp2=NULL,*grp3=NULL,*listgrp1=NULL,*listgrp2=NULL,*listgrp3=NULL;
-	double *data=NULL,*tempdata=NULL;
+	long nlistgrp3=0,count,*index=NULL,*code3=NULL,*group=NULL;
+	double *grp1=NULL,*grp2=NULL,*grp3=NULL,*listgrp3=NULL,*key[3];
+	double *data=NULL;
 	/* arguments */
 	char *infile=NULL,*setmissing=NULL;
 	int setgint=0,setcolg1=1,setcolg2=2,setcolg3=3,setcoldata=4,setp=-1;
@@ -134,6 +142,7 @@ int main (int argc, char *argv[]) {
 	while(fgets(line,MAXLINELEN,fpin)!=NULL) {
 		if(line[0]=='#') continue;
 		pline=line; colmatch=4; // number of columns to match
+		if(setcolg2==0) { bb=1.0; colmatch--; } // no between-subjects grouping column
 		for(col=1;(pcol=strtok(pline," ,\t\n\r"))!=NULL;col++) {
 			pline=NULL;
 			if(col==setcolg1 && sscanf(pcol,"%lf",&aa)==1) colmatch--;
@@ -142,11 +151,13 @@ int main (int argc, char *argv[]) {
 			if(col==setcoldata && sscanf(pcol,"%lf",&dd)==1) colmatch--;
 		}
 		if(colmatch!=0 || !isfinite(aa) || !isfinite(bb) || !isfinite(cc) || !isfinite(dd)) continue;
-		grp1= realloc(grp1,(nn+1)*sizeofgrp1);
-		grp2= realloc(grp2,(nn+1)*sizeofgrp2);
-		grp3= realloc(grp3,(nn+1)*sizeofgrp3);
-		data= realloc(data,(nn+1)*sizeofdata);
-		if(grp1==NULL||grp2==NULL||grp3==NULL||data==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		if((nn%BLOCKSIZE)==0) {
+			grp1= realloc(grp1,(nn+BLOCKSIZE)*sizeofgrp1);
+			grp2= realloc(grp2,(nn+BLOCKSIZE)*sizeofgrp2);
+			grp3= realloc(grp3,(nn+BLOCKSIZE)*sizeofgrp3);
+			data= realloc(data,(nn+BLOCKSIZE)*sizeofdata);
+			if(grp1==NULL||grp2==NULL||grp3==NULL||data==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+		}
 		grp1[nn]= aa;
 		grp2[nn]= bb;
 		grp3[nn]= cc;
@@ -157,58 +168,47 @@ int main (int argc, char *argv[]) {
 	//TEST:	for(ii=0;ii<nn;ii++) printf("%g\t%g\t%g\n",grp1[ii],grp2[ii],grp3[ii],data[ii]); exit(0);
 
 
-	/* ALLOCATE MEMORY FOR LISTS AND TEMPDATA */
-	listgrp1= realloc(listgrp1,(nn+1)*sizeofgrp1);
-	listgrp2= realloc(listgrp2,(nn+1)*sizeofgrp2);
-	listgrp3= realloc(listgrp3,(nn+1)*sizeofgrp3);
-	tempdata= realloc(tempdata,(nn+1)*sizeofdata);
-	if(listgrp1==NULL||listgrp2==NULL||listgrp3==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
-
-	/* CREATE A SORTED LIST OF THE ELEMENTS IN GRP1 */
-	for(ii=0;ii<nn;ii++) listgrp1[ii]= grp1[ii];
-	qsort(listgrp1,nn,sizeof(double),xf_compare1_d);
-	/* copy only unique items to new version of listgrp1 */
-	aa=listgrp1[0]; for(ii=nlistgrp1=1;ii<nn;ii++) {if(listgrp1[ii]!=aa) listgrp1[nlistgrp1++]=listgrp1[ii];aa=listgrp1[ii]; }
-	/* CREATE A SORTED LIST OF THE ELEMENTS IN GRP2 */
-	for(ii=0;ii<nn;ii++) listgrp2[ii]=grp2[ii];
-	qsort(listgrp2,nn,sizeof(double),xf_compare1_d);
-	/* copy only unique items to new version of listgrp2 */
-	aa=listgrp2[0]; for(ii=nlistgrp2=1;ii<nn;ii++) {if(listgrp2[ii]!=aa) listgrp2[nlistgrp2++]=listgrp2[ii];aa=listgrp2[ii]; }
-	/* CREATE A SORTED LIST OF THE ELEMENTS IN GRP3 */
-	for(ii=0;ii<nn;ii++) listgrp3[ii]=grp3[ii];
-	qsort(listgrp3,nn,sizeof(double),xf_compare1_d);
-	/* copy only unique items to new version of listgrp3 */
-	aa=listgrp3[0]; for(ii=nlistgrp3=1;ii<nn;ii++) {if(listgrp3[ii]!=aa) listgrp3[nlistgrp3++]=listgrp3[ii];aa=listgrp3[ii]; }
-	//TEST:for(ii=0;ii<nn;ii++) printf("%g\t%g\t%g\t\t%g\n",listgrp1[ii],listgrp2[ii],listgrp3[ii],data[ii]); exit(0);
-	//TEST: printf("1:%ld\n2:%ld\n3:%ld\n",nlistgrp1,nlistgrp2,nlistgrp3);exit(0);
+	/* ALLOCATE MEMORY FOR THE GROUPING ARRAYS */
+	index= malloc((nn+1)*sizeof(*index));
+	group= malloc((nn+1)*sizeof(*group));
+	code3= malloc((nn+1)*sizeof(*code3));
+	listgrp3= malloc((nn+1)*sizeofgrp3);
+	if(index==NULL||group==NULL||code3==NULL||listgrp3==NULL) {fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog);exit(1);};
+
+	/* CODE THE REPEATED-MEASURE LEVELS (OUTPUT COLUMNS) AS INTEGERS, AND MAKE THE SORTED LIST OF LEVELS */
+	key[0]= grp3;
+	nlistgrp3= xf_groupsort1_d(key,1,nn,index,code3,message);
+	if(nlistgrp3<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	for(ii=0;ii<nn;ii++) listgrp3[code3[ii]]= grp3[ii];
 
+	/* SORT THE ROWS BY GRP1, GRP2 AND GRP3 - ROWS WITH THE SAME GROUPS KEEP THEIR INPUT ORDER */
+	key[0]= grp1;
+	key[1]= grp2;
+	key[2]= grp3;
+	if(xf_groupsort1_d(key,3,nn,index,group,message)<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
 
 	/* OUTPUT THE HEADER */
 	printf("subj\tgrp"); for(kk=0;kk<nlistgrp3;kk++) printf("\tr_%g",listgrp3[kk]); printf("\n");
 
-	/* TRANSPOSE THE DATA */
-	for(ii=0;ii<nlistgrp1;ii++) {
-		for(jj=0;jj<nlistgrp2;jj++) {
+	/* TRANSPOSE THE DATA - EACH SUBJECT/GROUP COMBINATION IS A CONTIGUOUS BLOCK OF THE SORTED ROWS */
+	for(ii=0;ii<nn;ii=jj) {
+		mm= index[ii];
+		for(jj=ii;jj<nn && grp1[index[jj]]==grp1[mm] && grp2[index[jj]]==grp2[mm];jj++);
+		if(setgint==0) printf("%f\t%f",grp1[mm],grp2[mm]);
+		else           printf("%ld\t%ld",(long)grp1[mm],(long)grp2[mm]);
+		/* within the block, rows are sorted by level - output every value at each level */
+		ll= ii;
+		for(kk=0;kk<nlistgrp3;kk++) {
 			count=0;
-			for(mm=0;mm<nn;mm++) { if(grp1[mm]==listgrp1[ii] && grp2[mm]==listgrp2[jj]) { count=1; break; }	}
-			if(count==0) continue;
-			if(setgint==0) printf("%f\t%f",listgrp1[ii],listgrp2[jj]);
-			else           printf("%ld\t%ld",(long)listgrp1[ii],(long)listgrp2[jj]);
-			for(kk=0;kk<nlistgrp3;kk++) {
-				count=0;
-				for(mm=0;mm<nn;mm++) {
-					if(grp1[mm]==listgrp1[ii] && grp2[mm]==listgrp2[jj] && grp3[mm]==listgrp3[kk]) {
-						if(setp>0) printf("\t%.*f",setp,data[mm]);
-						else if(setp==0) printf("\t%g",data[mm]);
-						else printf("\t%f",data[mm]);
-						count++;
-					}
-				}
-				if(count==0) printf("\t%s",setmissing);
-				//TEST:	fprintf(stderr,"%g	%g	%g	%ld\n",listgrp1[i],listgrp2[j],listgrp3[k],count);
+			for(;ll<jj && code3[index[ll]]==kk;ll++) {
+				if(setp>0) printf("\t%.*f",setp,data[index[ll]]);
+				else if(setp==0) printf("\t%g",data[index[ll]]);
+				else printf("\t%f",data[index[ll]]);
+				count++;
 			}
-			printf("\n");
+			if(count==0) printf("\t%s",setmissing);
 		}
+		printf("\n");
 	}
 
 
@@ -216,10 +216,10 @@ int main (int argc, char *argv[]) {
 	free(grp1);
 	free(grp2);
 	free(grp3);
-	free(listgrp1);
-	free(listgrp2);
 	free(listgrp3);
 	free(data);
-	free(tempdata);
+	free(index);
+	free(group);
+	free(code3);
 	exit(0);
 }
@@ -4,13 +4,19 @@
 #include <math.h>
 
 #define thisprog "xe-trimoutliers1"
-#define TITLE_STRING thisprog" v 2: 14.August.2012 [JRH]"
+#define TITLE_STRING thisprog" v 3: 18.October.2026 [JRH]"
 #define MAXLINELEN 1000
 #define MAXGROUP 8000
 
 /*
 <TAGS>filter signal_processing</TAGS>
 
+v 3: 18.October.2026 [JRH]
+	- add -sort option: if set to 0, cutoffs are found by selection (xf_select1_d) instead of sorting
+		- output is then in the original order, and time is O(N) instead of O(N*log(N))
+	- bugfix: a lower cutoff of 0 no longer reads before the start of the data
+	- store data in blocks instead of calling realloc for every value
+
 v 2: 14.August.2012 [JRH]
 	- bugfix - changed use of fscanf to read data with fgets/sscanf, to avoid problems related to "-" and "."
 */
@@ -31,6 +37,8 @@ void xfinternal_minisortf(double *array,long n) {
 
 
 /* external functions start */
+double xf_select1_d(double *data, long nn, long kk);
+int xf_compare1_d(const void *a, const void *b);
 /* external functions end */
 
 int main (int argc, char *argv[]) {
@@ -43,9 +51,10 @@ int main (int argc, char *argv[]) {
 	double aa,bb,cc,result_d[64];
 	FILE *fpin,*fpout;
 	/* program-specific variables */
-	double *data=NULL,min,max,lcut,ucut;
+	double *data=NULL,*temp=NULL,min,max,lcut,ucut;
+	long nalloc=0;
 	/* arguments */
-	int groupcol=-1,varcalc=2;
+	int groupcol=-1,varcalc=2,setsort=1;
 	float setlower=0.0,setupper=100.0;
 
 	void xfinternal_minisortf(double *array,long n);
@@ -63,10 +72,12 @@ int main (int argc, char *argv[]) {
 		fprintf(stderr,"OPTIONS ( defaults in [] ):\n");
 		fprintf(stderr,"	-l lower percentile cutoff [%g]\n",setlower);
 		fprintf(stderr,"	-u upper percentile cutoff [%g]\n",setupper);
+		fprintf(stderr,"	-sort output sorted data (0=NO 1=YES) [%d]\n",setsort);
+		fprintf(stderr,"		0= output in original order (faster for very large inputs)\n");
 		fprintf(stderr,"EXAMPLES:\n");
 		fprintf(stderr,"	%s data.txt -l 10 -u 90\n",thisprog);
 		fprintf(stderr,"	cat temp.txt | %s stdin -l 25 -u 75\n",thisprog);
-		fprintf(stderr,"OUTPUT: trimmed and sorted dataset\n");
+		fprintf(stderr,"OUTPUT: trimmed dataset (sorted unless -sort 0)\n");
 		fprintf(stderr,"----------------------------------------------------------------------\n");
 		fprintf(stderr,"\n");
 		exit(0);
@@ -79,11 +90,13 @@ int main (int argc, char *argv[]) {
 			if((i+1)>=argc) {fprintf(stderr,"\n--- Error[%s]: missing value for argument \"%s\"\n\n",thisprog,argv[i]); exit(1);}
 			else if(strcmp(argv[i],"-l")==0) 	{ setlower=atof(argv[i+1]); i++;}
 			else if(strcmp(argv[i],"-u")==0) 	{ setupper=atof(argv[i+1]); i++;}
+			else if(strcmp(argv[i],"-sort")==0) 	{ setsort=atoi(argv[i+1]); i++;}
 			else {fprintf(stderr,"\t\aError[%s]: invalid command line argument \"%s\"\n",thisprog,argv[i]); exit(1);}
 	}}
 
 	// CHECK VALIDITY OF ARGUMENTS
 	if(setlower<0||setlower>100|setupper<0||setupper>100) {fprintf(stderr,"\n--- Error[%s]: -l and -u must specify a percentile from 0-100\n\n",thisprog); exit(1);}
+	if(setsort!=0 && setsort!=1) {fprintf(stderr,"\n--- Error[%s]: -sort (%d) must be 0 or 1\n\n",thisprog,setsort); exit(1);}
 	if(setlower>=setupper) {fprintf(stderr,"\n--- Error[%s]: -l (%g) must be less than -u (%g)\n\n",thisprog,setlower,setupper); exit(1);}
 
 	// CONVERT PERCENTILES TO FRACTIONS
@@ -96,27 +109,52 @@ int main (int argc, char *argv[]) {
 	while(fgets(line,MAXLINELEN,fpin)!=NULL) {
 		if(sscanf(line,"%lf",&aa)!=1) continue;
 		if(isfinite(aa)) {
-			data=(double *)realloc(data,(n+1)*sizeofdouble);
-			if(data==NULL) {fprintf(stderr,"\t\aError[%s]: insufficient memory\n",thisprog);exit(1);}
+			if(n>=nalloc) {
+				nalloc+= 100000;
+				data=(double *)realloc(data,nalloc*sizeofdouble);
+				if(data==NULL) {fprintf(stderr,"\t\aError[%s]: insufficient memory\n",thisprog);exit(1);}
+			}
 			data[n++]=aa;
 	}}
 	if(strcmp(infile,"stdin")!=0) fclose(fpin);
 
-	// SORT THE DATA
-	xfinternal_minisortf(data,n);
+	if(n<1) { free(data); exit(0); }
+
+	// SORT THE DATA - or, if the output order is to be preserved, select the cutoffs from a copy
+	if(setsort==1) temp=data;
+	else {
+		temp=(double *)malloc(n*sizeofdouble);
+		if(temp==NULL) {fprintf(stderr,"\t\aError[%s]: insufficient memory\n",thisprog);exit(1);}
+		for(i=0;i<n;i++) temp[i]=data[i];
+	}
+	if(setsort==1) xfinternal_minisortf(data,n);
 
 	// GET LOWER & UPPER CUTOFFS
-	a=n*setlower; j=(int)a;	if(j<0)j=0;	// calculate the lower cutoff - make an integer version
-	if(a!=(double)j) lcut=data[j];  	// if the percentile limit does not fall exactly on an item, cutoff is unchanged
-	else lcut=(data[j]+data[j-1])/2.0;  // otherwise if the cutoff is exactly an item number, take the avergage of this point and the previous item
+	// if the percentile limit does not fall exactly on an item, cutoff is unchanged
+	// otherwise if the cutoff is exactly an item number, take the avergage of this point and the previous item
+	a=n*setlower; j=(long)a; if(j<0)j=0;	// calculate the lower cutoff - make an integer version
+	if(j>=n) { j=n-1; a=0.5; }
+	if(setsort==0) xf_select1_d(temp,n,j); // after selection, temp[j] is in place and all items below are <=
+	lcut=temp[j];
+	if(a==(double)j && j>0) {
+		if(setsort==1) bb=temp[j-1];
+		else for(k=1,bb=temp[0];k<j;k++) if(temp[k]>bb) bb=temp[k];
+		lcut=(lcut+bb)/2.0;
+	}
 
-	a=n*setupper; j=(int)a;	if(j>=n)j=n-1;	// repeat for the upper cutoff
-	if(a!=(double)j) ucut=data[j];
-	else ucut=(data[j]+data[j-1])/2.0;
+	a=n*setupper; j=(long)a; if(j>=n) { j=n-1; a=0.5; }	// repeat for the upper cutoff
+	if(setsort==0) xf_select1_d(temp,n,j);
+	ucut=temp[j];
+	if(a==(double)j && j>0) {
+		if(setsort==1) bb=temp[j-1];
+		else for(k=1,bb=temp[0];k<j;k++) if(temp[k]>bb) bb=temp[k];
+		ucut=(ucut+bb)/2.0;
+	}
 
 	// OUTPUT THE TRIMMED DATASET
 	for(i=0;i<n;i++) if(data[i]>=lcut && data[i]<=ucut) printf("%g\n",data[i]);
 
+	if(setsort==0) free(temp);
 	free(data);
 	exit(0);
 }
@@ -0,0 +1,70 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Add an array of values to a streaming statistics accumulator (see xf_accinit1_d)
+	- single-pass update of count, mean, M2 and M3 (Welford's method, extended to the third moment)
+	- numerically stable: no sums of squares of the raw data are kept
+	- NAN and INF values are ignored
+	- to add a single value, pass its address with nn=1
+
+USES:
+	Summary statistics on a stream or on chunks of data
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *acc  : accumulator, initialised by xf_accinit1_d
+	double *data : array of values to add
+	long nn      : number of elements in data
+
+RETURN VALUE:
+	number of valid values added
+
+SAMPLE CALL:
+	xf_accinit1_d(acc);
+	for(ii=0;ii<nblocks;ii++) xf_accadd1_d(acc,(data+ii*blocksize),blocksize);
+*/
+
+#include <math.h>
+
+long xf_accadd1_d(double *acc, double *data, long nn) {
+
+	long ii,nvalid=0;
+	double aa,nnd,nnd1,delta,deltan,term1,mean,m2,m3,min,max,sum;
+
+	nnd= acc[0];
+	mean= acc[1];
+	m2= acc[2];
+	m3= acc[3];
+	min= acc[4];
+	max= acc[5];
+	sum= acc[6];
+
+	for(ii=0;ii<nn;ii++) {
+		aa= data[ii];
+		if(!isfinite(aa)) continue;
+		nnd1= nnd;
+		nnd+= 1.0;
+		delta= aa-mean;
+		deltan= delta/nnd;
+		term1= delta*deltan*nnd1;
+		mean+= deltan;
+		m3+= term1*deltan*(nnd-2.0) - 3.0*deltan*m2;
+		m2+= term1;
+		sum+= aa;
+		if(nnd1==0.0) min=max=aa;
+		else { if(aa<min) min=aa; if(aa>max) max=aa; }
+		nvalid++;
+	}
+
+	acc[0]= nnd;
+	acc[1]= mean;
+	acc[2]= m2;
+	acc[3]= m3;
+	acc[4]= min;
+	acc[5]= max;
+	acc[6]= sum;
+	return(nvalid);
+}
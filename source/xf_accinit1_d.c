@@ -0,0 +1,50 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Initialise a streaming statistics accumulator
+	The accumulator is an array of 8 doubles, updated by xf_accadd1_d,
+	combined by xf_accmerge1_d and converted to summary statistics by xf_accresult1_d
+		acc[0]: n, number of valid values added
+		acc[1]: running mean
+		acc[2]: M2, sum of squared deviations from the mean
+		acc[3]: M3, sum of cubed deviations from the mean
+		acc[4]: minimum
+		acc[5]: maximum
+		acc[6]: sum
+		acc[7]: reserved (0)
+	Memory required is independent of the number of values, so data can be processed
+	as a stream, in chunks, or in parallel (one accumulator per thread, merged at the end)
+
+USES:
+	Summary statistics on data which need not be stored in memory
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *acc: pre-allocated accumulator (at least 8 elements)
+
+RETURN VALUE:
+	None
+
+SAMPLE CALL:
+	double acc[8],result_d[8];
+	xf_accinit1_d(acc);
+	while(fscanf(fpin,"%lf",&aa)==1) xf_accadd1_d(acc,&aa,1);
+	nn= xf_accresult1_d(acc,result_d); mean=result_d[0];
+*/
+
+#include <math.h>
+
+void xf_accinit1_d(double *acc) {
+	acc[0]= 0.0;
+	acc[1]= 0.0;
+	acc[2]= 0.0;
+	acc[3]= 0.0;
+	acc[4]= NAN;
+	acc[5]= NAN;
+	acc[6]= 0.0;
+	acc[7]= 0.0;
+	return;
+}
@@ -0,0 +1,63 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Combine two streaming statistics accumulators (see xf_accinit1_d)
+	- the result is the same as if all values had been added to a single accumulator
+	- allows partial results from threads or chunks of data to be reduced
+	- uses the pairwise update of Chan et al. for the mean, M2 and M3
+
+USES:
+	Parallel or chunked calculation of summary statistics
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *acc1 : accumulator to be updated
+	double *acc2 : accumulator to be merged into acc1 (not modified)
+
+RETURN VALUE:
+	None
+
+SAMPLE CALL:
+	xf_accinit1_d(acc);
+	#pragma omp parallel private(acc2)
+	{
+		xf_accinit1_d(acc2);
+		#pragma omp for
+		for(ii=0;ii<nn;ii++) xf_accadd1_d(acc2,(data+ii),1);
+		#pragma omp critical
+		xf_accmerge1_d(acc,acc2);
+	}
+*/
+
+#include <math.h>
+
+void xf_accmerge1_d(double *acc1, double *acc2) {
+
+	int ii;
+	double na,nb,nnd,delta,delta2,m2,m3;
+
+	na= acc1[0];
+	nb= acc2[0];
+	if(nb<=0.0) return;
+	if(na<=0.0) { for(ii=0;ii<8;ii++) acc1[ii]= acc2[ii]; return; }
+
+	nnd= na+nb;
+	delta= acc2[1]-acc1[1];
+	delta2= delta*delta;
+	m2= acc1[2] + acc2[2] + delta2*na*nb/nnd;
+	m3= acc1[3] + acc2[3]
+		+ delta*delta2*na*nb*(na-nb)/(nnd*nnd)
+		+ 3.0*delta*(na*acc2[2]-nb*acc1[2])/nnd;
+
+	acc1[0]= nnd;
+	acc1[1]= acc1[1] + delta*nb/nnd;
+	acc1[2]= m2;
+	acc1[3]= m3;
+	if(acc2[4]<acc1[4]) acc1[4]= acc2[4];
+	if(acc2[5]>acc1[5]) acc1[5]= acc2[5];
+	acc1[6]+= acc2[6];
+	return;
+}
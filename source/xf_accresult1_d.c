@@ -0,0 +1,67 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Convert a streaming statistics accumulator (see xf_accinit1_d) to summary statistics
+	The results array has the same layout as for xf_stats2_d and xf_stats3_d
+
+USES:
+	Getting the mean, stdev, etc. of a data set processed as a stream
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *acc      : accumulator, updated by xf_accadd1_d or xf_accmerge1_d
+	double *result_d : pre-allocated array (at least 8 elements) to hold the results
+		[0] mean
+		[1] variance
+		[2] standard deviation
+		[3] standard error of the mean
+		[4] minimum
+		[5] maximum
+		[6] skew
+		[7] sum
+
+RETURN VALUE:
+	number of valid values in the accumulator
+	if this is zero, results are NAN
+	if this is one, variance, sd, sem and skew are zero
+
+SAMPLE CALL:
+	nn= xf_accresult1_d(acc,result_d); mean=result_d[0]; sd=result_d[2];
+*/
+
+#include <math.h>
+
+long xf_accresult1_d(double *acc, double *result_d) {
+
+	long ii;
+	double nnd,var,sd;
+
+	nnd= acc[0];
+	if(nnd<1.0) {
+		for(ii=0;ii<8;ii++) result_d[ii]= NAN;
+		return(0);
+	}
+
+	result_d[0]= acc[1];
+	result_d[4]= acc[4];
+	result_d[5]= acc[5];
+	result_d[7]= acc[6];
+	if(nnd<2.0) {
+		result_d[1]= result_d[2]= result_d[3]= result_d[6]= 0.0;
+		return((long)nnd);
+	}
+
+	var= acc[2]/(nnd-1.0);
+	sd= sqrt(var);
+	result_d[1]= var;
+	result_d[2]= sd;
+	result_d[3]= sd/sqrt(nnd);
+	/* skew is defined as for xf_stats2_d, but negative skew is also reported */
+	if(nnd>2.0 && sd>0.0) result_d[6]= (nnd/((nnd-1.0)*(nnd-2.0))) * (acc[3]/(sd*sd*sd));
+	else result_d[6]= 0.0;
+
+	return((long)nnd);
+}
@@ -0,0 +1,176 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Pearson's correlation and linear regression for every pair of columns in a table
+	- n, r, F, prob and slope match xf_correlate_d for each pair (to rounding error), but this is much faster for many columns
+		- the intercept uses the means of the valid pairs, so it differs from xf_correlate_d
+		  (which divides by the total number of rows) if any rows are invalid
+		- non-finite values are always invalid, even if setinv is finite
+	- invalid values are masked, so each pair uses all the rows where both columns are valid (pairwise deletion)
+		- invalid values are replaced by zero, with a parallel mask of 1 (valid) or 0 (invalid)
+		- each sum is then a branch-free product of values and masks
+	- each column is centred on its mean before summing, which avoids the loss of precision
+	  from large sums of squares when values are large relative to their variability
+	- sums are accumulated in 4 lanes, which allows the compiler to use SIMD instructions
+	- columns are processed in blocks of 8, and rows in blocks of 1024, so data stays in cache
+	- if compiled with OpenMP (-fopenmp), blocks of columns are processed in parallel
+
+USES:
+	Correlation matrices, screening many variables against each other
+
+DEPENDENCY TREE:
+	float xf_prob_F(float F,int df1,int df2);
+
+ARGUMENTS:
+	double *data   : input, table of nn rows x ncols columns, stored row by row: data[row*ncols+col]
+	long nn        : input, number of rows
+	long ncols     : input, number of columns (must be >0)
+	double setinv  : input, invalid value (typically NAN, but may be other) - non-finite values are always invalid
+	double *result : output, pre-allocated array of 6*ncols*ncols values holding 6 matrices:
+		- the value for x=column ii and y=column jj is result[stat*ncols*ncols + ii*ncols + jj]
+		- stat 0: n (number of rows valid in both columns)
+		- stat 1: r (Pearson's correlation coefficient)
+		- stat 2: F (F-statistic, 999999 for a near-perfect correlation)
+		- stat 3: prob (probability)
+		- stat 4: slope (regression of column jj on column ii)
+		- stat 5: intercept (mean y - slope * mean x, using only rows valid in both columns)
+		- if n<4 for a pair, statistics 1-5 are NAN
+		- as for xf_correlate_d, r=0 if either column has no variability,
+		  and slope and intercept are NAN if column ii has no variability
+		- the diagonal holds the results of correlating each column with itself
+	char *message  : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	0 on success, -1 on error
+
+SAMPLE CALL:
+	result= malloc(6*ncols*ncols*sizeof(*result));
+	if(xf_correlatematrix1_d(data,nn,ncols,NAN,result,message)<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	rmatrix= result+ncols*ncols;
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define XF_CORMATRIX_BLOCKC 8
+#define XF_CORMATRIX_BLOCKR 1024
+
+/* external functions start */
+float xf_prob_F(float F,int df1,int df2);
+/* external functions end */
+
+int xf_correlatematrix1_d(double *data, long nn, long ncols, double setinv, double *result, char *message) {
+
+	char *thisfunc="xf_correlatematrix1_d\0";
+	long ii,jj,kk,ib,nblock,nmat;
+	double aa,*val=NULL,*mask=NULL,*shift=NULL,*sums=NULL;
+
+	if(ncols<1) { sprintf(message,"%s [ERROR]: invalid number of columns (%ld)",thisfunc,ncols); return(-1); }
+	if(nn<0) { sprintf(message,"%s [ERROR]: invalid number of rows (%ld)",thisfunc,nn); return(-1); }
+	nmat= ncols*ncols;
+
+	val= malloc((nn*ncols+1)*sizeof(*val));
+	mask= malloc((nn*ncols+1)*sizeof(*mask));
+	shift= malloc((ncols+1)*sizeof(*shift));
+	sums= calloc((6*nmat+1),sizeof(*sums));
+	if(val==NULL||mask==NULL||shift==NULL||sums==NULL) {
+		free(val); free(mask); free(shift); free(sums);
+		sprintf(message,"%s [ERROR]: insufficient memory",thisfunc);
+		return(-1);
+	}
+
+	/* BUILD THE COLUMN-ORDERED VALUES AND MASKS, CENTRED ON THE MEAN OF EACH COLUMN */
+	for(jj=0;jj<ncols;jj++) {
+		double *pv=val+jj*nn,*pm=mask+jj*nn,sum=0.0,nv=0.0;
+		for(kk=0;kk<nn;kk++) {
+			aa= data[kk*ncols+jj];
+			if(isfinite(aa) && aa!=setinv) { pv[kk]=aa; pm[kk]=1.0; sum+=aa; nv+=1.0; }
+			else { pv[kk]=0.0; pm[kk]=0.0; }
+		}
+		shift[jj]= (nv>0.0) ? sum/nv : 0.0;
+		for(kk=0;kk<nn;kk++) pv[kk]= (pv[kk]-shift[jj])*pm[kk];
+	}
+
+	/* ACCUMULATE THE SUMS FOR EACH PAIR (jj>=ii) - sums[(ii*ncols+jj)*6 + 0-5]= n,sx,sy,sxx,syy,sxy */
+	nblock= (ncols+XF_CORMATRIX_BLOCKC-1)/XF_CORMATRIX_BLOCKC;
+	#pragma omp parallel for schedule(dynamic) private(ii,jj,kk)
+	for(ib=0;ib<nblock;ib++) {
+		long i0=ib*XF_CORMATRIX_BLOCKC,i1=i0+XF_CORMATRIX_BLOCKC,j0,j1,row0,row1,lane;
+		if(i1>ncols) i1=ncols;
+		for(j0=i0;j0<ncols;j0+=XF_CORMATRIX_BLOCKC) {
+			j1= j0+XF_CORMATRIX_BLOCKC; if(j1>ncols) j1=ncols;
+			for(row0=0;row0<nn;row0+=XF_CORMATRIX_BLOCKR) {
+				row1= row0+XF_CORMATRIX_BLOCKR; if(row1>nn) row1=nn;
+				for(ii=i0;ii<i1;ii++) {
+					double *x1=val+ii*nn,*m1=mask+ii*nn;
+					for(jj=(j0>ii?j0:ii);jj<j1;jj++) {
+						double *x2=val+jj*nn,*m2=mask+jj*nn,*ps=sums+(ii*ncols+jj)*6;
+						double s0[4]={0},s1[4]={0},s2[4]={0},s3[4]={0},s4[4]={0},s5[4]={0};
+						/* 4 independent lanes of partial sums */
+						for(kk=row0;kk+4<=row1;kk+=4) {
+							for(lane=0;lane<4;lane++) {
+								double a1=x1[kk+lane],a2=x2[kk+lane],b1=m1[kk+lane],b2=m2[kk+lane];
+								s0[lane]+= b1*b2;
+								s1[lane]+= a1*b2;
+								s2[lane]+= a2*b1;
+								s3[lane]+= a1*a1*b2;
+								s4[lane]+= a2*a2*b1;
+								s5[lane]+= a1*a2;
+						}}
+						for(;kk<row1;kk++) {
+							double a1=x1[kk],a2=x2[kk],b1=m1[kk],b2=m2[kk];
+							s0[0]+= b1*b2; s1[0]+= a1*b2; s2[0]+= a2*b1;
+							s3[0]+= a1*a1*b2; s4[0]+= a2*a2*b1; s5[0]+= a1*a2;
+						}
+						ps[0]+= (s0[0]+s0[1])+(s0[2]+s0[3]);
+						ps[1]+= (s1[0]+s1[1])+(s1[2]+s1[3]);
+						ps[2]+= (s2[0]+s2[1])+(s2[2]+s2[3]);
+						ps[3]+= (s3[0]+s3[1])+(s3[2]+s3[3]);
+						ps[4]+= (s4[0]+s4[1])+(s4[2]+s4[3]);
+						ps[5]+= (s5[0]+s5[1])+(s5[2]+s5[3]);
+		}}}}
+	}
+
+	/* CALCULATE THE STATISTICS - for the lower half of the matrix, x and y are swapped */
+	for(ii=0;ii<ncols;ii++) {
+		for(jj=0;jj<ncols;jj++) {
+			long cell=ii*ncols+jj;
+			double *ps,nv,sx,sy,sxx,syy,sxy,SSx,SSy,SPxy,r,r2,F,prob,b0,b1;
+			if(jj>=ii) { ps=sums+cell*6; sx=ps[1]; sy=ps[2]; sxx=ps[3]; syy=ps[4]; }
+			else { ps=sums+(jj*ncols+ii)*6; sx=ps[2]; sy=ps[1]; sxx=ps[4]; syy=ps[3]; }
+			nv= ps[0];
+			sxy= ps[5];
+			result[cell]= nv;
+			if(nv<4) { for(kk=1;kk<6;kk++) result[kk*nmat+cell]=NAN; continue; }
+			SSx= sxx-((sx*sx)/nv);
+			SSy= syy-((sy*sy)/nv);
+			SPxy= sxy-((sx*sy)/nv);
+			if(SSy<=0.0) { r=0.0; b1=0.0; b0=sy/nv+shift[jj]; }
+			else if(SSx<=0.0) { r=0.0; b1=NAN; b0=NAN; }
+			else {
+				r= SPxy/(sqrt(SSx)*sqrt(SSy));
+				b1= SPxy/SSx;
+				b0= (sy/nv+shift[jj])-b1*(sx/nv+shift[ii]);
+			}
+			r2= r*r;
+			F= (r2*(nv-2))/(1-r2);
+			if(r>=.999999||r<=-.999999) { F=999999.0; prob=0.0; }
+			else if(F>0 && SSx>0.0) prob= xf_prob_F((float)F,1,(int)(nv-2));
+			else prob= NAN;
+			result[1*nmat+cell]= r;
+			result[2*nmat+cell]= F;
+			result[3*nmat+cell]= prob;
+			result[4*nmat+cell]= b1;
+			result[5*nmat+cell]= b0;
+		}
+	}
+
+	free(val);
+	free(mask);
+	free(shift);
+	free(sums);
+	sprintf(message,"%s [OK]",thisfunc);
+	return(0);
+}
@@ -0,0 +1,68 @@
+/*
+<TAGS>signal_processing stats dt.matrix</TAGS>
+
+DESCRIPTION:
+	Add x/y points (optionally weighted by z) to a density matrix of fixed range and dimensions
+	- unlike xf_densitymatrix1_l, the range is set by the caller, so points need not be stored
+	- the matrix is accumulated, so it can be called repeatedly on successive chunks of input
+	- separate matrices (e.g. one per thread) can be summed to combine partial results
+	- points outside the range, or with non-finite x, y or z, are ignored
+	- binning is as for xe-densitymatrix1: bin= (int)((x-xmin)/nextafter(binwidth,DBL_MAX))
+
+USES:
+	- occupancy or spike-density matrices from very long x/y position records
+	- time-frequency density from long 3-column (time,frequency,power) input
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *xdata       : input, x-values
+	double *ydata       : input, y-values
+	double *zdata       : input, z-values to sum in each bin - NULL to count points
+	long nn             : input, number of points
+	double *range       : input, array of 4 values: xmin, xmax, ymin, ymax
+	long xbintot        : input, matrix width (>0)
+	long ybintot        : input, matrix height (>0)
+	double *matrix      : input/output, pre-allocated xbintot*ybintot array, sum of z (or count)
+	long *matrixcount   : input/output, pre-allocated xbintot*ybintot array, count of points - may be NULL
+
+RETURN VALUE:
+	the number of points added to the matrix
+
+SAMPLE CALL:
+	range[0]=xmin; range[1]=xmax; range[2]=ymin; range[3]=ymax;
+	for(ii=0;ii<(xbintot*ybintot);ii++) { matrix[ii]=0.0; matrixcount[ii]=0; }
+	while((nchunk=readchunk(fpin,xdata,ydata,zdata))>0) n+= xf_densitymatrix3_d(xdata,ydata,zdata,nchunk,range,xbintot,ybintot,matrix,matrixcount);
+*/
+
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+
+long xf_densitymatrix3_d(double *xdata, double *ydata, double *zdata, long nn, double *range, long xbintot, long ybintot, double *matrix, long *matrixcount) {
+
+	long ii,jj,x,y,nadded=0;
+	double aa,bb,cc,xmin,xmax,ymin,ymax,xbinwidth_inv,ybinwidth_inv;
+
+	xmin= range[0]; xmax= range[1];
+	ymin= range[2]; ymax= range[3];
+	xbinwidth_inv= 1.0/nextafter((xmax-xmin)/(double)xbintot,DBL_MAX);
+	ybinwidth_inv= 1.0/nextafter((ymax-ymin)/(double)ybintot,DBL_MAX);
+
+	for(ii=0;ii<nn;ii++) {
+		aa= xdata[ii];
+		bb= ydata[ii];
+		/* comparisons are false for NAN, so non-finite values are also excluded here */
+		if(!(aa>=xmin && aa<=xmax && bb>=ymin && bb<=ymax)) continue;
+		if(zdata!=NULL) { cc= zdata[ii]; if(!isfinite(cc)) continue; }
+		else cc= 1.0;
+		x= (long)((aa-xmin)*xbinwidth_inv); if(x>=xbintot) x= xbintot-1;
+		y= (long)((bb-ymin)*ybinwidth_inv); if(y>=ybintot) y= ybintot-1;
+		jj= y*xbintot+x;
+		matrix[jj]+= cc;
+		if(matrixcount!=NULL) matrixcount[jj]++;
+		nadded++;
+	}
+	return(nadded);
+}
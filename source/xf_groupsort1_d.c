@@ -0,0 +1,113 @@
+/*
+<TAGS>stats database</TAGS>
+
+DESCRIPTION:
+	Group the rows of a long-format table by one or more key-columns, using a single sort
+	- each key-column is coded as integers (0 to nlevels-1, in ascending order of value)
+	- the integer codes are combined into one composite key per row, which is sorted once
+	- rows are thereby ordered by key1, then key2, etc. - the sort is stable, so rows with the
+	  same keys remain in their original order
+	- non-finite keys (NAN) are treated as equal to each other, and are placed last
+
+	This is the engine for reshaping (long to wide) and group-wise processing of repeated-measures
+	data without repeated scans of the input, and without requiring the input to be pre-sorted
+
+USES:
+	- normalising subject x group x time data (xe-norm3)
+	- transposing repeated measures for mixed-design analysis (xe-transpose4)
+	- processing blocks of repeated measures (xe-repeated1)
+	- coding a single column as integers (nkeys=1)
+
+DEPENDENCY TREE:
+	xf_groupsort1_d
+		xf_qsortindex1_d
+		xf_qsortindex1_l
+
+ARGUMENTS:
+	double **key   : input, array of nkeys pointers to the key-columns, each holding nn values
+	long nkeys     : input, number of key-columns (>0)
+	long nn        : input, number of rows
+	long *index    : output, pre-allocated array of nn row-numbers, sorted by the keys
+	long *group    : output, pre-allocated array of nn group-numbers (0 to ngroups-1) for each row
+	                 - groups are numbered in the sorted order, so group[index[ii]] never decreases
+	char *message  : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	the number of groups (unique combinations of key-values) on success, -1 on error
+
+SAMPLE CALL:
+	key[0]= subject; key[1]= group;
+	ngroups= xf_groupsort1_d(key,2,nn,index,group,message);
+	if(ngroups<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	for(ii=0;ii<nn;ii=jj) {
+		for(jj=ii;jj<nn && group[index[jj]]==group[index[ii]];jj++);
+		... rows index[ii] to index[jj-1] belong to one group, in their original order
+	}
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+
+/* external functions start */
+void xf_qsortindex1_d(double *data, long *index,long nn);
+void xf_qsortindex1_l(long *data, long *index,long nn);
+/* external functions end */
+
+long xf_groupsort1_d(double **key, long nkeys, long nn, long *index, long *group, char *message) {
+
+	char *thisfunc="xf_groupsort1_d\0";
+	long ii,jj,kk,nlevels,ncomposite,*code=NULL,*composite=NULL;
+	double aa,prev,*temp=NULL;
+
+	if(nkeys<1) { sprintf(message,"%s [ERROR]: invalid number of keys (%ld)",thisfunc,nkeys); return(-1); }
+	if(nn<1) return(0);
+
+	temp= malloc(nn*sizeof(*temp));
+	code= malloc(nn*sizeof(*code));
+	composite= malloc(nn*sizeof(*composite));
+	if(temp==NULL||code==NULL||composite==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); free(temp); free(code); free(composite); return(-1); }
+
+	/* BUILD THE COMPOSITE KEY - CODE EACH KEY-COLUMN IN TURN */
+	ncomposite= 1;
+	for(kk=0;kk<nkeys;kk++) {
+		/* sort a copy of the column (all NANs made positive, so they sort together at the end) */
+		for(ii=0;ii<nn;ii++) { aa= key[kk][ii]; temp[ii]= isnan(aa) ? NAN : aa; index[ii]= ii; }
+		xf_qsortindex1_d(temp,index,nn);
+		/* assign an integer to each unique value */
+		nlevels= 0;
+		prev= temp[0];
+		for(ii=0;ii<nn;ii++) {
+			aa= temp[ii];
+			if(aa!=prev && !(isnan(aa) && isnan(prev))) nlevels++;
+			code[index[ii]]= nlevels;
+			prev= aa;
+		}
+		nlevels++;
+		/* if the composite would overflow, first re-code it densely (the combined levels can never exceed nn) */
+		if(ncomposite>(LONG_MAX/nlevels)) {
+			for(ii=0;ii<nn;ii++) { group[ii]= composite[ii]; index[ii]= ii; }
+			xf_qsortindex1_l(group,index,nn);
+			for(ii=jj=0;ii<nn;ii++) { if(ii>0 && group[ii]!=group[ii-1]) jj++; composite[index[ii]]= jj; }
+			ncomposite= jj+1;
+		}
+		/* combine with the codes for the previous keys */
+		if(kk==0) for(ii=0;ii<nn;ii++) composite[ii]= code[ii];
+		else for(ii=0;ii<nn;ii++) composite[ii]= composite[ii]*nlevels+code[ii];
+		ncomposite*= nlevels;
+	}
+
+	/* THE SINGLE SORT: ORDER THE ROWS BY THE COMPOSITE KEY, AND NUMBER THE GROUPS */
+	for(ii=0;ii<nn;ii++) index[ii]= ii;
+	xf_qsortindex1_l(composite,index,nn);
+	for(ii=jj=0;ii<nn;ii++) {
+		if(ii>0 && composite[ii]!=composite[ii-1]) jj++;
+		group[index[ii]]= jj;
+	}
+
+	free(temp);
+	free(code);
+	free(composite);
+	return(jj+1);
+}
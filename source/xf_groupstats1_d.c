@@ -0,0 +1,138 @@
+/*
+<TAGS>math stats</TAGS>
+
+DESCRIPTION:
+	Group-by statistics: count, mean, standard deviation and SEM for every
+	combination of values in any number of grouping-variables
+	- row-indices are sorted once by the composite group-key
+		- stable merge-sort, applied to each grouping-variable from last to first
+		- this leaves rows sorted by group1, then group2, etc., in original order within each group
+	- statistics are then calculated for each group in a single pass, using a streaming accumulator (xf_accadd1_d)
+	- only combinations which actually occur in the data are reported
+	- time is O(ngrp*N*log(N)) regardless of the number of groups
+
+USES:
+	Summary tables (e.g. subject x trial x bin) for xe-statsgrp1, xe-statsgrp2, xe-statsgrp3
+
+DEPENDENCY TREE:
+	void xf_accinit1_d(double *acc);
+	long xf_accadd1_d(double *acc, double *data, long nn);
+	long xf_accresult1_d(double *acc, double *result_d);
+
+ARGUMENTS:
+	double **group    : input, array of ngrp pointers to the grouping-variables, each holding nn values
+		- grouping-values should be finite (NAN or INF will not group reliably)
+	long ngrp         : input, number of grouping-variables (must be >0)
+	double *data      : input, array of nn data values - non-finite values are counted in "ntot" only
+	long nn           : input, number of rows
+	long **grpindex   : output, unallocated pointer, passed as &grpindex
+		- on return, holds one row-index per group, which can be used to get the group-values
+		- e.g. the value of grouping-variable kk for group gg is group[kk][grpindex[gg]]
+	double **grpstats : output, unallocated pointer, passed as &grpstats
+		- on return, holds 5 values per group: grpstats[gg*5+...]
+			[0] ntot: total rows in the group
+			[1] n: rows with finite data
+			[2] mean (NAN if n=0)
+			[3] sd (NAN if n=0, 0 if n=1)
+			[4] sem (NAN if n=0, 0 if n=1)
+	char *message     : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	number of groups on success, -1 on error
+	grpindex and grpstats must be freed by the calling function
+
+SAMPLE CALL:
+	double *group[2]={grp1,grp2},*grpstats=NULL;
+	long *grpindex=NULL;
+	ngroups= xf_groupstats1_d(group,2,data,nn,&grpindex,&grpstats,message);
+	if(ngroups<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	for(ii=0;ii<ngroups;ii++) printf("%g\t%g\t%g\n",grp1[grpindex[ii]],grp2[grpindex[ii]],grpstats[ii*5+2]);
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* external functions start */
+void xf_accinit1_d(double *acc);
+long xf_accadd1_d(double *acc, double *data, long nn);
+long xf_accresult1_d(double *acc, double *result_d);
+/* external functions end */
+
+long xf_groupstats1_d(double **group, long ngrp, double *data, long nn, long **grpindex, double **grpstats, char *message) {
+
+	char *thisfunc="xf_groupstats1_d\0";
+	long ii,jj,kk,mm,gg,width,ngroups,left,mid,right,out,*index=NULL,*index2=NULL,*ptemp,*gindex=NULL;
+	double acc[8],result_d[8],*key,*gstats=NULL;
+
+	if(ngrp<1) { sprintf(message,"%s [ERROR]: invalid number of grouping-variables (%ld)",thisfunc,ngrp); return(-1); }
+	if(nn<0) { sprintf(message,"%s [ERROR]: invalid number of rows (%ld)",thisfunc,nn); return(-1); }
+
+	index= malloc((nn+1)*sizeof(*index));
+	index2= malloc((nn+1)*sizeof(*index2));
+	if(index==NULL||index2==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto ERROR; }
+	for(ii=0;ii<nn;ii++) index[ii]=ii;
+
+	/* SORT THE ROW-INDICES BY EACH GROUPING-VARIABLE, LAST TO FIRST - the sort is stable so earlier orderings are preserved */
+	for(kk=(ngrp-1);kk>=0;kk--) {
+		key= group[kk];
+		/* bottom-up merge-sort: merge runs of increasing width */
+		for(width=1;width<nn;width*=2) {
+			for(left=0;left<nn;left+=(2*width)) {
+				mid= left+width; if(mid>nn) mid=nn;
+				right= left+2*width; if(right>nn) right=nn;
+				ii=left; jj=mid; out=left;
+				while(ii<mid && jj<right) {
+					if(key[index[jj]]<key[index[ii]]) index2[out++]= index[jj++];
+					else index2[out++]= index[ii++];
+				}
+				while(ii<mid) index2[out++]= index[ii++];
+				while(jj<right) index2[out++]= index[jj++];
+			}
+			ptemp=index; index=index2; index2=ptemp;
+		}
+	}
+
+	/* COUNT THE GROUPS - a new group starts wherever any grouping-variable changes */
+	for(ii=ngroups=0;ii<nn;ii++) {
+		if(ii==0) { ngroups++; continue; }
+		for(kk=0;kk<ngrp;kk++) if(group[kk][index[ii]]!=group[kk][index[ii-1]]) break;
+		if(kk<ngrp) ngroups++;
+	}
+	gindex= malloc((ngroups+1)*sizeof(*gindex));
+	gstats= malloc((ngroups*5+1)*sizeof(*gstats));
+	if(gindex==NULL||gstats==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto ERROR; }
+
+	/* CALCULATE STATS FOR EACH GROUP IN A SINGLE PASS */
+	for(ii=gg=0;ii<nn;ii=jj) {
+		/* find the end of the current group */
+		for(jj=ii+1;jj<nn;jj++) {
+			for(kk=0;kk<ngrp;kk++) if(group[kk][index[jj]]!=group[kk][index[ii]]) break;
+			if(kk<ngrp) break;
+		}
+		/* single-pass stats - non-finite data is ignored by the accumulator */
+		xf_accinit1_d(acc);
+		for(kk=ii;kk<jj;kk++) xf_accadd1_d(acc,(data+index[kk]),1);
+		mm= xf_accresult1_d(acc,result_d);
+		gindex[gg]= index[ii];
+		gstats[gg*5+0]= (double)(jj-ii);
+		gstats[gg*5+1]= (double)mm;
+		gstats[gg*5+2]= result_d[0];
+		gstats[gg*5+3]= result_d[2];
+		gstats[gg*5+4]= result_d[3];
+		gg++;
+	}
+
+	free(index);
+	free(index2);
+	(*grpindex)= gindex;
+	(*grpstats)= gstats;
+	return(ngroups);
+
+ERROR:
+	if(index!=NULL) free(index);
+	if(index2!=NULL) free(index2);
+	if(gindex!=NULL) free(gindex);
+	if(gstats!=NULL) free(gstats);
+	return(-1);
+}
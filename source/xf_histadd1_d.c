@@ -0,0 +1,110 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Add values to a streaming histogram created by xf_histinit1_d
+	- non-finite values (NAN, INF) are ignored
+	- fixed-range: bins are assigned exactly as by xf_hist1d
+	- adaptive: the first nbins values are stored, after which they are binned
+		- the fine bins initially span twice the range of the stored values
+		- a value outside the fine bins doubles the span (towards the value) until it fits
+
+USES:
+	Histograms of very long inputs without storing the values
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *hist   : input/output, histogram from xf_histinit1_d
+	double *data   : input, array of values to add
+	long nn        : input, number of values in data
+
+RETURN VALUE:
+	the number of finite values added
+
+SAMPLE CALL:
+	xf_histadd1_d(hist,data,nn);
+*/
+
+#include <math.h>
+
+/* double the span of the fine bins, keeping the lower edge (up=1) or the upper edge (up=0) fixed */
+static void xf_histadd1_d_expand(double *hist, int up) {
+	long ii,nbins=(long)hist[0],half=nbins/2;
+	double *count=hist+8;
+	if(up) {
+		for(ii=0;ii<half;ii++) count[ii]= count[2*ii]+count[2*ii+1];
+		for(ii=half;ii<nbins;ii++) count[ii]= 0.0;
+	}
+	else {
+		for(ii=nbins-1;ii>=half;ii--) count[ii]= count[2*(ii-half)]+count[2*(ii-half)+1];
+		for(ii=0;ii<half;ii++) count[ii]= 0.0;
+		hist[2]-= (double)nbins*hist[3];
+	}
+	hist[3]*= 2.0;
+}
+
+/* start binning: set the fine bins to span twice the range of the stored values, centred on that range */
+static void xf_histadd1_d_start(double *hist) {
+	long ii,jj,nbins=(long)hist[0],nstored=(long)hist[7];
+	double aa,range,*count=hist+8,*stored=hist+8+nbins;
+	range= hist[6]-hist[5];
+	if(range<=0.0) range= (hist[5]!=0.0) ? fabs(hist[5]) : 1.0;
+	hist[3]= 2.0*range/(double)nbins;
+	hist[2]= hist[5]-0.5*range;
+	hist[7]= -1.0;
+	for(ii=0;ii<nstored;ii++) {
+		aa= stored[ii];
+		while(aa<hist[2]) xf_histadd1_d_expand(hist,0);
+		while((jj=(long)((aa-hist[2])/hist[3]))>=nbins) xf_histadd1_d_expand(hist,1);
+		count[jj]++;
+	}
+}
+
+long xf_histadd1_d(double *hist, double *data, long nn) {
+
+	long ii,jj,nadded=0,nbins=(long)hist[0];
+	double aa,min,max,binwidth,inv_binwidth,*count=hist+8;
+
+	/* FIXED-RANGE: AS FOR xf_hist1d */
+	if(hist[1]==1.0) {
+		min= hist[2];
+		max= hist[3];
+		binwidth= (max-min)/(double)nbins;
+		inv_binwidth= 1.0/binwidth;
+		for(ii=0;ii<nn;ii++) {
+			aa= data[ii];
+			if(!isfinite(aa)) continue;
+			nadded++;
+			if(!(aa>=hist[5])) hist[5]=aa;
+			if(!(aa<=hist[6])) hist[6]=aa;
+			if(aa>=min && aa<=max) {
+				jj= (int)((aa-min)*inv_binwidth);
+				if(jj==nbins) jj--;
+				count[jj]++;
+			}
+		}
+		hist[4]+= (double)nadded;
+		return(nadded);
+	}
+
+	/* ADAPTIVE */
+	for(ii=0;ii<nn;ii++) {
+		aa= data[ii];
+		if(!isfinite(aa)) continue;
+		nadded++;
+		if(!(aa>=hist[5])) hist[5]=aa;
+		if(!(aa<=hist[6])) hist[6]=aa;
+		/* store values until the store is full, then start binning */
+		if(hist[7]>=0.0) {
+			if(hist[7]<(double)nbins) { hist[8+nbins+(long)hist[7]]= aa; hist[7]++; continue; }
+			xf_histadd1_d_start(hist);
+		}
+		while(aa<hist[2]) xf_histadd1_d_expand(hist,0);
+		while((jj=(long)((aa-hist[2])/hist[3]))>=nbins) xf_histadd1_d_expand(hist,1);
+		count[jj]++;
+	}
+	hist[4]+= (double)nadded;
+	return(nadded);
+}
@@ -0,0 +1,87 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Initialise a streaming histogram, which uses fixed memory regardless of the number of values
+	The histogram is an array of doubles, updated by xf_histadd1_d,
+	combined by xf_histmerge1_d and converted to output bins by xf_histresult1_d
+
+	Two types:
+	fixed-range (min and max both finite):
+		- nbins bins from min to max, filled exactly as by xf_hist1d
+		- values outside the range are counted in the total but not binned
+	adaptive (min or max is NAN):
+		- the first nbins values are stored, so small inputs give exactly the same result as xf_hist1d
+		- after that, values are counted in nbins fine bins, spanning twice the range seen so far
+		- if a value falls outside the fine bins, the range is doubled (pairs of bins are merged)
+		- resolution is therefore at least 1/(nbins/2) of the final data range
+		- nbins should be much larger than the number of output bins (e.g. 65536)
+
+	Layout (hist[0]-hist[7] are a header):
+		hist[0]: nbins
+		hist[1]: type (1=fixed-range, 0=adaptive)
+		hist[2]: lowest bin-edge (fixed: min) - NAN until set
+		hist[3]: bin-width (fixed: the upper edge, max) - NAN until set
+		hist[4]: n, the number of finite values added
+		hist[5]: minimum value added
+		hist[6]: maximum value added
+		hist[7]: adaptive: number of stored values, or -1 once binning has begun
+		hist[8] to hist[8+nbins-1]: counts
+		hist[8+nbins] to hist[8+2*nbins-1]: (adaptive only) stored values
+
+USES:
+	Histograms of very long inputs (e.g. inter-spike intervals) without storing the values
+	Building partial histograms from several files or threads, to be merged
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double min     : input, bottom of the range (NAN for adaptive)
+	double max     : input, top of the range (NAN for adaptive)
+	long nbins     : input, number of bins (fixed-range) or fine bins (adaptive, must be even)
+	char *message  : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	pointer to the histogram on success, NULL on error
+	the histogram must be freed by the calling function
+
+SAMPLE CALL:
+	hist= xf_histinit1_d(NAN,NAN,65536,message);
+	if(hist==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	while(fscanf(fpin,"%lf",&aa)==1) xf_histadd1_d(hist,&aa,1);
+	nn= xf_histresult1_d(hist,histx,histy,bintot,hist[5],hist[6],1);
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+double *xf_histinit1_d(double min, double max, long nbins, char *message) {
+
+	char *thisfunc="xf_histinit1_d\0";
+	long ii,ntot;
+	int fixed;
+	double *hist=NULL;
+
+	fixed= (isfinite(min) && isfinite(max));
+	if(nbins<2) { sprintf(message,"%s [ERROR]: invalid number of bins (%ld)",thisfunc,nbins); return(NULL); }
+	if(fixed && min>=max) { sprintf(message,"%s [ERROR]: min (%g) must be less than max (%g)",thisfunc,min,max); return(NULL); }
+	if(!fixed && (nbins%2)!=0) { sprintf(message,"%s [ERROR]: number of fine bins (%ld) must be even",thisfunc,nbins); return(NULL); }
+
+	ntot= fixed ? (8+nbins) : (8+2*nbins);
+	hist= malloc(ntot*sizeof(*hist));
+	if(hist==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(NULL); }
+
+	hist[0]= (double)nbins;
+	hist[1]= (double)fixed;
+	hist[2]= fixed ? min : NAN;
+	hist[3]= fixed ? max : NAN;
+	hist[4]= 0.0;
+	hist[5]= NAN;
+	hist[6]= NAN;
+	hist[7]= 0.0;
+	for(ii=8;ii<(8+nbins);ii++) hist[ii]= 0.0;
+
+	return(hist);
+}
@@ -0,0 +1,114 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Merge two streaming histograms created by xf_histinit1_d - hist2 is added to hist1
+	- both must be the same type, with the same number of bins
+	- fixed-range: the ranges must match, and counts are simply added
+	- adaptive:
+		- values still stored in hist2 are added to hist1 one by one (exact)
+		- if only hist1 is still storing values, hist2 is copied to hist1 and the stored values are added
+		- if both are binning, hist1 is expanded to cover hist2, and each fine bin in hist2
+		  is added to the hist1 bin holding its centre (accurate to one fine bin)
+
+USES:
+	Combining partial histograms built from several files, or by several threads
+
+DEPENDENCY TREE:
+	long xf_histadd1_d(double *hist, double *data, long nn);
+
+ARGUMENTS:
+	double *hist1  : input/output, histogram which will hold the merged result
+	double *hist2  : input, histogram to add to hist1 - not modified
+	char *message  : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	0 on success, -1 on error
+
+SAMPLE CALL:
+	for(ii=1;ii<nfiles;ii++) if(xf_histmerge1_d(hist[0],hist[ii],message)<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* external functions start */
+long xf_histadd1_d(double *hist, double *data, long nn);
+/* external functions end */
+
+/* double the span of the fine bins, keeping the lower edge (up=1) or the upper edge (up=0) fixed - as for xf_histadd1_d */
+static void xf_histmerge1_d_expand(double *hist, int up) {
+	long ii,nbins=(long)hist[0],half=nbins/2;
+	double *count=hist+8;
+	if(up) {
+		for(ii=0;ii<half;ii++) count[ii]= count[2*ii]+count[2*ii+1];
+		for(ii=half;ii<nbins;ii++) count[ii]= 0.0;
+	}
+	else {
+		for(ii=nbins-1;ii>=half;ii--) count[ii]= count[2*(ii-half)]+count[2*(ii-half)+1];
+		for(ii=0;ii<half;ii++) count[ii]= 0.0;
+		hist[2]-= (double)nbins*hist[3];
+	}
+	hist[3]*= 2.0;
+}
+
+int xf_histmerge1_d(double *hist1, double *hist2, char *message) {
+
+	char *thisfunc="xf_histmerge1_d\0";
+	long ii,jj,nbins,nstored;
+	double aa,lo2,hi2,*count1,*count2,*temp=NULL;
+
+	nbins= (long)hist1[0];
+	count1= hist1+8;
+	count2= hist2+8;
+	if(hist2[0]!=hist1[0] || hist2[1]!=hist1[1]) { sprintf(message,"%s [ERROR]: histograms are of different types or sizes",thisfunc); return(-1); }
+	if(hist2[4]==0.0) return(0);
+
+	/* FIXED-RANGE */
+	if(hist1[1]==1.0) {
+		if(hist2[2]!=hist1[2] || hist2[3]!=hist1[3]) { sprintf(message,"%s [ERROR]: histograms have different ranges",thisfunc); return(-1); }
+		for(ii=0;ii<nbins;ii++) count1[ii]+= count2[ii];
+		hist1[4]+= hist2[4];
+		if(!(hist2[5]>=hist1[5])) hist1[5]= hist2[5];
+		if(!(hist2[6]<=hist1[6])) hist1[6]= hist2[6];
+		return(0);
+	}
+
+	/* ADAPTIVE: hist2 IS STILL STORING VALUES - ADD THEM */
+	if(hist2[7]>=0.0) {
+		xf_histadd1_d(hist1,(hist2+8+nbins),(long)hist2[7]);
+		return(0);
+	}
+
+	/* ADAPTIVE: ONLY hist1 IS STILL STORING VALUES - COPY hist2 TO hist1, THEN ADD THE STORED VALUES */
+	if(hist1[7]>=0.0) {
+		nstored= (long)hist1[7];
+		temp= malloc((nstored+1)*sizeof(*temp));
+		if(temp==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(-1); }
+		for(ii=0;ii<nstored;ii++) temp[ii]= hist1[8+nbins+ii];
+		for(ii=0;ii<(8+nbins);ii++) hist1[ii]= hist2[ii];
+		xf_histadd1_d(hist1,temp,nstored);
+		free(temp);
+		return(0);
+	}
+
+	/* ADAPTIVE: BOTH ARE BINNING - EXPAND hist1 TO COVER hist2, THEN ADD EACH hist2 BIN AT ITS CENTRE */
+	lo2= hist2[2];
+	hi2= hist2[2]+(double)nbins*hist2[3];
+	while(hist1[3]<hist2[3]) xf_histmerge1_d_expand(hist1,1);
+	while(lo2<hist1[2]) xf_histmerge1_d_expand(hist1,0);
+	while(hi2>(hist1[2]+(double)nbins*hist1[3])) xf_histmerge1_d_expand(hist1,1);
+	for(ii=0;ii<nbins;ii++) {
+		if(count2[ii]==0.0) continue;
+		aa= hist2[2]+((double)ii+0.5)*hist2[3];
+		jj= (long)((aa-hist1[2])/hist1[3]);
+		if(jj<0) jj=0;
+		if(jj>=nbins) jj=nbins-1;
+		count1[jj]+= count2[ii];
+	}
+	hist1[4]+= hist2[4];
+	if(!(hist2[5]>=hist1[5])) hist1[5]= hist2[5];
+	if(!(hist2[6]<=hist1[6])) hist1[6]= hist2[6];
+	return(0);
+}
@@ -0,0 +1,91 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Build histogram output (histx, histy) from a streaming histogram created by xf_histinit1_d
+	- output is as for xf_hist1d: histx holds the middle of each bin, histy the counts (or proportions)
+	- fixed-range with the same bins and range as the output: counts are copied exactly
+	- adaptive, with values still stored: xf_hist1d is applied to the stored values (exact)
+	- otherwise each fine bin is added to the output bin holding its centre
+		- accurate to one fine bin, so use many more fine bins than output bins
+	- values outside min-max are excluded, as for xf_hist1d
+
+USES:
+	Output of histograms built without storing the values
+
+DEPENDENCY TREE:
+	long xf_hist1d(double *data, long n, double *histx, double *histy, int bintot, double min, double max, int format);
+
+ARGUMENTS:
+	double *hist   : input, histogram from xf_histinit1_d
+	double *histx  : output, pre-allocated array of bintot values
+	double *histy  : output, pre-allocated array of bintot values
+	int bintot     : input, number of output bins
+	double min     : input, bottom of the output range (e.g. hist[5], the minimum value added)
+	double max     : input, top of the output range (e.g. hist[6], the maximum value added)
+	int format     : input, 1=counts, 2=proportion (peak=1), 3=probability (sum of values=1)
+
+RETURN VALUE:
+	the number of values in the output range, as for xf_hist1d
+
+SAMPLE CALL:
+	kk= xf_histresult1_d(hist,histx,histy,bintot,min,max,settype);
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* external functions start */
+long xf_hist1d(double *data, long n, double *histx, double *histy, int bintot, double min, double max, int format);
+/* external functions end */
+
+long xf_histresult1_d(double *hist, double *histx, double *histy, int bintot, double min, double max, int format) {
+
+	long ii,jj,nn,nbins=(long)hist[0];
+	double aa,binwidth,inv_binwidth,plotedge,histmax,finewidth,*count=hist+8;
+
+	for(ii=0;ii<bintot;ii++) histy[ii]= 0.0;
+
+	/* ADAPTIVE, STILL STORING VALUES: USE THE VALUES */
+	if(hist[1]==0.0 && hist[7]>=0.0) return(xf_hist1d((hist+8+nbins),(long)hist[7],histx,histy,bintot,min,max,format));
+
+	binwidth= (max-min)/(double)bintot;
+	inv_binwidth= 1.0/binwidth;
+	plotedge= min+binwidth/2.0;
+
+	/* FIXED-RANGE WITH MATCHING BINS: COPY THE COUNTS */
+	if(hist[1]==1.0 && nbins==bintot && hist[2]==min && hist[3]==max) {
+		for(ii=0;ii<bintot;ii++) histy[ii]= count[ii];
+	}
+	/* OTHERWISE ASSIGN EACH FINE BIN TO THE OUTPUT BIN HOLDING ITS CENTRE */
+	else {
+		finewidth= (hist[1]==1.0) ? (hist[3]-hist[2])/(double)nbins : hist[3];
+		for(ii=0;ii<nbins;ii++) {
+			if(count[ii]==0.0) continue;
+			aa= hist[2]+((double)ii+0.5)*finewidth;
+			/* the outermost fine bins may be centred just outside the data range - keep them */
+			if(aa<min && hist[5]>=min) aa=min;
+			if(aa>max && hist[6]<=max) aa=max;
+			if(aa>=min && aa<=max) {
+				jj= (long)((aa-min)*inv_binwidth);
+				if(jj==bintot) jj--;
+				histy[jj]+= count[ii];
+			}
+		}
+	}
+	for(ii=nn=0;ii<bintot;ii++) nn+= (long)histy[ii];
+
+	/* FILL X-VALUES AND APPLY THE FORMAT - AS FOR xf_hist1d */
+	for(ii=0;ii<bintot;ii++) histx[ii]=(double)ii*binwidth+plotedge;
+	if(format==2) {
+		histmax=histy[0]; for(ii=0;ii<bintot;ii++) if(histy[ii]>histmax) histmax=histy[ii];
+		aa=1.0/histmax;
+		for(ii=0;ii<bintot;ii++) histy[ii]=histy[ii]*aa;
+	}
+	if(format==3) {
+		aa=1.0/(double)(nn);
+		for(ii=0;ii<bintot;ii++) histy[ii]=histy[ii]*aa;
+	}
+	return(nn);
+}
@@ -0,0 +1,51 @@
+/*
+<TAGS>math dt.matrix</TAGS>
+
+DESCRIPTION:
+	Merge two sets of matrix accumulators built by xf_matrixaccum1_d - acc2 is added to acc1
+	- counts and sums are added
+	- sums of squared deviations are combined using the difference between the two means
+	  (Chan et al. 1979), so the result is the same as if all matrices had been added to acc1
+
+USES:
+	Combining partial averages built from several files, or by several threads
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *acc1   : input/output, accumulators which will hold the merged result
+	double *acc2   : input, accumulators to add to acc1 - not modified
+	long bintot    : input, number of cells in the matrix
+
+RETURN VALUE:
+	none
+
+SAMPLE CALL:
+	for(ii=1;ii<nfiles;ii++) xf_matrixaccmerge1_d(acc[0],acc[ii],bintot);
+*/
+
+#include <math.h>
+
+void xf_matrixaccmerge1_d(double *acc1, double *acc2, long bintot) {
+
+	long ii;
+	double n1,n2,delta,*count1,*sum1,*ssd1,*count2,*sum2,*ssd2;
+
+	count1= acc1; sum1= acc1+bintot; ssd1= acc1+2*bintot;
+	count2= acc2; sum2= acc2+bintot; ssd2= acc2+2*bintot;
+
+	for(ii=0;ii<bintot;ii++) {
+		n2= count2[ii];
+		if(n2<=0.0) continue;
+		n1= count1[ii];
+		if(n1>0.0) {
+			delta= sum2[ii]/n2 - sum1[ii]/n1;
+			ssd1[ii]+= ssd2[ii] + delta*delta*n1*n2/(n1+n2);
+		}
+		else ssd1[ii]= ssd2[ii];
+		count1[ii]+= n2;
+		sum1[ii]+= sum2[ii];
+	}
+	return;
+}
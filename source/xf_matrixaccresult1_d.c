@@ -0,0 +1,52 @@
+/*
+<TAGS>math dt.matrix</TAGS>
+
+DESCRIPTION:
+	Calculate the mean, standard deviation and standard error for each cell of a set of
+	matrix accumulators built by xf_matrixaccum1_d
+	- cells with no valid values are set to NAN
+	- the SD (and therefore SEM) is NAN for cells with only one valid value
+
+USES:
+	Output of streaming matrix averages
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *acc    : input, accumulators for bintot cells
+	long bintot    : input, number of cells in the matrix
+	double *mean   : output, pre-allocated array of bintot means (NULL if not required)
+	double *sd     : output, pre-allocated array of bintot standard deviations (NULL if not required)
+	double *sem    : output, pre-allocated array of bintot standard errors (NULL if not required)
+
+RETURN VALUE:
+	number of cells with at least one valid value
+
+SAMPLE CALL:
+	nn= xf_matrixaccresult1_d(acc,bintot,mean,sd,NULL);
+*/
+
+#include <math.h>
+#include <stdlib.h>
+
+long xf_matrixaccresult1_d(double *acc, long bintot, double *mean, double *sd, double *sem) {
+
+	long ii,nn=0;
+	double aa,n1,*count,*sum,*ssd;
+
+	count= acc;
+	sum= acc+bintot;
+	ssd= acc+2*bintot;
+
+	for(ii=0;ii<bintot;ii++) {
+		n1= count[ii];
+		if(n1>0.0) nn++;
+		if(mean!=NULL) mean[ii]= (n1>0.0) ? sum[ii]/n1 : NAN;
+		aa= (n1>1.0) ? sqrt(ssd[ii]/(n1-1.0)) : NAN;
+		if(sd!=NULL) sd[ii]= aa;
+		if(sem!=NULL) sem[ii]= aa/sqrt(n1);
+	}
+
+	return(nn);
+}
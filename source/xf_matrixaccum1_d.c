@@ -0,0 +1,72 @@
+/*
+<TAGS>math dt.matrix</TAGS>
+
+DESCRIPTION:
+	Add a matrix to a set of running accumulators, for averaging matrices without storing them
+	- memory depends on the size of the matrix, not the number of matrices
+	- non-finite values (NAN, INF) are ignored, so each cell has its own count
+	- results are obtained with xf_matrixaccresult1_d, and partial accumulators (e.g. from
+	  different files or threads) can be combined with xf_matrixaccmerge1_d
+
+	Accumulator layout (3*bintot doubles, initialised to zero, e.g. with calloc):
+		acc[0] to acc[bintot-1]             : count of valid values for each cell
+		acc[bintot] to acc[2*bintot-1]      : sum of valid values
+		acc[2*bintot] to acc[3*bintot-1]    : sum of squared deviations from the mean
+		                                      (updated using Welford's method, which avoids
+		                                      the loss of precision of a raw sum-of-squares)
+
+	The mean for each cell (sum/count) is identical to that from xf_matrixavg1_d
+
+USES:
+	Averaging spectrograms or density maps across many trials or subjects
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *acc    : input/output, accumulators for bintot cells (see above)
+	double *matrix : input, the matrix to add (bintot values)
+	long bintot    : input, number of cells in the matrix (ncols*nrows)
+
+RETURN VALUE:
+	number of valid values added
+
+SAMPLE CALL:
+	acc= calloc(3*bintot,sizeof(*acc));
+	while((matrix=xf_matrixread3_d(fpin,&ncols,&nrows,header,message))!=NULL) {
+		xf_matrixaccum1_d(acc,matrix,bintot);
+		free(matrix);
+	}
+	xf_matrixaccresult1_d(acc,bintot,mean,sd,sem);
+*/
+
+#include <math.h>
+
+long xf_matrixaccum1_d(double *acc, double *matrix, long bintot) {
+
+	long ii,nn=0;
+	double aa,mean1,*count,*sum,*ssd;
+
+	count= acc;
+	sum= acc+bintot;
+	ssd= acc+2*bintot;
+
+	for(ii=0;ii<bintot;ii++) {
+		aa= matrix[ii];
+		if(!isfinite(aa)) continue;
+		/* the deviation from the previous mean times the deviation from the new mean */
+		if(count[ii]>0.0) {
+			mean1= sum[ii]/count[ii];
+			count[ii]+= 1.0;
+			sum[ii]+= aa;
+			ssd[ii]+= (aa-mean1)*(aa-(sum[ii]/count[ii]));
+		}
+		else {
+			count[ii]= 1.0;
+			sum[ii]= aa;
+		}
+		nn++;
+	}
+
+	return(nn);
+}
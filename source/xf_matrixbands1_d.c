@@ -0,0 +1,79 @@
+/*
+<TAGS>math dt.matrix signal_processing</TAGS>
+
+DESCRIPTION:
+	Calculate the area under the curve (AUC) for multiple bands (ranges of columns) in
+	every row of a matrix, e.g. power in several frequency bands at each time in a spectrogram
+	- each band is passed directly to xf_auc1_d (ref=0), so results are identical to calling it per band
+		- a running sum over the whole row is not used, as the difference of two large sums
+		  loses precision when the row holds much larger values outside the band (e.g. a DC bin)
+		- the cost is the total width of the bands per row
+	- bands containing any non-finite values yield NAN
+	- if compiled with OpenMP, blocks of rows are processed in parallel
+
+USES:
+	- extracting power in delta, theta, beta, gamma bands from a long spectrogram
+
+DEPENDENCY TREE:
+	xf_auc1_d
+
+ARGUMENTS:
+	double *matrix  : input, matrix of nrows*ncols values (rows=time, columns=frequency)
+	long nrows      : input, number of rows
+	long ncols      : input, number of columns
+	long *bstart    : input, array of nbands first columns (zero-offset) for each band
+	long *bstop     : input, array of nbands stop columns for each band (not included)
+	long nbands     : input, number of bands
+	double interval : input, interval between columns (e.g. frequency resolution)
+	double *result  : output, pre-allocated array of nrows*nbands values to hold the AUCs
+	                  - result[row*nbands+band]
+	char *message   : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	0 on success, -1 on error
+
+SAMPLE CALL:
+	z= xf_matrixbands1_d(matrix,nrows,ncols,bstart,bstop,nbands,0.5,result,message);
+	if(z!=0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#define BANDS_BLOCKSIZE 256
+
+int xf_auc1_d(double *curvey, long nn, double interval, int ref, double *result ,char *message);
+
+int xf_matrixbands1_d(double *matrix, long nrows, long ncols, long *bstart, long *bstop, long nbands, double interval, double *result, char *message) {
+
+	char *thisfunc="xf_matrixbands1_d\0";
+	long ii,nblocks;
+
+	if(nrows<0||ncols<1||nbands<1) { sprintf(message,"%s [ERROR]: invalid matrix size (%ld x %ld) or number of bands (%ld)",thisfunc,ncols,nrows,nbands); return(-1); }
+	for(ii=0;ii<nbands;ii++) {
+		if(bstart[ii]<0 || bstop[ii]>ncols || (bstop[ii]-bstart[ii])<2) {
+			sprintf(message,"%s [ERROR]: band %ld (columns %ld-%ld) must span at least two of the %ld columns",thisfunc,ii,bstart[ii],bstop[ii],ncols);
+			return(-1);
+	}}
+	nblocks= (nrows+BANDS_BLOCKSIZE-1)/BANDS_BLOCKSIZE;
+
+	#pragma omp parallel for schedule(dynamic)
+	for(ii=0;ii<nblocks;ii++) {
+		long row,row2,col,band,mm;
+		double auc[3],*prow,*pres;
+		char message2[256];
+		row2= (ii+1)*BANDS_BLOCKSIZE; if(row2>nrows) row2= nrows;
+		for(row=ii*BANDS_BLOCKSIZE;row<row2;row++) {
+			pres= result+row*nbands;
+			for(band=0;band<nbands;band++) {
+				prow= matrix+row*ncols+bstart[band];
+				mm= bstop[band]-bstart[band];
+				for(col=0;col<mm;col++) if(!isfinite(prow[col])) break;
+				if(col<mm) { pres[band]= NAN; continue; }
+				xf_auc1_d(prow,mm,interval,0,auc,message2);
+				pres[band]= auc[0];
+			}
+		}
+	}
+	return(0);
+}
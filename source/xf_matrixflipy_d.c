@@ -21,7 +21,8 @@ USES:
 	- converting cartesian to plotting coordinates or vice-versa
 
 DEPENDENCY TREE:
-	No dependencies
+	xf_matrixflipy_d
+		xf_matrixorient1_d
 
 ARGUMENTS:
 
@@ -49,35 +50,27 @@ SAMPLE CALL :
 #include <stdio.h>
 #include <stdlib.h>
 
-double *xf_matrixflipy_d(double *data1, long nx, long ny) {
+/* external functions start */
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
+/* external functions end */
 
+double *xf_matrixflipy_d(double *data1, long nx, long ny) {
 
-	long ii,jj,kk,in1,in2;
 	double *data2=NULL;
 
-
 	/* MAKE SURE ARRAY CONTAINS ELEMENTS */
 	if(ny<1||nx<1) return(data1);
 
-	/* ALLOCATE MEMORY FOR THE NEW ROTATED MATRIX */
-	data2=(double *)realloc(data2,nx*ny*sizeof(double));
+	/* ALLOCATE MEMORY FOR THE NEW FLIPPED MATRIX */
+	data2= malloc(nx*ny*sizeof(*data2));
 	if(data2==NULL) return(NULL);
 
 	/* TRANSFER VALUES FROM ORIGINAL MATRIX TO NEW FLIPPED VERSION */
-	kk=0;
-	ii=ny-1;
-	for(ii=ii;ii>=0;ii--) {
-		for(jj=0;jj<nx;jj++) {
-			in1=ii*nx+jj;
-			in2=kk*nx+jj;
-			data2[in2]=data1[in1];
-		}
-		kk++;
-	}
+	xf_matrixorient1_d(data1,data2,nx,ny,6);
 
 	/* FREE ORIGINAL MEMORY */
 	free(data1);
 
-	/* RETURN A POINTER TO THE NEW BLOCK OF MEMORY FOR THE TRANSPOSED MATRIX */
+	/* RETURN A POINTER TO THE NEW BLOCK OF MEMORY FOR THE FLIPPED MATRIX */
 	return(data2);
 }
@@ -0,0 +1,177 @@
+/*
+<TAGS>dt.matrix</TAGS>
+
+DESCRIPTION:
+	Label the connected components (contiguous regions) of values exceeding a threshold
+	in one or more matrices, and calculate statistics for each component
+	- values are included if they are finite and >= the threshold for their matrix
+	- values are connected only to their left/right/up/down neighbours (no diagonals)
+	- two-pass union-find algorithm
+		- pass 1: each value takes the label of its left or upper neighbour, or a new
+		  label - where these neighbours have different labels, the labels are merged
+		- pass 2: merged labels are replaced by final labels (1,2,3...) and the statistics
+		  for each component are accumulated at the same time
+	- the cost is proportional to the size of the matrix, regardless of the number or
+	  shape of the components
+	- batched: data may hold nmatrices matrices of the same size, packed together
+	- if compiled with OpenMP, matrices are processed in parallel
+
+USES:
+	- define hippocampal place fields
+	- find bright spots in a video frame
+	- define peaks in a phase-amplitude coupling plot
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *data   : input, nmatrices matrices of width*height values
+	long nmatrices : input, number of matrices
+	long width     : input, width of each matrix
+	long height    : input, height of each matrix
+	double *thresh : input, array of nmatrices thresholds, one for each matrix
+	long *label    : output, pre-allocated array of nmatrices*width*height labels
+		- 0= below threshold (or not finite)
+		- 1-n= component number - within each matrix, numbered in the order that the first
+		  value of each component is encountered (top-left to bottom-right)
+	long *ncomp    : output, pre-allocated array to hold the number of components in each matrix
+	double **stats : output, array (re)allocated by this function, holding 8 values per
+	                 component for all components in all matrices, in order
+		[0] area (number of values)
+		[1] sum of values
+		[2] mean value
+		[3] peak (maximum) value
+		[4] x-position (zero-offset) of the peak - first occurrence if there is a tie
+		[5] y-position (zero-offset) of the peak
+		[6] x-position of the centre of mass (left=0)
+		[7] y-position of the centre of mass (top=0)
+	char *message  : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	total number of components in all matrices on success, -1 on error
+
+SAMPLE CALL:
+	double *stats=NULL;
+	for(ii=0;ii<nmatrices;ii++) thresh[ii]= 0.25*max[ii];
+	ntot= xf_matrixlabel1_d(matrix,nmatrices,width,height,thresh,label,ncomp,&stats,message);
+	if(ntot<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	for(ii=jj=0;ii<nmatrices;ii++) for(kk=0;kk<ncomp[ii];kk++,jj++) printf("%ld %ld %g\n",ii,kk+1,stats[jj*8]);
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#define LABEL_NSTATS 8
+
+/* label one matrix - parent must hold nn+1 values, scratch (nn/2+1)*LABEL_NSTATS - returns the number of components */
+static long xf_matrixlabel1_d_one(double *data, long width, long height, double thresh, long *label, long *parent, double *scratch) {
+
+	long ii,jj,x,y,nprov=0,ncomp=0,left,up,ra,rb;
+	double aa,*ps;
+
+	/* PASS 1: PROVISIONAL LABELS - MERGED LABELS ALWAYS POINT TO THE LOWER LABEL */
+	for(y=ii=0;y<height;y++) {
+		for(x=0;x<width;x++,ii++) {
+			aa= data[ii];
+			if(!isfinite(aa) || aa<thresh) { label[ii]=0; continue; }
+			left= (x>0) ? label[ii-1] : 0;
+			up= (y>0) ? label[ii-width] : 0;
+			if(left==0 && up==0) { nprov++; parent[nprov]= nprov; label[ii]= nprov; continue; }
+			if(left==0 || up==0 || left==up) { label[ii]= (left>0) ? left : up; continue; }
+			/* both neighbours labelled differently: find the roots (with path-halving) and merge */
+			ra= left; while(parent[ra]!=ra) { parent[ra]= parent[parent[ra]]; ra= parent[ra]; }
+			rb= up;   while(parent[rb]!=rb) { parent[rb]= parent[parent[rb]]; rb= parent[rb]; }
+			if(ra<rb) { parent[rb]= ra; label[ii]= ra; }
+			else      { parent[ra]= rb; label[ii]= rb; }
+		}
+	}
+
+	/* RESOLVE: REPLACE EACH PROVISIONAL LABEL WITH A FINAL LABEL - PARENTS ALWAYS COME FIRST */
+	for(jj=1;jj<=nprov;jj++) {
+		if(parent[jj]==jj) parent[jj]= ++ncomp;
+		else parent[jj]= parent[parent[jj]];
+	}
+	for(jj=0;jj<(ncomp*LABEL_NSTATS);jj++) scratch[jj]= 0.0;
+
+	/* PASS 2: APPLY THE FINAL LABELS AND ACCUMULATE THE STATISTICS */
+	for(y=ii=0;y<height;y++) {
+		for(x=0;x<width;x++,ii++) {
+			if(label[ii]==0) continue;
+			label[ii]= parent[label[ii]];
+			ps= scratch+(label[ii]-1)*LABEL_NSTATS;
+			aa= data[ii];
+			if(ps[0]==0.0 || aa>ps[3]) { ps[3]= aa; ps[4]= (double)x; ps[5]= (double)y; }
+			ps[0]+= 1.0;
+			ps[1]+= aa;
+			ps[6]+= x*aa;
+			ps[7]+= y*aa;
+		}
+	}
+	for(jj=0;jj<ncomp;jj++) {
+		ps= scratch+jj*LABEL_NSTATS;
+		ps[2]= ps[1]/ps[0];
+		ps[6]/= ps[1];
+		ps[7]/= ps[1];
+	}
+
+	return(ncomp);
+}
+
+
+long xf_matrixlabel1_d(double *data, long nmatrices, long width, long height, double *thresh, long *label, long *ncomp, double **stats, char *message) {
+
+	char *thisfunc="xf_matrixlabel1_d\0";
+	int error=0;
+	long ii,mm,nn,ntot;
+	double **block=NULL,*tempstats=NULL;
+
+	if(width<1||height<1||nmatrices<1) { sprintf(message,"%s [ERROR]: invalid matrix size (%ld x %ld x %ld)",thisfunc,width,height,nmatrices); return(-1); }
+	nn= width*height;
+
+	/* one block of statistics per matrix, filled in parallel and concatenated afterwards */
+	block= calloc(nmatrices,sizeof(*block));
+	if(block==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(-1); }
+
+	#pragma omp parallel if(nmatrices>1) reduction(|:error)
+	{
+		long kk,*parent=NULL;
+		double *scratch=NULL;
+		parent= malloc((nn+1)*sizeof(*parent));
+		scratch= malloc((nn/2+1)*LABEL_NSTATS*sizeof(*scratch));
+		if(parent==NULL || scratch==NULL) error=1;
+		#pragma omp for schedule(dynamic)
+		for(mm=0;mm<nmatrices;mm++) {
+			if(parent==NULL || scratch==NULL) continue;
+			kk= xf_matrixlabel1_d_one(data+mm*nn,width,height,thresh[mm],label+mm*nn,parent,scratch);
+			ncomp[mm]= kk;
+			if(kk<1) continue;
+			block[mm]= malloc(kk*LABEL_NSTATS*sizeof(**block));
+			if(block[mm]==NULL) { error=1; continue; }
+			memcpy(block[mm],scratch,kk*LABEL_NSTATS*sizeof(*scratch));
+		}
+		if(parent!=NULL) free(parent);
+		if(scratch!=NULL) free(scratch);
+	}
+
+	/* CONCATENATE THE STATISTICS */
+	ntot= 0;
+	if(error==0) {
+		for(mm=0;mm<nmatrices;mm++) ntot+= ncomp[mm];
+		tempstats= realloc(*stats,(ntot+1)*LABEL_NSTATS*sizeof(*tempstats));
+		if(tempstats==NULL) error=1;
+		else {
+			*stats= tempstats;
+			for(mm=ii=0;mm<nmatrices;mm++) {
+				if(ncomp[mm]<1) continue;
+				memcpy(tempstats+ii*LABEL_NSTATS,block[mm],ncomp[mm]*LABEL_NSTATS*sizeof(*tempstats));
+				ii+= ncomp[mm];
+			}
+		}
+	}
+
+	for(mm=0;mm<nmatrices;mm++) if(block[mm]!=NULL) free(block[mm]);
+	free(block);
+	if(error) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(-1); }
+	return(ntot);
+}
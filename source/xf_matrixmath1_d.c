@@ -0,0 +1,111 @@
+/*
+<TAGS>math dt.matrix</TAGS>
+
+DESCRIPTION:
+	Apply an arithmetic operation to every cell of a matrix, in place
+	- binary operations combine each cell with the corresponding cell of a second matrix, or a constant
+	- unary operations transform each cell, or the matrix as a whole (z-score)
+	- each operation is a simple loop with no function calls or branches (except log),
+	  so the compiler can vectorise it (SIMD)
+		- invalid values are handled by selecting a harmless operand, not by skipping the cell
+
+	Operations (op):
+		1= add          data1 + data2
+		2= sub          data1 - data2
+		3= mul          data1 * data2
+		4= div          data1 / data2
+		5= log          natural logarithm of data1
+		6= zscore       (data1 - mean) / standard-deviation, using the valid cells of data1
+
+	Rules for non-finite values (nanrule):
+		0= ignore: if either input is non-finite, the data1 cell is left unchanged
+		   - a non-finite cell in data2 (or a non-finite constant) does not affect data1
+		1= propagate: if either input is non-finite, the result is NAN
+
+USES:
+	- adjusting a matrix (or each of a stack of matrices) by another, e.g. baseline-correction
+	- chaining several operations on a matrix held in memory (see xe-matrixmath2)
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *data1  : input/output, matrix of bintot values, modified in place
+	double *data2  : input, second matrix of bintot values (binary operations only) - NULL to use the constant
+	double constant: input, value to use if data2 is NULL
+	long bintot    : input, number of cells in the matrix
+	int op         : input, the operation (see above)
+	int nanrule    : input, how to treat non-finite values (see above)
+	char *message  : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	0 on success, -1 on error
+
+SAMPLE CALL:
+	for(kk=0;kk<nmatrices;kk++) {
+		z= xf_matrixmath1_d((data1+kk*bintot),baseline,NAN,bintot,2,0,message);
+		if(z!=0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	}
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+int xf_matrixmath1_d(double *data1, double *data2, double constant, long bintot, int op, int nanrule, char *message) {
+
+	char *thisfunc="xf_matrixmath1_d\0";
+	long ii,nn;
+	double aa,bb,cc,fallback,sum,ssd,mean,sd;
+
+	if(bintot<1) { sprintf(message,"%s [ERROR]: invalid matrix size (%ld)",thisfunc,bintot); return(-1); }
+	if(op<1 || op>6) { sprintf(message,"%s [ERROR]: invalid operation (%d) must be 1-6",thisfunc,op); return(-1); }
+	if(nanrule!=0 && nanrule!=1) { sprintf(message,"%s [ERROR]: invalid nanrule (%d) must be 0 or 1",thisfunc,nanrule); return(-1); }
+
+	/* BINARY OPERATIONS WITH A CONSTANT */
+	if(op<=4 && data2==NULL) {
+		if(!isfinite(constant)) {
+			if(nanrule==1) for(ii=0;ii<bintot;ii++) data1[ii]= NAN;
+			return(0);
+		}
+		bb= constant;
+		if(op==1) for(ii=0;ii<bintot;ii++) data1[ii]+= bb;
+		if(op==2) for(ii=0;ii<bintot;ii++) data1[ii]-= bb;
+		if(op==3) for(ii=0;ii<bintot;ii++) data1[ii]*= bb;
+		if(op==4) for(ii=0;ii<bintot;ii++) data1[ii]/= bb;
+		/* non-finite cells stay non-finite, but are set to NAN if they are to be propagated */
+		if(nanrule==1) for(ii=0;ii<bintot;ii++) { aa= data1[ii]; data1[ii]= isfinite(aa) ? aa : NAN; }
+		return(0);
+	}
+
+	/* BINARY OPERATIONS WITH A SECOND MATRIX */
+	/* the second operand is selected, not branched: if either input is invalid it is replaced by */
+	/* the identity for the operation (data1 unchanged) or NAN (propagate) - so the loops vectorise */
+	if(op<=4) {
+		if(op==1) { fallback= nanrule ? NAN : -0.0; for(ii=0;ii<bintot;ii++) { aa= data1[ii]; bb= data2[ii]; bb= (isfinite(aa) && isfinite(bb)) ? bb : fallback; data1[ii]= aa+bb; }}
+		if(op==2) { fallback= nanrule ? NAN :  0.0; for(ii=0;ii<bintot;ii++) { aa= data1[ii]; bb= data2[ii]; bb= (isfinite(aa) && isfinite(bb)) ? bb : fallback; data1[ii]= aa-bb; }}
+		if(op==3) { fallback= nanrule ? NAN :  1.0; for(ii=0;ii<bintot;ii++) { aa= data1[ii]; bb= data2[ii]; bb= (isfinite(aa) && isfinite(bb)) ? bb : fallback; data1[ii]= aa*bb; }}
+		if(op==4) { fallback= nanrule ? NAN :  1.0; for(ii=0;ii<bintot;ii++) { aa= data1[ii]; bb= data2[ii]; bb= (isfinite(aa) && isfinite(bb)) ? bb : fallback; data1[ii]= aa/bb; }}
+		return(0);
+	}
+
+	/* LOG */
+	if(op==5) {
+		for(ii=0;ii<bintot;ii++) { aa= data1[ii]; if(isfinite(aa)) data1[ii]= log(aa); else if(nanrule==1) data1[ii]= NAN; }
+		return(0);
+	}
+
+	/* Z-SCORE - MEAN AND SAMPLE STANDARD DEVIATION OF THE VALID CELLS */
+	sum= 0.0; nn= 0;
+	for(ii=0;ii<bintot;ii++) { aa= data1[ii]; if(isfinite(aa)) { sum+= aa; nn++; } }
+	mean= (nn>0) ? sum/(double)nn : NAN;
+	ssd= 0.0;
+	for(ii=0;ii<bintot;ii++) { aa= data1[ii]; if(isfinite(aa)) ssd+= (aa-mean)*(aa-mean); }
+	sd= (nn>1) ? sqrt(ssd/(double)(nn-1)) : NAN;
+	/* if the matrix is flat (or has only one valid cell), the z-scores are undefined */
+	if(!(sd>0.0)) sd= NAN;
+	/* as above, invalid cells are given operands which leave them unchanged (0,1) or make them NAN */
+	fallback= nanrule ? NAN : 0.0;
+	for(ii=0;ii<bintot;ii++) { aa= data1[ii]; bb= isfinite(aa) ? mean : fallback; cc= isfinite(aa) ? sd : 1.0; data1[ii]= (aa-bb)/cc; }
+	return(0);
+}
@@ -0,0 +1,90 @@
+/*
+<TAGS>dt.matrix</TAGS>
+
+DESCRIPTION:
+	Transpose, rotate or flip a matrix, copying the result to a separate array
+	- the core of the transpose, rotate and flip functions (xf_matrixtrans1_d, xf_matrixrotate1_d etc.)
+	- transpose and 90-degree rotations are done in square tiles (TILESIZE x TILESIZE values)
+		- within a tile, both input rows and output rows stay in the cache
+		- this avoids a cache-miss for every value when striding through a large matrix
+		- the inner loop writes consecutive output values, so the compiler can vectorise it
+	- 180-degree rotation and flips only reverse rows or row-order, so need no tiling
+
+	Operations (op) - for the example matrix...
+		1 2 3
+		4 5 6
+
+		1= transpose       2= rotate 90        3= rotate 180      4= rotate 270 (-90)
+		   1 4                4 1                 6 5 4              3 6
+		   2 5                5 2                 3 2 1              2 5
+		   3 6                6 3                                    1 4
+
+		5= flip x          6= flip y
+		   3 2 1              4 5 6
+		   6 5 4              1 2 3
+
+USES:
+	- fast transformation of large matrices (e.g. spectrograms)
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *data1 : input, the original matrix, nx*ny values
+	double *data2 : output, pre-allocated array of nx*ny values to hold the result - must not overlap data1
+	long nx       : input, width of the original matrix
+	long ny       : input, height of the original matrix
+	int op        : input, the operation (see above)
+		- for op 1,2 and 4, the result has width ny and height nx - the calling function must swap them
+
+RETURN VALUE:
+	0 on success
+	-1 for invalid size of input
+	-2 for invalid operation
+
+SAMPLE CALL:
+	z= xf_matrixorient1_d(matrix1,matrix2,width,height,2);
+	if(z==0) { kk=width; width=height; height=kk; }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#define TILESIZE 32
+
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op) {
+
+	long ii,jj,x1,y1,x2,y2,xmax,ymax;
+	double *pdata1,*pdata2;
+
+	if(nx<1||ny<1) return(-1);
+	if(op<1||op>6) return(-2);
+	xmax= nx-1;
+	ymax= ny-1;
+
+	/* TRANSPOSE AND 90-DEGREE ROTATIONS: TILED */
+	/* - each column x of a tile becomes part of output row x (op 1,2) or xmax-x (op 4) */
+	if(op==1||op==2||op==4) {
+		for(y1=0;y1<ny;y1+=TILESIZE) {
+			y2= y1+TILESIZE; if(y2>ny) y2=ny;
+			for(x1=0;x1<nx;x1+=TILESIZE) {
+				x2= x1+TILESIZE; if(x2>nx) x2=nx;
+				for(ii=x1;ii<x2;ii++) {
+					pdata1= data1+ii;
+					if(op==1) { pdata2= data2+ii*ny;        for(jj=y1;jj<y2;jj++) pdata2[jj]= pdata1[jj*nx]; }
+					if(op==2) { pdata2= data2+ii*ny+ymax;   for(jj=y1;jj<y2;jj++) pdata2[-jj]= pdata1[jj*nx]; }
+					if(op==4) { pdata2= data2+(xmax-ii)*ny; for(jj=y1;jj<y2;jj++) pdata2[jj]= pdata1[jj*nx]; }
+				}
+			}
+		}
+		return(0);
+	}
+
+	/* 180-DEGREE ROTATION AND FLIPS: ROW BY ROW */
+	for(jj=0;jj<ny;jj++) {
+		pdata1= data1+jj*nx;
+		if(op==3) { pdata2= data2+(ymax-jj)*nx; for(ii=0;ii<nx;ii++) pdata2[xmax-ii]= pdata1[ii]; }
+		if(op==5) { pdata2= data2+jj*nx;        for(ii=0;ii<nx;ii++) pdata2[xmax-ii]= pdata1[ii]; }
+		if(op==6) { pdata2= data2+(ymax-jj)*nx; for(ii=0;ii<nx;ii++) pdata2[ii]= pdata1[ii]; }
+	}
+	return(0);
+}
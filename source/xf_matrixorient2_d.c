@@ -0,0 +1,113 @@
+/*
+<TAGS>dt.matrix</TAGS>
+
+DESCRIPTION:
+	Transpose, rotate or flip one or more matrices in place
+	- batched: data may hold nmatrices matrices of the same size, packed together
+	- operations are as for xf_matrixorient1_d (1=transpose, 2-4=rotate 90/180/270, 5-6=flip x/y)
+	- no extra memory is needed if the matrix is square, or for 180-degree rotation and flips
+		- square matrices are transposed by swapping tiles above and below the diagonal
+		- 90 and 270-degree rotations are a transpose followed by a flip
+	- otherwise each matrix is transformed into a single scratch matrix (xf_matrixorient1_d) and copied back
+	- if compiled with OpenMP, matrices are processed in parallel (one scratch matrix per thread)
+
+USES:
+	- fast transformation of large matrices, or of all the matrices in a multi-matrix file
+
+DEPENDENCY TREE:
+	xf_matrixorient2_d
+		xf_matrixorient1_d
+
+ARGUMENTS:
+	double *data   : input/output, nmatrices matrices of width*height values
+	long nmatrices : input, number of matrices
+	long *width    : input/output, width of each matrix - swapped with height for op 1,2 and 4
+	long *height   : input/output, height of each matrix
+	int op         : input, the operation (see xf_matrixorient1_d)
+
+RETURN VALUE:
+	0 on success
+	-1 for invalid size of input
+	-2 for invalid operation
+	-3 for memory allocation error
+
+SAMPLE CALL:
+	z= xf_matrixorient2_d(multimatrix,nmatrices,&width,&height,1);
+	if(z==-3) { fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define TILESIZE 32
+
+/* external functions start */
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
+/* external functions end */
+
+/* in-place operations on one matrix: flips and 180-degree rotation for any size, transpose for square matrices */
+static void xf_matrixorient2_d_flipx(double *data, long nx, long ny) {
+	long ii,jj; double aa,*pa,*pb;
+	for(jj=0;jj<ny;jj++) { pa= data+jj*nx; pb= pa+nx-1; for(ii=0;ii<(nx/2);ii++) { aa=pa[ii]; pa[ii]=pb[-ii]; pb[-ii]=aa; } }
+}
+static void xf_matrixorient2_d_flipy(double *data, long nx, long ny) {
+	long ii,jj; double aa,*pa,*pb;
+	for(jj=0;jj<(ny/2);jj++) { pa= data+jj*nx; pb= data+(ny-1-jj)*nx; for(ii=0;ii<nx;ii++) { aa=pa[ii]; pa[ii]=pb[ii]; pb[ii]=aa; } }
+}
+static void xf_matrixorient2_d_reverse(double *data, long nn) {
+	long ii; double aa,*pb=data+nn-1;
+	for(ii=0;ii<(nn/2);ii++) { aa=data[ii]; data[ii]=pb[-ii]; pb[-ii]=aa; }
+}
+static void xf_matrixorient2_d_transsquare(double *data, long nn) {
+	long ii,jj,x1,y1,x2,y2; double aa;
+	for(y1=0;y1<nn;y1+=TILESIZE) {
+		y2= y1+TILESIZE; if(y2>nn) y2=nn;
+		for(x1=y1;x1<nn;x1+=TILESIZE) {
+			x2= x1+TILESIZE; if(x2>nn) x2=nn;
+			for(jj=y1;jj<y2;jj++) {
+				for(ii=(x1>jj?x1:jj+1);ii<x2;ii++) { aa=data[jj*nn+ii]; data[jj*nn+ii]=data[ii*nn+jj]; data[ii*nn+jj]=aa; }
+			}
+		}
+	}
+}
+
+int xf_matrixorient2_d(double *data, long nmatrices, long *width, long *height, int op) {
+
+	int inplace,error=0;
+	long kk,nx=*width,ny=*height,nn;
+
+	if(nx<1||ny<1||nmatrices<1) return(-1);
+	if(op<1||op>6) return(-2);
+	nn= nx*ny;
+	inplace= (nx==ny || op==3 || op==5 || op==6);
+
+	#pragma omp parallel if(nmatrices>1) reduction(|:error)
+	{
+		double *scratch=NULL,*pdata;
+		long mm;
+		#pragma omp for schedule(static)
+		for(mm=0;mm<nmatrices;mm++) {
+			pdata= data+mm*nn;
+			if(inplace) {
+				if(op==1) xf_matrixorient2_d_transsquare(pdata,nx);
+				if(op==2) { xf_matrixorient2_d_transsquare(pdata,nx); xf_matrixorient2_d_flipx(pdata,nx,ny); }
+				if(op==3) xf_matrixorient2_d_reverse(pdata,nn);
+				if(op==4) { xf_matrixorient2_d_transsquare(pdata,nx); xf_matrixorient2_d_flipy(pdata,nx,ny); }
+				if(op==5) xf_matrixorient2_d_flipx(pdata,nx,ny);
+				if(op==6) xf_matrixorient2_d_flipy(pdata,nx,ny);
+				continue;
+			}
+			/* the scratch matrix is allocated the first time this thread needs it */
+			if(scratch==NULL) scratch= malloc(nn*sizeof(*scratch));
+			if(scratch==NULL) { error=1; continue; }
+			xf_matrixorient1_d(pdata,scratch,nx,ny,op);
+			memcpy(pdata,scratch,nn*sizeof(*scratch));
+		}
+		if(scratch!=NULL) free(scratch);
+	}
+	if(error) return(-3);
+
+	/* TRANSPOSE AND 90-DEGREE ROTATIONS SWAP THE DIMENSIONS */
+	if(op==1||op==2||op==4) { kk=nx; *width=ny; *height=kk; }
+	return(0);
+}
@@ -11,12 +11,18 @@ DESCRIPTION:
 
 		NOTE: multiple whitespace is treated as a single whitespace
 			- so "empty" words in a line will affect the index to all subsequent columns.
+
+		Binary multi-matrix input (BINXMM, see xf_matrixwritebin1_d) is detected automatically
+			- the first byte of a BINXMM file (0x89) cannot start an ASCII file
+			- all matrices are read, without parsing
+			- a header-less stream of matrix records (e.g. from xe-matrixsplit1) is also accepted,
+			  but only if all the matrices are the same size - otherwise an error is returned
 USES:
 	storing 2-d blocks of ascii data into memory as a 1d array
 
 DEPENDENCY TREE:
-
-	No dependencies
+	xf_matrixread1_d
+		xf_matrixreadbin1_d
 
 ARGUMENTS:
 	long *nmatrices - output variable, how many matrices were read
@@ -39,6 +45,10 @@ SAMPLE CALL:
 #include <stdlib.h>
 #include <string.h>
 
+/* external functions start */
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
+/* external functions end */
+
 /* internal functions start */
 char *xfinternal_lineread1(char *line,long *maxlinelen,FILE *fpin);
 long *xfinternal_lineparse1(char *line,long *nwords);
@@ -49,13 +59,19 @@ double *xf_matrixread1_d(long *nmatrices, long *ncols, long *nrows, char *messag
 	char *thisfunc= "xf_matrixread1_d\0";
 	char *line=NULL;
 	int prevblank=1;
-	long i,j,k,n=0,nwords,nrowstemp=0,nlines=0,maxlinelen=0;
+	int firstbyte;
+	long i,j,k,n=0,nwords,nrowstemp=0,nlines=0,maxlinelen=0,nalloc=0;
 	long *start=NULL;
 	double aa,*matrix=NULL;
 	size_t sizeofdouble=sizeof(double);
 
 	*ncols=0; *nrows=0; *nmatrices=0;
 
+	/* BINARY MULTI-MATRIX INPUT: READ DIRECTLY */
+	firstbyte= fgetc(fpin);
+	if(firstbyte!=EOF) ungetc(firstbyte,fpin);
+	if(firstbyte==0x89) return(xf_matrixreadbin1_d(fpin,-1,nmatrices,ncols,nrows,NULL,message));
+
 	while((line=xfinternal_lineread1(line,&maxlinelen,fpin))!=NULL) {
 
 		nlines++;
@@ -65,8 +81,12 @@ double *xf_matrixread1_d(long *nmatrices, long *ncols, long *nrows, char *messag
 
 		if(line[0]!='#' && nwords>0) {
 
-			matrix=(double *)realloc(matrix,(n+nwords)*sizeofdouble);
-			if(matrix==NULL) {matrix=NULL; sprintf(message,"%s: memory allocation error storing matrix",thisfunc); goto FINISH;}
+			/* allocate memory in increasing blocks, rather than for every row */
+			if((n+nwords)>nalloc) {
+				nalloc= 2*(n+nwords);
+				matrix=(double *)realloc(matrix,nalloc*sizeofdouble);
+				if(matrix==NULL) {matrix=NULL; sprintf(message,"%s: memory allocation error storing matrix",thisfunc); goto FINISH;}
+			}
 			for(i=0,j=n;i<nwords;i++) {
 				if(sscanf((line+start[i]),"%lf",&aa)==1 && isfinite(aa)) matrix[j]=aa;
 				else matrix[j]=NAN;
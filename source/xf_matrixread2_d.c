@@ -14,8 +14,15 @@ DESCRIPTION:
 USES:
 	storing 2-d blocks of ASCII data into memory as a 1d array
 
+	Binary multi-matrix input (BINXMM, see xf_matrixwritebin1_d) is detected automatically
+		- identifiers are then taken from the file (idcol is ignored)
+		- a header-less stream of matrix records (e.g. from xe-matrixsplit1) is also accepted,
+		  but only if all the matrices are the same size - otherwise an error is returned
+
 DEPENDENCIES:
 	char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
+	long *xf_lineparse1(char *line,long *nwords);
+	double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
 
 ARGUMENTS:
 	char *infile     - name of the input file, or "stdin"
@@ -57,14 +64,15 @@ SAMPLE CALL:
 /* external functions start */
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse1(char *line,long *nwords);
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message);
 /* external functions end */
 
 long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1, long *ncols, long *nrows, char *message) {
 
 	char *thisfunc="xf_matrixread2_d\0";
 	char *line=NULL;
-	int prevblank=1;
-	long *start=NULL,ii,jj,kk,nn=0,nwords,nrowstemp=0,nlines=0,maxlinelen=0,nmatrices;
+	int prevblank=1,firstbyte;
+	long *start=NULL,ii,jj,kk,nn=0,nwords,nrowstemp=0,nlines=0,maxlinelen=0,nmatrices,nalloc=0;
 	double *matrix2=NULL,*id2=NULL,tempid,aa;
 	size_t sizeofmatrix= sizeof(*matrix2);
 	FILE *fpin;
@@ -74,23 +82,35 @@ long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1,
 	if(strcmp(infile,"stdin")==0) fpin=stdin;
 	else if((fpin=fopen(infile,"r"))==0) { sprintf(message," %s: file \"%s\" not found",thisfunc,infile); nmatrices=-1; goto FINISH; }
 
+	/* BINARY MULTI-MATRIX INPUT: READ DIRECTLY */
+	firstbyte= fgetc(fpin);
+	if(firstbyte!=EOF) ungetc(firstbyte,fpin);
+	if(firstbyte==0x89) {
+		matrix2= xf_matrixreadbin1_d(fpin,-1,&nmatrices,ncols,nrows,&id2,message);
+		if(matrix2==NULL) nmatrices=-1;
+		goto FINISH;
+	}
+
 	while((line=xf_lineread1(line,&maxlinelen,fpin))!=NULL) {
 
 		nlines++;
-		if(maxlinelen==-1)  {matrix2=NULL; sprintf(message," %s: memory allocation error reading line %d",thisfunc,nlines); nmatrices=-1; goto FINISH;}
+		if(maxlinelen==-1)  {matrix2=NULL; sprintf(message," %s: memory allocation error reading line %ld",thisfunc,nlines); nmatrices=-1; goto FINISH;}
 		start= xf_lineparse1(line,&nwords);
 
 		/* THIS IS DATA, STORE THE VALUES FROM THE LINE */
 		if(line[0]!='#' && nwords>0) {
-			matrix2= realloc(matrix2,(nn+nwords)*sizeofmatrix);
-			if(matrix2==NULL) {matrix2=NULL; sprintf(message,"%s: memory allocation error storing matrix2",thisfunc); nmatrices=-1; goto FINISH;}
+			if((nn+nwords)>nalloc) {
+				nalloc= 2*(nn+nwords);
+				matrix2= realloc(matrix2,nalloc*sizeofmatrix);
+				if(matrix2==NULL) {matrix2=NULL; sprintf(message,"%s: memory allocation error storing matrix2",thisfunc); nmatrices=-1; goto FINISH;}
+			}
 			for(ii=0,jj=nn;ii<nwords;ii++) {
 				if(sscanf((line+start[ii]),"%lf",&aa)==1 && isfinite(aa)) matrix2[jj]= aa;
 				else matrix2[jj]=NAN;
 				jj++;
 			}
 			if(nrowstemp==0 && nmatrices==0) *ncols=nwords;
-			else if(nwords!=*ncols) {matrix2=NULL; sprintf(message,"%s: unequal number of columns detected at line %d",thisfunc,nlines); nmatrices=-1; goto FINISH;}
+			else if(nwords!=*ncols) {matrix2=NULL; sprintf(message,"%s: unequal number of columns detected at line %ld",thisfunc,nlines); nmatrices=-1; goto FINISH;}
 			prevblank=0; // for next iteration, indicate that previous line contained matrix data
 			nrowstemp++; // count the number of rows for this matrix
 			nn+=nwords;  // count the total number of items in the matrix for next memory allocation iteration
@@ -99,7 +119,7 @@ long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1,
 		else {
 			if(prevblank==0) {
 				if(nmatrices==0) *nrows=nrowstemp;
-				else if(nrowstemp!=(*nrows)) {matrix2=NULL; sprintf(message,"%s: unequal number of rows detected at line %d",thisfunc,nlines); nmatrices=-1; goto FINISH;}
+				else if(nrowstemp!=(*nrows)) {matrix2=NULL; sprintf(message,"%s: unequal number of rows detected at line %ld",thisfunc,nlines); nmatrices=-1; goto FINISH;}
 				id2= realloc(id2,(nmatrices+1)*sizeof(*id2));
 				if(id2==NULL) {id2=NULL; sprintf(message,"%s: memory allocation error storing id2",thisfunc); nmatrices=-1; goto FINISH;}
 				id2[nmatrices]= tempid;
@@ -118,7 +138,7 @@ long xf_matrixread2_d(char *infile, long idcol, double **matrix1, double **id1,
 	/* IF YOU GET TO THE END OF THE FILE AND THE PREVIOUS LINE WAS NOT BLANK/COMMENT, TREAT THIS AS THE CONCLUSION OF A MATRIX */
 	if(prevblank==0) {
 		if(nmatrices==0) *nrows=nrowstemp;
-		else if(nrowstemp!=(*nrows)) {matrix2=NULL; sprintf(message,"%s: unequal number of rows detected at line %d",thisfunc,nlines); nmatrices=-1; goto FINISH;}
+		else if(nrowstemp!=(*nrows)) {matrix2=NULL; sprintf(message,"%s: unequal number of rows detected at line %ld",thisfunc,nlines); nmatrices=-1; goto FINISH;}
 		id2= realloc(id2,(nmatrices+1)*sizeof(*id2));
 		if(id2==NULL) {id2=NULL; sprintf(message,"%s: memory allocation error storing id2",thisfunc); nmatrices=-1; goto FINISH;}
 		id2[nmatrices]= tempid;
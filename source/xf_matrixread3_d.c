@@ -15,6 +15,9 @@ DESCRIPTION:
 	NOTE: 	multiple whitespace is treated as a single whitespace, so "empty"
        			words in a line will affect the index to all subsequent columns.
 
+	Binary multi-matrix input (BINXMM, see xf_matrixwritebin1_d) is detected automatically
+		- one matrix is read per call, and header[] is set to "# [id]" (or blank if there is no id)
+
 USES:
 	- Finding matrices for a given subject or group in a multi-matrix file
 
@@ -22,6 +25,7 @@ DEPENDENCIES:
 
 	char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 	long *xf_lineparse1(char *line,long *nwords);
+	double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message);
 
 ARGUMENTS:
 	FILE *fpin      - input: pointer to input stream (typically a file or stdin) - updated by the function
@@ -71,20 +75,32 @@ SAMPLE CALL:
 /* external functions start */
 char *xf_lineread1(char *line, long *maxlinelen, FILE *fpin);
 long *xf_lineparse1(char *line,long *nwords);
+double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message);
 /* external functions end */
 
 double *xf_matrixread3_d(FILE *fpin, long *ncols, long *nrows, char *header, char *message) {
 
 	char *thisfunc= "xf_matrixread3_d\0";
 	char *line=NULL;
-	int prevblank=0;
-	long *start=NULL,ii,jj,kk,nn=0,nwords,nlines=0,nlinesmatrix=0,maxlinelen=0;
+	int prevblank=0,firstbyte;
+	long *start=NULL,ii,jj,kk,nn=0,nwords,nlines=0,nlinesmatrix=0,maxlinelen=0,nalloc=0;
 	double aa,*matrix=NULL;
 	size_t sizeofmatrix;
 
 	sizeofmatrix= sizeof(*matrix);
 	*ncols=	*nrows= 0;
 
+	/* BINARY MULTI-MATRIX INPUT: READ THE NEXT RECORD */
+	firstbyte= fgetc(fpin);
+	if(firstbyte!=EOF) ungetc(firstbyte,fpin);
+	if(firstbyte==0x89) {
+		matrix= xf_matrixreadbin2_d(fpin,ncols,nrows,&aa,message);
+		if(isfinite(aa)) snprintf(header,256,"# %.16g\n",aa);
+		else { header[0]='\n'; header[1]='\0'; }
+		if(*nrows>=0) { message[0]='\n'; message[1]='\0'; }
+		return(matrix);
+	}
+
 	/* use message[] to initialize header[] */
 	/* this represents the memory of the last header from a previous call */
 	header= strncpy(header,message,256);
@@ -119,8 +135,11 @@ double *xf_matrixread3_d(FILE *fpin, long *ncols, long *nrows, char *header, cha
 			*ncols= nwords;
 			*nrows= *nrows+1;
 			/* store this row in the matrix */
-	 		matrix= realloc(matrix,(nn+nwords)*sizeofmatrix);
-			if(matrix==NULL) {sprintf(message,"%s: memory allocation error storing matrix",thisfunc);*nrows=*ncols=-1;goto FINISH;}
+			if((nn+nwords)>nalloc) {
+				nalloc= 2*(nn+nwords);
+		 		matrix= realloc(matrix,nalloc*sizeofmatrix);
+				if(matrix==NULL) {sprintf(message,"%s: memory allocation error storing matrix",thisfunc);*nrows=*ncols=-1;goto FINISH;}
+			}
 			for(ii=0;ii<nwords;ii++) {
 				if(sscanf((line+start[ii]),"%lf",&aa)==1 && isfinite(aa)) matrix[nn]=aa;
 				else matrix[nn]= NAN;
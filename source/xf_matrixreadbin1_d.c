@@ -0,0 +1,167 @@
+/*
+<TAGS>file dt.matrix</TAGS>
+
+DESCRIPTION:
+	Read all matrices, or one selected matrix, from a binary multi-matrix file (BINXMM format)
+	- see xf_matrixwritebin1_d for a description of the format
+	- the input must be positioned at the start of the file
+	- a selected matrix is found using the offset table
+		- if the input is seekable (a file) the preceding matrices are skipped without reading
+		- otherwise (e.g. stdin) the preceding matrices are read and discarded
+	- also reads a header-less stream of matrix records (e.g. from xe-matrixsplit1 when blocks differ in height)
+		- records are read in order, as there is no offset table
+		- to read all matrices, the records must be the same size - otherwise select one matrix (kk),
+		  or use xf_matrixreadbin2_d to read them one at a time
+
+USES:
+	Fast reading of multi-matrix data, or random access to one matrix in a large file
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	FILE *fpin        : input, stream positioned at the start of a BINXMM file or record stream
+	long kk           : input, matrix to read (zero-offset), or -1 to read all matrices
+	long *nmatrices   : output, total number of matrices in the file
+	long *ncols       : output, columns in each matrix (in matrix kk, for a record stream)
+	long *nrows       : output, rows in each matrix (in matrix kk, for a record stream)
+	double **id       : output, allocated array of identifiers for the matrices read (all, or matrix kk)
+	                    - set to NULL if not required - otherwise, must be freed by the calling function
+	char *message     : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	pointer to the matrix data (all matrices packed together, or matrix kk), or NULL on error
+	the data must be freed by the calling function
+
+SAMPLE CALL:
+	matrix= xf_matrixreadbin1_d(fpin,5,&nmatrices,&ncols,&nrows,&id,message);
+	if(matrix==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#define BINXMM_HEADERSIZE 500
+#define BINXMM_RECORDSIZE 32
+
+double *xf_matrixreadbin1_d(FILE *fpin, long kk, long *nmatrices, long *ncols, long *nrows, double **id, char *message) {
+
+	char *thisfunc="xf_matrixreadbin1_d\0";
+	char header[BINXMM_HEADERSIZE],record[BINXMM_RECORDSIZE];
+	size_t ii,hsize1=32,params[6],matrixsize,nread;
+	long jj,first,last,nmat,position,nalloc,dims[2],*offset=NULL;
+	double *tableid=NULL,*matrix=NULL,*id2=NULL,*temp=NULL;
+
+	*nmatrices= *ncols= *nrows= 0;
+	if(id!=NULL) *id= NULL;
+
+	/* READ THE FILETYPE OR RECORD TAG */
+	if(fread(header,1,8,fpin)!=8) { sprintf(message,"%s [ERROR]: problem reading header",thisfunc); return(NULL); }
+
+	/* HEADER-LESS RECORD STREAM: READ THE RECORDS IN ORDER, KEEPING ALL OR JUST MATRIX kk */
+	if(memcmp(header,"\x89" "MATRIX1",8)==0) {
+		memcpy(record,header,8);
+		for(nmat=nalloc=0;;nmat++) {
+			if(nmat>0) {
+				nread= fread(record,1,8,fpin);
+				if(nread==0) break;
+				if(nread!=8 || memcmp(record,"\x89" "MATRIX1",8)!=0) { sprintf(message,"%s [ERROR]: invalid record for matrix %ld",thisfunc,nmat); goto ERROR; }
+			}
+			if(fread((record+8),sizeof(double),1,fpin)!=1 || fread(dims,sizeof(long),2,fpin)!=2) { sprintf(message,"%s [ERROR]: problem reading record header for matrix %ld",thisfunc,nmat); goto ERROR; }
+			matrixsize= dims[0]*dims[1];
+			/* skip records which are not required - seek if possible, otherwise read and discard */
+			if(kk>=0 && nmat!=kk) {
+				if(fseek(fpin,(long)(matrixsize*sizeof(double)),SEEK_CUR)==0) continue;
+				for(ii=0;ii<matrixsize;ii++) if(fread((record+8),sizeof(double),1,fpin)!=1) break;
+				if(ii!=matrixsize) { sprintf(message,"%s [ERROR]: unexpected end of file reading matrix %ld",thisfunc,nmat); goto ERROR; }
+				continue;
+			}
+			/* when reading all records, they must be the same size */
+			if(kk<0 && nmat>0 && (dims[0]!=*ncols || dims[1]!=*nrows)) { sprintf(message,"%s [ERROR]: matrix %ld (%ld x %ld) differs in size from matrix 0 (%ld x %ld) - read one matrix at a time instead",thisfunc,nmat,dims[0],dims[1],*ncols,*nrows); goto ERROR; }
+			*ncols= dims[0];
+			*nrows= dims[1];
+			jj= (kk<0) ? nmat : 0;
+			if(jj>=nalloc) {
+				nalloc= (kk>=0) ? 1 : ((nalloc<1) ? 16 : 2*nalloc);
+				temp= realloc(matrix,(nalloc*matrixsize+1)*sizeof(*matrix));
+				if(temp==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto ERROR; }
+				matrix= temp;
+				temp= realloc(tableid,nalloc*sizeof(*tableid));
+				if(temp==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto ERROR; }
+				tableid= temp;
+			}
+			memcpy((tableid+jj),(record+8),sizeof(double));
+			if(fread((matrix+jj*matrixsize),sizeof(double),matrixsize,fpin)!=matrixsize) { sprintf(message,"%s [ERROR]: unexpected end of file reading matrix %ld",thisfunc,nmat); goto ERROR; }
+		}
+		if(kk>=nmat) { sprintf(message,"%s [ERROR]: matrix %ld requested but file contains %ld",thisfunc,kk,nmat); goto ERROR; }
+		if(id!=NULL) { *id= tableid; tableid= NULL; }
+		if(tableid!=NULL) free(tableid);
+		*nmatrices= nmat;
+		return(matrix);
+	}
+
+	/* READ THE REST OF THE HEADER */
+	if(fread((header+8),1,(BINXMM_HEADERSIZE-8),fpin)!=(BINXMM_HEADERSIZE-8)) { sprintf(message,"%s [ERROR]: problem reading header",thisfunc); return(NULL); }
+	if(memcmp(header,"\x89" "BINXMM1",8)!=0) { sprintf(message,"%s [ERROR]: input is not a BINXMM multi-matrix file",thisfunc); return(NULL); }
+	memcpy(params,(header+hsize1),6*sizeof(size_t));
+	if(params[0]!=BINXMM_HEADERSIZE || params[1]!=sizeof(double) || params[2]!=9) { sprintf(message,"%s [ERROR]: unsupported header parameters",thisfunc); return(NULL); }
+	nmat= params[5];
+	matrixsize= params[3]*params[4];
+	position= BINXMM_HEADERSIZE;
+	if(kk>=nmat) { sprintf(message,"%s [ERROR]: matrix %ld requested but file contains %ld",thisfunc,kk,nmat); return(NULL); }
+
+	/* READ THE OFFSET TABLE */
+	offset= malloc((nmat+1)*sizeof(*offset));
+	tableid= malloc((nmat+1)*sizeof(*tableid));
+	if(offset==NULL || tableid==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto ERROR; }
+	for(jj=0;jj<nmat;jj++) {
+		if(fread((offset+jj),sizeof(long),1,fpin)!=1 || fread((tableid+jj),sizeof(double),1,fpin)!=1) { sprintf(message,"%s [ERROR]: problem reading offset table",thisfunc); goto ERROR; }
+	}
+	position+= nmat*(sizeof(long)+sizeof(double));
+
+	/* DETERMINE THE RANGE OF MATRICES TO READ, AND ALLOCATE MEMORY */
+	if(kk<0) { first= 0; last= nmat-1; }
+	else { first= last= kk; }
+	matrix= malloc(((last-first+1)*matrixsize+1)*sizeof(*matrix));
+	if(matrix==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto ERROR; }
+
+	/* GO TO THE FIRST RECORD - SEEK IF POSSIBLE, OTHERWISE READ AND DISCARD */
+	if(offset[first]!=position) {
+		if(fseek(fpin,(offset[first]-position),SEEK_CUR)!=0) {
+			for(;position<offset[first];position+=nread) {
+				nread= offset[first]-position;
+				if(nread>(matrixsize*sizeof(double))) nread= matrixsize*sizeof(double);
+				if(nread<1 || fread(matrix,1,nread,fpin)!=nread) { sprintf(message,"%s [ERROR]: unexpected end of file",thisfunc); goto ERROR; }
+			}
+		}
+	}
+
+	/* READ THE RECORDS - THEY ARE CONTIGUOUS */
+	for(jj=first;jj<=last;jj++) {
+		if(fread(record,1,BINXMM_RECORDSIZE,fpin)!=BINXMM_RECORDSIZE || memcmp(record,"\x89" "MATRIX1",8)!=0) { sprintf(message,"%s [ERROR]: invalid record for matrix %ld",thisfunc,jj); goto ERROR; }
+		if(fread((matrix+(jj-first)*matrixsize),sizeof(double),matrixsize,fpin)!=matrixsize) { sprintf(message,"%s [ERROR]: unexpected end of file reading matrix %ld",thisfunc,jj); goto ERROR; }
+	}
+
+	/* COPY THE IDENTIFIERS */
+	if(id!=NULL) {
+		id2= malloc((last-first+1)*sizeof(*id2));
+		if(id2==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto ERROR; }
+		for(jj=first;jj<=last;jj++) id2[jj-first]= tableid[jj];
+		*id= id2;
+	}
+
+	*nmatrices= nmat;
+	*ncols= params[3];
+	*nrows= params[4];
+	free(offset);
+	free(tableid);
+	return(matrix);
+
+ERROR:
+	*nmatrices= *ncols= *nrows= 0;
+	if(offset!=NULL) free(offset);
+	if(tableid!=NULL) free(tableid);
+	if(matrix!=NULL) free(matrix);
+	return(NULL);
+}
@@ -0,0 +1,78 @@
+/*
+<TAGS>file dt.matrix</TAGS>
+
+DESCRIPTION:
+	Read the next matrix from a binary multi-matrix stream (BINXMM format)
+	- see xf_matrixwritebin1_d for a description of the format
+	- the file header and offset table are skipped if they are encountered
+	- can be called repeatedly, one matrix per call, until the end of the file
+	- because each record has its own header, no information needs to be kept between calls
+
+USES:
+	Processing matrices one at a time without holding the whole file in memory
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	FILE *fpin      : input, stream positioned at the start of the file, or at the end of the previous matrix
+	long *ncols     : output, columns in the matrix (0 at end of file, -1 on error)
+	long *nrows     : output, rows in the matrix (0 at end of file, -1 on error)
+	double *id      : output, identifier for the matrix (NAN if none)
+	char *message   : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	pointer to the matrix, or NULL at end of file or on error (check nrows)
+	the matrix must be freed by the calling function
+
+SAMPLE CALL:
+	while((matrix=xf_matrixreadbin2_d(fpin,&ncols,&nrows,&id,message))!=NULL) {
+		... process the matrix
+		free(matrix);
+	}
+	if(nrows<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#define BINXMM_HEADERSIZE 500
+#define BINXMM_RECORDSIZE 32
+
+double *xf_matrixreadbin2_d(FILE *fpin, long *ncols, long *nrows, double *id, char *message) {
+
+	char *thisfunc="xf_matrixreadbin2_d\0";
+	char buffer[BINXMM_HEADERSIZE];
+	size_t ii,hsize1=32,params[6],matrixsize;
+	long dims[2];
+	double *matrix=NULL;
+
+	*ncols= *nrows= 0;
+	*id= NAN;
+
+	/* READ THE TAG - END OF FILE HERE IS NORMAL */
+	if(fread(buffer,1,8,fpin)!=8) return(NULL);
+
+	/* IF THIS IS THE FILE HEADER, SKIP IT AND THE OFFSET TABLE, THEN READ THE NEXT TAG */
+	if(memcmp(buffer,"\x89" "BINXMM1",8)==0) {
+		if(fread((buffer+8),1,(BINXMM_HEADERSIZE-8),fpin)!=(BINXMM_HEADERSIZE-8)) { sprintf(message,"%s [ERROR]: problem reading header",thisfunc); *ncols=*nrows=-1; return(NULL); }
+		memcpy(params,(buffer+hsize1),6*sizeof(size_t));
+		for(ii=0;ii<params[5];ii++) {
+			if(fread(buffer,1,(sizeof(long)+sizeof(double)),fpin)!=(sizeof(long)+sizeof(double))) { sprintf(message,"%s [ERROR]: problem reading offset table",thisfunc); *ncols=*nrows=-1; return(NULL); }
+		}
+		if(fread(buffer,1,8,fpin)!=8) return(NULL);
+	}
+
+	/* READ THE RECORD */
+	if(memcmp(buffer,"\x89" "MATRIX1",8)!=0) { sprintf(message,"%s [ERROR]: invalid matrix record",thisfunc); *ncols=*nrows=-1; return(NULL); }
+	if(fread(id,sizeof(double),1,fpin)!=1 || fread(dims,sizeof(long),2,fpin)!=2) { sprintf(message,"%s [ERROR]: problem reading record header",thisfunc); *ncols=*nrows=-1; return(NULL); }
+	matrixsize= dims[0]*dims[1];
+	matrix= malloc((matrixsize+1)*sizeof(*matrix));
+	if(matrix==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); *ncols=*nrows=-1; return(NULL); }
+	if(fread(matrix,sizeof(double),matrixsize,fpin)!=matrixsize) { sprintf(message,"%s [ERROR]: unexpected end of file",thisfunc); free(matrix); *ncols=*nrows=-1; return(NULL); }
+
+	*ncols= dims[0];
+	*nrows= dims[1];
+	return(matrix);
+}
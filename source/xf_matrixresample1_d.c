@@ -8,8 +8,11 @@ DESCRIPTION:
 	Rows and columns are split (new dimensions > old dimensions)
 	or binned & averaged (new dimensions >= old dimansions), accordingly
 
-	Alters input array
-	NAN values will be ignored, but INF will affect the results
+	Does not alter the input array - the result is a new array
+	NAN and INF values will be ignored
+
+	Uses the separable resampling engine xf_matrixresample2_d (box method)
+	- see xf_matrixresample2_d for linear and Lanczos resampling, and for multiple matrices
 
 	[JRH] 23 November 2015
 
@@ -18,109 +21,45 @@ USES:
 	- modifying different matrices so they are all the same size
 
 DEPENDENCY TREE:
-	xf_bin1a_d
-	xf_expand1_d
+	xf_matrixresample1_d
+		xf_matrixresample2_d
 
 ARGUMENTS:
 	double *martix1: input, array of numbers to be resampled - matrix format
 	long nx1: original matrix width
 	long ny1: original matrix height
-	long nx2: original matrix width
-	long ny2: original matrix height
+	long nx2: new matrix width
+	long ny2: new matrix height
 
 RETURN VALUE:
 	Pointer to modified matrix - NULL on error
 
 SAMPLE CALL:
-
+	matrix2= xf_matrixresample1_d(matrix1,width,height,100,100);
+	if(matrix2==NULL) { fprintf(stderr,"\n--- Error[%s]: insufficient memory\n\n",thisprog); exit(1); }
 */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
-double xf_bin1a_d(double *data, size_t *setn, size_t *setz, size_t setbins, char *message);
-double *xf_expand1_d(double *data , long nn, long setn, char *message);
 
+/* external functions start */
+int xf_matrixresample2_d(double *matrix1, long nmatrices, long nx1, long ny1, double *matrix2, long nx2, long ny2, int method, char *message);
+/* external functions end */
 
 double *xf_matrixresample1_d(double *matrix1, long nx1, long ny1, long nx2, long ny2) {
 
 	char message[256];
-	long i,j,k,x1,x2,y1,y2,n1,n2;
-	double *matrix2=NULL,*tempdata=NULL,aa;
-	size_t sizeofdouble=sizeof(double),iii,jjj,zzz;
-
-	double *xfinternal_resample1(double *tempdata , long tempn, long setn);
+	double *matrix2=NULL;
 
 	if(nx1==nx2 && ny1==ny2) return(matrix1);
 
-	/* find largest dimension required for temporary array */
-	k=nx1;
-	if(nx2>k) k=nx2;
-	if(ny1>k) k=ny1;
-	if(ny2>k) k=ny2;
-
-	/* calculate the total size of original and destination arrays (n1 and n2, respectively) */
-	n1= nx1*ny1;
-	n2= k*k;
-
 	/* allocate memory */
-	tempdata=(double *)realloc(tempdata,((k)*sizeof(double)));
-	if(tempdata==NULL) return(NULL);
-	matrix2=(double *)realloc(matrix2,((n2)*sizeof(double)));
+	matrix2= malloc(nx2*ny2*sizeof(*matrix2));
 	if(matrix2==NULL) return(NULL);
 
-	/* initialize the destination array */
-	for(i=0;i<n2;i++) matrix2[i]=NAN;
-
-
- 	/* RESAMPLE EACH ROW */
-	for(y1=0;y1<ny1;y1++) {
-
-		/* set index j to the beginning of current row */
-		j=y1*nx1;
-		/* copy row to tempdata and resample */
-		for(x1=0;x1<nx1;x1++) tempdata[x1]=matrix1[j+x1];
-
-		if(nx1<=nx2) {
-			tempdata= xf_expand1_d(tempdata,nx1,nx2,message);
-			if(tempdata==NULL) return(NULL);
-		}
-		else {
-			zzz=0;
-			iii=(size_t)nx1;
-			aa= xf_bin1a_d(tempdata,&iii,&zzz,nx2,message);
-			if(aa<=0.0) return(NULL);
-		}
-
-		/* set index j to the beginning of current row */
-		j=y1*nx2;
-		/* copy tempdata to a corresponding row in matrix2 */
-		for(x2=0;x2<nx2;x2++) matrix2[j+x2]=tempdata[x2];
-
-	}
-
-	/* RESAMPLE EACH COLUMN - use the new range of columns */
-	for(x2=0;x2<nx2;x2++) {
-
-		/* copy column to tempdata */
-		for(y1=0;y1<ny1;y1++) tempdata[y1]=matrix2[y1*nx2+x2];
-
-		/* resample temporary column */
-		if(ny1<=ny2) {
-			tempdata= xf_expand1_d(tempdata,ny1,ny2,message);
-			if(tempdata==NULL) return(NULL);
-		}
-		else {
-			zzz=0;
-			jjj=(size_t)ny1;
-			aa= xf_bin1a_d(tempdata,&jjj,&zzz,ny2,message);
-			if(aa<=0.0) return(NULL);
-		}
-
-		/* copy temporary column back into a column in matrix2 */
-		for(y2=0;y2<ny2;y2++) matrix2[y2*nx2+x2]=tempdata[y2];
-	}
-
-	free(tempdata);
+	/* box resampling: bin-average or split, one dimension at a time */
+	if(xf_matrixresample2_d(matrix1,1,nx1,ny1,matrix2,nx2,ny2,0,message)!=0) { free(matrix2); return(NULL); }
+
 	return(matrix2);
 }
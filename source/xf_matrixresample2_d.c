@@ -0,0 +1,228 @@
+/*
+<TAGS>dt.matrix filter</TAGS>
+
+DESCRIPTION:
+	Resample one or more matrices to a new number of columns and rows
+	- separable: rows are resampled first, then columns
+	- for each dimension a table of weights is computed once, then applied to every row (or column)
+	  of every matrix, so the cost per value is just the number of weights
+	- the column pass combines whole rows, so it reads memory in order rather than down columns
+	- NAN-aware: non-finite inputs are skipped and the remaining weights renormalised
+		- an output is NAN only if none of its inputs are valid
+		- Lanczos weights can be negative, so where inputs are missing only the valid inputs with
+		  positive weights are used (or the negative-lobe inputs, by absolute weight, if there are
+		  none) - this keeps outputs within the range of the inputs next to gaps
+	- if compiled with OpenMP, rows are processed in parallel
+
+	Methods:
+		0= box:  downsampling averages the inputs falling in each output bin, upsampling
+		         repeats the nearest input to the left - identical to xf_matrixbin1_d and
+		         xf_matrixexpand1_d
+		1= linear: triangle filter (linear interpolation when upsampling), widened when
+		         downsampling so all inputs contribute
+		2= Lanczos: windowed sinc (a=3), widened when downsampling - sharper than linear,
+		         but may overshoot near steps
+
+USES:
+	- resampling an image or matrix to reduce or increase resolution
+	- bringing different matrices (e.g. place-field maps) to a common size
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *matrix1 : input, nmatrices matrices of nx1*ny1 values, packed together - not modified
+	long nmatrices  : input, number of matrices
+	long nx1        : input, width of the input matrices
+	long ny1        : input, height of the input matrices
+	double *matrix2 : output, pre-allocated array for nmatrices matrices of nx2*ny2 values
+	long nx2        : input, width of the output matrices
+	long ny2        : input, height of the output matrices
+	int method      : input, resampling method (see above)
+	char *message   : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	0 on success, -1 on error
+
+SAMPLE CALL:
+	matrix2= malloc(nmatrices*nx2*ny2*sizeof(*matrix2));
+	z= xf_matrixresample2_d(matrix1,nmatrices,nx1,ny1,matrix2,nx2,ny2,2,message);
+	if(z!=0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#define LANCZOS_A 3.0
+
+/* the filter kernels, for a distance x in units of input samples (scaled when downsampling) */
+static double xf_matrixresample2_d_kernel(double x, int method) {
+	double aa;
+	x= fabs(x);
+	if(method==1) return((x<1.0) ? (1.0-x) : 0.0);
+	if(x<1e-12) return(1.0);
+	if(x>=LANCZOS_A) return(0.0);
+	aa= M_PI*x;
+	return(LANCZOS_A*sin(aa)*sin(aa/LANCZOS_A)/(aa*aa));
+}
+
+/* Lanczos output with missing inputs: renormalise over the valid positive weights only */
+/* - a plain sum/wsum is unbounded when the remaining weights include negative lobes */
+static double xf_matrixresample2_d_partial(double *pin, long stride, double *pw, long ntaps) {
+	long jj;
+	double aa,ww,psum=0.0,pwsum=0.0,nsum=0.0,nwsum=0.0;
+	for(jj=0;jj<ntaps;jj++) {
+		aa= pin[jj*stride];
+		if(!isfinite(aa)) continue;
+		ww= pw[jj];
+		if(ww>0.0) { psum+= ww*aa; pwsum+= ww; }
+		else if(ww<0.0) { nsum-= ww*aa; nwsum-= ww; }
+	}
+	if(pwsum>0.0) return(psum/pwsum);
+	if(nwsum>0.0) return(nsum/nwsum);
+	return(NAN);
+}
+
+/* build the weight table for one dimension: output ii uses inputs first[ii] to first[ii]+ntaps[ii]-1 */
+/* returns the maximum number of taps, or -1 on memory error */
+static long xf_matrixresample2_d_table(long n1, long n2, int method, long **first, long **ntaps, double **weight) {
+
+	long ii,jj,kk,maxtaps,lo,hi;
+	double scale,fscale,support,centre,limit;
+
+	*first= malloc(n2*sizeof(**first));
+	*ntaps= malloc(n2*sizeof(**ntaps));
+	if(*first==NULL || *ntaps==NULL) return(-1);
+	scale= (double)n1/(double)n2;
+
+	/* BOX: REPLAY THE BINNING (xf_matrixbin1_d) OR EXPANSION (xf_matrixexpand1_d) */
+	if(method==0) {
+		if(n2>=n1) {
+			*weight= malloc(n2*sizeof(**weight));
+			if(*weight==NULL) return(-1);
+			for(ii=0;ii<n2;ii++) { (*first)[ii]= (long)((double)ii*scale); (*ntaps)[ii]= 1; (*weight)[ii]= 1.0; }
+			return(1);
+		}
+		maxtaps= (long)scale+2;
+		*weight= malloc(n2*maxtaps*sizeof(**weight));
+		if(*weight==NULL) return(-1);
+		for(ii=0;ii<n2;ii++) { (*first)[ii]= 0; (*ntaps)[ii]= 0; }
+		limit= scale;
+		for(jj=kk=0;jj<n1;jj++) {
+			if(jj>=limit) { limit+= scale; if(kk<(n2-1)) kk++; }
+			if((*ntaps)[kk]==0) (*first)[kk]= jj;
+			if((*ntaps)[kk]<maxtaps) (*weight)[kk*maxtaps+(*ntaps)[kk]++]= 1.0;
+		}
+		return(maxtaps);
+	}
+
+	/* LINEAR OR LANCZOS: KERNEL CENTRED ON EACH OUTPUT, WIDENED BY THE SCALE IF DOWNSAMPLING */
+	fscale= (scale>1.0) ? scale : 1.0;
+	support= ((method==1) ? 1.0 : LANCZOS_A) * fscale;
+	maxtaps= (long)ceil(2.0*support)+2;
+	*weight= malloc(n2*maxtaps*sizeof(**weight));
+	if(*weight==NULL) return(-1);
+	for(ii=0;ii<n2;ii++) {
+		centre= ((double)ii+0.5)*scale;
+		lo= (long)floor(centre-support); if(lo<0) lo=0;
+		hi= (long)ceil(centre+support); if(hi>n1) hi=n1;
+		if((hi-lo)>maxtaps) hi= lo+maxtaps;
+		(*first)[ii]= lo;
+		(*ntaps)[ii]= hi-lo;
+		for(jj=lo;jj<hi;jj++) (*weight)[ii*maxtaps+(jj-lo)]= xf_matrixresample2_d_kernel((((double)jj+0.5)-centre)/fscale,method);
+	}
+	return(maxtaps);
+}
+
+int xf_matrixresample2_d(double *matrix1, long nmatrices, long nx1, long ny1, double *matrix2, long nx2, long ny2, int method, char *message) {
+
+	char *thisfunc="xf_matrixresample2_d\0";
+	int error=0;
+	long ii,nrows1,nrows2,xmaxtaps=0,ymaxtaps=0;
+	long *xfirst=NULL,*xntaps=NULL,*yfirst=NULL,*yntaps=NULL;
+	double *xweight=NULL,*yweight=NULL,*temp=NULL;
+
+	if(nx1<1||ny1<1||nx2<1||ny2<1||nmatrices<1) { sprintf(message,"%s [ERROR]: invalid matrix size (%ld x %ld to %ld x %ld)",thisfunc,nx1,ny1,nx2,ny2); return(-1); }
+	if(method<0||method>2) { sprintf(message,"%s [ERROR]: invalid method (%d) must be 0-2",thisfunc,method); return(-1); }
+	nrows1= nmatrices*ny1;
+	nrows2= nmatrices*ny2;
+
+	/* BUILD THE WEIGHT TABLES AND ALLOCATE THE INTERMEDIATE (ROW-RESAMPLED) MATRICES */
+	if(nx2!=nx1) xmaxtaps= xf_matrixresample2_d_table(nx1,nx2,method,&xfirst,&xntaps,&xweight);
+	if(ny2!=ny1) ymaxtaps= xf_matrixresample2_d_table(ny1,ny2,method,&yfirst,&yntaps,&yweight);
+	if(ny2!=ny1) temp= malloc(nrows1*nx2*sizeof(*temp));
+	else temp= matrix2;
+	if(xmaxtaps<0 || ymaxtaps<0 || temp==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); error=1; goto END; }
+
+	/* PASS 1: RESAMPLE EACH ROW OF EACH MATRIX */
+	if(nx2==nx1) memcpy(temp,matrix1,nrows1*nx1*sizeof(*temp));
+	else {
+		#pragma omp parallel for schedule(static)
+		for(ii=0;ii<nrows1;ii++) {
+			long x2,jj,nbad;
+			double aa,sum,wsum,*pin=matrix1+ii*nx1,*pout=temp+ii*nx2,*pw;
+			for(x2=0;x2<nx2;x2++) {
+				pw= xweight+x2*xmaxtaps;
+				sum= wsum= 0.0;
+				nbad= 0;
+				for(jj=0;jj<xntaps[x2];jj++) {
+					aa= pin[xfirst[x2]+jj];
+					if(isfinite(aa)) { sum+= pw[jj]*aa; wsum+= pw[jj]; }
+					else nbad++;
+				}
+				if(nbad>0 && method==2) pout[x2]= xf_matrixresample2_d_partial(pin+xfirst[x2],1,pw,xntaps[x2]);
+				else pout[x2]= (wsum!=0.0) ? sum/wsum : NAN;
+			}
+		}
+	}
+
+	/* PASS 2: RESAMPLE EACH COLUMN - EACH OUTPUT ROW IS A WEIGHTED COMBINATION OF WHOLE INPUT ROWS */
+	if(ny2!=ny1) {
+		#pragma omp parallel reduction(|:error)
+		{
+			long y2,mm,jj,x2;
+			double aa,ww,*pin,*pout,*pw,*wsum=NULL;
+			long *nbad=NULL;
+			wsum= malloc(nx2*sizeof(*wsum));
+			nbad= malloc(nx2*sizeof(*nbad));
+			if(wsum==NULL || nbad==NULL) error=1;
+			#pragma omp for schedule(static)
+			for(ii=0;ii<nrows2;ii++) {
+				if(wsum==NULL || nbad==NULL) continue;
+				mm= ii/ny2;
+				y2= ii-mm*ny2;
+				pout= matrix2+ii*nx2;
+				pw= yweight+y2*ymaxtaps;
+				for(x2=0;x2<nx2;x2++) { pout[x2]= 0.0; wsum[x2]= 0.0; nbad[x2]= 0; }
+				for(jj=0;jj<yntaps[y2];jj++) {
+					pin= temp+(mm*ny1+yfirst[y2]+jj)*nx2;
+					ww= pw[jj];
+					for(x2=0;x2<nx2;x2++) {
+						aa= pin[x2];
+						if(isfinite(aa)) { pout[x2]+= ww*aa; wsum[x2]+= ww; }
+						else nbad[x2]++;
+					}
+				}
+				pin= temp+(mm*ny1+yfirst[y2])*nx2;
+				for(x2=0;x2<nx2;x2++) {
+					if(nbad[x2]>0 && method==2) pout[x2]= xf_matrixresample2_d_partial(pin+x2,nx2,pw,yntaps[y2]);
+					else pout[x2]= (wsum[x2]!=0.0) ? pout[x2]/wsum[x2] : NAN;
+				}
+			}
+			if(wsum!=NULL) free(wsum);
+			if(nbad!=NULL) free(nbad);
+		}
+		if(error) sprintf(message,"%s [ERROR]: insufficient memory",thisfunc);
+	}
+
+END:
+	if(xfirst!=NULL) free(xfirst);
+	if(xntaps!=NULL) free(xntaps);
+	if(xweight!=NULL) free(xweight);
+	if(yfirst!=NULL) free(yfirst);
+	if(yntaps!=NULL) free(yntaps);
+	if(yweight!=NULL) free(yweight);
+	if(temp!=NULL && temp!=matrix2) free(temp);
+	return(error ? -1 : 0);
+}
@@ -3,13 +3,15 @@
 
 DESCRIPTION:
 	Rotate a 1-dimensional array of numbers  meant to be interpreted as a 2-dimensional matrix
+	- uses the cache-blocked (tiled) kernel xf_matrixorient1_d
 
 USES:
 	- image or map rotation
 	- matrix algebra
 
 DEPENDENCY TREE:
-	No dependencies
+	xf_matrixrotate1_d
+		xf_matrixorient1_d
 
 ARGUMENTS:
 	float *data1 (input)- pointer to array of numbers representing the original matrix
@@ -55,33 +57,36 @@ TEST PROGRAM :
 #include <stdio.h>
 #include <stdlib.h>
 
+/* external functions start */
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
+/* external functions end */
+
 double *xf_matrixrotate1_d(double *data1, long *width, long *height, int r) {
 
-	long x1,y1,xmax1,ymax1,index1;
-	long x2,y2,nx1=*width,ny1=*height,nx2,ny2,index2;
-	long i,j,k;
+	int op;
+	long nx1=*width,ny1=*height,nx2,ny2;
 	double *data2=NULL;
 
 	/* MAKE SURE ARRAY CONTAINS ELEMENTS */
-	if(nx1<1||nx1<1) return(data1);
+	if(nx1<1||ny1<1) return(data1);
 
-	/* DETERMINE THE HEIGHT (ny2) AND WIDTH (nx2) OF THE ROTATED MATRIX */
-	if(r==90 || r==270 || r==-90 || r==-270) { nx2=ny1; ny2=nx1; }
-	else if(r==180||r==-180) { nx2=nx1; ny2=ny1; }
+	/* CONVERT THE ROTATION TO AN OPERATION FOR xf_matrixorient */
+	if(r==90||r==-270) op=2;
+	else if(r==180||r==-180) op=3;
+	else if(r==-90||r==270) op=4;
 	/* IF ROTATION IS NOT A MULTIPLE OF 90, CHANGE NOTHING */
 	else return(data1);
 
+	/* DETERMINE THE HEIGHT (ny2) AND WIDTH (nx2) OF THE ROTATED MATRIX */
+	if(op==3) { nx2=nx1; ny2=ny1; }
+	else { nx2=ny1; ny2=nx1; }
+
 	/* ALLOCATE MEMORY FOR THE NEW ROTATED MATRIX */
-	data2=(double *)realloc(data2,nx2*ny2*sizeof(double));
+	data2= malloc(nx2*ny2*sizeof(*data2));
 	if(data2==NULL) return(NULL);
 
-	/* CALCULATE HIGHEST VALUE OF ROW & COLUMN - FOR SPEED IN THE NEXT STEP */
-	xmax1=nx1-1; ymax1=ny1-1;
-
 	/* TRANSFER VALUES FROM ORIGINAL MATRIX TO NEW ROTATED MATRIX */
-	if(r==90||r==-270)  for(y1=0;y1<ny1;y1++) { j=y1*nx1; k=ymax1-y1; for(x1=0;x1<nx1;x1++) { data2[x1*nx2+k]= data1[j+x1]; } }
-	if(r==180||r==-180) for(y1=0;y1<ny1;y1++) { j=y1*nx1; k=ymax1-y1; for(x1=0;x1<nx1;x1++) { data2[k*nx2+(xmax1-x1)]= data1[j+x1]; } }
-	if(r==-90||r==270)  for(y1=0;y1<ny1;y1++) { j=y1*nx1;             for(x1=0;x1<nx1;x1++) { data2[(xmax1-x1)*nx2+y1]= data1[j+x1]; } }
+	xf_matrixorient1_d(data1,data2,nx1,ny1,op);
 
 	/* FREE ORIGINAL MEMORY */
 	free(data1);
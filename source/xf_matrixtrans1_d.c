@@ -4,6 +4,7 @@ DESCRIPTION:
 	Transpose a 1-dimensional array of numbers meant to be interpreted as a 2-dimensional matrix
 	Note that this differs from rotation, because low columns become low rows ( & vice versa)
 	This version deals with double-precision floating-point numbers
+	Uses the cache-blocked (tiled) kernel xf_matrixorient1_d
 
 	Example: this matrix...
 
@@ -24,7 +25,8 @@ USES:
 	- matrix algebra
 
 DEPENDENCY TREE:
-	No dependencies
+	xf_matrixtrans1_d
+		xf_matrixorient1_d
 
 ARGUMENTS:
 
@@ -53,10 +55,13 @@ SAMPLE CALL :
 #include <stdio.h>
 #include <stdlib.h>
 
-double *xf_matrixtrans1_d(double *data1, long *width, long *height) {
+/* external functions start */
+int xf_matrixorient1_d(double *data1, double *data2, long nx, long ny, int op);
+/* external functions end */
 
+double *xf_matrixtrans1_d(double *data1, long *width, long *height) {
 
-	long h,i,j,k,nx,ny;
+	long nx,ny;
 	double *data2=NULL;
 
 	nx = (*width);
@@ -65,19 +70,12 @@ double *xf_matrixtrans1_d(double *data1, long *width, long *height) {
 	/* MAKE SURE ARRAY CONTAINS ELEMENTS */
 	if(ny<1||nx<1) return(data1);
 
-	/* ALLOCATE MEMORY FOR THE NEW ROTATED MATRIX */
-	data2=(double *)realloc(data2,nx*ny*sizeof(double));
+	/* ALLOCATE MEMORY FOR THE NEW TRANSPOSED MATRIX */
+	data2= malloc(nx*ny*sizeof(*data2));
 	if(data2==NULL) return(NULL);
 
 	/* TRANSFER VALUES FROM ORIGINAL MATRIX TO NEW TRANSPOSED */
-	for(i=0;i<nx;i++) {
-		k=i*ny;
-		h=i;
-		for(j=0;j<ny;j++) {
-			data2[k+j] = data1[h];
-			h+=nx;
-		}
-	}
+	xf_matrixorient1_d(data1,data2,nx,ny,1);
 
 	/* FREE ORIGINAL MEMORY */
 	free(data1);
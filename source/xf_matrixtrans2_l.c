@@ -3,8 +3,8 @@
 
 DESCRIPTION:
 	Transpose a 1-dimensional array meant to be interpreted as a 2-dimensional matrix
-	- makes an internal copy of data, modifies it, and copies it back to the original
-	- therefore, safer for memory management and nested functions, but has a heavier computational load
+	- modifies the original data in place, using xf_matrixorient2_l
+	- cache-blocked (tiled), and no copy of the data is needed for square matrices or flips
 
 	- Example
 		1 2 3                1 4 7
@@ -16,7 +16,9 @@ DESCRIPTION:
 	- matrix algebra
 
 DEPENDENCIES:
-	None
+	xf_matrixtrans2_l
+		xf_matrixorient2_l
+			xf_matrixorient1_l
 
 ARGUMENTS:
 	long *data1   : input/output - pointer to array of numbers representing the original matrix
@@ -34,36 +36,19 @@ RETURN VALUE:
 #include <stdio.h>
 #include <stdlib.h>
 
+/* external functions start */
+int xf_matrixorient2_l(long *data, long nmatrices, long *width, long *height, int op);
+/* external functions end */
+
 int xf_matrixtrans2_l(long *data1, long *width, long *height) {
 
-	long x1,y1,index1;
-	long ii,jj,kk,mm,nn,nx1=*width,ny1=*height;
-	long *data2=NULL;
+	int z;
 
 	/* MAKE SURE ARRAY CONTAINS ELEMENTS */
-	if(nx1<1||ny1<1) return(-1);
-
-	/* ALLOCATE MEMORY FOR THE NEW TRANSPOSED MATRIX */
-	nn= nx1*ny1;
-	data2= realloc(data2,nn*sizeof(*data2));
-	if(data2==NULL) return(-2);
-
-	/* TRANSFER VALUES FROM ORIGINAL MATRIX TO NEW TRANSPOSED MATIX */
-	for(ii=0;ii<nx1;ii++) {
-		kk= ii*ny1;
-		mm= ii;
-		for(jj=0;jj<ny1;jj++) {
-			data2[kk+jj] = data1[mm];
-			mm+= nx1;
-	}}
-
-	/* COPY BACK TO ORIGINAL */
-	for(ii=0;ii<nn;ii++) data1[ii]= data2[ii];
-
-	/* UPDATE VARIABLES FOR WIDTH & HEIGHT OF MATRIX */
-	*width=ny1; *height=nx1;
+	if(*width<1||*height<1) return(-1);
 
-	/* CLEANUP AND RETURN */
-	free(data2);
-	return(0);
+	/* TRANSPOSE IN PLACE - THIS ALSO SWAPS THE WIDTH AND HEIGHT */
+	z= xf_matrixorient2_l(data1,1,width,height,1);
+	if(z==-3) return(-2);
+	return(z);
 }
@@ -0,0 +1,104 @@
+/*
+<TAGS>file dt.matrix</TAGS>
+
+DESCRIPTION:
+	Write one or more matrices of equal size to a binary multi-matrix file (BINXMM format)
+	The format is designed for large multi-matrix data (e.g. time-frequency matrices for many subjects)
+		- no parsing is required to read the data
+		- any matrix can be read directly using the offset table (xf_matrixreadbin1_d)
+		- matrices can also be read one at a time from a stream (xf_matrixreadbin2_d)
+		- the xf_matrixread1_d, xf_matrixread2_d and xf_matrixread3_d functions detect this format
+		  automatically, so any program reading ASCII multi-matrix input can also read it
+
+	BINXMM format:
+		1. 500-byte header, as for BINX files (see xf_writebinx1)
+			a. 32-byte filetype, starting with byte 0x89 (never the start of an ASCII file)
+			b. 6 size_t parameters: header-size, bytes per datum (8), data-type (9=double), ncols, nrows, nmatrices
+			c. ASCII description of the file structure
+		2. offset table: for each matrix, the byte-offset of its record (long) and its id (double, NAN if none)
+		3. one record per matrix:
+			a. 32-byte record header: tag (0x89 + "MATRIX1"), id (double), ncols (long), nrows (long)
+			b. ncols*nrows doubles, row by row
+
+USES:
+	Saving multi-matrix output for fast re-reading and random access
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	FILE *fpout       : input, output stream (file or stdout) - need not be seekable
+	double *matrix    : input, nmatrices matrices of ncols x nrows values, packed together
+	long nmatrices    : input, number of matrices
+	long ncols        : input, columns in each matrix
+	long nrows        : input, rows in each matrix
+	double *id        : input, array of nmatrices identifiers - NULL if there are none
+	char *message     : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	number of matrices written, or -1 on error
+
+SAMPLE CALL:
+	nmatrices= xf_matrixread2_d(infile,1,&matrix1,&id1,&ncols,&nrows,message);
+	if(xf_matrixwritebin1_d(stdout,matrix1,nmatrices,ncols,nrows,id1,message)<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#define BINXMM_HEADERSIZE 500
+#define BINXMM_RECORDSIZE 32
+
+long xf_matrixwritebin1_d(FILE *fpout, double *matrix, long nmatrices, long ncols, long nrows, double *id, char *message) {
+
+	char *thisfunc="xf_matrixwritebin1_d\0";
+	char header[BINXMM_HEADERSIZE],tag[8];
+	size_t ii,nparams=6,hsize1=32,params[6],matrixsize;
+	long kk,offset,dims[2];
+	double aa;
+
+	if(nmatrices<1) { sprintf(message,"%s [ERROR]: no matrices to write",thisfunc); return(-1); }
+	if(ncols<1 || nrows<1) { sprintf(message,"%s [ERROR]: invalid matrix size (%ld columns x %ld rows)",thisfunc,ncols,nrows); return(-1); }
+	matrixsize= (size_t)ncols*(size_t)nrows;
+
+	/* BUILD THE HEADER: FILETYPE, PARAMETERS, DESCRIPTION */
+	memset(header,0,BINXMM_HEADERSIZE);
+	memcpy(header,"\x89" "BINXMM1________________________",hsize1);
+	params[0]= BINXMM_HEADERSIZE;
+	params[1]= sizeof(double);
+	params[2]= 9;
+	params[3]= ncols;
+	params[4]= nrows;
+	params[5]= nmatrices;
+	memcpy((header+hsize1),params,nparams*sizeof(size_t));
+	ii= hsize1+nparams*sizeof(size_t);
+	snprintf((header+ii),(BINXMM_HEADERSIZE-ii),
+		"\nBINXMM multi-matrix file\n"
+		"params: headersize, datasize, datatype(9=double), ncols, nrows, nmatrices\n"
+		"then offset table: nmatrices x (long offset, double id)\n"
+		"then records: 32-byte header (tag, double id, long ncols, long nrows) + ncols*nrows doubles\n");
+
+	if(fwrite(header,1,BINXMM_HEADERSIZE,fpout)!=BINXMM_HEADERSIZE) { sprintf(message,"%s [ERROR]: problem writing header",thisfunc); return(-1); }
+
+	/* WRITE THE OFFSET TABLE - RECORDS FOLLOW THE TABLE, AND ARE ALL THE SAME SIZE */
+	for(kk=0;kk<nmatrices;kk++) {
+		offset= BINXMM_HEADERSIZE + nmatrices*(sizeof(long)+sizeof(double)) + kk*(BINXMM_RECORDSIZE+matrixsize*sizeof(double));
+		aa= (id==NULL) ? NAN : id[kk];
+		if(fwrite(&offset,sizeof(long),1,fpout)!=1 || fwrite(&aa,sizeof(double),1,fpout)!=1) { sprintf(message,"%s [ERROR]: problem writing offset table",thisfunc); return(-1); }
+	}
+
+	/* WRITE THE RECORDS */
+	memcpy(tag,"\x89" "MATRIX1",8);
+	dims[0]= ncols;
+	dims[1]= nrows;
+	for(kk=0;kk<nmatrices;kk++) {
+		aa= (id==NULL) ? NAN : id[kk];
+		if(fwrite(tag,1,8,fpout)!=8 || fwrite(&aa,sizeof(double),1,fpout)!=1 || fwrite(dims,sizeof(long),2,fpout)!=2) {
+			sprintf(message,"%s [ERROR]: problem writing record header for matrix %ld",thisfunc,kk); return(-1); }
+		if(fwrite((matrix+kk*matrixsize),sizeof(double),matrixsize,fpout)!=matrixsize) {
+			sprintf(message,"%s [ERROR]: problem writing data for matrix %ld",thisfunc,kk); return(-1); }
+	}
+
+	return(nmatrices);
+}
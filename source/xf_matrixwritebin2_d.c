@@ -0,0 +1,64 @@
+/*
+<TAGS>file dt.matrix</TAGS>
+
+DESCRIPTION:
+	Write a single matrix record to a binary multi-matrix stream (BINXMM format)
+	- see xf_matrixwritebin1_d for a description of the format
+	- writes only the record (record header + data), not the file header or offset table
+	- call once per matrix to write a header-less record stream
+		- matrices need not be the same size
+		- no matrices need to be held in memory, so this suits programs which process one matrix at a time
+	- header-less record streams can be read by xf_matrixreadbin2_d, xf_matrixread1_d and xf_matrixread2_d,
+	  and converted to a file with an offset table by xe-matrixbin1
+
+USES:
+	Binary output from programs which read or produce matrices one at a time
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	FILE *fpout       : input, output stream (file or stdout) - need not be seekable
+	double *matrix    : input, a matrix of ncols x nrows values
+	long ncols        : input, columns in the matrix
+	long nrows        : input, rows in the matrix
+	double id         : input, identifier for the matrix (NAN if none)
+	char *message     : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	0 on success, -1 on error
+
+SAMPLE CALL:
+	while((matrix=xf_matrixread3_d(fpin,&ncols,&nrows,header,message))!=NULL) {
+		... process the matrix
+		if(xf_matrixwritebin2_d(stdout,matrix,ncols,nrows,NAN,message)<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+		free(matrix);
+	}
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+long xf_matrixwritebin2_d(FILE *fpout, double *matrix, long ncols, long nrows, double id, char *message) {
+
+	char *thisfunc="xf_matrixwritebin2_d\0";
+	size_t matrixsize;
+	long dims[2];
+
+	if(ncols<1 || nrows<1) { sprintf(message,"%s [ERROR]: invalid matrix size (%ld columns x %ld rows)",thisfunc,ncols,nrows); return(-1); }
+	matrixsize= (size_t)ncols*(size_t)nrows;
+
+	/* WRITE THE RECORD HEADER: TAG, ID, NCOLS, NROWS */
+	dims[0]= ncols;
+	dims[1]= nrows;
+	if(fwrite("\x89" "MATRIX1",1,8,fpout)!=8 || fwrite(&id,sizeof(double),1,fpout)!=1 || fwrite(dims,sizeof(long),2,fpout)!=2) {
+		sprintf(message,"%s [ERROR]: problem writing record header",thisfunc); return(-1); }
+
+	/* WRITE THE DATA */
+	if(fwrite(matrix,sizeof(double),matrixsize,fpout)!=matrixsize) {
+		sprintf(message,"%s [ERROR]: problem writing data",thisfunc); return(-1); }
+
+	return(0);
+}
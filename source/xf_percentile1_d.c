@@ -6,6 +6,10 @@ AUTHORS
 	updated 4 September 2012: remove reference to FUNC_NAME
 	updated 6 October 2012 - eliminate use of "message" string to store error messages
 	updated 22 October 2017 - now will ignore non-finite numbers (INF or NAN)
+	updated 18 October 2026 - use selection (xf_select1_d) instead of sorting the whole array
+		- average time is O(N) instead of O(N*log(N))
+		- results are identical to those from the sorted array
+		- if there are no finite numbers, results are NAN
 
 DESCRIPTION:
 	Calculate percentile cutoffs for a distribution of double values
@@ -14,7 +18,7 @@ USES:
 	Getting the median, finding outliers in a distribution
 
 DEPENDENCIES:
-	xf_compare1_d
+	double xf_select1_d(double *data, long nn, long kk);
 
 ARGUMENTS:
 	double *data  : array holding the input data
@@ -44,13 +48,24 @@ SAMPLE CALL:
 #include <stdio.h>
 #include <math.h>
 
-/* external compare function required by qsort - in this instance, comparing type double */
-int xf_compare1_d(const void *a, const void *b);
+/* external functions start */
+double xf_select1_d(double *data, long nn, long kk);
+/* external functions end */
+
+/* find several ranks: select the middle rank, then the ranks below it in the lower part of the array and the ranks above it in the upper part */
+static void xf_percentile1_d_multiselect(double *temp, long lower, long upper, long *rank, double *value, long nrank) {
+	long mid;
+	if(nrank<1) return;
+	mid= nrank/2;
+	value[mid]= xf_select1_d((temp+lower),(upper-lower),(rank[mid]-lower));
+	xf_percentile1_d_multiselect(temp,lower,rank[mid],rank,value,mid);
+	xf_percentile1_d_multiselect(temp,rank[mid],upper,(rank+mid+1),(value+mid+1),(nrank-mid-1));
+}
 
 int xf_percentile1_d(double *data, long nn, double *result) {
 
-	long int ii,jj,kk,n2;
-	double aa,bb,cc, *temp=NULL;
+	long int ii,jj,kk,n2,nrank,rank[22];
+	double aa,bb,cc, *temp=NULL,value[22];
 	double perclist[11]={.01,.025,.05,.1,.25,.5,.75,.90,.95,.975,.99};
 
 	/* initialize results */
@@ -61,15 +76,31 @@ int xf_percentile1_d(double *data, long nn, double *result) {
 	if(temp==NULL) return(-1);
 	for(ii=n2=0;ii<nn;ii++) if(isfinite(data[ii])) temp[n2++]= data[ii];
 
-	/* sort the temporary array */
-	qsort(temp,n2,sizeof(double),xf_compare1_d);
+	if(n2<1) { for(ii=0;ii<11;ii++) result[ii]=NAN; free(temp); return(0); }
+
+	/* list the ranks required - the percentile position, and the item before if the percentile falls exactly on an item */
+	for(ii=nrank=0;ii<11;ii++) {
+		aa= n2*perclist[ii];
+		jj= (long)aa;
+		if(aa==(double)jj && jj>0) rank[nrank++]= jj-1;
+		rank[nrank++]= jj;
+	}
+	/* sort the ranks (insertion sort - the list is short and almost sorted) */
+	for(ii=1;ii<nrank;ii++) { kk=rank[ii]; for(jj=ii-1;jj>=0&&rank[jj]>kk;jj--) rank[jj+1]=rank[jj]; rank[jj+1]=kk; }
+	/* remove duplicate ranks */
+	for(ii=jj=1;ii<nrank;ii++) if(rank[ii]!=rank[jj-1]) rank[jj++]=rank[ii];
+	if(nrank>0) nrank=jj;
+
+	/* select the ranks - each selection only searches the part of the array between ranks already found */
+	xf_percentile1_d_multiselect(temp,0,n2,rank,value,nrank);
 
 	/* build the percentile list */
 	for(ii=0;ii<11;ii++) {
 		aa= n2*perclist[ii];  /* find the position in the array corresponding to the current percentile */
 		jj= (long)aa;	      /* convert this to an integer element-number */
-		if(aa!=(double)jj) result[ii]= temp[jj]; /* if the percentile limit does not fall exactly on an item, cutoff is unchanged */
-		else result[ii]= (temp[jj]+temp[jj-1])/2.0; /* otherwise if the cutoff is exactly an item number, take the avergage of this point and the previous item */
+		for(kk=0;rank[kk]!=jj;kk++);
+		if(aa!=(double)jj || jj<1) result[ii]= value[kk]; /* if the percentile limit does not fall exactly on an item, cutoff is unchanged */
+		else result[ii]= (value[kk]+value[kk-1])/2.0; /* otherwise if the cutoff is exactly an item number, take the avergage of this point and the previous item */
 	}
 
 	free(temp);
@@ -3,12 +3,16 @@
 
 DESCRIPTION:
 	Calculate a percentile cutoff for an array of double-precision float values
+	18 October 2026:
+		- use selection (xf_select1_d) instead of sorting the whole array: average time is O(N)
+		- bugfix: percentiles of 0 or 100 no longer read outside the array
+		- bugfix: return NAN (with a message) if there are no finite numbers
 
 USES:
 	Getting the median, finding outliers in a distribution
 
 DEPENDENCIES:
-	xf_compare1_d
+	double xf_select1_d(double *data, long nn, long kk);
 
 ARGUMENTS:
 	double *data  : array holding the input data
@@ -17,25 +21,26 @@ ARGUMENTS:
 	char *message : pre-allocated array to hold error message
 
 RETURN VALUE:
-	0  if successful, -1 if fail
+	the percentile value if successful, NAN if fail
 
 SAMPLE CALL:
-	if ( xf_percentile1_d(data,n,result) >=0) median=result[5];
-	else { fprintf(stderr,"** Memory allocation error\n"); exit(1); }
+	median= xf_percentile2_d(data,n,50.0,message);
+	if(!isfinite(median)) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
 */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 
-/* external compare function required by qsort - in this instance, comparing type double */
-int xf_compare1_d(const void *a, const void *b);
+/* external functions start */
+double xf_select1_d(double *data, long nn, long kk);
+/* external functions end */
 
 double xf_percentile2_d(double *data, long nn, double setper, char *message) {
 
 	char *thisfunc="xf_percentile2_d\0";
 	long int ii,jj,kk,n2;
-	double aa,bb, *temp=NULL;
+	double aa,bb,cc, *temp=NULL;
 
 	/* check validity of arguments */
 	if(nn==0) { sprintf(message,"%s [ERROR]: invalid size of input (%ld)",thisfunc,nn); bb=NAN; goto END; }
@@ -43,16 +48,21 @@ double xf_percentile2_d(double *data, long nn, double setper, char *message) {
 
 	/* build a temporary array - omit non-finite numbers */
 	temp= malloc((nn+1)*sizeof(*temp));
-	if(temp==NULL) return(NAN);
+	if(temp==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); bb=NAN; goto END; }
 	for(ii=n2=0;ii<nn;ii++) if(isfinite(data[ii])) temp[n2++]= data[ii];
-
-	/* sort the temporary array */
-	qsort(temp,n2,sizeof(double),xf_compare1_d);
+	if(n2<1) { sprintf(message,"%s [ERROR]: no finite numbers in input",thisfunc); bb=NAN; goto END; }
 
 	aa= n2*(setper/100); /* find the position in the array corresponding to the percentile */
 	jj= (long)aa;  /* convert this to an integer element-number */
-	if(aa!=(double)jj) bb= temp[jj]; /* if the percentile limit does not fall exactly on an item, cutoff is unchanged */
-	else bb= (temp[jj]+temp[jj-1])/2.0; /* otherwise if the cutoff is exactly an item number, take the avergage of this point and the previous item */
+	if(jj>=n2) { jj=n2-1; aa=0.5; } /* 100th percentile is the maximum */
+	/* find the item at position jj - the items below it are left in the lower part of the array */
+	bb= xf_select1_d(temp,n2,jj);
+	/* if the percentile limit does not fall exactly on an item, cutoff is unchanged */
+	/* otherwise if the cutoff is exactly an item number, take the avergage of this point and the previous item (the largest below jj) */
+	if(aa==(double)jj && jj>0) {
+		for(ii=1,cc=temp[0];ii<jj;ii++) if(temp[ii]>cc) cc=temp[ii];
+		bb= (bb+cc)/2.0;
+	}
 
 END:
 	if(temp!=NULL) free(temp);
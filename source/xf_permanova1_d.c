@@ -0,0 +1,150 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Permutation test for differences between any number of groups (one-way ANOVA)
+	- the k-group counterpart of the independent-groups test in xf_permboot1_d
+	- statistic: the F-ratio, between-group mean-square / within-group mean-square
+	- permutation: group-labels are randomly re-assigned, keeping the original group sizes
+		- p = (1 + number of resamples with F >= observed F) / (1 + nperm)
+	- random numbers come from the counter-based generator xf_rand2_d, with one stream per resample
+		- the result depends only on the data and the seed, not the number of threads
+	- if compiled with OpenMP (-fopenmp), resamples are calculated in parallel
+	- non-finite values are ignored, as are values with a group-number outside the range 0 to (ngrps-1)
+
+USES:
+	Non-parametric alternative to a one-way ANOVA, e.g. comparing more than two treatment groups
+
+DEPENDENCY TREE:
+	double xf_rand2_d(unsigned long seed, unsigned long stream, unsigned long counter);
+
+ARGUMENTS:
+	double *data         : input, array of nn values
+	long *group          : input, array of nn group-numbers (0 to ngrps-1) for each value
+	long nn              : input, number of elements in data and group
+	long ngrps           : input, number of groups
+	long nperm           : input, number of permutations (0 to skip)
+	unsigned long seed   : input, random seed - the same seed gives the same result
+	double *result_d     : output, pre-allocated array of at least 8 values
+		[0] the observed F-ratio
+		[1] the effect-size: eta-squared (between-group sum-of-squares / total sum-of-squares)
+		[2] number of valid values
+		[3] number of groups containing valid values
+		[4] permutation p-value (NAN if nperm=0)
+		[5] degrees of freedom, between groups
+		[6] degrees of freedom, within groups
+		[7] the between-group sum-of-squares
+	char *message        : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	0 on success, -1 on error
+
+SAMPLE CALL:
+	if(xf_permanova1_d(data,group,nn,ngrps,10000,seed,result_d,message)<0) {
+		fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1);
+	}
+	printf("F(%g,%g)= %g\tp= %g\n",result_d[5],result_d[6],result_d[0],result_d[4]);
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* external functions start */
+double xf_rand2_d(unsigned long seed, unsigned long stream, unsigned long counter);
+/* external functions end */
+
+/* between-group sum-of-squares for values zz with group-numbers gg - sum must hold ngrps values */
+static double xf_permanova1_d_ssb(double *zz, long *gg, long nn, long *count, long ngrps, double grand, double *sum) {
+	long ii;
+	double aa,ssb=0.0;
+	for(ii=0;ii<ngrps;ii++) sum[ii]= 0.0;
+	for(ii=0;ii<nn;ii++) sum[gg[ii]]+= zz[ii];
+	for(ii=0;ii<ngrps;ii++) if(count[ii]>0) { aa= sum[ii]/(double)count[ii]-grand; ssb+= (double)count[ii]*aa*aa; }
+	return(ssb);
+}
+
+int xf_permanova1_d(double *data, long *group, long nn, long ngrps, long nperm, unsigned long seed, double *result_d, char *message) {
+
+	char *thisfunc="xf_permanova1_d\0";
+	int memerr=0,status=0;
+	long ii,kk,nz,rr,nused,*gg=NULL,*count=NULL;
+	double aa,grand,sst,ssb,df1,df2,stat,*zz=NULL,*sum=NULL,*statperm=NULL;
+
+	for(ii=0;ii<8;ii++) result_d[ii]= NAN;
+	if(ngrps<2) { sprintf(message,"%s [ERROR]: invalid number of groups (%ld) - must be >1",thisfunc,ngrps); return(-1); }
+	if(nperm<0) { sprintf(message,"%s [ERROR]: invalid number of resamples",thisfunc); return(-1); }
+
+	/* COPY THE VALID DATA AND GROUP-NUMBERS */
+	zz= malloc((nn+1)*sizeof(*zz));
+	gg= malloc((nn+1)*sizeof(*gg));
+	count= calloc(ngrps,sizeof(*count));
+	sum= malloc(ngrps*sizeof(*sum));
+	if(zz==NULL||gg==NULL||count==NULL||sum==NULL) { memerr=1; goto FINISH; }
+	for(ii=nz=0;ii<nn;ii++) {
+		if(!isfinite(data[ii]) || group[ii]<0 || group[ii]>=ngrps) continue;
+		zz[nz]= data[ii]; gg[nz]= group[ii]; count[group[ii]]++; nz++;
+	}
+	for(kk=nused=0;kk<ngrps;kk++) if(count[kk]>0) nused++;
+	result_d[2]= (double)nz;
+	result_d[3]= (double)nused;
+	if(nused<2 || nz<=nused) { sprintf(message,"%s [ERROR]: need at least 2 groups and more values (%ld) than groups (%ld)",thisfunc,nz,nused); status=-1; goto FINISH; }
+
+	/* THE OBSERVED STATISTIC - the total sum-of-squares is the same for every permutation */
+	for(ii=0,grand=0.0;ii<nz;ii++) grand+= zz[ii];
+	grand/= (double)nz;
+	for(ii=0,sst=0.0;ii<nz;ii++) { aa= zz[ii]-grand; sst+= aa*aa; }
+	df1= (double)(nused-1);
+	df2= (double)(nz-nused);
+	ssb= xf_permanova1_d_ssb(zz,gg,nz,count,ngrps,grand,sum);
+	stat= ((sst-ssb)>0.0) ? (ssb/df1)/((sst-ssb)/df2) : NAN;
+	result_d[0]= stat;
+	result_d[1]= (sst>0.0) ? ssb/sst : NAN;
+	result_d[5]= df1;
+	result_d[6]= df2;
+	result_d[7]= ssb;
+
+	/* PERMUTATIONS - each thread has its own scratch arrays, and every thread reaches the worksharing loop */
+	statperm= malloc((nperm+1)*sizeof(*statperm));
+	if(statperm==NULL) { memerr=1; goto FINISH; }
+	#pragma omp parallel private(ii,rr,aa) reduction(|:memerr)
+	{
+		long jj,tempg,*wg=NULL;
+		double ssbperm,*wsum=NULL;
+		wg= malloc((nz+1)*sizeof(*wg));
+		wsum= malloc(ngrps*sizeof(*wsum));
+		if(wg==NULL||wsum==NULL) memerr=1;
+		#pragma omp for schedule(static)
+		for(rr=0;rr<nperm;rr++) {
+			if(wg==NULL||wsum==NULL) continue;
+			/* shuffle the group-numbers relative to the values */
+			for(ii=0;ii<nz;ii++) wg[ii]= gg[ii];
+			for(ii=nz-1;ii>0;ii--) {
+				jj= (long)(xf_rand2_d(seed,(unsigned long)rr,(unsigned long)ii)*(double)(ii+1));
+				tempg=wg[ii]; wg[ii]=wg[jj]; wg[jj]=tempg;
+			}
+			ssbperm= xf_permanova1_d_ssb(zz,wg,nz,count,ngrps,grand,wsum);
+			statperm[rr]= ((sst-ssbperm)>0.0) ? (ssbperm/df1)/((sst-ssbperm)/df2) : NAN;
+		}
+		if(wg!=NULL) free(wg);
+		if(wsum!=NULL) free(wsum);
+	}
+	if(memerr) goto FINISH;
+
+	/* PERMUTATION P-VALUE (ONE-TAILED, F IS NEVER NEGATIVE) - with the same rounding tolerance as xf_permboot1_d */
+	if(nperm>0 && isfinite(stat)) {
+		aa= stat*(1.0-1e-12);
+		for(rr=kk=0;rr<nperm;rr++) if(statperm[rr]>=aa) kk++;
+		result_d[4]= (double)(kk+1)/(double)(nperm+1);
+	}
+	sprintf(message,"%s [OK]",thisfunc);
+
+FINISH:
+	if(zz!=NULL) free(zz);
+	if(gg!=NULL) free(gg);
+	if(count!=NULL) free(count);
+	if(sum!=NULL) free(sum);
+	if(statperm!=NULL) free(statperm);
+	if(memerr) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(-1); }
+	return(status);
+}
@@ -0,0 +1,251 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Permutation and bootstrap tests for differences between groups, paired differences, and correlation
+	- non-parametric alternatives to the t-test (xf_ttest2_d, xf_ttest3_d) and Pearson's correlation (xf_correlate_d)
+	- permutation test: the p-value for the observed statistic, from resamples with group-membership randomised
+		- p = (1 + number of resamples with |statistic| >= observed |statistic|) / (1 + nperm)
+	- bootstrap: confidence interval and standard error for the effect-size, from resamples with replacement
+		- the interval is the percentile interval (e.g. 2.5th and 97.5th percentiles for setci=95)
+	- random numbers come from the counter-based generator xf_rand2_d, with one stream per resample
+		- the result depends only on the data and the seed, not the number of threads
+	- if compiled with OpenMP (-fopenmp), resamples are calculated in parallel
+
+	test=1: independent groups (data1 and data2)
+		- statistic: Student's t for the difference (mean2-mean1), as for xf_ttest2_d
+		- permutation: values are randomly re-assigned to groups of the original sizes
+		- bootstrap: each group is resampled separately - effect-size is (mean2-mean1)
+	test=2: paired samples (data1[ii] and data2[ii] are a pair)
+		- statistic: paired t for the differences (data2-data1), as for xf_ttest3_d
+		- permutation: the sign of each difference is randomly flipped
+		- bootstrap: the differences are resampled - effect-size is the mean difference
+	test=3: correlation (data1 is x, data2 is y)
+		- statistic: Pearson's r
+		- permutation: y-values are shuffled relative to x-values
+		- bootstrap: x-y pairs are resampled - effect-size is r
+
+	non-finite values are ignored - for test 2 and 3, the whole pair is ignored
+
+USES:
+	Significance testing for non-normal data, without calling external statistics packages
+
+DEPENDENCY TREE:
+	double xf_rand2_d(unsigned long seed, unsigned long stream, unsigned long counter);
+	void xf_qsortindex1_d(double *data, long *index,long nn);
+
+ARGUMENTS:
+	double *data1        : input, array of n1 values (group 1, or x for correlation)
+	double *data2        : input, array of n2 values (group 2, or y for correlation)
+	long n1              : input, number of elements in data1
+	long n2              : input, number of elements in data2 - must equal n1 for test 2 and 3
+	int test             : input, the test (1-3, see above)
+	long nperm           : input, number of permutations (0 to skip)
+	long nboot           : input, number of bootstrap resamples (0 to skip)
+	double setci         : input, confidence interval, percent (e.g. 95)
+	unsigned long seed   : input, random seed - the same seed gives the same result
+	double *result_d     : output, pre-allocated array of at least 8 values
+		[0] the observed statistic (t or r)
+		[1] the observed effect-size (mean difference or r)
+		[2] number of valid values (or pairs) in data1
+		[3] number of valid values (or pairs) in data2
+		[4] permutation p-value (NAN if nperm=0)
+		[5] lower limit of the bootstrap confidence interval for the effect-size (NAN if nboot=0)
+		[6] upper limit of the bootstrap confidence interval for the effect-size (NAN if nboot=0)
+		[7] bootstrap standard error of the effect-size (NAN if nboot=0)
+	char *message        : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	0 on success, -1 on error
+
+SAMPLE CALL:
+	if(xf_permboot1_d(grp1,grp2,n1,n2,1,10000,10000,95.0,seed,result_d,message)<0) {
+		fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1);
+	}
+	printf("t= %g\tp= %g\tCI= %g to %g\n",result_d[0],result_d[4],result_d[5],result_d[6]);
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* external functions start */
+double xf_rand2_d(unsigned long seed, unsigned long stream, unsigned long counter);
+void xf_qsortindex1_d(double *data, long *index,long nn);
+/* external functions end */
+
+/* statistics for each test - return NAN if the statistic is undefined */
+static double xf_permboot1_d_tindep(double *z1, long n1, double *z2, long n2, double *effect) {
+	long ii;
+	double m1=0.0,m2=0.0,ss1=0.0,ss2=0.0,aa,pooledvar;
+	for(ii=0;ii<n1;ii++) m1+= z1[ii];
+	for(ii=0;ii<n2;ii++) m2+= z2[ii];
+	m1/= (double)n1; m2/= (double)n2;
+	for(ii=0;ii<n1;ii++) { aa=z1[ii]-m1; ss1+= aa*aa; }
+	for(ii=0;ii<n2;ii++) { aa=z2[ii]-m2; ss2+= aa*aa; }
+	*effect= m2-m1;
+	pooledvar= (ss1+ss2)/(double)(n1+n2-2);
+	if(!(pooledvar>0.0)) return(NAN);
+	return((m2-m1)/(sqrt(pooledvar)*sqrt(1.0/(double)n1+1.0/(double)n2)));
+}
+static double xf_permboot1_d_tpaired(double *dd, long nn, double *effect) {
+	long ii;
+	double mean=0.0,ss=0.0,aa;
+	for(ii=0;ii<nn;ii++) mean+= dd[ii];
+	mean/= (double)nn;
+	for(ii=0;ii<nn;ii++) { aa=dd[ii]-mean; ss+= aa*aa; }
+	*effect= mean;
+	if(!(ss>0.0)) return(NAN);
+	return(mean/(sqrt(ss/(double)(nn-1))/sqrt((double)nn)));
+}
+static double xf_permboot1_d_r(double *xx, double *yy, long nn, double *effect) {
+	long ii;
+	double mx=0.0,my=0.0,sxx=0.0,syy=0.0,sxy=0.0,aa,bb,r;
+	for(ii=0;ii<nn;ii++) { mx+= xx[ii]; my+= yy[ii]; }
+	mx/= (double)nn; my/= (double)nn;
+	for(ii=0;ii<nn;ii++) { aa=xx[ii]-mx; bb=yy[ii]-my; sxx+= aa*aa; syy+= bb*bb; sxy+= aa*bb; }
+	if(!(sxx>0.0) || !(syy>0.0)) r= NAN;
+	else r= sxy/(sqrt(sxx)*sqrt(syy));
+	*effect= r;
+	return(r);
+}
+
+int xf_permboot1_d(double *data1, double *data2, long n1, long n2, int test, long nperm, long nboot, double setci, unsigned long seed, double *result_d, char *message) {
+
+	char *thisfunc="xf_permboot1_d\0";
+	int memerr=0;
+	long ii,jj,nn,nz,rr,count;
+	double aa,bb,stat,effect,*z1=NULL,*z2=NULL,*statperm=NULL,*statboot=NULL;
+
+	for(ii=0;ii<8;ii++) result_d[ii]= NAN;
+	if(test<1||test>3) { sprintf(message,"%s [ERROR]: invalid test (%d) - must be 1-3",thisfunc,test); return(-1); }
+	if((test==2||test==3) && n1!=n2) { sprintf(message,"%s [ERROR]: paired data must have equal numbers of values (%ld,%ld)",thisfunc,n1,n2); return(-1); }
+	if(nperm<0||nboot<0) { sprintf(message,"%s [ERROR]: invalid number of resamples",thisfunc); return(-1); }
+	if(setci<=0.0||setci>=100.0) { sprintf(message,"%s [ERROR]: invalid confidence interval (%g) - must be >0 and <100",thisfunc,setci); return(-1); }
+
+	/* COPY THE VALID DATA: z1 and z2 are contiguous, so permutations of independent groups can shuffle both at once */
+	z1= malloc((n1+n2+1)*sizeof(*z1));
+	if(z1==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(-1); }
+	if(test==1) {
+		for(ii=nn=0;ii<n1;ii++) if(isfinite(data1[ii])) z1[nn++]= data1[ii];
+		z2= z1+nn;
+		for(ii=nz=0;ii<n2;ii++) if(isfinite(data2[ii])) z2[nz++]= data2[ii];
+		result_d[2]= (double)nn; result_d[3]= (double)nz;
+		if(nn<2||nz<2) { free(z1); sprintf(message,"%s [ERROR]: fewer than 2 valid values in a group",thisfunc); return(-1); }
+		stat= xf_permboot1_d_tindep(z1,nn,z2,nz,&effect);
+	}
+	else {
+		z2= z1+n1;
+		for(ii=nn=0;ii<n1;ii++) if(isfinite(data1[ii]) && isfinite(data2[ii])) {
+			if(test==2) z1[nn]= data2[ii]-data1[ii];
+			else { z1[nn]= data1[ii]; z2[nn]= data2[ii]; }
+			nn++;
+		}
+		nz= nn;
+		result_d[2]= result_d[3]= (double)nn;
+		if(nn<3) { free(z1); sprintf(message,"%s [ERROR]: fewer than 3 valid pairs",thisfunc); return(-1); }
+		if(test==2) stat= xf_permboot1_d_tpaired(z1,nn,&effect);
+		else stat= xf_permboot1_d_r(z1,z2,nn,&effect);
+	}
+	result_d[0]= stat;
+	result_d[1]= effect;
+
+	statperm= malloc((nperm+1)*sizeof(*statperm));
+	statboot= malloc((nboot+1)*sizeof(*statboot));
+	if(statperm==NULL||statboot==NULL) { memerr=1; goto FINISH; }
+
+	/* PERMUTATIONS AND BOOTSTRAP RESAMPLES - each thread has its own scratch arrays */
+	/* every thread must reach both worksharing loops, so a thread without scratch memory skips the work instead */
+	#pragma omp parallel private(ii,jj,rr,aa,bb) reduction(|:memerr)
+	{
+		double *w1,*w2,dummy;
+		unsigned long stream,ntot=(unsigned long)(nn+nz);
+		w1= malloc((nn+nz+1)*sizeof(*w1));
+		if(w1==NULL) memerr=1;
+		w2= (w1!=NULL) ? w1+nn : NULL;
+		/* permutations: streams 0 to nperm-1 */
+		#pragma omp for schedule(static)
+		for(rr=0;rr<nperm;rr++) {
+			if(w1==NULL) continue;
+			stream= (unsigned long)rr;
+			if(test==1) {
+				/* shuffle the pooled values, then split at nn */
+				for(ii=0;ii<(nn+nz);ii++) w1[ii]= z1[ii];
+				for(ii=(nn+nz)-1;ii>0;ii--) {
+					jj= (long)(xf_rand2_d(seed,stream,(unsigned long)ii)*(double)(ii+1));
+					aa=w1[ii]; w1[ii]=w1[jj]; w1[jj]=aa;
+				}
+				statperm[rr]= xf_permboot1_d_tindep(w1,nn,w2,nz,&dummy);
+			}
+			else if(test==2) {
+				/* flip the sign of each difference with probability 0.5 */
+				for(ii=0;ii<nn;ii++) w1[ii]= (xf_rand2_d(seed,stream,(unsigned long)ii)<0.5) ? -z1[ii] : z1[ii];
+				statperm[rr]= xf_permboot1_d_tpaired(w1,nn,&dummy);
+			}
+			else {
+				/* shuffle y relative to x */
+				for(ii=0;ii<nn;ii++) w2[ii]= z2[ii];
+				for(ii=nn-1;ii>0;ii--) {
+					jj= (long)(xf_rand2_d(seed,stream,(unsigned long)ii)*(double)(ii+1));
+					bb=w2[ii]; w2[ii]=w2[jj]; w2[jj]=bb;
+				}
+				statperm[rr]= xf_permboot1_d_r(z1,w2,nn,&dummy);
+			}
+		}
+		/* bootstrap: streams nperm onwards, so they never overlap the permutations */
+		#pragma omp for schedule(static)
+		for(rr=0;rr<nboot;rr++) {
+			if(w1==NULL) continue;
+			stream= (unsigned long)(nperm+rr);
+			if(test==1) {
+				for(ii=0;ii<nn;ii++) w1[ii]= z1[(long)(xf_rand2_d(seed,stream,(unsigned long)ii)*(double)nn)];
+				for(ii=0;ii<nz;ii++) w2[ii]= z2[(long)(xf_rand2_d(seed,stream,ntot+(unsigned long)ii)*(double)nz)];
+				xf_permboot1_d_tindep(w1,nn,w2,nz,(statboot+rr));
+			}
+			else if(test==2) {
+				for(ii=0;ii<nn;ii++) w1[ii]= z1[(long)(xf_rand2_d(seed,stream,(unsigned long)ii)*(double)nn)];
+				xf_permboot1_d_tpaired(w1,nn,(statboot+rr));
+			}
+			else {
+				for(ii=0;ii<nn;ii++) {
+					jj= (long)(xf_rand2_d(seed,stream,(unsigned long)ii)*(double)nn);
+					w1[ii]= z1[jj]; w2[ii]= z2[jj];
+				}
+				xf_permboot1_d_r(w1,w2,nn,(statboot+rr));
+			}
+		}
+		if(w1!=NULL) free(w1);
+	}
+	if(memerr) goto FINISH;
+
+	/* PERMUTATION P-VALUE - a small tolerance allows for rounding when a resample reproduces the observed statistic */
+	if(nperm>0 && isfinite(stat)) {
+		aa= fabs(stat)*(1.0-1e-12);
+		for(rr=count=0;rr<nperm;rr++) if(fabs(statperm[rr])>=aa) count++;
+		result_d[4]= (double)(count+1)/(double)(nperm+1);
+	}
+
+	/* BOOTSTRAP CONFIDENCE INTERVAL AND STANDARD ERROR - undefined resamples (e.g. r for constant x) are excluded */
+	if(nboot>0) {
+		for(rr=jj=0;rr<nboot;rr++) if(isfinite(statboot[rr])) statboot[jj++]= statboot[rr];
+		if(jj>1) {
+			xf_qsortindex1_d(statboot,NULL,jj);
+			aa= (0.5-setci/200.0)*(double)(jj-1);
+			bb= (0.5+setci/200.0)*(double)(jj-1);
+			result_d[5]= statboot[(long)aa]+(aa-floor(aa))*(statboot[(long)ceil(aa)]-statboot[(long)aa]);
+			result_d[6]= statboot[(long)bb]+(bb-floor(bb))*(statboot[(long)ceil(bb)]-statboot[(long)bb]);
+			for(rr=0,aa=0.0;rr<jj;rr++) aa+= statboot[rr];
+			aa/= (double)jj;
+			for(rr=0,bb=0.0;rr<jj;rr++) bb+= (statboot[rr]-aa)*(statboot[rr]-aa);
+			result_d[7]= sqrt(bb/(double)(jj-1));
+		}
+	}
+
+FINISH:
+	free(z1);
+	if(statperm!=NULL) free(statperm);
+	if(statboot!=NULL) free(statboot);
+	if(memerr) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(-1); }
+	sprintf(message,"%s [OK]",thisfunc);
+	return(0);
+}
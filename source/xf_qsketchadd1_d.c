@@ -0,0 +1,73 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Add values to a streaming quantile-sketch (see xf_qsketchinit1_d)
+	- NAN and INF values are ignored
+	- to add a single value, pass its address with nn=1
+
+USES:
+	Percentiles for streams of data too large to store in memory
+
+DEPENDENCY TREE:
+	int xf_compare1_d(const void *a, const void *b);
+
+ARGUMENTS:
+	double *sketch : sketch created by xf_qsketchinit1_d
+	double *data   : array of values to add
+	long nn        : number of elements in data
+
+RETURN VALUE:
+	number of valid values added
+
+SAMPLE CALL:
+	xf_qsketchadd1_d(sketch,data,nn);
+*/
+
+#include <stdlib.h>
+#include <math.h>
+
+/* external functions start */
+int xf_compare1_d(const void *a, const void *b);
+/* external functions end */
+
+long xf_qsketchadd1_d(double *sketch, double *data, long nn) {
+
+	long ii,jj,kk,ll,nvalid=0;
+	unsigned long rng;
+	double aa,*level,*next;
+
+	kk= (long)sketch[0];
+
+	for(ii=0;ii<nn;ii++) {
+		aa= data[ii];
+		if(!isfinite(aa)) continue;
+		nvalid++;
+
+		/* track the total count, minimum and maximum */
+		if(sketch[1]==0.0) sketch[4]=sketch[5]=aa;
+		else { if(aa<sketch[4]) sketch[4]=aa; if(aa>sketch[5]) sketch[5]=aa; }
+		sketch[1]+= 1.0;
+
+		/* add to level 0 */
+		sketch[72+(long)sketch[8]]= aa;
+		sketch[8]+= 1.0;
+
+		/* compact each full level into the next */
+		for(ll=0;ll<63 && (long)sketch[8+ll]>=kk;ll++) {
+			level= sketch+72+ll*kk;
+			next= sketch+72+(ll+1)*kk;
+			qsort(level,kk,sizeof(double),xf_compare1_d);
+			/* choose odd or even items at random, so that rank-errors tend to cancel */
+			rng= (unsigned long)sketch[3];
+			rng= (rng*1103515245UL+12345UL)%2147483648UL;
+			sketch[3]= (double)rng;
+			jj= (long)((rng>>16)&1UL);
+			for(;jj<kk;jj+=2) { next[(long)sketch[9+ll]]= level[jj]; sketch[9+ll]+= 1.0; }
+			sketch[8+ll]= 0.0;
+			if((double)(ll+1)>sketch[2]) sketch[2]= (double)(ll+1);
+		}
+	}
+
+	return(nvalid);
+}
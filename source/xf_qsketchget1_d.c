@@ -0,0 +1,93 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Get an approximate percentile from a streaming quantile-sketch (see xf_qsketchinit1_d)
+	- the value is the item at rank N*(setper/100), as for xf_percentile1_d and xf_percentile2_d
+		- if N*(setper/100) is a whole number, the average of the items at that rank and the rank below
+	- percentiles of 0 and 100 return the exact minimum and maximum
+	- the result is exact if fewer than kk values have been added to the sketch
+
+USES:
+	Percentiles for streams of data too large to store in memory
+
+DEPENDENCY TREE:
+	void xf_qsortindex1_d(double *data, long *index,long nn);
+
+ARGUMENTS:
+	double *sketch : sketch created by xf_qsketchinit1_d and filled by xf_qsketchadd1_d
+	double setper  : the percentile cutoff desired (0-100)
+	char *message  : pre-allocated array to hold error message
+
+RETURN VALUE:
+	the percentile value if successful, NAN if fail
+
+SAMPLE CALL:
+	median= xf_qsketchget1_d(sketch,50.0,message);
+	if(!isfinite(median)) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* external functions start */
+void xf_qsortindex1_d(double *data, long *index,long nn);
+/* external functions end */
+
+double xf_qsketchget1_d(double *sketch, double setper, char *message) {
+
+	char *thisfunc="xf_qsketchget1_d\0";
+	int exact;
+	long ii,jj,kk,ll,nlev,nitems,*index=NULL;
+	double aa,bb,nnd,target,rank,rank1,cumweight,*value=NULL,*weight=NULL;
+
+	kk= (long)sketch[0];
+	nnd= sketch[1];
+	nlev= (long)sketch[2]+1;
+
+	if(setper<0.0||setper>100.0) { sprintf(message,"%s [ERROR]: invalid percentile (%g), must be 0-100",thisfunc,setper); return(NAN); }
+	if(nnd<1.0) { sprintf(message,"%s [ERROR]: no finite numbers in sketch",thisfunc); return(NAN); }
+
+	target= nnd*(setper/100.0); /* position of the percentile */
+	rank= floor(target);        /* zero-offset rank of the item at that position */
+	if(rank<=0.0) return(sketch[4]);
+	if(rank>=nnd) return(sketch[5]); /* 100th percentile is the maximum */
+	/* if the position falls exactly on an item, average it with the item below */
+	exact= (target==rank);
+	rank1= exact ? rank-1.0 : rank;
+	if(rank1>=(nnd-1.0)) return(sketch[5]);
+
+	/* COLLECT THE ITEMS FROM ALL LEVELS - each item at level ll represents 2^ll values */
+	for(ll=nitems=0;ll<nlev;ll++) nitems+= (long)sketch[8+ll];
+	value= malloc((nitems+1)*sizeof(*value));
+	weight= malloc((nitems+1)*sizeof(*weight));
+	index= malloc((nitems+1)*sizeof(*index));
+	if(value==NULL||weight==NULL||index==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); bb=NAN; goto END; }
+	for(ll=ii=0,aa=1.0;ll<nlev;ll++,aa*=2.0) {
+		for(jj=0;jj<(long)sketch[8+ll];jj++) {
+			value[ii]= sketch[72+ll*kk+jj];
+			weight[ii]= aa;
+			index[ii]= ii;
+			ii++;
+	}}
+
+	/* SORT THE ITEMS AND FIND THE FIRST ONES WHOSE CUMULATIVE WEIGHT EXCEEDS EACH RANK - the minimum and maximum are exact */
+	xf_qsortindex1_d(value,index,nitems);
+	aa= (rank1<=0.0) ? sketch[4] : NAN;
+	bb= (rank>=(nnd-1.0)) ? sketch[5] : NAN;
+	for(ii=0,cumweight=0.0;ii<nitems&&(isnan(aa)||isnan(bb));ii++) {
+		cumweight+= weight[index[ii]];
+		if(isnan(aa) && cumweight>rank1) aa= value[ii];
+		if(isnan(bb) && cumweight>rank) bb= value[ii];
+	}
+	if(isnan(aa)) aa= value[nitems-1];
+	if(isnan(bb)) bb= value[nitems-1];
+	if(exact) bb= (aa+bb)/2.0;
+
+END:
+	if(value!=NULL) free(value);
+	if(weight!=NULL) free(weight);
+	if(index!=NULL) free(index);
+	return(bb);
+}
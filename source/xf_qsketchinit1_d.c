@@ -0,0 +1,74 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Create a streaming quantile-sketch, for approximate percentiles in bounded memory
+	Use with xf_qsketchadd1_d (add values) and xf_qsketchget1_d (get a percentile)
+	- the sketch is a stack of "compactors" (Manku-Rajagopalan-Lindsay / KLL style)
+		- each level holds up to kk values
+		- when a level fills, it is sorted and every second value (random odd/even offset)
+		  is passed to the next level, where each value represents twice as many data-points
+	- memory is fixed (about 64*kk doubles) regardless of the number of values added
+	- rank-error is typically about 1/kk of the number of values (e.g. 0.1% for kk=1024)
+	- minimum and maximum are tracked exactly
+	- until kk values have been added, results are exact
+
+	Layout of the sketch array (all doubles):
+		[0]    kk: capacity of each level
+		[1]    n: total values added
+		[2]    highest level in use
+		[3]    random-number state
+		[4]    minimum
+		[5]    maximum
+		[6-7]  reserved
+		[8-71] number of values held in each of 64 levels
+		[72-]  values for each level, level ll starting at 72+ll*kk
+
+USES:
+	Percentiles for streams of data too large to store in memory
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	long kk       : capacity of each level - larger values reduce the error (must be an even number >=8)
+	char *message : pre-allocated array to hold error message
+
+RETURN VALUE:
+	pointer to the sketch on success, NULL on error
+	the sketch should be freed by the calling function
+
+SAMPLE CALL:
+	sketch= xf_qsketchinit1_d(1024,message);
+	if(sketch==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	while(fscanf(fpin,"%lf",&aa)==1) xf_qsketchadd1_d(sketch,&aa,1);
+	median= xf_qsketchget1_d(sketch,50.0,message);
+	free(sketch);
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+double *xf_qsketchinit1_d(long kk, char *message) {
+
+	char *thisfunc="xf_qsketchinit1_d\0";
+	long ii;
+	double *sketch=NULL;
+
+	if(kk<8 || kk%2!=0) { sprintf(message,"%s [ERROR]: invalid level-capacity (%ld) - must be an even number >=8",thisfunc,kk); return(NULL); }
+
+	sketch= malloc((72+64*kk)*sizeof(*sketch));
+	if(sketch==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(NULL); }
+
+	sketch[0]= (double)kk;
+	sketch[1]= 0.0;
+	sketch[2]= 0.0;
+	sketch[3]= 12345.0;
+	sketch[4]= NAN;
+	sketch[5]= NAN;
+	sketch[6]= sketch[7]= 0.0;
+	for(ii=8;ii<72;ii++) sketch[ii]= 0.0;
+
+	return(sketch);
+}
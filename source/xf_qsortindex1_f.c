@@ -2,9 +2,19 @@
 <TAGS>math</TAGS>
 
 DESCRIPTION:
-	Sort an array of long integers using a quick-sort algorithm
-	Modifies the input data array
-	This function also modifies an array of indices so the user can know the original position of the sorted numbers
+	Sort an array of single-precision floating-point numbers, and an optional array of indices to track the original order
+	Modifies the input data array, and the index array if provided
+
+	18 October 2026: replaces the previous recursive quick-sort with an LSD radix-sort
+		- 4 passes of 8 bits, with no comparisons - time is O(N)
+		- passes are skipped when every value has the same byte (e.g. high bytes of timestamps)
+		- floating-point values are mapped to unsigned integers which sort in the same order
+		- negative zero sorts before positive zero, NAN sorts to the start or end depending on its sign bit
+		- the sort is stable: equal values stay in their original order
+		- the index order of equal values can therefore differ from the previous quick-sort, which changes
+		  results for callers that rank ties by sort position (e.g. xe-spearmans1 -mat 0 before ties were averaged)
+		- if compiled with OpenMP (-fopenmp), large arrays are sorted using multiple threads
+		- short arrays are insertion-sorted, and if temporary memory cannot be allocated a quick-sort is used (not stable)
 
 USES:
 	rearranging data in numerical order
@@ -15,53 +25,133 @@ DEPENDENCY TREE:
 ARGUMENTS:
 	float *data: array holding the data
 	long *index: array of numbers representing the original order of the data, typically 0 to (n-1)
-	long n: size of the array
+		- set to NULL if only the data is to be sorted
+	long nn: size of the array
 
 RETURN VALUE:
 	None
 
+SAMPLE CALL:
+	for(ii=0;ii<nn;ii++) index[ii]=ii;
+	xf_qsortindex1_f(data,index,nn);
+	xf_qsortindex1_f(data,NULL,nn);
+
 NOTE!
-	- behaviour for non-numeric values, Inf and Nan is not specified
 	- arrays with only one element will be unaltered
 */
 
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#define XF_RADIX_MINPARALLEL 1000000
+
+/* insertion-sort for short arrays (stable) */
+static void xf_qsortindex1_f_insert(float *data, long *index, long nn) {
+	long ii,jj,tempindex=0;
+	float tempdatum;
+	for(ii=1;ii<nn;ii++) {
+		tempdatum=data[ii]; if(index!=NULL) tempindex=index[ii];
+		for(jj=ii-1;jj>=0 && data[jj]>tempdatum;jj--) { data[jj+1]=data[jj]; if(index!=NULL) index[jj+1]=index[jj]; }
+		data[jj+1]=tempdatum; if(index!=NULL) index[jj+1]=tempindex;
+	}
+}
+
+/* fallback for when memory cannot be allocated - quick-sort (median-of-3, Hoare partition) */
+static void xf_qsortindex1_f_quick(float *data, long *index, long nn) {
+	long ii,jj,tempindex;
+	float tempdatum,pivotvalue,aa,bb,cc;
+	while(nn>16) {
+		aa= data[0]; bb= data[nn/2]; cc= data[nn-1];
+		if(aa<bb) { if(bb<cc) pivotvalue=bb; else if(aa<cc) pivotvalue=cc; else pivotvalue=aa; }
+		else { if(aa<cc) pivotvalue=aa; else if(bb<cc) pivotvalue=cc; else pivotvalue=bb; }
+		ii=0; jj=nn-1;
+		while(ii<=jj) {
+			while(data[ii]<pivotvalue) ii++;
+			while(data[jj]>pivotvalue) jj--;
+			if(ii<=jj) {
+				tempdatum=data[ii]; data[ii]=data[jj]; data[jj]=tempdatum;
+				if(index!=NULL) { tempindex=index[ii]; index[ii]=index[jj]; index[jj]=tempindex; }
+				ii++; jj--;
+		}}
+		/* recurse on the smaller side, loop on the larger */
+		if((jj+1)<(nn-ii)) { xf_qsortindex1_f_quick(data,index,(jj+1)); data+=ii; if(index!=NULL) index+=ii; nn-=ii; }
+		else { xf_qsortindex1_f_quick((data+ii),(index!=NULL?index+ii:NULL),(nn-ii)); nn=jj+1; }
+	}
+	xf_qsortindex1_f_insert(data,index,nn);
+}
+
 void xf_qsortindex1_f(float *data, long *index,long nn) {
 
-	long ii,jj,kk,mm,left=0,right=(nn-1),tempindex;
-	long first,last,pivot;
-	float tempdatum,pivotvalue;
+	int pass,nthreads=1;
+	long ii,jj,tt,sum,count[4][256],*tcount=NULL,*idx1=NULL,*idx2=NULL,*ptemp;
+	uint32_t uu,*key1=NULL,*key2=NULL,*pkey;
 
 	/* if data is less than 2 elements long, do nothing */
-	if( right<=left ) return;
-	/* choose the middle element of the data for the initial pivot */
-	pivot=(long)((left+right)/2);
-	/* check if pivot=left, which could cause endless recursion	*/
-	if(pivot==left) pivot=right;
-	/* define pivot value (saves indexing time in loop below) */
-	pivotvalue=data[pivot];
-
-	/* do an initial swap to move the pivot out of the way */
-	tempdatum = data[left]; data[left] = data[pivot]; data[pivot] = tempdatum;
-	tempindex = index[left]; index[left] = index[pivot]; index[pivot] = tempindex;
-
-	/* define end of the search (to be modified in the loop below) */
-	last=left;
-
-	/* scan from first to last for values out of sequence: data[first]<= pivotvalue <data[last] */
-	for(first=left+1; first<=right; first++) {
-		if(data[first]<pivotvalue) {
-			last++;
-			tempdatum = data[first]; data[first] = data[last]; data[last] = tempdatum;
-			tempindex = index[first]; index[first] = index[last]; index[last] = tempindex;
-	}}
-
-	/* move the pivot to the adjusted last position */
-	tempdatum = data[left]; data[left] = data[last]; data[last] = tempdatum;
-	tempindex = index[left]; index[left] = index[last]; index[last] = tempindex;
-
-	/* recursively sort the left-side */
-	ii=left; jj=last-1; kk=1+(jj-ii); xf_qsortindex1_f((data+ii),(index+ii),kk);
-
-	/* recursively sort the right-side */
-	ii=last+1; jj=right;  kk=1+(jj-ii); xf_qsortindex1_f((data+ii),(index+ii),kk);
+	if(nn<2) return;
+	/* short arrays: use insertion-sort */
+	if(nn<64) { xf_qsortindex1_f_insert(data,index,nn); return; }
+#ifdef _OPENMP
+	if(nn>=XF_RADIX_MINPARALLEL) nthreads= omp_get_max_threads();
+#endif
+	key1= malloc(nn*sizeof(*key1));
+	key2= malloc(nn*sizeof(*key2));
+	tcount= malloc(nthreads*256*sizeof(*tcount));
+	if(index!=NULL) idx2= malloc(nn*sizeof(*idx2));
+	if(key1==NULL||key2==NULL||tcount==NULL||(index!=NULL&&idx2==NULL)) {
+		free(key1); free(key2); free(tcount); free(idx2);
+		xf_qsortindex1_f_quick(data,index,nn);
+		return;
+	}
+	idx1= index;
+
+	/* CONVERT TO UNSIGNED KEYS AND COUNT THE VALUES OF EVERY BYTE */
+	memset(count,0,sizeof(count));
+	for(ii=0;ii<nn;ii++) {
+		memcpy(&uu,(data+ii),sizeof(uu));
+		key1[ii]= (uu&((uint32_t)1<<31)) ? ~uu : (uu|((uint32_t)1<<31));
+		for(pass=0;pass<4;pass++) count[pass][(key1[ii]>>(pass*8))&255]++;
+	}
+
+	/* SORT ONE BYTE AT A TIME, LEAST-SIGNIFICANT FIRST */
+	for(pass=0;pass<4;pass++) {
+		/* skip this pass if every key has the same value for this byte */
+		if(count[pass][(key1[0]>>(pass*8))&255]==nn) continue;
+		/* each thread counts the bytes in its own section of the array */
+		#pragma omp parallel for num_threads(nthreads) private(ii,jj)
+		for(tt=0;tt<nthreads;tt++) {
+			long *tc=tcount+tt*256;
+			for(jj=0;jj<256;jj++) tc[jj]=0;
+			for(ii=(tt*nn)/nthreads;ii<((tt+1)*nn)/nthreads;ii++) tc[(key1[ii]>>(pass*8))&255]++;
+		}
+		/* convert counts to starting positions - by byte-value, then by thread, so the sort is stable */
+		for(jj=sum=0;jj<256;jj++) for(tt=0;tt<nthreads;tt++) { ii=tcount[tt*256+jj]; tcount[tt*256+jj]=sum; sum+=ii; }
+		/* each thread moves the keys (and indices) from its section */
+		#pragma omp parallel for num_threads(nthreads) private(ii,jj)
+		for(tt=0;tt<nthreads;tt++) {
+			long *tc=tcount+tt*256;
+			for(ii=(tt*nn)/nthreads;ii<((tt+1)*nn)/nthreads;ii++) {
+				jj= tc[(key1[ii]>>(pass*8))&255]++;
+				key2[jj]= key1[ii];
+				if(idx1!=NULL) idx2[jj]= idx1[ii];
+		}}
+		pkey=key1; key1=key2; key2=pkey;
+		ptemp=idx1; idx1=idx2; idx2=ptemp;
+	}
+
+	/* CONVERT BACK TO THE ORIGINAL TYPE, AND MAKE SURE THE INDEX IS IN THE CALLING FUNCTION'S ARRAY */
+	for(ii=0;ii<nn;ii++) {
+		uu= key1[ii];
+		uu= (uu&((uint32_t)1<<31)) ? (uu&~((uint32_t)1<<31)) : ~uu;
+		memcpy((data+ii),&uu,sizeof(uu));
+	}
+	if(idx1!=index) { memcpy(index,idx1,nn*sizeof(*index)); idx2=idx1; }
+
+	free(key1);
+	free(key2);
+	free(tcount);
+	if(idx2!=NULL) free(idx2);
+	return;
 }
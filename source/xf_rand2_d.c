@@ -0,0 +1,52 @@
+/*
+<TAGS>synthetic_data math</TAGS>
+DESCRIPTION:
+	Counter-based random number generator: a double-precision random number from 0 to <1
+	- the number is a fixed function of (seed,stream,counter) - there is no internal state
+	- hence numbers can be generated in any order, by any number of threads, with identical results
+		- e.g. use "stream" for the resample-number and "counter" for the position within the resample
+	- the three arguments are combined and scrambled by two rounds of the splitmix64 finaliser
+	- quality is sufficient for shuffling and resampling, but this is not a cryptographic generator
+	- compare with xf_rand1_d, which depends on the state of the system random() function
+
+USES:
+	Reproducible, multi-threaded permutation and bootstrap tests (see xf_permboot1_d)
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	unsigned long seed    : the seed, e.g. set by the user or from the time and process-ID
+	unsigned long stream  : the stream number (e.g. one stream per resample)
+	unsigned long counter : the position in the stream
+
+RETURN VALUE:
+	The random number, from 0 to less than 1
+
+SAMPLE CALL:
+	// a random element from an array of nn values, for position kk of resample rr
+	jj= (long)(xf_rand2_d(seed,rr,kk)*nn);
+*/
+
+#include <stdint.h>
+
+double xf_rand2_d(unsigned long seed, unsigned long stream, unsigned long counter) {
+
+	uint64_t zz;
+
+	/* combine the key (seed,stream) with the counter */
+	zz= (uint64_t)seed*0x9E3779B97F4A7C15ULL ^ ((uint64_t)stream+0x632BE59BD9B4E019ULL)*0xD1B54A32D192ED03ULL;
+	zz+= (uint64_t)counter*0x9E3779B97F4A7C15ULL;
+
+	/* two rounds of the splitmix64 finaliser */
+	zz= (zz^(zz>>30))*0xBF58476D1CE4E5B9ULL;
+	zz= (zz^(zz>>27))*0x94D049BB133111EBULL;
+	zz^= (zz>>31);
+	zz+= 0x9E3779B97F4A7C15ULL;
+	zz= (zz^(zz>>30))*0xBF58476D1CE4E5B9ULL;
+	zz= (zz^(zz>>27))*0x94D049BB133111EBULL;
+	zz^= (zz>>31);
+
+	/* top 53 bits give a double from 0 to <1 */
+	return((double)(zz>>11)*(1.0/9007199254740992.0));
+}
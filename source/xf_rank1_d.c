@@ -0,0 +1,69 @@
+/*
+<TAGS>math stats</TAGS>
+
+DESCRIPTION:
+	Convert an array of doubles to ranks, assigning tied values the average of their ranks
+	- ranks start at 1 (the smallest value)
+	- e.g. data= 5,2,2,9 gives rank= 3,1.5,1.5,4
+	- non-finite values (NAN or INF) are not ranked - their rank is set to NAN
+	- uses a stable radix-sort (xf_qsortindex1_d), so time is O(N)
+
+USES:
+	Spearman's rank correlation, non-parametric tests
+
+DEPENDENCY TREE:
+	void xf_qsortindex1_d(double *data, long *index,long nn);
+
+ARGUMENTS:
+	double *data   : input, array of values - not modified
+	double *rank   : output, pre-allocated array of nn ranks
+	long nn        : number of elements in data and rank
+	char *message  : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	number of finite (ranked) values on success, -1 on error
+
+SAMPLE CALL:
+	nranked= xf_rank1_d(data,rank,nn,message);
+	if(nranked<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* external functions start */
+void xf_qsortindex1_d(double *data, long *index,long nn);
+/* external functions end */
+
+long xf_rank1_d(double *data, double *rank, long nn, char *message) {
+
+	char *thisfunc="xf_rank1_d\0";
+	long ii,jj,kk,mm,*index=NULL;
+	double aa,*temp=NULL;
+
+	if(nn<0) { sprintf(message,"%s [ERROR]: invalid number of values (%ld)",thisfunc,nn); return(-1); }
+
+	temp= malloc((nn+1)*sizeof(*temp));
+	index= malloc((nn+1)*sizeof(*index));
+	if(temp==NULL||index==NULL) { free(temp); free(index); sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(-1); }
+
+	/* COPY THE FINITE VALUES, KEEPING THEIR ORIGINAL POSITIONS */
+	for(ii=mm=0;ii<nn;ii++) {
+		rank[ii]= NAN;
+		if(isfinite(data[ii])) { temp[mm]= data[ii]; index[mm]= ii; mm++; }
+	}
+
+	/* SORT, THEN ASSIGN EACH RUN OF TIED VALUES THE MEAN OF ITS RANKS */
+	xf_qsortindex1_d(temp,index,mm);
+	for(ii=0;ii<mm;ii=jj) {
+		for(jj=ii+1;jj<mm && temp[jj]==temp[ii];jj++);
+		aa= 0.5*(double)(ii+jj+1); /* mean of ranks ii+1 to jj */
+		for(kk=ii;kk<jj;kk++) rank[index[kk]]= aa;
+	}
+
+	free(temp);
+	free(index);
+	sprintf(message,"%s [OK]",thisfunc);
+	return(mm);
+}
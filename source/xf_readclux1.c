@@ -0,0 +1,192 @@
+/*
+<TAGS>file dt.spikes</TAGS>
+DESCRIPTION:
+	Read selected clusters from an indexed spike-store (.clux - see xf_writeclux1)
+	The file is memory-mapped, so only the spikes for the requested clusters are touched
+	Output is the same as xf_readclub1 followed by xf_matchclub1_ls:
+		- timestamp and cluster-ID arrays, in ascending time-order
+
+USES:
+	Replacement for xf_readclub1 when only some clusters are needed
+
+DEPENDENCY TREE:
+	long *xf_lineparse2(char *line,char *delimiters, long *nwords);
+
+ARGUMENTS:
+	char *infile  : name of the .clux file (stdin is not allowed)
+	char *list1   : CSV list of clusters to read, or NULL to read all clusters
+	long tstart   : read only spikes with timestamps >= tstart...
+	long tstop    : ...and < tstop (set tstop<=tstart to read all times)
+	long **clubt  : unallocated pointer for timestamp array, passed by calling function as &clubt
+	short **club  : unallocated pointer for cluster-ID array, passed by calling function as &club
+	long *params  : array of at least 4 elements to hold file properties, or NULL
+		params[0] : total spikes in the file
+		params[1] : number of cluster-IDs (highest ID +1)
+		params[2] : first timestamp in the file
+		params[3] : last timestamp in the file
+	char *message : pre-allocated array to hold error message
+
+RETURN VALUE:
+	number of spikes read, -1 on error
+	listed clusters which are not in the file are ignored
+
+SAMPLE CALL:
+	nn= xf_readclux1("data.clux","5,7",0,0,&clubt,&club,NULL,message);
+	if(nn<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define CLUX_HEADERSIZE 512
+#define CLUX_NPARAMS 8
+
+/* external functions start */
+long *xf_lineparse2(char *line,char *delimiters, long *nwords);
+/* external functions end */
+
+/* find the first spike >= tt within a cluster, using that cluster's time-index to narrow the search */
+static long xf_readclux1_lowerbound(long *tt, long n, long *ti, long nti, long step, long target) {
+	long lo,hi,mid;
+	/* last time-index entry < target */
+	lo=0; hi=nti;
+	while(lo<hi) { mid=(lo+hi)/2; if(ti[mid]<target) lo=mid+1; else hi=mid; }
+	if(lo==0) return(0);
+	/* search only the block defined by the index entry */
+	hi= lo*step; if(hi>n) hi=n;
+	lo= (lo-1)*step;
+	while(lo<hi) { mid=(lo+hi)/2; if(tt[mid]<target) lo=mid+1; else hi=mid; }
+	return(lo);
+}
+
+long xf_readclux1(char *infile, char *list1, long tstart, long tstop, long **clubt, short **club, long *params, char *message) {
+
+	char *thisfunc="xf_readclux1\0";
+	char *map=NULL,*listcopy=NULL;
+	int fd=-1;
+	long ii,jj,kk,nn,mm,nclu,nspikes,step,ntindex,nsel,nruns,width,status=-1;
+	long *hparams,*offset,*toffset,*tindex,*times;
+	long *index1=NULL,*runstart=NULL,*runstop=NULL,*clulist=NULL;
+	long *temp1=NULL,*temp1b=NULL,*ptemp;
+	short *temp2=NULL,*temp2b=NULL,*ptemp2,*clukeep=NULL;
+	size_t mapsize=0;
+	struct stat sts;
+
+	/* OPEN AND MAP THE FILE */
+	if(strcmp(infile,"stdin")==0) { sprintf(message,"%s [ERROR]: cannot read .clux from stdin",thisfunc); return(-1); }
+	if((fd=open(infile,O_RDONLY))<0) { sprintf(message,"%s [ERROR]: could not open file %s",thisfunc,infile); return(-1); }
+	if(fstat(fd,&sts)!=0 || sts.st_size<CLUX_HEADERSIZE) { sprintf(message,"%s [ERROR]: %s is too small to be a .clux file",thisfunc,infile); goto END; }
+	mapsize= sts.st_size;
+	map= mmap(NULL,mapsize,PROT_READ,MAP_SHARED,fd,0);
+	if(map==MAP_FAILED) { map=NULL; sprintf(message,"%s [ERROR]: could not map file %s",thisfunc,infile); goto END; }
+
+	/* CHECK THE HEADER AND SET POINTERS TO THE TABLES */
+	if(strncmp(map,"CLUX_V1",7)!=0) { sprintf(message,"%s [ERROR]: %s is not a .clux file",thisfunc,infile); goto END; }
+	hparams= (long *)(map+32);
+	nspikes= hparams[1];
+	nclu= hparams[2];
+	step= hparams[5];
+	ntindex= hparams[6];
+	if(hparams[0]!=CLUX_HEADERSIZE || nspikes<0 || nclu<0 || step<1 || ntindex<0 ||
+		(CLUX_HEADERSIZE+sizeof(long)*(2*(nclu+1)+ntindex+nspikes))!=mapsize
+	) { sprintf(message,"%s [ERROR]: %s is corrupt (bad header or file-size)",thisfunc,infile); goto END; }
+	offset= (long *)(map+CLUX_HEADERSIZE);
+	toffset= offset+(nclu+1);
+	tindex= toffset+(nclu+1);
+	times= tindex+ntindex;
+	if(params!=NULL) { params[0]=nspikes; params[1]=nclu; params[2]=hparams[3]; params[3]=hparams[4]; }
+
+	/* BUILD THE LIST OF CLUSTERS TO READ, IN ASCENDING ORDER WITHOUT DUPLICATES */
+	if((clukeep=calloc(nclu+1,sizeof(*clukeep)))==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+	if(list1==NULL) { for(kk=0;kk<nclu;kk++) clukeep[kk]=1; }
+	else {
+		/* parse a copy, as xf_lineparse2 modifies the list */
+		if((listcopy=strdup(list1))==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+		index1= xf_lineparse2(listcopy,",",&mm);
+		if(mm<0) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+		for(ii=0;ii<mm;ii++) { kk= atol(listcopy+index1[ii]); if(kk>=0 && kk<nclu) clukeep[kk]=1; }
+	}
+	runstart= malloc((nclu+1)*sizeof(*runstart));
+	runstop= malloc((nclu+1)*sizeof(*runstop));
+	clulist= malloc((nclu+1)*sizeof(*clulist));
+	if(runstart==NULL||runstop==NULL||clulist==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+
+	/* FIND THE RANGE OF SPIKES TO READ FOR EACH CLUSTER - apply time-limits via the time-index */
+	for(kk=nruns=nsel=0;kk<nclu;kk++) {
+		if(clukeep[kk]!=1) continue;
+		ii= offset[kk];
+		jj= offset[kk+1];
+		if(tstop>tstart) {
+			mm= jj-ii;
+			nn= toffset[kk+1]-toffset[kk];
+			jj= ii+xf_readclux1_lowerbound(times+ii,mm,tindex+toffset[kk],nn,step,tstop);
+			ii= ii+xf_readclux1_lowerbound(times+ii,mm,tindex+toffset[kk],nn,step,tstart);
+		}
+		if(jj<=ii) continue;
+		clulist[nruns]= kk;
+		runstart[nruns]= nsel;
+		nsel+= (jj-ii);
+		runstop[nruns]= ii; // temporarily store the file-position of this run
+		nruns++;
+	}
+
+	/* COPY THE SELECTED RUNS - each run is already sorted by time */
+	temp1= malloc((nsel+1)*sizeof(*temp1));
+	temp2= malloc((nsel+1)*sizeof(*temp2));
+	if(temp1==NULL||temp2==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+	for(kk=0;kk<nruns;kk++) {
+		ii= runstop[kk];
+		nn= ((kk+1)<nruns ? runstart[kk+1] : nsel) - runstart[kk];
+		memcpy(temp1+runstart[kk],times+ii,nn*sizeof(long));
+		for(jj=0;jj<nn;jj++) temp2[runstart[kk]+jj]= (short)clulist[kk];
+		runstop[kk]= runstart[kk]+nn;
+	}
+
+	/* MERGE THE RUNS INTO TIME-ORDER - pairwise, doubling the run-width each pass, O(nsel*log(nruns)) */
+	if(nruns>1) {
+		temp1b= malloc((nsel+1)*sizeof(*temp1b));
+		temp2b= malloc((nsel+1)*sizeof(*temp2b));
+		if(temp1b==NULL||temp2b==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+		for(width=1;width<nruns;width*=2) {
+			for(kk=0;kk<nruns;kk+=(2*width)) {
+				long a1,a2,b1,b2,out;
+				a1= runstart[kk];
+				a2= runstop[((kk+width-1)<nruns ? kk+width-1 : nruns-1)];
+				b1= a2;
+				b2= runstop[((kk+2*width-1)<nruns ? kk+2*width-1 : nruns-1)];
+				out= a1;
+				while(a1<a2 && b1<b2) {
+					if(temp1[b1]<temp1[a1]) { temp1b[out]=temp1[b1]; temp2b[out++]=temp2[b1++]; }
+					else { temp1b[out]=temp1[a1]; temp2b[out++]=temp2[a1++]; }
+				}
+				while(a1<a2) { temp1b[out]=temp1[a1]; temp2b[out++]=temp2[a1++]; }
+				while(b1<b2) { temp1b[out]=temp1[b1]; temp2b[out++]=temp2[b1++]; }
+			}
+			ptemp=temp1; temp1=temp1b; temp1b=ptemp;
+			ptemp2=temp2; temp2=temp2b; temp2b=ptemp2;
+		}
+	}
+
+	(*clubt)= temp1; temp1=NULL;
+	(*club)= temp2; temp2=NULL;
+	status= nsel;
+
+END:
+	if(map!=NULL) munmap(map,mapsize);
+	if(fd>=0) close(fd);
+	if(listcopy!=NULL) free(listcopy);
+	if(index1!=NULL) free(index1);
+	if(clukeep!=NULL) free(clukeep);
+	if(runstart!=NULL) free(runstart);
+	if(runstop!=NULL) free(runstop);
+	if(clulist!=NULL) free(clulist);
+	if(temp1!=NULL) free(temp1);
+	if(temp2!=NULL) free(temp2);
+	if(temp1b!=NULL) free(temp1b);
+	if(temp2b!=NULL) free(temp2b);
+	return(status);
+}
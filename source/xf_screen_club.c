@@ -8,7 +8,8 @@ USES:
 	- keeping only chunks of club falling within certain time-windows
 
 DEPENDENCY TREE:
-	No dependencies
+	long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+	long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 
 ARGUMENTS:
 	long *start : input array of start-times used for screening
@@ -31,28 +32,34 @@ SAMPLE CALL:
 
 # include <string.h>
 # include <stdio.h>
+# include <stdlib.h>
+
+/* external functions start */
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
+/* external functions end */
 
 long xf_screen_club(long *start, long *stop, long nssp, long *clubt, short *club, long nclub, char *message) {
 
 	char *thisfunc="xf_screen_club\0";
-	long ii,jj,kk=0,tempt;
+	long ii,kk=0,tempt,hint=0,*sspindex=NULL;
+
+	/* build a sorted index of the SSPs - timestamps are found by binary search, or a sweep if they are sorted */
+	sspindex= xf_sspindex1_l(start,stop,nssp,message);
+	if(sspindex==NULL) return(-1);
 
 	for(ii=0;ii<nclub;ii++) {
 		tempt= clubt[ii];
-		/* test all the SSPs */
-		for(jj=0;jj<nssp;jj++) {
-			/* if current club falls inside current SSP... */
-			if(tempt>=start[jj] && tempt<stop[jj]) {
-				/* copy club back to kk counter */
-				clubt[kk]= clubt[ii];
-				club[kk]= club[ii];
-				/* increment the new club counter */
-				kk++;
-				/* do not check in any other SSP's */
-				break;
-			}
+		/* if current club falls inside any SSP (start <= tempt < stop)... */
+		if(xf_sspfind1_l(sspindex,nssp,tempt,&hint)>tempt) {
+			/* copy club back to kk counter */
+			clubt[kk]= clubt[ii];
+			club[kk]= club[ii];
+			/* increment the new club counter */
+			kk++;
 		}
 	}
 
+	free(sspindex);
 	return(kk);
 }
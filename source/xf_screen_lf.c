@@ -8,7 +8,8 @@ USES:
 	- keeping only chunks of data falling within certain time-windows
 
 DEPENDENCY TREE:
-	No dependencies
+	long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+	long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 
 ARGUMENTS:
 	long *start : input array of start-times used for screening
@@ -32,27 +33,33 @@ SAMPLE CALL:
 
 # include <string.h>
 # include <stdio.h>
+# include <stdlib.h>
+
+/* external functions start */
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
+/* external functions end */
 
 long xf_screen_lf(long *start, long *stop, long nssp, long *time1, float *data, long ndata, char *message) {
 
 	char *thisfunc="xf_screen_lf\0";
-	long ii,jj,kk=0,tempt;
+	long ii,kk=0,tempt,hint=0,*sspindex=NULL;
+
+	/* build a sorted index of the SSPs - timestamps are found by binary search, or a sweep if they are sorted */
+	sspindex= xf_sspindex1_l(start,stop,nssp,message);
+	if(sspindex==NULL) return(-1);
 
 	for(ii=0;ii<ndata;ii++) {
 		tempt= time1[ii];
-		/* test all the SSPs */
-		for(jj=0;jj<nssp;jj++) {
-			/* if current data falls inside current SSP... */
-			if(tempt>=start[jj] && tempt<stop[jj]) {
-				/* copy data back to kk counter */
-				data[kk]= data[ii];
-				/* increment the new data counter */
-				kk++;
-				/* do not check in any other SSPs */
-				break;
-			}
+		/* if current data falls inside any SSP (start <= tempt < stop)... */
+		if(xf_sspfind1_l(sspindex,nssp,tempt,&hint)>tempt) {
+			/* copy data back to kk counter */
+			data[kk]= data[ii];
+			/* increment the new data counter */
+			kk++;
 		}
 	}
 
+	free(sspindex);
 	return(kk);
 }
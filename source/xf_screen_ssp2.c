@@ -9,7 +9,8 @@ USES:
 	- selecting mutually inclusive sets of SSPs
 
 DEPENDENCY TREE:
-	No dependencies
+	long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+	long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
 
 ARGUMENTS:
 	long *start1 : input array of start1-times used for screening
@@ -38,43 +39,46 @@ SAMPLE CALL: keep only start2/stop2 pairs which fall within the boundaries defin
 
 # include <string.h>
 # include <stdio.h>
+# include <stdlib.h>
+
+/* external functions start */
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message);
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint);
+/* external functions end */
 
 long xf_screen_ssp2(long *start1, long *stop1, long nssp1, long *start2, long *stop2, long *extra2, long nssp2, int mode, char *message) {
 
 	char *thisfunc="xf_screen_ssp2\0";
-	long ii,jj,kk=0,tempstart,tempstop,reject;
+	long ii,kk=0,tempstart,tempstop,reject,hint1=0,hint2=0,*sspindex=NULL;
 
 	if(mode!=1&&mode!=2) { sprintf(message,"%s [ERROR]: invalid mode (%d) - must be 0 or 1",thisfunc,mode); return(-1); }
 
+	/* build a sorted index of the screening SSPs - each look-up returns the largest stop1 of the SSPs starting at or before a given time */
+	sspindex= xf_sspindex1_l(start1,stop1,nssp1,message);
+	if(sspindex==NULL) return(-1);
+
 	/* keep overlapping SSPs */
 	if(mode==1){
 		for(ii=0;ii<nssp2;ii++) {
 			tempstart=start2[ii];
 			tempstop=stop2[ii];
-			for(jj=0;jj<nssp1;jj++) {
-				/* if current data falls inside current screening-SSP, copy the data */
-				if(tempstart>=start1[jj] && tempstop<=stop1[jj]) {
-					start2[kk]=start2[ii];
-					stop2[kk]=stop2[ii];
-					extra2[kk]=extra2[ii];
-					/* increment the new data counter */
-					kk++;
-					/* do not check in any other SSP's */
-					break;
-		}}}
-	}
+			/* if current data falls inside a single screening-SSP (start1<=tempstart, stop1>=tempstop), copy the data */
+			if(xf_sspfind1_l(sspindex,nssp1,tempstart,&hint1)>=tempstop) {
+				start2[kk]=start2[ii];
+				stop2[kk]=stop2[ii];
+				extra2[kk]=extra2[ii];
+				/* increment the new data counter */
+				kk++;
+	}}}
 	/* keep non-overlapping SSPs */
 	if(mode==2){
 		for(ii=0;ii<nssp2;ii++) {
 			tempstart=start2[ii];
 			tempstop=stop2[ii];
 			reject=0;
-			for(jj=0;jj<nssp1;jj++) {
-				/* if either the start or stop falls inside current screening-SSP, reject it */
-				if( (tempstart>=start1[jj]&&tempstart<=stop1[jj]) || (tempstop>=start1[jj]&&tempstop<=stop1[jj]) ) {
-					reject=1;
-					break;
-			}}
+			/* if either the start or stop falls inside any screening-SSP (inclusive of stop1), reject it */
+			if(xf_sspfind1_l(sspindex,nssp1,tempstart,&hint1)>=tempstart) reject=1;
+			else if(xf_sspfind1_l(sspindex,nssp1,tempstop,&hint2)>=tempstop) reject=1;
 			if(reject==0) {
 				start2[kk]=start2[ii];
 				stop2[kk]=stop2[ii];
@@ -82,6 +86,7 @@ long xf_screen_ssp2(long *start1, long *stop1, long nssp1, long *start2, long *s
 				kk++;
 	}}}
 
+	free(sspindex);
 	/* return new size of start2/stop2 arraps - this should be set to nssp2 by calling function */
 	return(kk);
 }
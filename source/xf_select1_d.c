@@ -0,0 +1,85 @@
+/*
+<TAGS>math stats</TAGS>
+
+DESCRIPTION:
+	Selection: find the kk-th smallest value in an array of doubles without a full sort
+	- introselect: quickselect with a median-of-3 pivot and a Hoare partition
+		- values equal to the pivot are split between both sides, so runs of equal values do not slow the search
+		- if the partitions shrink too slowly, the remaining range is sorted instead,
+		  so the worst case is O(N*log(N)) rather than O(N^2)
+	- average time is O(N)
+	- on return the array is partially ordered:
+		data[0] to data[kk-1] are <= data[kk]
+		data[kk+1] to data[nn-1] are >= data[kk]
+	- this allows several order-statistics to be found by selecting in ascending order,
+	  each time passing only the part of the array above the previous selection
+
+USES:
+	Percentiles and medians (see xf_percentile1_d, xf_percentile2_d)
+
+DEPENDENCY TREE:
+	int xf_compare1_d(const void *a, const void *b);
+
+ARGUMENTS:
+	double *data : input array - will be re-ordered
+	long nn      : number of elements in the array
+	long kk      : the zero-offset rank of the value to find (0 to nn-1)
+
+RETURN VALUE:
+	the kk-th smallest value, or NAN if kk is out of range
+	NOTE: behaviour for NAN values is not defined - remove these first
+
+SAMPLE CALL:
+	median= xf_select1_d(data,nn,(nn/2));
+*/
+
+#include <stdlib.h>
+#include <math.h>
+
+/* external functions start */
+int xf_compare1_d(const void *a, const void *b);
+/* external functions end */
+
+double xf_select1_d(double *data, long nn, long kk) {
+
+	long ii,jj,left,right,depth;
+	double aa,bb,cc,pivot,temp;
+
+	if(kk<0||kk>=nn) return(NAN);
+
+	left= 0;
+	right= nn-1;
+	/* allow about 2*log2(nn) partitioning steps before falling back to a sort */
+	for(ii=nn,depth=0;ii>0;ii/=2) depth+=2;
+
+	while(right>left) {
+
+		/* FALL BACK TO SORTING THE REMAINING RANGE IF PROGRESS IS TOO SLOW */
+		if(depth--<=0) {
+			qsort((data+left),(right-left+1),sizeof(double),xf_compare1_d);
+			break;
+		}
+
+		/* CHOOSE THE PIVOT: MEDIAN OF FIRST, MIDDLE AND LAST VALUES */
+		aa= data[left];
+		bb= data[left+(right-left)/2];
+		cc= data[right];
+		if(aa<bb) { if(bb<cc) pivot=bb; else if(aa<cc) pivot=cc; else pivot=aa; }
+		else { if(aa<cc) pivot=aa; else if(bb<cc) pivot=cc; else pivot=bb; }
+
+		/* PARTITION: [left,jj] <= pivot, [ii,right] >= pivot, anything between is equal to pivot */
+		ii= left; jj= right;
+		while(ii<=jj) {
+			while(data[ii]<pivot) ii++;
+			while(data[jj]>pivot) jj--;
+			if(ii<=jj) { temp=data[ii]; data[ii]=data[jj]; data[jj]=temp; ii++; jj--; }
+		}
+
+		/* CONTINUE IN THE PARTITION HOLDING kk */
+		if(kk<=jj) right= jj;
+		else if(kk>=ii) left= ii;
+		else break;
+	}
+
+	return(data[kk]);
+}
@@ -5,6 +5,9 @@ DESCRIPTION:
 	Modifies array data[xbin][ybin]
 	Note that if xsmooth=0 or ysmooth=0 the results may be unpredictable
 	6 November 2012: fix so that xsmooth or ysmooth can now be zero
+	18 October 2026: separable implementation (x then y), as for xf_smoothgauss2_d
+		- bins equal to "invalid" are excluded by normalised convolution
+		- bugfix: the kernel now includes the x-weights
 ************************************************************************/
 #include <math.h>
 #include <stdio.h>
@@ -12,61 +15,71 @@ DESCRIPTION:
 
 int xf_smooth2d_gaussd(double *data,int xbintot,int ybintot,int xsmooth,int ysmooth, double invalid) {
 
-	int x,y,p1,p2,xbin,ybin,xstart,xend,ystart,yend;
-	int xwinwidth=xsmooth+xsmooth+1;
-	int ywinwidth=ysmooth+ysmooth+1;
-	int Nmap=xbintot*ybintot, Nwin=xwinwidth*ywinwidth;
-	double temp1,temp2,temp3,xstd,ystd,*conv,*sdata;
+	int x,y,xbin,ybin,xstart,xend,ystart,yend;
+	long p1,Nmap=(long)xbintot*(long)ybintot;
+	double temp1,temp2,temp3,xstd,ystd,*xconv=NULL,*yconv=NULL,*snum=NULL,*sden=NULL,*rownum=NULL,*rowden=NULL;
 
+	if(xsmooth<0) xsmooth=0;
+	if(ysmooth<0) ysmooth=0;
 	xstd=(double)xsmooth*2.0;
 	ystd=(double)ysmooth*2.0;
 
 	/* INITIALISE TEMPORARY ARRAYS */
-	conv= (double *) malloc((Nwin+1)*sizeof(double)); if(conv==NULL) return(-1);
-	sdata= (double *) malloc((Nmap+1)*sizeof(double)); if(sdata==NULL) return(-1);
+	xconv= (double *) malloc((2*xsmooth+2)*sizeof(double));
+	yconv= (double *) malloc((2*ysmooth+2)*sizeof(double));
+	snum= (double *) malloc((Nmap+1)*sizeof(double));
+	sden= (double *) malloc((Nmap+1)*sizeof(double));
+	rownum= (double *) malloc((xbintot+1)*sizeof(double));
+	rowden= (double *) malloc((xbintot+1)*sizeof(double));
+	if(xconv==NULL||yconv==NULL||snum==NULL||sden==NULL||rownum==NULL||rowden==NULL) {
+		free(xconv); free(yconv); free(snum); free(sden); free(rownum); free(rowden);
+		return(-1);
+	}
 
-	/* CREATE GAUSSIAN KERNAL */
-	temp3=0.0;
-	for(y=-ysmooth;y<=ysmooth;y++) {
-		for(x=-xsmooth;x<=xsmooth;x++) {
-			p2=((y+ysmooth)*xwinwidth)+(x+xsmooth);
-			if(ysmooth<1) temp1=1; else temp1=exp(-y*y/ystd);
-			if(xsmooth<1) temp2=1; else temp1=exp(-x*x/xstd);
-			conv[p2] = temp1*temp2;
-			temp3+=conv[p2];
-	}}
-
-	/* NORMALISE THE KERNAL SO SUM OF WEIGHTS = 1.0 */
-	for(p2=0;p2<Nwin;p2++) conv[p2]/=temp3;
+	/* CREATE THE 1-DIMENSIONAL GAUSSIAN KERNALS */
+	for(x=-xsmooth;x<=xsmooth;x++) { if(xsmooth<1) xconv[x+xsmooth]=1.0; else xconv[x+xsmooth]=exp(-x*x/xstd); }
+	for(y=-ysmooth;y<=ysmooth;y++) { if(ysmooth<1) yconv[y+ysmooth]=1.0; else yconv[y+ysmooth]=exp(-y*y/ystd); }
 
-	/* SMOOTH THE 2-DIMENSIONAL ARRAY */
+	/* PASS 1: SMOOTH EACH ROW - weighted sum of valid data and of valid-bin weights */
 	for(ybin=0;ybin<ybintot;ybin++) {
-		ystart= ybin-ysmooth; if(ystart<0) ystart=0;
-		yend= ybin+ysmooth; if(yend>=ybintot) yend=(ybintot-1);
-
 		for(xbin=0;xbin<xbintot;xbin++) {
 			xstart= xbin-xsmooth; if(xstart<0) xstart=0;
 			xend = xbin+xsmooth; if(xend>=xbintot) xend=(xbintot-1);
 			temp2 = temp3 = 0.0;
-
-			/* calculate the weighted average for the block of bins surrounding [ybin,xbin]*/
-			for(y=ystart;y<=yend;y++) { /* the y-range of surrounding bins */
-				for(x=xstart;x<=xend;x++) { /* the x-range of surrounding bins */
-					p1 = y*xbintot+x; /* pointer to the datum at this x-y coordinate*/
-					p2= ((y-ybin)+ysmooth) * xwinwidth + ((x-xbin)+xsmooth); /* pointer to the correct kernel element */
-					if(data[p1]!=invalid) {
-						temp1 = conv[p2];
-						temp2 += temp1 * data[p1]; /* add up weighted data points in the window */
-						temp3 += temp1;	/* sum weights from visited bins - this should add to 1, ideally*/
-			}}}
-			if(temp3>0.0)	sdata[ybin*xbintot+xbin] = temp2/temp3; /* divide weighted mean by sum of weights - corrects for missing bins */
-			else 			sdata[ybin*xbintot+xbin] = data[ybin*xbintot+xbin]; /* otherwise, data is smae as original */
+			for(x=xstart;x<=xend;x++) {
+				p1= (long)ybin*xbintot+x;
+				if(data[p1]!=invalid) {
+					temp1 = xconv[x-xbin+xsmooth];
+					temp2 += temp1 * data[p1];
+					temp3 += temp1;
+			}}
+			p1= (long)ybin*xbintot+xbin;
+			snum[p1]= temp2;
+			sden[p1]= temp3;
 	}}
 
-	/* copy smoothed array to original data map */
-	for(x=0;x<Nmap;x++) data[x]=sdata[x];
+	/* PASS 2: SMOOTH EACH COLUMN, A ROW AT A TIME */
+	for(ybin=0;ybin<ybintot;ybin++) {
+		ystart= ybin-ysmooth; if(ystart<0) ystart=0;
+		yend= ybin+ysmooth; if(yend>=ybintot) yend=(ybintot-1);
+		for(xbin=0;xbin<xbintot;xbin++) rownum[xbin]=rowden[xbin]=0.0;
+		for(y=ystart;y<=yend;y++) {
+			temp1= yconv[y-ybin+ysmooth];
+			p1= (long)y*xbintot;
+			for(xbin=0;xbin<xbintot;xbin++) {
+				rownum[xbin]+= temp1*snum[p1+xbin];
+				rowden[xbin]+= temp1*sden[p1+xbin];
+		}}
+		/* divide weighted sum by sum of weights - corrects for missing bins - otherwise, data is same as original */
+		p1= (long)ybin*xbintot;
+		for(xbin=0;xbin<xbintot;xbin++) if(rowden[xbin]>0.0) data[p1+xbin]= rownum[xbin]/rowden[xbin];
+	}
 
-	free(conv);
-	free(sdata);
+	free(xconv);
+	free(yconv);
+	free(snum);
+	free(sden);
+	free(rownum);
+	free(rowden);
 	return(0);
 }
@@ -0,0 +1,220 @@
+/*
+<TAGS>signal_processing filter</TAGS>
+DESCRIPTION:
+	- Gaussian smoothing of a batch of equal-sized 2-dimensional matrices
+	- gives the same result as calling xf_smoothgauss2_d on each matrix, but:
+		- kernels, FFT configurations and work-arrays are set up once for the whole batch
+		- large kernels can optionally be applied by FFT convolution (setfft)
+	- smoothing is separable: each row is smoothed, then each column
+	- NAN and INF are treated as missing data (normalised convolution)
+		- the smoothed data and the smoothed valid-bin mask are divided
+		- bins with no valid data in the kernel window are left unchanged
+	- kernel weights for offset x are exp(-x*x/(2*xsmooth)), x= -xsmooth to +xsmooth
+	- FFT convolution uses single-precision (kiss_fft), so results agree with the
+	  direct method to about 4 significant figures of the largest value in each line
+		- bins where the valid data carries little of the kernel weight (e.g. next
+		  to large areas of missing data) are recalculated directly, as rounding
+		  errors would otherwise dominate
+		- rounding errors scale with the largest value in the line, so small values
+		  near a large peak can be badly wrong (even negative): use the direct method
+		  (setfft=0) unless the data has a limited dynamic range and speed matters
+
+USES:
+	- smoothing many rate-maps, spectrograms or other matrices at once
+
+DEPENDENCY TREE:
+	kiss_fftr.h
+
+ARGUMENTS:
+	double *data  : input, nmaps matrices of xbintot*ybintot, stored one after another - modified
+	long nmaps    : number of matrices in data
+	long xbintot  : matrix width
+	long ybintot  : matrix height
+	long xsmooth  : half-width of the kernel in the x-dimension (0= no smoothing in x)
+	long ysmooth  : half-width of the kernel in the y-dimension (0= no smoothing in y)
+	int setfft    : use FFT convolution? (0=NO, 1=YES, -1=AUTO: only if the kernel is large)
+		- 0 is recommended, as it is exact for any data (see above)
+	char *message : pre-allocated array to hold error message
+
+RETURN VALUE:
+	0 on success, -1 on error
+
+SAMPLE CALL:
+	z= xf_smoothgauss3_d(multimatrix,nmatrices,width,height,2,2,0,message);
+	if(z!=0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "kiss_fftr.h"
+/* kernel full-width above which FFT convolution is used when setfft=-1 */
+#define XF_SMOOTHGAUSS3_FFTMIN 49
+/* with FFT, bins with less than this proportion of the total kernel weight are recalculated directly */
+#define XF_SMOOTHGAUSS3_FFTTOL 0.001
+
+/* state for convolving lines of one length with one kernel */
+typedef struct {
+	long n,smooth,nfft;
+	double *kernel;
+	kiss_fftr_cfg fwd,inv;
+	kiss_fft_cpx *hfft,*xfft;
+	kiss_fft_scalar *buff;
+} xf_smoothgauss3_d_line;
+
+static void xf_smoothgauss3_d_free(xf_smoothgauss3_d_line *ln) {
+	free(ln->kernel);
+	free(ln->fwd);
+	free(ln->inv);
+	free(ln->hfft);
+	free(ln->xfft);
+	free(ln->buff);
+}
+
+/* build the kernel and, if required, the FFT configuration and kernel spectrum */
+static int xf_smoothgauss3_d_setup(xf_smoothgauss3_d_line *ln, long n, long smooth, int setfft) {
+	long ii;
+	double std=(double)smooth*2.0;
+	ln->n= n;
+	ln->smooth= smooth;
+	ln->nfft= 0;
+	ln->kernel= malloc((2*smooth+1)*sizeof(*ln->kernel));
+	if(ln->kernel==NULL) return(-1);
+	for(ii=-smooth;ii<=smooth;ii++) { if(smooth<1) ln->kernel[ii+smooth]=1.0; else ln->kernel[ii+smooth]=exp(-ii*ii/std); }
+	if(setfft==-1) setfft= ((2*smooth+1)>=XF_SMOOTHGAUSS3_FFTMIN);
+	if(setfft!=1 || smooth<1) return(0);
+	/* FFT length must allow linear (not circular) convolution: n+2*smooth */
+	ln->nfft= kiss_fftr_next_fast_size_real(n+2*smooth);
+	ln->fwd= kiss_fftr_alloc(ln->nfft,0,0,0);
+	ln->inv= kiss_fftr_alloc(ln->nfft,1,0,0);
+	ln->hfft= malloc((ln->nfft/2+1)*sizeof(*ln->hfft));
+	ln->xfft= malloc((ln->nfft/2+1)*sizeof(*ln->xfft));
+	ln->buff= malloc(ln->nfft*sizeof(*ln->buff));
+	if(ln->fwd==NULL||ln->inv==NULL||ln->hfft==NULL||ln->xfft==NULL||ln->buff==NULL) return(-1);
+	/* kernel spectrum - includes the 1/nfft scaling of the inverse transform */
+	for(ii=0;ii<ln->nfft;ii++) ln->buff[ii]= (ii<=2*smooth) ? ln->kernel[ii]/(double)ln->nfft : 0.0;
+	kiss_fftr(ln->fwd,ln->buff,ln->hfft);
+	return(0);
+}
+
+/* convolve n values spaced by stride in "in", writing to "out" with the same spacing */
+static void xf_smoothgauss3_d_conv(xf_smoothgauss3_d_line *ln, double *in, double *out, long stride) {
+	long ii,jj,start,end,n=ln->n,smooth=ln->smooth;
+	double aa,ar,ai,*kernel=ln->kernel;
+	if(ln->nfft==0) {
+		for(ii=0;ii<n;ii++) {
+			start= ii-smooth; if(start<0) start=0;
+			end= ii+smooth; if(end>=n) end=n-1;
+			for(jj=start,aa=0.0;jj<=end;jj++) aa+= kernel[jj-ii+smooth]*in[jj*stride];
+			out[ii*stride]= aa;
+		}
+	}
+	else {
+		for(ii=0;ii<n;ii++) ln->buff[ii]= in[ii*stride];
+		for(ii=n;ii<ln->nfft;ii++) ln->buff[ii]= 0.0;
+		kiss_fftr(ln->fwd,ln->buff,ln->xfft);
+		for(ii=0;ii<=ln->nfft/2;ii++) {
+			ar= ln->xfft[ii].r*ln->hfft[ii].r - ln->xfft[ii].i*ln->hfft[ii].i;
+			ai= ln->xfft[ii].r*ln->hfft[ii].i + ln->xfft[ii].i*ln->hfft[ii].r;
+			ln->xfft[ii].r= ar;
+			ln->xfft[ii].i= ai;
+		}
+		kiss_fftri(ln->inv,ln->xfft,ln->buff);
+		/* the centre of the kernel is at offset "smooth" */
+		for(ii=0;ii<n;ii++) out[ii*stride]= ln->buff[ii+smooth];
+	}
+}
+
+int xf_smoothgauss3_d(double *data, long nmaps, long xbintot, long ybintot, long xsmooth, long ysmooth, int setfft, char *message) {
+
+	char *thisfunc="xf_smoothgauss3_d\0";
+	long ii,jj,kk,x,y,x1,x2,y1,y2,x3,y3,nmap,status=-1;
+	long *valid=NULL;
+	double aa,bb,ww,wmin=0.0,*pdata,*snum=NULL,*sden=NULL,*tnum=NULL,*tden=NULL;
+	xf_smoothgauss3_d_line xline={0},yline={0};
+
+	if(nmaps<0 || xbintot<1 || ybintot<1) { sprintf(message,"%s [ERROR]: invalid matrix size (%ld x %ld x %ld)",thisfunc,nmaps,xbintot,ybintot); return(-1); }
+	if(setfft<-1 || setfft>1) { sprintf(message,"%s [ERROR]: invalid FFT setting (%d) - must be -1, 0 or 1",thisfunc,setfft); return(-1); }
+	if(xsmooth<0) xsmooth=0;
+	if(ysmooth<0) ysmooth=0;
+	nmap= xbintot*ybintot;
+
+	/* SET UP KERNELS, FFT CONFIGURATIONS AND WORK ARRAYS FOR THE WHOLE BATCH */
+	if(xf_smoothgauss3_d_setup(&xline,xbintot,xsmooth,setfft)!=0 ||
+		xf_smoothgauss3_d_setup(&yline,ybintot,ysmooth,setfft)!=0
+	) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+	snum= malloc(nmap*sizeof(*snum));
+	sden= malloc(nmap*sizeof(*sden));
+	tnum= malloc(nmap*sizeof(*tnum));
+	tden= malloc(nmap*sizeof(*tden));
+	valid= malloc((xbintot+1)*(ybintot+1)*sizeof(*valid));
+	if(snum==NULL||sden==NULL||tnum==NULL||tden==NULL||valid==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+	/* minimum valid weight for FFT results to be used */
+	if(xline.nfft>0 || yline.nfft>0) {
+		for(x=0,aa=0.0;x<=2*xsmooth;x++) aa+= xline.kernel[x];
+		for(y=0,bb=0.0;y<=2*ysmooth;y++) bb+= yline.kernel[y];
+		wmin= aa*bb*XF_SMOOTHGAUSS3_FFTTOL;
+	}
+
+	for(kk=0;kk<nmaps;kk++) {
+		pdata= data+kk*nmap;
+
+		/* SPLIT INTO VALID DATA (ZERO FOR MISSING) AND VALID-BIN MASK, AND BUILD A SUMMED-AREA TABLE OF VALID BINS */
+		/* - valid[(y+1)*(xbintot+1)+(x+1)] = number of valid bins in rows 0-y and columns 0-x */
+		for(x=0;x<=xbintot;x++) valid[x]=0;
+		for(y=0;y<ybintot;y++) {
+			valid[(y+1)*(xbintot+1)]=0;
+			for(x=0;x<xbintot;x++) {
+				ii= y*xbintot+x;
+				if(isfinite(pdata[ii])) { snum[ii]=pdata[ii]; sden[ii]=1.0; }
+				else { snum[ii]=0.0; sden[ii]=0.0; }
+				valid[(y+1)*(xbintot+1)+(x+1)]= valid[y*(xbintot+1)+(x+1)] + valid[(y+1)*(xbintot+1)+x] - valid[y*(xbintot+1)+x] + (long)sden[ii];
+		}}
+
+		/* PASS 1: SMOOTH THE ROWS */
+		for(y=0;y<ybintot;y++) {
+			xf_smoothgauss3_d_conv(&xline,snum+y*xbintot,tnum+y*xbintot,1);
+			xf_smoothgauss3_d_conv(&xline,sden+y*xbintot,tden+y*xbintot,1);
+		}
+		/* PASS 2: SMOOTH THE COLUMNS */
+		for(x=0;x<xbintot;x++) {
+			xf_smoothgauss3_d_conv(&yline,tnum+x,snum+x,xbintot);
+			xf_smoothgauss3_d_conv(&yline,tden+x,sden+x,xbintot);
+		}
+
+		/* DIVIDE - ONLY WHERE THE WINDOW CONTAINS AT LEAST ONE VALID BIN - results go to tnum, as pdata may be needed below */
+		for(y=0;y<ybintot;y++) {
+			y1= y-ysmooth; if(y1<0) y1=0;
+			y2= y+ysmooth+1; if(y2>ybintot) y2=ybintot;
+			for(x=0;x<xbintot;x++) {
+				x1= x-xsmooth; if(x1<0) x1=0;
+				x2= x+xsmooth+1; if(x2>xbintot) x2=xbintot;
+				jj= valid[y2*(xbintot+1)+x2] - valid[y1*(xbintot+1)+x2] - valid[y2*(xbintot+1)+x1] + valid[y1*(xbintot+1)+x1];
+				ii= y*xbintot+x;
+				tnum[ii]= pdata[ii];
+				if(jj<1) continue;
+				if(sden[ii]>wmin) { tnum[ii]= snum[ii]/sden[ii]; continue; }
+				/* too little valid weight for FFT precision: direct calculation */
+				for(y3=y1,aa=bb=0.0;y3<y2;y3++) {
+					for(x3=x1;x3<x2;x3++) {
+						if(!isfinite(pdata[y3*xbintot+x3])) continue;
+						ww= yline.kernel[y3-y+ysmooth]*xline.kernel[x3-x+xsmooth];
+						aa+= ww*pdata[y3*xbintot+x3];
+						bb+= ww;
+				}}
+				tnum[ii]= aa/bb;
+		}}
+		for(ii=0;ii<nmap;ii++) pdata[ii]= tnum[ii];
+	}
+	status= 0;
+
+END:
+	xf_smoothgauss3_d_free(&xline);
+	xf_smoothgauss3_d_free(&yline);
+	free(snum);
+	free(sden);
+	free(tnum);
+	free(tden);
+	free(valid);
+	return(status);
+}
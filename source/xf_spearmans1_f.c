@@ -3,6 +3,7 @@
 
 DESCRIPTION :
 	Find the Spearman's rank correlation for pairs of data
+	- tied values are given the average of their ranks, so rho matches xf_spearmans2_d
 
 USES:
 
@@ -30,9 +31,9 @@ void xf_qsortindex1_f(float *data, long *index,long nn);
 double xf_spearmans1_f(float *xdat1, float *ydat1, long ndata, char *message) {
 
 	char *thisfunc="xf_spearmans1_f\0";
-	long *xrank=NULL,*yrank=NULL,*tempindex=NULL,ii,jj,kk,mm,nn;
+	long *tempindex=NULL,ii,jj,kk,mm,nn;
 	float *xdat2=NULL,*ydat2=NULL,*tempdata=NULL;
-	double rankmean,aa,bb,SUMx,SUMy,SUMx2,SUMy2,SUMxy, SSx,SSy,SPxy,rho;
+	double *xrank=NULL,*yrank=NULL,rankmean,aa,bb,SUMx,SUMy,SUMx2,SUMy2,SUMxy, SSx,SSy,SPxy,rho;
 
 	/* ALLOCATE MEMORY */
 	xdat2= malloc(ndata * sizeof *xdat2);
@@ -68,22 +69,31 @@ double xf_spearmans1_f(float *xdat1, float *ydat1, long ndata, char *message) {
 	/* - sort the data+index - index preserves original data-position */
 	xf_qsortindex1_f(tempdata,tempindex,nn);
 	/* assign ranks to origial data at each saved-position (tempindex) according to the current sorted position (ii) */
-	for(ii=0;ii<nn;ii++) xrank[tempindex[ii]]= ii;
+	/* - each run of tied values gets the mean of its ranks */
+	for(ii=0;ii<nn;ii=jj) {
+		for(jj=ii+1;jj<nn && tempdata[jj]==tempdata[ii];jj++);
+		aa= 0.5*(double)(ii+jj-1);
+		for(kk=ii;kk<jj;kk++) xrank[tempindex[kk]]= aa;
+	}
 
 	/* REPEAT FOR THE Y-DATA */
 	for(ii=0;ii<nn;ii++) { tempdata[ii]= ydat2[ii]; tempindex[ii]= ii; }
 	xf_qsortindex1_f(tempdata,tempindex,nn);
-	for(ii=0;ii<nn;ii++) yrank[tempindex[ii]]= ii;
+	for(ii=0;ii<nn;ii=jj) {
+		for(jj=ii+1;jj<nn && tempdata[jj]==tempdata[ii];jj++);
+		aa= 0.5*(double)(ii+jj-1);
+		for(kk=ii;kk<jj;kk++) yrank[tempindex[kk]]= aa;
+	}
 
-	// TEST	for(ii=0;ii<nn;ii++) fprintf(stderr,"%f	%ld	%f	%ld\n",xdat2[ii],xrank[ii],ydat2[ii],yrank[ii]);
+	// TEST	for(ii=0;ii<nn;ii++) fprintf(stderr,"%f	%g	%f	%g\n",xdat2[ii],xrank[ii],ydat2[ii],yrank[ii]);
 
 	/********************************************************************************/
 	/* CALCULATE SPEARMAN'S RHO (PEARSON'S R FOR THE PAIRED RANKS, ZEROED TO THE RANK-MEAN) */
 	/********************************************************************************/
 	SUMx=SUMy=SUMx2=SUMy2=SUMxy=0.00;
 	for(ii=0;ii<nn;ii++) {
-		aa= (double)xrank[ii]-rankmean;
-		bb= (double)yrank[ii]-rankmean;
+		aa= xrank[ii]-rankmean;
+		bb= yrank[ii]-rankmean;
 		SUMx+= aa;
 		SUMy+= bb;
 		SUMx2+= aa*aa;
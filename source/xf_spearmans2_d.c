@@ -0,0 +1,204 @@
+/*
+<TAGS>stats</TAGS>
+
+DESCRIPTION:
+	Spearman's rank correlation (and optionally Pearson's r) for every pair of columns in a table
+	- each column is ranked once (ties get the average rank, see xf_rank1_d)
+	- the ranks are centred and scaled to unit length, so each rho is a single dot-product
+	- dot-products are computed in blocks of columns and rows which stay in cache
+	- if compiled with OpenMP (-fopenmp), blocks are calculated in parallel
+	- optional permutation test: the rows of the cached ranks are shuffled and all pairs re-tested
+		- p = (1 + number of permutations with |rho| >= observed |rho|) / (1 + nperm)
+		- the same shuffle is used for every pair, so each permutation costs one pass through the blocks
+	- rows with a non-finite value in any column are excluded (listwise deletion)
+	- for a column with no variability, rho (and r) with all other columns is zero
+
+USES:
+	Correlation screens: testing many behavioural and neural variables against each other
+
+DEPENDENCY TREE:
+	long xf_rank1_d(double *data, double *rank, long nn, char *message);
+		void xf_qsortindex1_d(double *data, long *index,long nn);
+
+ARGUMENTS:
+	double *data         : input, table of nrows x ncols values, stored row by row: data[row*ncols+col]
+	long nrows           : input, number of rows
+	long ncols           : input, number of columns (must be >0)
+	double *rho          : output, pre-allocated ncols*ncols array for Spearman's rho: rho[col1*ncols+col2]
+	double *rpear        : output, pre-allocated ncols*ncols array for Pearson's r (NULL to skip)
+	long nperm           : input, number of permutations (0 to skip the permutation test)
+	unsigned long seed   : input, seed for the permutations - the same seed gives the same result
+	double *pperm        : output, pre-allocated ncols*ncols array for permutation p-values (ignored if nperm=0)
+	char *message        : output, pre-allocated array to hold error message
+
+RETURN VALUE:
+	number of rows used on success, -1 on error
+	output matrices are symmetrical, with 1 (or 0 for a constant column) on the diagonal
+	if fewer than 3 rows are usable, all results are NAN
+
+SAMPLE CALL:
+	nn= xf_spearmans2_d(data,nrows,ncols,rho,NULL,1000,seed,pperm,message);
+	if(nn<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#define XF_SPEARMANS2_BLOCKC 8
+#define XF_SPEARMANS2_BLOCKR 1024
+
+/* external functions start */
+long xf_rank1_d(double *data, double *rank, long nn, char *message);
+/* external functions end */
+
+/* dot-products of column ii in z1 with column jj (>ii) in z2 - z1 and z2 hold nn values per column */
+static void xf_spearmans2_d_dot(double *z1, double *z2, long nn, long ncols, double *out) {
+	long ib,ii,jj,row0,row1,kk;
+	long nblock= (ncols+XF_SPEARMANS2_BLOCKC-1)/XF_SPEARMANS2_BLOCKC;
+	for(ii=0;ii<(ncols*ncols);ii++) out[ii]=0.0;
+	/* each block of rows (ii) is written by one thread only */
+	#pragma omp parallel for schedule(dynamic) private(ii,jj,row0,row1,kk)
+	for(ib=0;ib<nblock;ib++) {
+		long i0=ib*XF_SPEARMANS2_BLOCKC,i1=i0+XF_SPEARMANS2_BLOCKC,j0;
+		if(i1>ncols) i1=ncols;
+		for(j0=i0;j0<ncols;j0+=XF_SPEARMANS2_BLOCKC) {
+			long j1= j0+XF_SPEARMANS2_BLOCKC; if(j1>ncols) j1=ncols;
+			for(row0=0;row0<nn;row0+=XF_SPEARMANS2_BLOCKR) {
+				row1= row0+XF_SPEARMANS2_BLOCKR; if(row1>nn) row1=nn;
+				for(ii=i0;ii<i1;ii++) {
+					double *x=z1+ii*nn;
+					for(jj=(j0>ii?j0:ii+1);jj<j1;jj++) {
+						double *y=z2+jj*nn,sum=0.0;
+						for(kk=row0;kk<row1;kk++) sum+= x[kk]*y[kk];
+						out[ii*ncols+jj]+= sum;
+		}}}}
+	}
+}
+
+/* centre a column and scale it to unit length - returns 0 if the column has no variability */
+static int xf_spearmans2_d_scale(double *z, long nn) {
+	long kk;
+	double mean=0.0,ss=0.0;
+	for(kk=0;kk<nn;kk++) mean+= z[kk];
+	mean/= (double)nn;
+	for(kk=0;kk<nn;kk++) { z[kk]-= mean; ss+= z[kk]*z[kk]; }
+	if(ss<=0.0) { for(kk=0;kk<nn;kk++) z[kk]=0.0; return(0); }
+	ss= 1.0/sqrt(ss);
+	for(kk=0;kk<nn;kk++) z[kk]*= ss;
+	return(1);
+}
+
+/* splitmix64: small, fast generator - enough for shuffling */
+static uint64_t xf_spearmans2_d_rand(uint64_t *state) {
+	uint64_t zz= (*state+= 0x9E3779B97F4A7C15ULL);
+	zz= (zz^(zz>>30))*0xBF58476D1CE4E5B9ULL;
+	zz= (zz^(zz>>27))*0x94D049BB133111EBULL;
+	return(zz^(zz>>31));
+}
+
+long xf_spearmans2_d(double *data, long nrows, long ncols, double *rho, double *rpear, long nperm, unsigned long seed, double *pperm, char *message) {
+
+	char *thisfunc="xf_spearmans2_d\0";
+	int *valid=NULL;
+	long ii,jj,kk,nn,perm,*order=NULL,*count=NULL;
+	double aa,*zrank=NULL,*zperm=NULL,*tempdata=NULL,*dot=NULL;
+	uint64_t state;
+
+	if(ncols<1) { sprintf(message,"%s [ERROR]: invalid number of columns (%ld)",thisfunc,ncols); return(-1); }
+	if(nrows<0) { sprintf(message,"%s [ERROR]: invalid number of rows (%ld)",thisfunc,nrows); return(-1); }
+	if(nperm<0) { sprintf(message,"%s [ERROR]: invalid number of permutations (%ld)",thisfunc,nperm); return(-1); }
+
+	/* FIND THE ROWS WITH FINITE VALUES IN EVERY COLUMN */
+	order= malloc((nrows+1)*sizeof(*order));
+	if(order==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); return(-1); }
+	for(ii=nn=0;ii<nrows;ii++) {
+		for(jj=0;jj<ncols;jj++) if(!isfinite(data[ii*ncols+jj])) break;
+		if(jj==ncols) order[nn++]= ii;
+	}
+	if(nn<3) {
+		for(ii=0;ii<(ncols*ncols);ii++) { rho[ii]=NAN; if(rpear!=NULL) rpear[ii]=NAN; if(nperm>0) pperm[ii]=NAN; }
+		free(order);
+		sprintf(message,"%s [WARNING]: fewer than 3 valid rows",thisfunc);
+		return(nn);
+	}
+
+	zrank= malloc((nn*ncols+1)*sizeof(*zrank));
+	tempdata= malloc((nn+1)*sizeof(*tempdata));
+	dot= malloc((ncols*ncols+1)*sizeof(*dot));
+	valid= malloc((ncols+1)*sizeof(*valid));
+	if(zrank==NULL||tempdata==NULL||dot==NULL||valid==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto ERROR; }
+
+	/* PEARSON'S R: SCALED RAW VALUES - zrank is used as temporary storage */
+	if(rpear!=NULL) {
+		for(jj=0;jj<ncols;jj++) {
+			for(kk=0;kk<nn;kk++) zrank[jj*nn+kk]= data[order[kk]*ncols+jj];
+			valid[jj]= xf_spearmans2_d_scale((zrank+jj*nn),nn);
+		}
+		xf_spearmans2_d_dot(zrank,zrank,nn,ncols,dot);
+		for(ii=0;ii<ncols;ii++) {
+			rpear[ii*ncols+ii]= (double)valid[ii];
+			for(jj=ii+1;jj<ncols;jj++) rpear[ii*ncols+jj]= rpear[jj*ncols+ii]= dot[ii*ncols+jj];
+		}
+	}
+
+	/* RANK EACH COLUMN ONCE, THEN CENTRE AND SCALE THE RANKS */
+	for(jj=0;jj<ncols;jj++) {
+		for(kk=0;kk<nn;kk++) tempdata[kk]= data[order[kk]*ncols+jj];
+		if(xf_rank1_d(tempdata,(zrank+jj*nn),nn,message)<0) goto ERROR;
+		valid[jj]= xf_spearmans2_d_scale((zrank+jj*nn),nn);
+	}
+	xf_spearmans2_d_dot(zrank,zrank,nn,ncols,dot);
+	for(ii=0;ii<ncols;ii++) {
+		rho[ii*ncols+ii]= (double)valid[ii];
+		for(jj=ii+1;jj<ncols;jj++) rho[ii*ncols+jj]= rho[jj*ncols+ii]= dot[ii*ncols+jj];
+	}
+
+	/* PERMUTATION TEST: SHUFFLE THE ROWS OF THE CACHED RANKS - "order" is re-used to hold the shuffle */
+	if(nperm>0) {
+		zperm= malloc((nn*ncols+1)*sizeof(*zperm));
+		count= calloc((ncols*ncols+1),sizeof(*count));
+		if(zperm==NULL||count==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto ERROR; }
+		state= (uint64_t)seed;
+		for(kk=0;kk<nn;kk++) order[kk]= kk;
+		for(perm=0;perm<nperm;perm++) {
+			/* Fisher-Yates shuffle */
+			for(kk=nn-1;kk>0;kk--) {
+				ii= (long)((double)(xf_spearmans2_d_rand(&state)>>11)*(1.0/9007199254740992.0)*(double)(kk+1));
+				jj=order[kk]; order[kk]=order[ii]; order[ii]=jj;
+			}
+			for(jj=0;jj<ncols;jj++) for(kk=0;kk<nn;kk++) zperm[jj*nn+kk]= zrank[jj*nn+order[kk]];
+			xf_spearmans2_d_dot(zrank,zperm,nn,ncols,dot);
+			/* a small tolerance allows for rounding when a shuffle reproduces the observed ranks */
+			for(ii=0;ii<ncols;ii++) for(jj=ii+1;jj<ncols;jj++) {
+				aa= fabs(rho[ii*ncols+jj]);
+				if(fabs(dot[ii*ncols+jj])>=(aa-1e-12)) count[ii*ncols+jj]++;
+			}
+		}
+		for(ii=0;ii<ncols;ii++) {
+			pperm[ii*ncols+ii]= 0.0;
+			for(jj=ii+1;jj<ncols;jj++) pperm[ii*ncols+jj]= pperm[jj*ncols+ii]= (double)(count[ii*ncols+jj]+1)/(double)(nperm+1);
+		}
+	}
+
+	free(order);
+	free(zrank);
+	free(tempdata);
+	free(dot);
+	free(valid);
+	if(zperm!=NULL) free(zperm);
+	if(count!=NULL) free(count);
+	sprintf(message,"%s [OK]",thisfunc);
+	return(nn);
+
+ERROR:
+	if(order!=NULL) free(order);
+	if(zrank!=NULL) free(zrank);
+	if(tempdata!=NULL) free(tempdata);
+	if(dot!=NULL) free(dot);
+	if(valid!=NULL) free(valid);
+	if(zperm!=NULL) free(zperm);
+	if(count!=NULL) free(count);
+	return(-1);
+}
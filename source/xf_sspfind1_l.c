@@ -0,0 +1,64 @@
+/*
+<TAGS>screen time</TAGS>
+DESCRIPTION:
+	- look up a timestamp in an SSP index built by xf_sspindex1_l
+	- returns the largest stop of all SSPs starting at or before the timestamp
+	- this single number answers the usual screening questions:
+		time inside any SSP (start <= time < stop)   : result > time
+		time inside any SSP (start <= time <= stop)  : result >= time
+		range t1-t2 inside a single SSP              : xf_sspfind1_l(index,nssp,t1,&hint) >= t2
+	- the search starts from the position of the previous result (hint) and
+	  gallops outwards, so sorted timestamps are found in O(1) amortised time
+
+USES:
+	- screening large numbers of timestamps against many time-windows
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	long *index : index created by xf_sspindex1_l
+	long nssp   : number of SSPs in the index
+	long tt     : the timestamp to look up
+	long *hint  : position of the previous look-up - initialize to 0, updated by this function
+
+RETURN VALUE:
+	the largest stop of SSPs starting at or before tt
+	LONG_MIN if there are no such SSPs
+
+SAMPLE CALL:
+	see xf_sspindex1_l
+*/
+
+#include <limits.h>
+
+long xf_sspfind1_l(long *index, long nssp, long tt, long *hint) {
+
+	long lo,hi,mid,step;
+
+	if(nssp<1) return(LONG_MIN);
+	lo= *hint;
+	if(lo<0 || lo>=nssp) lo=0;
+
+	/* BRACKET THE TARGET SO THAT index[lo] <= tt < index[hi] (lo may be -1, hi may be nssp) */
+	if(index[lo]<=tt) {
+		step=1; hi=lo+1;
+		while(hi<nssp && index[hi]<=tt) { lo=hi; step*=2; hi=lo+step; }
+		if(hi>nssp) hi=nssp;
+	}
+	else {
+		step=1; hi=lo; lo=hi-1;
+		while(lo>=0 && index[lo]>tt) { hi=lo; step*=2; lo=hi-step; }
+		if(lo<-1) lo=-1;
+	}
+	/* BINARY SEARCH WITHIN THE BRACKET */
+	while((hi-lo)>1) {
+		mid= lo+(hi-lo)/2;
+		if(index[mid]<=tt) lo=mid;
+		else hi=mid;
+	}
+
+	if(lo<0) { *hint=0; return(LONG_MIN); }
+	*hint=lo;
+	return(index[nssp+lo]);
+}
@@ -0,0 +1,82 @@
+/*
+<TAGS>screen time</TAGS>
+DESCRIPTION:
+	- build a sorted index of start-stop pairs (SSPs) for fast screening
+	- double-precision version of xf_sspindex1_l, for times in seconds etc.
+	- the index holds the starts in ascending order, and for each position the
+	  largest stop of all SSPs starting at or before that position
+	- SSPs may be unsorted or overlapping
+	- use with xf_sspfind1_d to test times or ranges in O(log(nssp)) time
+
+USES:
+	- screening lines of text with time-columns against many time-windows
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	double *start : input array of start-times
+	double *stop  : input array of stop-times
+	long nssp     : number of SSPs in total
+	char *message : pre-allocated array to hold error message
+
+RETURN VALUE:
+	success: pointer to the index, an array of 2*nssp elements (free when done)
+		[0 to nssp-1]      : sorted starts
+		[nssp to 2*nssp-1] : running maximum of the stops
+	error: NULL
+
+SAMPLE CALL: keep times falling in any SSP (start <= time <= stop)
+
+	double *sspindex=NULL;
+	long hint=0;
+	sspindex= xf_sspindex1_d(start,stop,nssp,message);
+	if(sspindex==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	for(ii=kk=0;ii<nn;ii++) if(xf_sspfind1_d(sspindex,nssp,time[ii],&hint)>=time[ii]) time[kk++]= time[ii];
+	free(sspindex);
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct { double start; double stop; } xf_sspindex1_d_pair;
+
+static int xf_sspindex1_d_compare(const void *a, const void *b) {
+	double aa= ((xf_sspindex1_d_pair *)a)->start, bb= ((xf_sspindex1_d_pair *)b)->start;
+	if(aa<bb) return (-1);
+	else if(aa>bb) return (1);
+	else return (0);
+}
+
+double *xf_sspindex1_d(double *start, double *stop, long nssp, char *message) {
+
+	char *thisfunc="xf_sspindex1_d\0";
+	long ii;
+	double *index=NULL;
+	xf_sspindex1_d_pair *pairs=NULL;
+
+	if(nssp<0) { sprintf(message,"%s [ERROR]: invalid number of SSPs (%ld)",thisfunc,nssp); return(NULL); }
+
+	index= malloc((2*nssp+1)*sizeof(*index));
+	pairs= malloc((nssp+1)*sizeof(*pairs));
+	if(index==NULL||pairs==NULL) {
+		sprintf(message,"%s [ERROR]: insufficient memory",thisfunc);
+		if(index!=NULL) free(index);
+		if(pairs!=NULL) free(pairs);
+		return(NULL);
+	}
+
+	/* SORT THE SSPS BY START-TIME */
+	for(ii=0;ii<nssp;ii++) { pairs[ii].start= start[ii]; pairs[ii].stop= stop[ii]; }
+	qsort(pairs,nssp,sizeof(*pairs),xf_sspindex1_d_compare);
+
+	/* STORE THE STARTS AND THE RUNNING MAXIMUM OF THE STOPS */
+	for(ii=0;ii<nssp;ii++) {
+		index[ii]= pairs[ii].start;
+		index[nssp+ii]= pairs[ii].stop;
+		if(ii>0 && index[nssp+ii-1]>index[nssp+ii]) index[nssp+ii]= index[nssp+ii-1];
+	}
+
+	free(pairs);
+	return(index);
+}
@@ -0,0 +1,80 @@
+/*
+<TAGS>screen time</TAGS>
+DESCRIPTION:
+	- build a sorted index of start-stop pairs (SSPs) for fast screening
+	- the index holds the starts in ascending order, and for each position the
+	  largest stop of all SSPs starting at or before that position
+	- SSPs may be unsorted or overlapping
+	- use with xf_sspfind1_l to test timestamps or ranges in O(log(nssp)) time,
+	  or O(1) amortised time if the timestamps are themselves sorted
+
+USES:
+	- screening large numbers of timestamps against many time-windows
+
+DEPENDENCY TREE:
+	No dependencies
+
+ARGUMENTS:
+	long *start : input array of start-times
+	long *stop  : input array of stop-times
+	long nssp   : number of SSPs in total
+	char *message : pre-allocated array to hold error message
+
+RETURN VALUE:
+	success: pointer to the index, an array of 2*nssp elements (free when done)
+		[0 to nssp-1]      : sorted starts
+		[nssp to 2*nssp-1] : running maximum of the stops
+	error: NULL
+
+SAMPLE CALL: keep timestamps falling in any SSP (start <= time < stop)
+
+	long *sspindex=NULL,hint=0;
+	sspindex= xf_sspindex1_l(start,stop,nssp,message);
+	if(sspindex==NULL) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	for(ii=kk=0;ii<nn;ii++) if(xf_sspfind1_l(sspindex,nssp,time[ii],&hint)>time[ii]) time[kk++]= time[ii];
+	free(sspindex);
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct { long start; long stop; } xf_sspindex1_l_pair;
+
+static int xf_sspindex1_l_compare(const void *a, const void *b) {
+	long aa= ((xf_sspindex1_l_pair *)a)->start, bb= ((xf_sspindex1_l_pair *)b)->start;
+	if(aa<bb) return (-1);
+	else if(aa>bb) return (1);
+	else return (0);
+}
+
+long *xf_sspindex1_l(long *start, long *stop, long nssp, char *message) {
+
+	char *thisfunc="xf_sspindex1_l\0";
+	long ii,*index=NULL;
+	xf_sspindex1_l_pair *pairs=NULL;
+
+	if(nssp<0) { sprintf(message,"%s [ERROR]: invalid number of SSPs (%ld)",thisfunc,nssp); return(NULL); }
+
+	index= malloc((2*nssp+1)*sizeof(*index));
+	pairs= malloc((nssp+1)*sizeof(*pairs));
+	if(index==NULL||pairs==NULL) {
+		sprintf(message,"%s [ERROR]: insufficient memory",thisfunc);
+		if(index!=NULL) free(index);
+		if(pairs!=NULL) free(pairs);
+		return(NULL);
+	}
+
+	/* SORT THE SSPS BY START-TIME */
+	for(ii=0;ii<nssp;ii++) { pairs[ii].start= start[ii]; pairs[ii].stop= stop[ii]; }
+	qsort(pairs,nssp,sizeof(*pairs),xf_sspindex1_l_compare);
+
+	/* STORE THE STARTS AND THE RUNNING MAXIMUM OF THE STOPS */
+	for(ii=0;ii<nssp;ii++) {
+		index[ii]= pairs[ii].start;
+		index[nssp+ii]= pairs[ii].stop;
+		if(ii>0 && index[nssp+ii-1]>index[nssp+ii]) index[nssp+ii]= index[nssp+ii-1];
+	}
+
+	free(pairs);
+	return(index);
+}
@@ -0,0 +1,155 @@
+/*
+<TAGS>file dt.spikes</TAGS>
+DESCRIPTION:
+	Write an indexed spike-store (.clux) from cluster timestamps and cluster-IDs
+	The .clux file combines a .clubt/.club pair, with spikes grouped by cluster
+	This allows programs to read only the clusters they need (see xf_readclux1)
+
+	CLUX format (all numbers are 64-bit long integers unless stated):
+		1. 512-byte header
+			a. 32 bytes (char) filetype "CLUX_V1"
+			b. 8 parameters
+				[0] header-size (512)
+				[1] nspikes: total spikes
+				[2] nclu: number of cluster-IDs (highest ID +1)
+				[3] tmin: first timestamp
+				[4] tmax: last timestamp
+				[5] step: spikes per time-index entry
+				[6] ntindex: total time-index entries
+				[7] reserved (0)
+			c. ASCII description of the layout, padded to 512 bytes
+		2. offset[nclu+1]: start of each cluster in the timestamp block
+			- spikes for cluster c are at offset[c] to offset[c+1]-1
+		3. toffset[nclu+1]: start of each cluster in the time-index block
+		4. tindex[ntindex]: every step-th timestamp for each cluster
+			- allows a time-window to be found without touching the whole cluster
+		5. clubt[nspikes]: timestamps grouped by cluster, ascending within each cluster
+
+USES:
+	Conversion of .clubt/.club files for fast cluster-selective reading
+
+DEPENDENCY TREE:
+	int xf_compare1_l(const void *a, const void *b);
+
+ARGUMENTS:
+	char *outfile : name of the file to write
+	long *clubt   : input array of timestamps
+	short *club   : input array of cluster-IDs (must be >=0)
+	long nn       : number of elements in clubt[] and club[]
+	char *message : pre-allocated array to hold error message
+
+RETURN VALUE:
+	number of spikes written, -1 on error
+	clubt[] and club[] are not modified
+
+SAMPLE CALL:
+	nn= xf_readclub1(infile1,infile2,&clubt,&club,message);
+	if(nn<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+	mm= xf_writeclux1("data.clux",clubt,club,nn,message);
+	if(mm<0) { fprintf(stderr,"\n\t--- %s/%s\n\n",thisprog,message); exit(1); }
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define CLUX_HEADERSIZE 512
+#define CLUX_NPARAMS 8
+#define CLUX_STEP 256
+
+/* external functions start */
+int xf_compare1_l(const void *a, const void *b);
+/* external functions end */
+
+long xf_writeclux1(char *outfile, long *clubt, short *club, long nn, char *message) {
+
+	char *thisfunc="xf_writeclux1\0";
+	char filetype[32],describe[CLUX_HEADERSIZE];
+	long ii,jj,kk,nclu,ntindex,hsize1=32,hsize2,hsize3,params[CLUX_NPARAMS];
+	long *offset=NULL,*toffset=NULL,*tindex=NULL,*clubt2=NULL,*fill=NULL;
+	long status=-1;
+	FILE *fpout=NULL;
+
+	/* CHECK VALIDITY OF ARGUMENTS */
+	if(nn<0) { sprintf(message,"%s [ERROR]: invalid size of input (%ld)",thisfunc,nn); return(-1); }
+	for(ii=0;ii<nn;ii++) if(club[ii]<0) { sprintf(message,"%s [ERROR]: invalid cluster-ID (%hd) at record %ld",thisfunc,club[ii],ii); return(-1); }
+
+	/* DETERMINE THE NUMBER OF CLUSTER-IDS */
+	nclu=0; for(ii=0;ii<nn;ii++) if(club[ii]>=nclu) nclu=club[ii]+1;
+
+	/* ALLOCATE MEMORY */
+	offset= calloc(nclu+1,sizeof(*offset));
+	toffset= calloc(nclu+1,sizeof(*toffset));
+	fill= calloc(nclu+1,sizeof(*fill));
+	clubt2= malloc((nn+1)*sizeof(*clubt2));
+	if(offset==NULL||toffset==NULL||fill==NULL||clubt2==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+
+	/* BUILD THE OFFSET TABLE - counts, then cumulative sum */
+	for(ii=0;ii<nn;ii++) offset[club[ii]+1]++;
+	for(ii=0;ii<nclu;ii++) offset[ii+1]+= offset[ii];
+
+	/* GROUP THE TIMESTAMPS BY CLUSTER - stable, so time-sorted input stays sorted within clusters */
+	for(ii=0;ii<nn;ii++) { kk= club[ii]; clubt2[offset[kk]+fill[kk]]= clubt[ii]; fill[kk]++; }
+	/* make sure each cluster is sorted, in case the input was not */
+	for(kk=0;kk<nclu;kk++) {
+		for(ii=offset[kk]+1;ii<offset[kk+1];ii++) if(clubt2[ii]<clubt2[ii-1]) break;
+		if(ii<offset[kk+1]) qsort((clubt2+offset[kk]),(offset[kk+1]-offset[kk]),sizeof(long),xf_compare1_l);
+	}
+
+	/* BUILD THE TIME-INDEX */
+	for(kk=0;kk<nclu;kk++) toffset[kk+1]= toffset[kk] + (offset[kk+1]-offset[kk]+CLUX_STEP-1)/CLUX_STEP;
+	ntindex= toffset[nclu];
+	tindex= malloc((ntindex+1)*sizeof(*tindex));
+	if(tindex==NULL) { sprintf(message,"%s [ERROR]: insufficient memory",thisfunc); goto END; }
+	for(kk=0;kk<nclu;kk++) for(ii=offset[kk],jj=toffset[kk];ii<offset[kk+1];ii+=CLUX_STEP) tindex[jj++]= clubt2[ii];
+
+	/* SET THE PARAMETERS */
+	params[0]= CLUX_HEADERSIZE;
+	params[1]= nn;
+	params[2]= nclu;
+	params[3]= 0; params[4]= 0;
+	if(nn>0) {
+		params[3]= clubt[0]; params[4]= clubt[0];
+		for(ii=0;ii<nn;ii++) { if(clubt[ii]<params[3]) params[3]=clubt[ii]; if(clubt[ii]>params[4]) params[4]=clubt[ii]; }
+	}
+	params[5]= CLUX_STEP;
+	params[6]= ntindex;
+	params[7]= 0;
+
+	/* BUILD THE HEADER */
+	hsize2= CLUX_NPARAMS*sizeof(long);
+	hsize3= CLUX_HEADERSIZE-(hsize1+hsize2);
+	memset(filetype,'_',hsize1);
+	memcpy(filetype,"CLUX_V1",7);
+	filetype[hsize1-1]='\0';
+	memset(describe,'-',hsize3);
+	kk= snprintf(describe,hsize3,
+		"\nCLUX indexed spike-store (long=%ld bytes)\n"
+		"header: filetype, params: size,nspikes,nclu,tmin,tmax,step,ntindex,0\n"
+		"long offset[nclu+1]\nlong toffset[nclu+1]\nlong tindex[ntindex]\nlong clubt[nspikes]\n",
+		sizeof(long));
+	if(kk<0 || kk>=(hsize3-2)) { sprintf(message,"%s [ERROR]: description exceeds header size",thisfunc); goto END; }
+	describe[kk]='-';
+	describe[hsize3-2]='\n';
+	describe[hsize3-1]='\0';
+
+	/* WRITE THE FILE */
+	if((fpout=fopen(outfile,"wb"))==NULL) { sprintf(message,"%s [ERROR]: could not open file %s for writing",thisfunc,outfile); goto END; }
+	if(fwrite(filetype,1,hsize1,fpout)!=hsize1 ||
+		fwrite(params,sizeof(long),CLUX_NPARAMS,fpout)!=CLUX_NPARAMS ||
+		fwrite(describe,1,hsize3,fpout)!=hsize3 ||
+		fwrite(offset,sizeof(long),(nclu+1),fpout)!=(nclu+1) ||
+		fwrite(toffset,sizeof(long),(nclu+1),fpout)!=(nclu+1) ||
+		fwrite(tindex,sizeof(long),ntindex,fpout)!=ntindex ||
+		fwrite(clubt2,sizeof(long),nn,fpout)!=nn
+	) { sprintf(message,"%s [ERROR]: problem writing to %s",thisfunc,outfile); goto END; }
+	status= nn;
+
+END:
+	if(fpout!=NULL) fclose(fpout);
+	if(offset!=NULL) free(offset);
+	if(toffset!=NULL) free(toffset);
+	if(tindex!=NULL) free(tindex);
+	if(fill!=NULL) free(fill);
+	if(clubt2!=NULL) free(clubt2);
+	return(status);
+}